@@ -32,7 +32,7 @@ PsCmd::PsCmd() :
 PsCmd::~PsCmd() {}
 
 void PsCmd::display(JSON& json, TaskInfo& info, long tasknb, const std::string& grep) const {
-    json << info;
+    info.json(json, tasknb);
 }
 
 void PsCmd::display(std::ostream& out, TaskInfo& info, long tasknb, const std::string& grep) const {
@@ -227,25 +227,30 @@ void PsCmd::execute(std::istream& in, std::ostream& out, CmdArg& args) {
         out << Colour::reset;
     }
 
+    // Displayed from private copies, the tasks keep running while they are printed
+    TaskSnapshot copy;
+
     if (all) {
         for (size_t j = 0; j < t.size(); j++) {
+            copy.take(info[t[j]]);
             if (!doJson) {
-                display(out, info[t[j]], t[j], grep);
+                display(out, copy.info(), t[j], grep);
             }
             else {
-                display(json, info[t[j]], t[j], grep);
+                display(json, copy.info(), t[j], grep);
             }
         }
     }
     else {
         for (size_t j = 0; j < t.size(); j++) {
+            copy.take(info[t[j]]);
             for (Ordinal i = 0; i < tasks.size(); ++i) {
                 if (isChild(info, tasks[i], t[j])) {
                     if (!doJson) {
-                        display(out, info[t[j]], t[j], grep);
+                        display(out, copy.info(), t[j], grep);
                     }
                     else {
-                        display(json, info[t[j]], t[j], grep);
+                        display(json, copy.info(), t[j], grep);
                     }
                     break;
                 }
@@ -253,10 +258,10 @@ void PsCmd::execute(std::istream& in, std::ostream& out, CmdArg& args) {
             for (Ordinal k = 0; k < taskids.size(); ++k) {
                 if (isParent(info, taskids[k], t[j])) {
                     if (!doJson) {
-                        display(out, info[t[j]], t[j], grep);
+                        display(out, copy.info(), t[j], grep);
                     }
                     else {
-                        display(json, info[t[j]], t[j], grep);
+                        display(json, copy.info(), t[j], grep);
                     }
                     break;
                 }
@@ -264,10 +269,10 @@ void PsCmd::execute(std::istream& in, std::ostream& out, CmdArg& args) {
             for (Ordinal l = 0; l < pids.size(); ++l) {
                 if (pids[l] == info[t[j]].pid()) {
                     if (!doJson) {
-                        display(out, info[t[j]], t[j], grep);
+                        display(out, copy.info(), t[j], grep);
                     }
                     else {
-                        display(json, info[t[j]], t[j], grep);
+                        display(json, copy.info(), t[j], grep);
                     }
                     break;
                 }
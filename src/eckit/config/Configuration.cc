@@ -13,10 +13,10 @@
 /// @date   July 2015
 
 #include "eckit/config/Configuration.h"
+#include "eckit/config/ConfigurationPath.h"
 #include "eckit/config/LocalConfiguration.h"
 #include "eckit/exception/Exceptions.h"
 #include "eckit/log/JSON.h"
-#include "eckit/utils/Tokenizer.h"
 #include "eckit/value/Value.h"
 
 namespace eckit {
@@ -65,31 +65,30 @@ char Configuration::separator() const {
     return separator_;
 }
 
-eckit::Value Configuration::lookUp(const std::string& s, bool& found) const {
-    eckit::Tokenizer parse(separator_);
-    std::vector<std::string> path;
-    parse(s, path);
-
-    eckit::Value result = *root_;
+const Value* Configuration::find(const std::string& name) const {
+    // Walk the tree in place, splitting the name as Tokenizer would (empty components are skipped)
+    const Value* v = root_.get();
 
-    for (size_t i = 0; i < path.size(); i++) {
-        if (!(result.isMap() || result.isOrderedMap())) {
-            found = false;
-            return result;
+    std::string::size_type start = 0;
+    while ((start = name.find_first_not_of(separator_, start)) != std::string::npos) {
+        std::string::size_type end = name.find(separator_, start);
+        if (!(v = v->find(Value(name.substr(start, end - start))))) {
+            return nullptr;
         }
-        const std::string& key = path[i];
-        if (!result.contains(key)) {
-            found = false;
-            return result;
-        }
-        // For some strange reasons clang decide to use
-        // the non-const version, that will clone the internal map
-        const Value& const_result = result;
-        result                    = const_result[key];
+        start = end;
     }
 
-    found = true;
-    return result;
+    return v;
+}
+
+const Value* Configuration::find(const ConfigurationPath& path) const {
+    return path.resolve(*root_);
+}
+
+eckit::Value Configuration::lookUp(const std::string& s, bool& found) const {
+    const Value* v = find(s);
+    found          = (v != nullptr);
+    return found ? *v : *root_;
 }
 
 eckit::Configuration::operator Value() const {
@@ -98,201 +97,139 @@ eckit::Configuration::operator Value() const {
 
 
 eckit::Value Configuration::lookUp(const std::string& name) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (!found) {
+    const Value* v = find(name);
+    if (!v) {
         throw ConfigurationNotFound(name);
     }
-    return v;
+    return *v;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+void convert(const Value& v, std::string& value) {
+    value = std::string(v);
 }
 
+void convert(const Value& v, bool& value) {
+    value = v;
+}
+
+void convert(const Value& v, int& value) {
+    long result(v);
+    ASSERT(int(result) == result);
+    value = result;
+}
+
+void convert(const Value& v, long& value) {
+    value = long(v);
+}
+
+void convert(const Value& v, long long& value) {
+    using long_long_t = long long;
+    value             = long_long_t(v);
+}
+
+void convert(const Value& v, size_t& value) {
+    value = size_t(v);
+}
+
+void convert(const Value& v, float& value) {
+    value = double(v);
+}
+
+void convert(const Value& v, double& value) {
+    value = v;
+}
+
+template <typename T>
+void convert(const Value& v, std::vector<T>& value) {
+    ASSERT(v.isList());
+    value.clear();
+    int i = 0;
+    while (v.contains(i)) {
+        T result;
+        convert(v[i], result);
+        value.push_back(result);
+        i++;
+    }
+}
+
+template <typename T>
+bool assign(const Value* v, T& value) {
+    if (v) {
+        convert(*v, value);
+    }
+    return v != nullptr;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
 
 bool Configuration::has(const std::string& name) const {
-    bool found = false;
-    lookUp(name, found);
-    return found;
+    return find(name) != nullptr;
 }
 
 bool Configuration::get(const std::string& name, std::string& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        value = std::string(v);
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, bool& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        value = v;
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, int& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        long result(v);
-        ASSERT(int(result) == result);
-        value = result;
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, long& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        value = long(v);
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, long long& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        using long_long_t = long long;
-        value             = long_long_t(v);
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, size_t& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        value = size_t(v);
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, float& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        value = double(v);
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, double& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        value = v;
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, std::vector<int>& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        ASSERT(v.isList());
-        value.clear();
-        int i = 0;
-        while (v.contains(i)) {
-            long result(v[i]);
-            ASSERT(int(result) == result);
-            value.push_back(result);
-            i++;
-        }
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, std::vector<long>& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        ASSERT(v.isList());
-        value.clear();
-        int i = 0;
-        while (v.contains(i)) {
-            value.push_back(v[i]);
-            i++;
-        }
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, std::vector<long long>& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        ASSERT(v.isList());
-        value.clear();
-        int i = 0;
-        while (v.contains(i)) {
-            value.push_back(v[i]);
-            i++;
-        }
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, std::vector<size_t>& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        ASSERT(v.isList());
-        value.clear();
-        int i = 0;
-        while (v.contains(i)) {
-            value.push_back(v[i]);
-            i++;
-        }
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, std::vector<float>& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        ASSERT(v.isList());
-        value.clear();
-        int i = 0;
-        while (v.contains(i)) {
-            value.push_back(double(v[i]));
-            i++;
-        }
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, std::vector<double>& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        ASSERT(v.isList());
-        value.clear();
-        int i = 0;
-        while (v.contains(i)) {
-            value.push_back(v[i]);
-            i++;
-        }
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, std::vector<std::string>& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        ASSERT(v.isList());
-        value.clear();
-        int i = 0;
-        while (v.contains(i)) {
-            value.push_back(v[i]);
-            i++;
-        }
-    }
-    return found;
+    return assign(find(name), value);
 }
 
 bool Configuration::get(const std::string& name, LocalConfiguration& value) const {
@@ -312,18 +249,83 @@ void Configuration::hash(Hash& h) const {
 }
 
 bool Configuration::get(const std::string& name, std::vector<LocalConfiguration>& value) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    if (found) {
-        ASSERT(v.isList());
+    const Value* v = find(name);
+    if (v) {
+        ASSERT(v->isList());
         value.clear();
         int i = 0;
-        while (v.contains(i)) {
-            value.push_back(LocalConfiguration(v[i], separator_));
+        while (v->contains(i)) {
+            value.push_back(LocalConfiguration((*v)[i], separator_));
             i++;
         }
     }
-    return found;
+    return v != nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Configuration::has(const ConfigurationPath& path) const {
+    return find(path) != nullptr;
+}
+
+bool Configuration::get(const ConfigurationPath& path, std::string& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, bool& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, int& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, long& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, long long& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, size_t& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, float& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, double& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, std::vector<int>& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, std::vector<long>& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, std::vector<long long>& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, std::vector<size_t>& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, std::vector<float>& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, std::vector<double>& value) const {
+    return assign(find(path), value);
+}
+
+bool Configuration::get(const ConfigurationPath& path, std::vector<std::string>& value) const {
+    return assign(find(path), value);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -390,6 +392,67 @@ std::string Configuration::getString(const std::string& name) const {
 }
 
 
+template <class T>
+void Configuration::_get(const ConfigurationPath& path, T& value) const {
+    if (!get(path, value)) {
+        throw ConfigurationNotFound(path.path());
+    }
+}
+
+bool Configuration::getBool(const ConfigurationPath& path) const {
+    bool result;
+    _get(path, result);
+    return result;
+}
+
+int Configuration::getInt(const ConfigurationPath& path) const {
+    int result;
+    _get(path, result);
+    return result;
+}
+
+long Configuration::getLong(const ConfigurationPath& path) const {
+    long result;
+    _get(path, result);
+    return result;
+}
+
+size_t Configuration::getUnsigned(const ConfigurationPath& path) const {
+    size_t result;
+    _get(path, result);
+    return result;
+}
+
+std::int32_t Configuration::getInt32(const ConfigurationPath& path) const {
+    std::int32_t result;
+    _get(path, result);
+    return result;
+}
+
+std::int64_t Configuration::getInt64(const ConfigurationPath& path) const {
+    std::int64_t result;
+    _get(path, result);
+    return result;
+}
+
+float Configuration::getFloat(const ConfigurationPath& path) const {
+    float result;
+    _get(path, result);
+    return result;
+}
+
+double Configuration::getDouble(const ConfigurationPath& path) const {
+    double result;
+    _get(path, result);
+    return result;
+}
+
+std::string Configuration::getString(const ConfigurationPath& path) const {
+    std::string result;
+    _get(path, result);
+    return result;
+}
+
 std::vector<int> Configuration::getIntVector(const std::string& name) const {
     std::vector<int> result;
     _get(name, result);
@@ -465,101 +528,90 @@ LocalConfiguration Configuration::getSubConfiguration(const std::string& name) c
 }
 
 bool Configuration::isIntegral(const std::string& name) const {
-    bool found = false;
-    eckit::Value v = lookUp(name, found);
-    return found && v.isNumber();
+    const Value* v = find(name);
+    return v && v->isNumber();
 }
 
 bool Configuration::isBoolean(const std::string& name) const {
-    bool found = false;
-    eckit::Value v = lookUp(name, found);
-    return found && v.isBool();
+    const Value* v = find(name);
+    return v && v->isBool();
 }
 
 bool Configuration::isFloatingPoint(const std::string& name) const {
-    bool found = false;
-    eckit::Value v = lookUp(name, found);
-    return found && v.isDouble();
+    const Value* v = find(name);
+    return v && v->isDouble();
 }
 
 bool Configuration::isString(const std::string& name) const {
-    bool found = false;
-    eckit::Value v = lookUp(name, found);
-    return found && v.isString();
+    const Value* v = find(name);
+    return v && v->isString();
 }
 
 bool Configuration::isList(const std::string& name) const {
-    bool found = false;
-    eckit::Value v = lookUp(name, found);
-    return found && v.isList();
+    const Value* v = find(name);
+    return v && v->isList();
 }
 
 bool Configuration::isSubConfiguration(const std::string& name) const {
-    bool found     = false;
-    eckit::Value v = lookUp(name, found);
-    return found && (v.isMap() || v.isOrderedMap());
+    const Value* v = find(name);
+    return v && (v->isMap() || v->isOrderedMap());
 }
 
 bool Configuration::isIntegralList(const std::string& name) const {
-    bool found = false;
-    eckit::Value v = lookUp(name, found);
-    if (found && v.isList()) {
-        if (v.size() == 0) {
+    const Value* v = find(name);
+    if (v && v->isList()) {
+        if (v->size() == 0) {
             return true;
         }
-        auto& firstElement = v[0];
+        const Value firstElement = (*v)[0];
         return firstElement.isNumber();
     }
     return false;
 }
 
 bool Configuration::isBooleanList(const std::string& name) const {
-    bool found = false;
-    eckit::Value v = lookUp(name, found);
-    if (found && v.isList()) {
-        if (v.size() == 0) {
+    const Value* v = find(name);
+    if (v && v->isList()) {
+        if (v->size() == 0) {
             return true;
         }
-        auto& firstElement = v[0];
+        const Value firstElement = (*v)[0];
         return firstElement.isBool();
     }
     return false;
 }
 
 bool Configuration::isFloatingPointList(const std::string& name) const {
-    bool found = false;
-    eckit::Value v = lookUp(name, found);
-    if (found && v.isList()) {
-        if (v.size() == 0) {
+    const Value* v = find(name);
+    if (v && v->isList()) {
+        if (v->size() == 0) {
             return true;
         }
-        auto& firstElement = v[0];
+        const Value firstElement = (*v)[0];
         return firstElement.isDouble();
     }
     return false;
 }
 
 bool Configuration::isStringList(const std::string& name) const {
-    bool found = false;
-    eckit::Value v = lookUp(name, found);
-    if (found && v.isList()) {
-        if (v.size() == 0) {
+    const Value* v = find(name);
+    if (v && v->isList()) {
+        if (v->size() == 0) {
             return true;
         }
-        auto& firstElement = v[0];
+        const Value firstElement = (*v)[0];
         return firstElement.isString();
     }
     return false;
 }
 
 bool Configuration::isSubConfigurationList(const std::string& name) const {
-    bool found = false;
-    eckit::Value v = lookUp(name, found);
-    if (found && v.isList()) {
-        if (v.size() == 0) {
+    const Value* v = find(name);
+    if (v && v->isList()) {
+        if (v->size() == 0) {
             return true;
         }
-        auto& firstElement = v[0];
+        const Value firstElement = (*v)[0];
         return firstElement.isMap() || firstElement.isOrderedMap();
     }
     return false;
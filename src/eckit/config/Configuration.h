@@ -26,6 +26,7 @@ namespace eckit {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+class ConfigurationPath;
 class LocalConfiguration;
 class JSON;
 class Value;
@@ -53,6 +54,18 @@ public:  // methods
     double getDouble(const std::string& name) const;
     std::string getString(const std::string& name) const;
 
+    // Fastest access, with a pre-parsed key, will throw an exception
+
+    bool getBool(const ConfigurationPath&) const;
+    int getInt(const ConfigurationPath&) const;
+    long getLong(const ConfigurationPath&) const;
+    std::size_t getUnsigned(const ConfigurationPath&) const;
+    std::int32_t getInt32(const ConfigurationPath&) const;
+    std::int64_t getInt64(const ConfigurationPath&) const;
+    float getFloat(const ConfigurationPath&) const;
+    double getDouble(const ConfigurationPath&) const;
+    std::string getString(const ConfigurationPath&) const;
+
     std::vector<int> getIntVector(const std::string& name) const;
     std::vector<long> getLongVector(const std::string& name) const;
     std::vector<std::size_t> getUnsignedVector(const std::string& name) const;
@@ -125,6 +138,27 @@ public:  // methods
     bool get(const std::string& name, std::vector<LocalConfiguration>&) const;
     bool get(const std::string& name, LocalConfiguration&) const;
 
+    // -- Access with a pre-parsed key
+
+    bool has(const ConfigurationPath&) const;
+
+    bool get(const ConfigurationPath&, std::string& value) const;
+    bool get(const ConfigurationPath&, bool& value) const;
+    bool get(const ConfigurationPath&, int& value) const;
+    bool get(const ConfigurationPath&, long& value) const;
+    bool get(const ConfigurationPath&, long long& value) const;
+    bool get(const ConfigurationPath&, std::size_t& value) const;
+    bool get(const ConfigurationPath&, float& value) const;
+    bool get(const ConfigurationPath&, double& value) const;
+
+    bool get(const ConfigurationPath&, std::vector<int>& value) const;
+    bool get(const ConfigurationPath&, std::vector<long>& value) const;
+    bool get(const ConfigurationPath&, std::vector<long long>& value) const;
+    bool get(const ConfigurationPath&, std::vector<std::size_t>& value) const;
+    bool get(const ConfigurationPath&, std::vector<float>& value) const;
+    bool get(const ConfigurationPath&, std::vector<double>& value) const;
+    bool get(const ConfigurationPath&, std::vector<std::string>& value) const;
+
     /// @todo This method should be protected. As per note above,
     ///       we don't want to expose eckit::Value out of Configuration.
     [[deprecated("eckit::Value should not be exposed via eckit::Configuration::get(). This method Will be removed in a next release.")]]
@@ -210,12 +244,17 @@ protected:  // methods
     Value lookUp(const std::string&) const;
     Value lookUp(const std::string&, bool&) const;
 
+    /// @returns pointer into the tree of values, nullptr if not found. Invalidated by any modification.
+    virtual const Value* find(const std::string&) const;
+    virtual const Value* find(const ConfigurationPath&) const;
+
     operator Value() const;
 
     const Value& getValue() const;
 
 protected:  // members
     friend class LocalConfiguration;
+    friend class FrozenConfiguration;
     std::unique_ptr<Value> root_;
     char separator_;
 
@@ -229,6 +268,9 @@ private:  // methods
     template <class T>
     void _get(const std::string&, T&) const;
 
+    template <class T>
+    void _get(const ConfigurationPath&, T&) const;
+
     template <class T>
     void _getWithDefault(const std::string& name, T& value, const T& defaultVal) const;
 
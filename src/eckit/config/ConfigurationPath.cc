@@ -0,0 +1,60 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <ostream>
+
+#include "eckit/config/ConfigurationPath.h"
+#include "eckit/value/Value.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ConfigurationPath::ConfigurationPath(const std::string& path, char separator) :
+    path_(path), separator_(separator) {
+    // Same splitting rules as Tokenizer: empty components are skipped
+    std::string::size_type start = 0;
+    while ((start = path_.find_first_not_of(separator_, start)) != std::string::npos) {
+        std::string::size_type end = path_.find(separator_, start);
+        keys_.emplace_back(path_.substr(start, end - start));
+        start = end;
+    }
+}
+
+ConfigurationPath::ConfigurationPath(const char* path, char separator) :
+    ConfigurationPath(std::string(path), separator) {}
+
+ConfigurationPath::ConfigurationPath(const ConfigurationPath&) = default;
+
+ConfigurationPath& ConfigurationPath::operator=(const ConfigurationPath&) = default;
+
+ConfigurationPath::~ConfigurationPath() = default;
+
+size_t ConfigurationPath::depth() const {
+    return keys_.size();
+}
+
+const Value* ConfigurationPath::resolve(const Value& root) const {
+    const Value* v = &root;
+    for (const Value& key : keys_) {
+        if (!(v = v->find(key))) {
+            return nullptr;
+        }
+    }
+    return v;
+}
+
+void ConfigurationPath::print(std::ostream& out) const {
+    out << path_;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
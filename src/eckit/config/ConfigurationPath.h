@@ -0,0 +1,73 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#ifndef eckit_ConfigurationPath_H
+#define eckit_ConfigurationPath_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+namespace eckit {
+
+class Value;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// A configuration key parsed once into its path components.
+///
+/// Use it in place of a std::string key when the same parameter is queried repeatedly, e.g. inside time-step loops:
+/// the lookup then walks the configuration tree directly, without tokenising the key or copying intermediate values.
+///
+///     static const ConfigurationPath timestep("model.timestep");
+///     double dt = config.getDouble(timestep);
+
+class ConfigurationPath {
+public:  // methods
+    explicit ConfigurationPath(const std::string& path, char separator = '.');
+    explicit ConfigurationPath(const char* path, char separator = '.');
+
+    ConfigurationPath(const ConfigurationPath&);
+    ConfigurationPath& operator=(const ConfigurationPath&);
+
+    ~ConfigurationPath();
+
+    const std::string& path() const { return path_; }
+    char separator() const { return separator_; }
+
+    size_t depth() const;
+
+private:  // methods
+    /// @returns pointer to the value at this path below root, or nullptr if not found
+    const Value* resolve(const Value& root) const;
+
+    void print(std::ostream&) const;
+
+    friend std::ostream& operator<<(std::ostream& s, const ConfigurationPath& p) {
+        p.print(s);
+        return s;
+    }
+
+private:  // members
+    friend class Configuration;
+
+    std::string path_;
+    char separator_;
+    std::vector<Value> keys_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <ostream>
+
+#include "eckit/config/ConfigurationPath.h"
+#include "eckit/config/FrozenConfiguration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/value/Value.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+FrozenConfiguration::FrozenConfiguration(const Configuration& other) :
+    Configuration(other.getValue().clone(), other.separator()) {
+    // deep copy above, so that nobody can modify the tree the index points into
+    index(*root_, "");
+}
+
+FrozenConfiguration::~FrozenConfiguration() = default;
+
+void FrozenConfiguration::index(const Value& node, const std::string& prefix) {
+    if (!(node.isMap() || node.isOrderedMap())) {
+        return;
+    }
+
+    const Value keys = node.keys();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const Value key = keys[i];
+        if (!key.isString()) {
+            continue;  // not addressable by name
+        }
+
+        const std::string name = key;
+        if (name.empty() || name.find(separator_) != std::string::npos) {
+            continue;  // not addressable by name, as it would be split
+        }
+
+        const Value* child = node.find(key);
+        ASSERT(child);
+
+        std::string path = prefix.empty() ? name : prefix + separator_ + name;
+        index(*child, path);
+        index_.emplace(std::move(path), child);
+    }
+}
+
+const Value* FrozenConfiguration::find(const std::string& name) const {
+    auto j = index_.find(name);
+    if (j != index_.end()) {
+        return j->second;
+    }
+
+    // not a canonical path (e.g. empty, leading or repeated separators), or not found
+    return Configuration::find(name);
+}
+
+const Value* FrozenConfiguration::find(const ConfigurationPath& path) const {
+    if (path.separator() == separator_) {
+        auto j = index_.find(path.path());
+        if (j != index_.end()) {
+            return j->second;
+        }
+    }
+    return Configuration::find(path);
+}
+
+void FrozenConfiguration::print(std::ostream& out) const {
+    out << "FrozenConfiguration[root=" << *root_ << "]";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,58 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#ifndef eckit_FrozenConfiguration_H
+#define eckit_FrozenConfiguration_H
+
+#include <string>
+#include <unordered_map>
+
+#include "eckit/config/Configuration.h"
+#include "eckit/memory/NonCopyable.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Read-only snapshot of a Configuration, for repeated queries in hot code.
+///
+/// Every reachable path (e.g. "a", "a.b", "a.b.c") is indexed once at construction into a flat hash table pointing
+/// into a private copy of the tree, so a get() costs a single hash lookup regardless of the depth of the key.
+/// Lookup semantics (separator handling, type conversions, exceptions) are those of Configuration.
+
+class FrozenConfiguration : public Configuration, private eckit::NonCopyable {
+public:  // methods
+    explicit FrozenConfiguration(const Configuration&);
+
+    ~FrozenConfiguration() override;
+
+    /// Number of indexed paths
+    size_t size() const { return index_.size(); }
+
+protected:  // methods
+    const Value* find(const std::string&) const override;
+    const Value* find(const ConfigurationPath&) const override;
+
+private:  // methods
+    void index(const Value&, const std::string& prefix);
+
+    void print(std::ostream&) const override;
+
+private:  // members
+    std::unordered_map<std::string, const Value*> index_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
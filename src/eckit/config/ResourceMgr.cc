@@ -68,8 +68,7 @@ bool ResourceMgr::parse(const char* p) {
         int len = p - q;
         p       = skip_spaces(p);
 
-        s[n] = q;
-        s[n].resize(len);
+        s[n].assign(q, len);
         n++;
 
         if (n == 3 || *p != '.') {
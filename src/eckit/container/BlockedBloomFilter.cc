@@ -0,0 +1,231 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/container/BlockedBloomFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+
+#include "eckit/eckit.h"
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/serialisation/FileStream.h"
+#include "eckit/serialisation/Stream.h"
+#include "eckit/utils/ByteSwap.h"
+
+#if eckit_HAVE_XXHASH
+#define XXH_INLINE_ALL
+#include "eckit/contrib/xxhash/xxhash.h"
+#endif
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+constexpr size_t BLOCK_BITS = BlockedBloomFilter::WORDS * 32;
+
+// Odd constants, each maps the hash to the bit set in one word (those of the Parquet split-block filter, then more)
+constexpr uint32_t SALTS[BlockedBloomFilter::WORDS] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+    0x9e3779b1U, 0x85ebca77U, 0xc2b2ae3dU, 0x27d4eb2fU, 0x165667b1U, 0xd3a2646dU, 0xfd7046c5U, 0xb55a4f09U,
+};
+
+// Selects the first of the consecutive words used by a hash
+constexpr uint32_t START_SALT = 0x61c88647U;
+
+// Encoded first: a filter is only valid with the hash function it was built with, which depends on eckit having xxHash
+#if eckit_HAVE_XXHASH
+constexpr unsigned HASH_FUNCTION = 1;  // XXH3, 64 bits
+#else
+constexpr unsigned HASH_FUNCTION = 2;  // FNV-1a, with a finaliser
+#endif
+
+// Blocks concentrate the bits, so that a few get more than their share of the entries: the bits per entry of a
+// classic Bloom filter are increased, by a factor measured with benchmark_bloomfilter
+constexpr double BLOCKING_OVERHEAD = 1.2;
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+BlockedBloomFilter::BlockedBloomFilter(size_t entries, double falsePositiveRate) :
+    entries_(0) {
+    ASSERT(falsePositiveRate > 0 && falsePositiveRate < 1);
+
+    const double ln2    = std::log(2.);
+    double bitsPerEntry = -std::log(falsePositiveRate) / (ln2 * ln2);
+    hashes_             = unsigned(std::max(1L, std::min(long(WORDS), std::lround(bitsPerEntry * ln2))));
+
+    double bits = std::max<double>(entries, 1) * bitsPerEntry * BLOCKING_OVERHEAD;
+    blocks_.resize(std::max<size_t>(1, size_t(std::ceil(bits / BLOCK_BITS))));
+    clear();
+}
+
+BlockedBloomFilter::BlockedBloomFilter(Stream& s) {
+    unsigned hashFunction;
+    s >> hashFunction;
+    if (hashFunction != HASH_FUNCTION) {
+        std::ostringstream oss;
+        oss << "BlockedBloomFilter: encoded with hash function " << hashFunction << ", expected " << HASH_FUNCTION
+            << " (1: XXH3, requires eckit built with xxHash, 2: FNV-1a)";
+        throw BadValue(oss.str(), Here());
+    }
+
+    size_t blocks;
+    s >> hashes_;
+    s >> entries_;
+    s >> blocks;
+    if (hashes_ < 1 || hashes_ > WORDS || blocks == 0) {
+        throw BadValue("BlockedBloomFilter: invalid encoding", Here());
+    }
+
+    blocks_.resize(blocks);
+    s.readLargeBlob(blocks_.data(), footprint());
+
+#if eckit_BIG_ENDIAN
+    for (Block& b : blocks_) {
+        byteswap(b.words, WORDS);
+    }
+#endif
+}
+
+uint64_t BlockedBloomFilter::hash(const void* data, size_t length) {
+#if eckit_HAVE_XXHASH
+    return XXH3_64bits(data, length);
+#else
+    // FNV-1a, with the bits mixed by a finaliser for those at the top to depend on every byte
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h             = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; ++i) {
+        h = (h ^ p[i]) * 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+#endif
+}
+
+void BlockedBloomFilter::insertHash(uint64_t hash) {
+    Block& b       = blocks_[index(hash)];
+    uint32_t h     = uint32_t(hash);
+    unsigned start = (h * START_SALT) >> 28;
+
+    for (unsigned i = 0; i < hashes_; ++i) {
+        b.words[(start + i) % WORDS] |= uint32_t(1) << ((h * SALTS[i]) >> 27);
+    }
+    entries_++;
+}
+
+bool BlockedBloomFilter::containsHash(uint64_t hash) const {
+    const Block& b = blocks_[index(hash)];
+    uint32_t h     = uint32_t(hash);
+    unsigned start = (h * START_SALT) >> 28;
+
+    // No early exit, the block is in one cache line
+    uint32_t found = 1;
+    for (unsigned i = 0; i < hashes_; ++i) {
+        found &= b.words[(start + i) % WORDS] >> ((h * SALTS[i]) >> 27);
+    }
+    return found;
+}
+
+void BlockedBloomFilter::checkCompatible(const BlockedBloomFilter& other) const {
+    if (blocks_.size() != other.blocks_.size() || hashes_ != other.hashes_) {
+        std::ostringstream oss;
+        oss << "Cannot combine " << *this << " and " << other << ", built for different numbers of entries or rates";
+        throw BadParameter(oss.str(), Here());
+    }
+}
+
+BlockedBloomFilter& BlockedBloomFilter::operator|=(const BlockedBloomFilter& other) {
+    checkCompatible(other);
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+        for (size_t w = 0; w < WORDS; ++w) {
+            blocks_[i].words[w] |= other.blocks_[i].words[w];
+        }
+    }
+    entries_ += other.entries_;
+    return *this;
+}
+
+BlockedBloomFilter& BlockedBloomFilter::operator&=(const BlockedBloomFilter& other) {
+    checkCompatible(other);
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+        for (size_t w = 0; w < WORDS; ++w) {
+            blocks_[i].words[w] &= other.blocks_[i].words[w];
+        }
+    }
+    entries_ = std::min(entries_, other.entries_);
+    return *this;
+}
+
+void BlockedBloomFilter::clear() {
+    std::memset(blocks_.data(), 0, footprint());
+    entries_ = 0;
+}
+
+double BlockedBloomFilter::falsePositiveRate() const {
+    // A lookup is a false positive if the k bits it checks are set, each in a different word
+    size_t set = 0;
+    for (const Block& b : blocks_) {
+        for (uint32_t w : b.words) {
+            set += __builtin_popcount(w);
+        }
+    }
+    return std::pow(double(set) / double(blocks_.size() * BLOCK_BITS), hashes_);
+}
+
+void BlockedBloomFilter::encode(Stream& s) const {
+    s << HASH_FUNCTION;
+    s << hashes_;
+    s << entries_;
+    s << blocks_.size();
+
+    // Words are little-endian
+#if eckit_BIG_ENDIAN
+    std::vector<Block> blocks(blocks_);
+    for (Block& b : blocks) {
+        byteswap(b.words, WORDS);
+    }
+    s.writeLargeBlob(blocks.data(), footprint());
+#else
+    s.writeLargeBlob(blocks_.data(), footprint());
+#endif
+}
+
+void BlockedBloomFilter::save(const PathName& path) const {
+    FileStream s(path, "w");
+    s << *this;
+    s.close();
+}
+
+BlockedBloomFilter BlockedBloomFilter::load(const PathName& path) {
+    FileStream s(path, "r");
+    BlockedBloomFilter f(s);
+    s.close();
+    return f;
+}
+
+void BlockedBloomFilter::print(std::ostream& s) const {
+    s << "BlockedBloomFilter(entries=" << entries_ << ",blocks=" << blocks_.size() << ",hashes=" << hashes_ << ")";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,122 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   BlockedBloomFilter.h
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace eckit {
+
+class PathName;
+class Stream;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Split-block Bloom filter: each value sets k bits in a single 64-byte block, one bit in each of k of its 32-bit
+/// words, so that an insert or a lookup costs one hash (XXH3 if eckit has xxHash) and one cache miss. The k bits are
+/// derived from the hash by multiplying it with fixed odd constants, with no branch, which compilers vectorise.
+///
+/// Filters built with the same number of blocks and hashes can be combined, e.g. the union of the filters of several
+/// indexes. Filters are plain values, not thread-safe.
+///
+/// The encoding records the hash function: a filter saved by an eckit built with xxHash cannot be loaded by one built
+/// without, and conversely.
+
+class BlockedBloomFilter {
+public:  // types
+    static constexpr size_t WORDS = 16;  ///< 32-bit words in a block, a cache line
+
+    struct alignas(64) Block {
+        uint32_t words[WORDS];
+    };
+
+public:  // methods
+    /// Sized for the expected number of entries to have at most the given rate of false positives
+    BlockedBloomFilter(size_t entries, double falsePositiveRate = 0.01);
+
+    explicit BlockedBloomFilter(Stream&);
+
+    bool empty() const { return entries_ == 0; }
+
+    void insert(const void* data, size_t length) { insertHash(hash(data, length)); }
+    void insert(const std::string& value) { insert(value.data(), value.size()); }
+
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+    void insert(T value) {
+        insert(&value, sizeof(value));
+    }
+
+    bool contains(const void* data, size_t length) const { return containsHash(hash(data, length)); }
+    bool contains(const std::string& value) const { return contains(value.data(), value.size()); }
+
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+    bool contains(T value) const {
+        return contains(&value, sizeof(value));
+    }
+
+    /// For values hashed once and looked up in several filters
+    static uint64_t hash(const void* data, size_t length);
+    void insertHash(uint64_t);
+    bool containsHash(uint64_t) const;
+
+    /// Values in either filter. The number of entries becomes an upper bound.
+    BlockedBloomFilter& operator|=(const BlockedBloomFilter&);
+
+    /// Values in both filters, with false positives of either. The number of entries becomes an upper bound.
+    BlockedBloomFilter& operator&=(const BlockedBloomFilter&);
+
+    void clear();
+
+    size_t entries() const { return entries_; }
+    size_t blocks() const { return blocks_.size(); }
+    unsigned hashes() const { return hashes_; }
+    size_t footprint() const { return blocks_.size() * sizeof(Block); }
+
+    /// Estimated from the proportion of bits set, ignoring that some blocks get more entries than others: lower than
+    /// measured at low rates
+    double falsePositiveRate() const;
+
+    void encode(Stream&) const;
+
+    void save(const PathName&) const;
+    static BlockedBloomFilter load(const PathName&);
+
+    friend Stream& operator<<(Stream& s, const BlockedBloomFilter& f) {
+        f.encode(s);
+        return s;
+    }
+
+    friend std::ostream& operator<<(std::ostream& s, const BlockedBloomFilter& f) {
+        f.print(s);
+        return s;
+    }
+
+private:  // methods
+    void print(std::ostream&) const;
+    void checkCompatible(const BlockedBloomFilter&) const;
+
+    /// From the high bits of the hash, the low bits select the bits in the block
+    size_t index(uint64_t hash) const { return ((hash >> 32) * blocks_.size()) >> 32; }
+
+private:  // members
+    std::vector<Block> blocks_;
+    unsigned hashes_;
+    size_t entries_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -39,8 +39,8 @@ template <typename T>
 void BloomFilter<T>::insert(const T& value) {
 
     size_t bit_index = index(value);
-    size_t elem      = bit_index / sizeof(data_type);
-    size_t offset    = bit_index % sizeof(data_type);
+    size_t elem      = bit_index / bitsPerElement;
+    size_t offset    = bit_index % bitsPerElement;
 
     data_[elem] |= (data_type(1) << offset);
     entries_++;
@@ -51,8 +51,8 @@ template <typename T>
 bool BloomFilter<T>::contains(const T& value) const {
 
     size_t bit_index = index(value);
-    size_t elem      = bit_index / sizeof(data_type);
-    size_t offset    = bit_index % sizeof(data_type);
+    size_t elem      = bit_index / bitsPerElement;
+    size_t offset    = bit_index % bitsPerElement;
 
     return !((data_[elem] & (data_type(1) << offset)) == 0);
 }
@@ -66,7 +66,7 @@ void BloomFilter<T>::print(std::ostream& s) const {
 
 template <typename T>
 size_t BloomFilter<T>::elementCount(size_t nbits) {
-    return (nbits == 0) ? 0 : ((nbits - 1) / sizeof(data_type)) + 1;
+    return (nbits == 0) ? 0 : ((nbits - 1) / bitsPerElement) + 1;
 }
 
 
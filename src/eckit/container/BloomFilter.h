@@ -33,6 +33,8 @@ class BloomFilter : private NonCopyable {
 public:  // types
     typedef unsigned long long data_type;
 
+    static constexpr size_t bitsPerElement = 8 * sizeof(data_type);
+
 public:  // methods
     BloomFilter(size_t size);
     ~BloomFilter();
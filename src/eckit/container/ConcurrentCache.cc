@@ -0,0 +1,509 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/container/ConcurrentCache.h"
+
+#include <algorithm>
+#include <mutex>
+#include <ostream>
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace concurrent_cache {
+
+inline uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+inline const char* name(CacheEviction eviction) {
+    switch (eviction) {
+        case CacheEviction::LRU:
+            return "LRU";
+        case CacheEviction::CLOCK:
+            return "CLOCK";
+        case CacheEviction::TinyLFU:
+            return "TinyLFU";
+    }
+    return "?";
+}
+
+}  // namespace concurrent_cache
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::FrequencySketch::resize(size_t entries) {
+    size_t width = 16;
+    while (width < entries) {
+        width <<= 1;
+    }
+    table_.assign(4 * width, 0);
+    mask_      = width - 1;
+    additions_ = 0;
+}
+
+template <typename K, typename V, typename H>
+size_t ConcurrentCache<K, V, H>::FrequencySketch::index(size_t hash, size_t row) const {
+    static const uint64_t seeds[] = {0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL, 0x165667b19e3779f9ULL,
+                                     0xd6e8feb86659fd93ULL};
+    return row * width() + (concurrent_cache::mix(hash + seeds[row]) & mask_);
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::FrequencySketch::increment(size_t hash) {
+    bool added = false;
+    for (size_t row = 0; row < 4; ++row) {
+        uint8_t& c = table_[index(hash, row)];
+        if (c < 15) {
+            ++c;
+            added = true;
+        }
+    }
+
+    // Ages all frequencies, so that keys once popular can be evicted
+    if (added && ++additions_ >= 10 * width()) {
+        for (uint8_t& c : table_) {
+            c >>= 1;
+        }
+        additions_ /= 2;
+    }
+}
+
+template <typename K, typename V, typename H>
+unsigned ConcurrentCache<K, V, H>::FrequencySketch::frequency(size_t hash) const {
+    unsigned f = 15;
+    for (size_t row = 0; row < 4; ++row) {
+        f = std::min<unsigned>(f, table_[index(hash, row)]);
+    }
+    return f;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <typename K, typename V, typename H>
+ConcurrentCache<K, V, H>::ConcurrentCache(size_t capacity, CacheEviction eviction, purge_handler_type purge,
+                                          weigh_handler_type weigh, size_t shards) :
+    shardCount_(1), shardBits_(0), capacity_(capacity), eviction_(eviction), purge_(purge), weigh_(weigh) {
+
+    // Enough shards for threads not to contend, each with enough entries for the eviction to be fair
+    if (shards == 0) {
+        shards = 1;
+        while (shards < 16 && capacity / (2 * shards) >= 64) {
+            shards *= 2;
+        }
+    }
+
+    while (shardCount_ < shards) {
+        shardCount_ <<= 1;
+        shardBits_++;
+    }
+
+    shards_.reset(new Shard[shardCount_]);
+
+    this->capacity(capacity);
+}
+
+template <typename K, typename V, typename H>
+ConcurrentCache<K, V, H>::~ConcurrentCache() {
+    clear();
+}
+
+template <typename K, typename V, typename H>
+typename ConcurrentCache<K, V, H>::Shard& ConcurrentCache<K, V, H>::shard(size_t hash) const {
+    // High bits, as the map of the shard uses the low bits of the same hash
+    return shards_[shardBits_ ? concurrent_cache::mix(hash) >> (64 - shardBits_) : 0];
+}
+
+template <typename K, typename V, typename H>
+bool ConcurrentCache<K, V, H>::insert(const key_type& key, const value_type& value) {
+    size_t h      = hash(key);
+    size_t weight = weigh_ ? weigh_(key, value) : 1;
+    Shard& s      = shard(h);
+
+    bool existed = false;
+    list_type evicted;
+    {
+        std::unique_lock<std::shared_mutex> lock(s.mutex_);
+
+        auto j = s.map_.find(key);
+        if (j != s.map_.end()) {
+            existed = true;
+
+            // As CacheLRU, the old value is not purged
+            node_iterator n = j->second;
+            s.weights_[n->segment_] -= n->weight_;
+            s.weights_[n->segment_] += weight;
+            n->value_  = value;
+            n->weight_ = weight;
+            touch(s, n);
+        }
+        else {
+            s.map_.emplace(key, link(s, key, value, h, weight));
+            s.insertions_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        trim(s, evicted);
+    }
+
+    purge(evicted);
+    return existed;
+}
+
+template <typename K, typename V, typename H>
+bool ConcurrentCache<K, V, H>::find(const key_type& key, value_type& value) {
+    size_t h = hash(key);
+    Shard& s = shard(h);
+
+    if (eviction_ == CacheEviction::CLOCK) {
+        std::shared_lock<std::shared_mutex> lock(s.mutex_);
+        auto j = s.map_.find(key);
+        if (j == s.map_.end()) {
+            s.misses_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        j->second->referenced_.store(true, std::memory_order_relaxed);
+        value = j->second->value_;
+        s.hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(s.mutex_);
+    auto j = s.map_.find(key);
+    if (j == s.map_.end()) {
+        // Misses count towards the frequency, for the key to be admitted once inserted
+        if (eviction_ == CacheEviction::TinyLFU) {
+            s.sketch_.increment(h);
+        }
+        s.misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    touch(s, j->second);
+    value = j->second->value_;
+    s.hits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+template <typename K, typename V, typename H>
+V ConcurrentCache<K, V, H>::access(const key_type& key) {
+    value_type value;
+    if (!find(key, value)) {
+        throw eckit::OutOfRange("key not in ConcurrentCache", Here());
+    }
+    return value;
+}
+
+template <typename K, typename V, typename H>
+V ConcurrentCache<K, V, H>::extract(const key_type& key) {
+    Shard& s = shard(hash(key));
+
+    list_type extracted;
+    {
+        std::unique_lock<std::shared_mutex> lock(s.mutex_);
+        auto j = s.map_.find(key);
+        if (j == s.map_.end()) {
+            throw eckit::OutOfRange("key not in ConcurrentCache", Here());
+        }
+        unlink(s, j->second, extracted);
+    }
+    return extracted.front().value_;
+}
+
+template <typename K, typename V, typename H>
+bool ConcurrentCache<K, V, H>::remove(const key_type& key) {
+    Shard& s = shard(hash(key));
+
+    list_type removed;
+    {
+        std::unique_lock<std::shared_mutex> lock(s.mutex_);
+        auto j = s.map_.find(key);
+        if (j == s.map_.end()) {
+            return false;
+        }
+        unlink(s, j->second, removed);
+    }
+    purge(removed);
+    return true;
+}
+
+template <typename K, typename V, typename H>
+bool ConcurrentCache<K, V, H>::exists(const key_type& key) const {
+    Shard& s = shard(hash(key));
+    std::shared_lock<std::shared_mutex> lock(s.mutex_);
+    return s.map_.find(key) != s.map_.end();
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::clear() {
+    for (size_t i = 0; i < shardCount_; ++i) {
+        Shard& s = shards_[i];
+        list_type removed;
+        {
+            std::unique_lock<std::shared_mutex> lock(s.mutex_);
+            for (auto& l : s.lists_) {
+                removed.splice(removed.end(), l);
+            }
+            s.map_.clear();
+            std::fill(std::begin(s.weights_), std::end(s.weights_), 0);
+            s.hand_ = s.lists_[Window].end();
+        }
+        purge(removed);
+    }
+}
+
+template <typename K, typename V, typename H>
+size_t ConcurrentCache<K, V, H>::size() const {
+    size_t n = 0;
+    for (size_t i = 0; i < shardCount_; ++i) {
+        std::shared_lock<std::shared_mutex> lock(shards_[i].mutex_);
+        n += shards_[i].map_.size();
+    }
+    return n;
+}
+
+template <typename K, typename V, typename H>
+size_t ConcurrentCache<K, V, H>::weight() const {
+    size_t n = 0;
+    for (size_t i = 0; i < shardCount_; ++i) {
+        std::shared_lock<std::shared_mutex> lock(shards_[i].mutex_);
+        n += shards_[i].weight();
+    }
+    return n;
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::capacity(size_t size) {
+    capacity_ = size;
+
+    // Rounded up, the total may slightly exceed the capacity
+    size_t perShard = (size + shardCount_ - 1) / shardCount_;
+
+    for (size_t i = 0; i < shardCount_; ++i) {
+        Shard& s = shards_[i];
+        list_type evicted;
+        {
+            std::unique_lock<std::shared_mutex> lock(s.mutex_);
+            s.capacity_ = perShard;
+            if (eviction_ == CacheEviction::TinyLFU) {
+                // Entries of unknown weight: the sketch grows with them
+                s.sketch_.resize(weigh_ ? std::max<size_t>(64, s.map_.size()) : perShard);
+            }
+            trim(s, evicted);
+        }
+        purge(evicted);
+    }
+}
+
+template <typename K, typename V, typename H>
+typename ConcurrentCache<K, V, H>::Statistics ConcurrentCache<K, V, H>::statistics() const {
+    Statistics st;
+    for (size_t i = 0; i < shardCount_; ++i) {
+        const Shard& s = shards_[i];
+        st.hits += s.hits_.load(std::memory_order_relaxed);
+        st.misses += s.misses_.load(std::memory_order_relaxed);
+        st.insertions += s.insertions_.load(std::memory_order_relaxed);
+        st.evictions += s.evictions_.load(std::memory_order_relaxed);
+    }
+    return st;
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::resetStatistics() {
+    for (size_t i = 0; i < shardCount_; ++i) {
+        Shard& s = shards_[i];
+        s.hits_.store(0, std::memory_order_relaxed);
+        s.misses_.store(0, std::memory_order_relaxed);
+        s.insertions_.store(0, std::memory_order_relaxed);
+        s.evictions_.store(0, std::memory_order_relaxed);
+    }
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::print(std::ostream& os) const {
+    os << "ConcurrentCache(capacity=" << capacity_ << ",size=" << size() << ",weight=" << weight()
+       << ",shards=" << shardCount_ << ",eviction=" << concurrent_cache::name(eviction_) << "," << statistics()
+       << ")";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <typename K, typename V, typename H>
+typename ConcurrentCache<K, V, H>::node_iterator ConcurrentCache<K, V, H>::link(Shard& s, const key_type& key,
+                                                                               const value_type& value, size_t hash,
+                                                                               size_t weight) {
+    s.weights_[Window] += weight;
+
+    switch (eviction_) {
+        case CacheEviction::CLOCK:
+            // Behind the hand, the last to be visited
+            return s.lists_[Window].emplace(s.hand_, key, value, hash, weight);
+
+        case CacheEviction::TinyLFU:
+            s.sketch_.increment(hash);
+            if (s.map_.size() >= s.sketch_.width()) {
+                s.sketch_.resize(2 * s.sketch_.width());
+            }
+            break;
+
+        case CacheEviction::LRU:
+            break;
+    }
+
+    s.lists_[Window].emplace_front(key, value, hash, weight);
+    return s.lists_[Window].begin();
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::unlink(Shard& s, node_iterator n, list_type& into) {
+    if (n == s.hand_) {
+        ++s.hand_;
+    }
+    s.map_.erase(n->key_);
+    s.weights_[n->segment_] -= n->weight_;
+    into.splice(into.end(), s.lists_[n->segment_], n);
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::move(Shard& s, node_iterator n, Segment segment) {
+    s.weights_[n->segment_] -= n->weight_;
+    s.weights_[segment] += n->weight_;
+    s.lists_[segment].splice(s.lists_[segment].begin(), s.lists_[n->segment_], n);
+    n->segment_ = segment;
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::touch(Shard& s, node_iterator n) {
+    switch (eviction_) {
+        case CacheEviction::LRU:
+            move(s, n, Window);
+            break;
+
+        case CacheEviction::CLOCK:
+            n->referenced_.store(true, std::memory_order_relaxed);
+            break;
+
+        case CacheEviction::TinyLFU: {
+            s.sketch_.increment(n->hash_);
+            if (n->segment_ != Probation) {
+                move(s, n, n->segment_);
+                break;
+            }
+
+            // Used again while on probation, the entry is protected, possibly at the expense of others
+            move(s, n, Protected);
+            size_t main          = s.capacity_ - std::min(s.capacity_, std::max<size_t>(s.capacity_ / 100, 1));
+            size_t protectedSize = main * 8 / 10;
+            while (s.weights_[Protected] > protectedSize && s.lists_[Protected].size() > 1) {
+                move(s, std::prev(s.lists_[Protected].end()), Probation);
+            }
+            break;
+        }
+    }
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::trim(Shard& s, list_type& evicted) {
+    size_t before = evicted.size();
+
+    switch (eviction_) {
+        case CacheEviction::LRU:
+            evictLRU(s, evicted);
+            break;
+        case CacheEviction::CLOCK:
+            evictCLOCK(s, evicted);
+            break;
+        case CacheEviction::TinyLFU:
+            evictTinyLFU(s, evicted);
+            break;
+    }
+
+    s.evictions_.fetch_add(evicted.size() - before, std::memory_order_relaxed);
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::evictLRU(Shard& s, list_type& evicted) {
+    list_type& l = s.lists_[Window];
+    while (s.weight() > s.capacity_ && !l.empty()) {
+        unlink(s, std::prev(l.end()), evicted);
+    }
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::evictCLOCK(Shard& s, list_type& evicted) {
+    list_type& l = s.lists_[Window];
+    while (s.weight() > s.capacity_ && !l.empty()) {
+        if (s.hand_ == l.end()) {
+            s.hand_ = l.begin();
+        }
+        // Entries used since the hand last passed get a second chance
+        if (s.hand_->referenced_.exchange(false, std::memory_order_relaxed)) {
+            ++s.hand_;
+            continue;
+        }
+        unlink(s, s.hand_, evicted);
+    }
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::evictTinyLFU(Shard& s, list_type& evicted) {
+    size_t window = std::min(s.capacity_, std::max<size_t>(s.capacity_ / 100, 1));
+    size_t main   = s.capacity_ - window;
+
+    // Entries leaving the window are admitted to the main space if they are used more often than those they replace
+    while (s.weights_[Window] > window) {
+        node_iterator candidate = std::prev(s.lists_[Window].end());
+        bool admitted           = true;
+
+        while (s.weights_[Probation] + s.weights_[Protected] + candidate->weight_ > main) {
+            list_type& l = s.lists_[Probation].empty() ? s.lists_[Protected] : s.lists_[Probation];
+            if (l.empty()) {
+                break;
+            }
+            node_iterator victim = std::prev(l.end());
+            if (s.sketch_.frequency(candidate->hash_) <= s.sketch_.frequency(victim->hash_)) {
+                admitted = false;
+                break;
+            }
+            unlink(s, victim, evicted);
+        }
+
+        if (admitted && s.weights_[Probation] + s.weights_[Protected] + candidate->weight_ <= main) {
+            move(s, candidate, Probation);
+        }
+        else {
+            unlink(s, candidate, evicted);
+        }
+    }
+
+    // After the capacity is reduced
+    for (Segment segment : {Probation, Protected, Window}) {
+        list_type& l = s.lists_[segment];
+        while (s.weight() > s.capacity_ && !l.empty()) {
+            unlink(s, std::prev(l.end()), evicted);
+        }
+    }
+}
+
+template <typename K, typename V, typename H>
+void ConcurrentCache<K, V, H>::purge(list_type& evicted) const {
+    if (purge_) {
+        for (auto& n : evicted) {
+            purge_(n.key_, n.value_);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,232 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   ConcurrentCache.h
+
+#ifndef eckit_container_ConcurrentCache_h
+#define eckit_container_ConcurrentCache_h
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <list>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/CodeLocation.h"
+#include "eckit/memory/NonCopyable.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+enum class CacheEviction
+{
+    LRU,      ///< Least recently used first
+    CLOCK,    ///< Second chance: lookups only mark entries, under a shared lock
+    TinyLFU,  ///< W-TinyLFU: a small LRU window, from which entries are admitted to a segmented LRU by frequency
+};
+
+/// A cache shared by many threads. Keys are spread over shards, each with its own lock, capacity and eviction, so that
+/// threads looking up different keys seldom contend. The interface follows CacheLRU; the capacity is a number of
+/// entries, or a total weight (e.g. in bytes) when entries are weighed. Purge handlers are called outside the locks,
+/// and may use the cache.
+
+template <typename K, typename V, typename Hash = std::hash<K>>
+class ConcurrentCache : private NonCopyable {
+
+public:  // types
+    typedef K key_type;
+    typedef V value_type;
+
+    typedef void (*purge_handler_type)(key_type&, value_type&);
+
+    /// Weight of an entry towards the capacity, e.g. its size in bytes
+    typedef size_t (*weigh_handler_type)(const key_type&, const value_type&);
+
+    struct Statistics {
+        size_t hits       = 0;
+        size_t misses     = 0;
+        size_t insertions = 0;
+        size_t evictions  = 0;
+
+        double hitRatio() const { return hits + misses ? double(hits) / double(hits + misses) : 0.; }
+
+        friend std::ostream& operator<<(std::ostream& s, const Statistics& st) {
+            s << "hits=" << st.hits << ",misses=" << st.misses << ",insertions=" << st.insertions
+              << ",evictions=" << st.evictions << ",ratio=" << st.hitRatio();
+            return s;
+        }
+    };
+
+public:  // methods
+    /// @param capacity number of entries, or total weight if entries are weighed
+    /// @param shards number of independently locked shards, rounded to a power of two, 0 to choose from the capacity
+    explicit ConcurrentCache(size_t capacity, CacheEviction eviction = CacheEviction::LRU,
+                             purge_handler_type purge = nullptr, weigh_handler_type weigh = nullptr, size_t shards = 0);
+
+    ~ConcurrentCache();
+
+    /// Inserts an entry into the cache, overwrites if already exists
+    /// @returns true if a key already existed
+    bool insert(const key_type& key, const value_type& value);
+
+    /// Looks up a key, counted as a hit or a miss
+    /// @returns true and the value if the key is in the cache
+    bool find(const key_type& key, value_type& value);
+
+    /// Accesses a key that must already exist
+    /// @throws OutOfRange exception is key not in cache
+    value_type access(const key_type& key);
+
+    /// Extracts the key from the cache without purging
+    /// @throws OutOfRange exception if key not in cache
+    value_type extract(const key_type& key);
+
+    /// Remove a key-value pair from the cache
+    /// No effect if key is not present
+    ///
+    /// @return true if removed
+    bool remove(const key_type& key);
+
+    /// @returns true if the key exists in the cache, not counted as an access
+    bool exists(const key_type& key) const;
+
+    /// Clears all entries in the cache
+    void clear();
+
+    /// @returns the maximum size of the cache
+    size_t capacity() const { return capacity_; }
+
+    /// @returns the current number of entries
+    size_t size() const;
+
+    /// @returns the current total weight of the entries (their number if they are not weighed)
+    size_t weight() const;
+
+    /// resizes the cache capacity
+    void capacity(size_t size);
+
+    size_t shards() const { return shardCount_; }
+
+    CacheEviction eviction() const { return eviction_; }
+
+    Statistics statistics() const;
+
+    void resetStatistics();
+
+    void print(std::ostream& os) const;
+
+    friend std::ostream& operator<<(std::ostream& s, const ConcurrentCache& p) {
+        p.print(s);
+        return s;
+    }
+
+private:  // types
+    /// LRU and CLOCK only use the first list
+    enum Segment : unsigned char
+    {
+        Window    = 0,
+        Probation = 1,
+        Protected = 2,
+    };
+
+    struct Node {
+        key_type key_;
+        value_type value_;
+        size_t hash_;
+        size_t weight_;
+        Segment segment_ = Window;
+        std::atomic<bool> referenced_{false};
+
+        Node(const key_type& key, const value_type& value, size_t hash, size_t weight) :
+            key_(key), value_(value), hash_(hash), weight_(weight) {}
+    };
+
+    typedef std::list<Node> list_type;
+    typedef typename list_type::iterator node_iterator;
+
+    /// Count-min sketch of the frequency of keys, with 4-bit counters halved periodically to age them
+    class FrequencySketch {
+    public:
+        void resize(size_t entries);
+        size_t width() const { return mask_ + 1; }
+        void increment(size_t hash);
+        unsigned frequency(size_t hash) const;
+
+    private:
+        size_t index(size_t hash, size_t row) const;
+
+        std::vector<uint8_t> table_;
+        size_t mask_      = 0;
+        size_t additions_ = 0;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex_;
+        std::unordered_map<key_type, node_iterator, Hash> map_;
+        list_type lists_[3];
+        size_t weights_[3] = {0, 0, 0};
+        node_iterator hand_;  ///< Of the CLOCK
+        size_t capacity_ = 0;
+        FrequencySketch sketch_;
+
+        mutable std::atomic<size_t> hits_{0};
+        mutable std::atomic<size_t> misses_{0};
+        std::atomic<size_t> insertions_{0};
+        std::atomic<size_t> evictions_{0};
+
+        Shard() :
+            hand_(lists_[Window].end()) {}
+
+        size_t weight() const { return weights_[Window] + weights_[Probation] + weights_[Protected]; }
+    };
+
+private:  // methods
+    size_t hash(const key_type& key) const { return hash_(key); }
+    Shard& shard(size_t hash) const;
+
+    node_iterator link(Shard&, const key_type&, const value_type&, size_t hash, size_t weight);
+    void unlink(Shard&, node_iterator, list_type& into);
+    void move(Shard&, node_iterator, Segment);
+
+    void touch(Shard&, node_iterator);
+    void trim(Shard&, list_type& evicted);
+    void evictLRU(Shard&, list_type& evicted);
+    void evictCLOCK(Shard&, list_type& evicted);
+    void evictTinyLFU(Shard&, list_type& evicted);
+
+    void purge(list_type& evicted) const;
+
+private:  // members
+    std::unique_ptr<Shard[]> shards_;
+    size_t shardCount_;
+    unsigned shardBits_;
+
+    size_t capacity_;
+    CacheEviction eviction_;
+
+    purge_handler_type purge_;
+    weigh_handler_type weigh_;
+
+    Hash hash_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#include "ConcurrentCache.cc"
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   FlatMap.h
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/serialisation/Stream.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Map stored in a sorted vector, for compact storage and fast ordered iteration. Unlike DenseMap, there is no sort()
+/// to call: insertions go to a small sorted buffer, merged into the vector when it holds more than about sqrt(n)
+/// entries, so that inserting costs O(sqrt(n)) amortised, and lookups O(log(n)).
+///
+/// Iterators are into the vector: find() and iterating merge the buffer first, even on a const map, which is therefore
+/// not safe to share between threads. Lookups interleaved with insertions should use contains(), at() or operator[],
+/// which do not. Inserting invalidates iterators and references.
+
+template <typename K, typename V, typename Compare = std::less<K>>
+class FlatMap {
+public:  // types
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<K, V> value_type;
+
+private:  // types
+    typedef std::vector<value_type> store_t;
+
+public:  // types
+    typedef typename store_t::iterator iterator;
+    typedef typename store_t::const_iterator const_iterator;
+
+public:  // methods
+    FlatMap() = default;
+
+    FlatMap(std::initializer_list<value_type> values) {
+        for (const value_type& v : values) {
+            insert(v.first, v.second);
+        }
+    }
+
+    /// Inserts if the key is not in the map
+    /// @returns true if inserted
+    bool insert(const K& k, const V& v) {
+        if (contains(k)) {
+            return false;
+        }
+        add(k, v);
+        return true;
+    }
+
+    /// Inserts or replaces
+    /// @returns true if inserted
+    bool replace(const K& k, const V& v) {
+        if (V* p = lookup(k)) {
+            *p = v;
+            return false;
+        }
+        add(k, v);
+        return true;
+    }
+
+    V& operator[](const K& k) {
+        if (V* p = lookup(k)) {
+            return *p;
+        }
+        return add(k, V());
+    }
+
+    /// @throws OutOfRange if the key is not in the map
+    V& at(const K& k) {
+        if (V* p = lookup(k)) {
+            return *p;
+        }
+        throw OutOfRange("key not in FlatMap", Here());
+    }
+
+    const V& at(const K& k) const { return const_cast<FlatMap*>(this)->at(k); }
+
+    bool contains(const K& k) const { return const_cast<FlatMap*>(this)->lookup(k) != nullptr; }
+    size_t count(const K& k) const { return contains(k) ? 1 : 0; }
+
+    iterator find(const K& k) {
+        merge();
+        iterator i = std::lower_bound(items_.begin(), items_.end(), k, KeyLess(compare_));
+        return i != items_.end() && !compare_(k, i->first) ? i : items_.end();
+    }
+
+    const_iterator find(const K& k) const { return const_cast<FlatMap*>(this)->find(k); }
+
+    /// @returns the number of values erased, 0 or 1
+    size_t erase(const K& k) {
+        for (store_t* s : {&pending_, &items_}) {
+            auto i = std::lower_bound(s->begin(), s->end(), k, KeyLess(compare_));
+            if (i != s->end() && !compare_(k, i->first)) {
+                s->erase(i);
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    void clear() {
+        items_.clear();
+        pending_.clear();
+    }
+
+    void reserve(size_t n) { items_.reserve(n); }
+
+    size_t size() const { return items_.size() + pending_.size(); }
+    bool empty() const { return items_.empty() && pending_.empty(); }
+
+    iterator begin() {
+        merge();
+        return items_.begin();
+    }
+
+    iterator end() {
+        merge();
+        return items_.end();
+    }
+
+    const_iterator begin() const { return const_cast<FlatMap*>(this)->begin(); }
+    const_iterator end() const { return const_cast<FlatMap*>(this)->end(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    void encode(Stream& s) const {
+        s << size();
+        for (const value_type& v : *this) {
+            s << v.first;
+            s << v.second;
+        }
+    }
+
+    void decode(Stream& s) {
+        size_t n;
+        s >> n;
+        clear();
+        items_.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            K k;
+            V v;
+            s >> k;
+            s >> v;
+            items_.emplace_back(k, v);
+        }
+        // Written in order, unless by a map with another comparison
+        if (!std::is_sorted(items_.begin(), items_.end(), ValueLess(compare_))) {
+            std::stable_sort(items_.begin(), items_.end(), ValueLess(compare_));
+        }
+    }
+
+    void print(std::ostream& s) const {
+        s << "FlatMap(size=" << size() << ")";
+    }
+
+    friend Stream& operator<<(Stream& s, const FlatMap& m) {
+        m.encode(s);
+        return s;
+    }
+
+    friend Stream& operator>>(Stream& s, FlatMap& m) {
+        m.decode(s);
+        return s;
+    }
+
+    friend std::ostream& operator<<(std::ostream& s, const FlatMap& m) {
+        m.print(s);
+        return s;
+    }
+
+private:  // types
+    struct KeyLess {
+        const Compare& compare_;
+        explicit KeyLess(const Compare& c) :
+            compare_(c) {}
+        bool operator()(const value_type& a, const K& b) const { return compare_(a.first, b); }
+    };
+
+    struct ValueLess {
+        const Compare& compare_;
+        explicit ValueLess(const Compare& c) :
+            compare_(c) {}
+        bool operator()(const value_type& a, const value_type& b) const { return compare_(a.first, b.first); }
+    };
+
+private:  // methods
+    V* lookup(const K& k) {
+        for (store_t* s : {&pending_, &items_}) {
+            auto i = std::lower_bound(s->begin(), s->end(), k, KeyLess(compare_));
+            if (i != s->end() && !compare_(k, i->first)) {
+                return &i->second;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Of a key not in the map
+    V& add(const K& k, const V& v) {
+        if (pending_.size() >= std::max<size_t>(32, size_t(std::sqrt(double(items_.size()))))) {
+            merge();
+        }
+        auto i = std::lower_bound(pending_.begin(), pending_.end(), k, KeyLess(compare_));
+        return pending_.insert(i, value_type(k, v))->second;
+    }
+
+    void merge() const {
+        if (pending_.empty()) {
+            return;
+        }
+        // The keys are distinct, the merge is in place at the end of the vector
+        size_t n = items_.size();
+        items_.insert(items_.end(), std::make_move_iterator(pending_.begin()), std::make_move_iterator(pending_.end()));
+        std::inplace_merge(items_.begin(), items_.begin() + n, items_.end(), ValueLess(compare_));
+        pending_.clear();
+    }
+
+private:  // members
+    mutable store_t items_;    ///< Sorted
+    mutable store_t pending_;  ///< Sorted, not yet merged into items_
+    Compare compare_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
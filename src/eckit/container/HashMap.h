@@ -0,0 +1,153 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   HashMap.h
+
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+
+#include "eckit/container/HashTable.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/serialisation/Stream.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace detail {
+
+template <typename K, typename V>
+struct HashMapPolicy {
+    typedef K key_type;
+    typedef std::pair<const K, V> value_type;
+
+    static const K& key(const value_type& v) { return v.first; }
+
+    /// Moves the key too: the value is destroyed right after, so its constness is never observed
+    static void transfer(value_type* to, value_type* from) {
+        new (to) value_type(std::move(const_cast<K&>(from->first)), std::move(from->second));
+        from->~value_type();
+    }
+};
+
+}  // namespace detail
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Hash map with open addressing (see detail::HashTable), with the interface of std::unordered_map, for lookups
+/// faster than std::map and std::unordered_map. Inserting invalidates the iterators and references, as it may move
+/// the values.
+
+template <typename K, typename V, typename Hash = std::hash<K>, typename Equal = std::equal_to<K>>
+class HashMap : public detail::HashTable<detail::HashMapPolicy<K, V>, Hash, Equal> {
+    typedef detail::HashTable<detail::HashMapPolicy<K, V>, Hash, Equal> Table;
+
+public:  // types
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef typename Table::value_type value_type;
+    typedef typename Table::iterator iterator;
+    typedef typename Table::const_iterator const_iterator;
+
+public:  // methods
+    using Table::Table;
+
+    HashMap() = default;
+
+    HashMap(std::initializer_list<value_type> values) {
+        this->reserve(values.size());
+        for (const value_type& v : values) {
+            insert(v);
+        }
+    }
+
+    /// Inserts if the key is not in the map
+    /// @returns the value of the key, and whether it was inserted
+    std::pair<iterator, bool> insert(const value_type& value) { return emplace(value.first, value.second); }
+
+    /// Constructs the value from the arguments if the key is not in the map
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(const key_type& key, Args&&... args) {
+        auto s = this->findOrPrepare(key);
+        if (s.free) {
+            this->emplaceAt(s, std::piecewise_construct, std::forward_as_tuple(key),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        return {this->iteratorAt(s.slot), s.free};
+    }
+
+    /// Inserts or replaces
+    /// @returns true if the key was inserted
+    bool replace(const key_type& key, const mapped_type& value) {
+        auto r = emplace(key, value);
+        if (!r.second) {
+            r.first->second = value;
+        }
+        return r.second;
+    }
+
+    mapped_type& operator[](const key_type& key) { return emplace(key).first->second; }
+
+    /// @throws OutOfRange if the key is not in the map
+    mapped_type& at(const key_type& key) {
+        iterator i = this->find(key);
+        if (i == this->end()) {
+            throw OutOfRange("key not in HashMap", Here());
+        }
+        return i->second;
+    }
+
+    const mapped_type& at(const key_type& key) const { return const_cast<HashMap*>(this)->at(key); }
+
+    void encode(Stream& s) const {
+        s << this->size();
+        for (const value_type& v : *this) {
+            s << v.first;
+            s << v.second;
+        }
+    }
+
+    void decode(Stream& s) {
+        size_t n;
+        s >> n;
+        this->clear();
+        this->reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            key_type k;
+            mapped_type v;
+            s >> k;
+            s >> v;
+            replace(k, v);
+        }
+    }
+
+    friend Stream& operator<<(Stream& s, const HashMap& m) {
+        m.encode(s);
+        return s;
+    }
+
+    friend Stream& operator>>(Stream& s, HashMap& m) {
+        m.decode(s);
+        return s;
+    }
+
+    friend std::ostream& operator<<(std::ostream& s, const HashMap& m) {
+        m.print(s);
+        return s;
+    }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,123 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   HashSet.h
+
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+#include "eckit/container/HashTable.h"
+#include "eckit/serialisation/Stream.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace detail {
+
+template <typename K>
+struct HashSetPolicy {
+    typedef K key_type;
+    typedef K value_type;
+
+    static const K& key(const K& v) { return v; }
+
+    static void transfer(K* to, K* from) {
+        new (to) K(std::move(*from));
+        from->~K();
+    }
+};
+
+}  // namespace detail
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Hash set with open addressing (see detail::HashTable), with the interface of std::unordered_set.
+/// Inserting invalidates the iterators and references, as it may move the values.
+
+template <typename K, typename Hash = std::hash<K>, typename Equal = std::equal_to<K>>
+class HashSet : public detail::HashTable<detail::HashSetPolicy<K>, Hash, Equal> {
+    typedef detail::HashTable<detail::HashSetPolicy<K>, Hash, Equal> Table;
+
+public:  // types
+    typedef K key_type;
+    typedef K value_type;
+
+    /// Values cannot be changed, their slot depends on them
+    typedef typename Table::const_iterator iterator;
+    typedef typename Table::const_iterator const_iterator;
+
+public:  // methods
+    using Table::Table;
+
+    HashSet() = default;
+
+    HashSet(std::initializer_list<K> values) {
+        this->reserve(values.size());
+        for (const K& v : values) {
+            insert(v);
+        }
+    }
+
+    const_iterator begin() const { return Table::begin(); }
+    const_iterator end() const { return Table::end(); }
+
+    const_iterator find(const K& value) const { return Table::find(value); }
+
+    /// @returns the value, and whether it was inserted
+    std::pair<iterator, bool> insert(const K& value) {
+        auto s = this->findOrPrepare(value);
+        if (s.free) {
+            this->emplaceAt(s, value);
+        }
+        return {this->iteratorAt(s.slot), s.free};
+    }
+
+    void encode(Stream& s) const {
+        s << this->size();
+        for (const K& v : *this) {
+            s << v;
+        }
+    }
+
+    void decode(Stream& s) {
+        size_t n;
+        s >> n;
+        this->clear();
+        this->reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            K v;
+            s >> v;
+            insert(v);
+        }
+    }
+
+    friend Stream& operator<<(Stream& s, const HashSet& m) {
+        m.encode(s);
+        return s;
+    }
+
+    friend Stream& operator>>(Stream& s, HashSet& m) {
+        m.decode(s);
+        return s;
+    }
+
+    friend std::ostream& operator<<(std::ostream& s, const HashSet& m) {
+        m.print(s);
+        return s;
+    }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,452 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   HashTable.h
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace eckit::detail {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Open-addressing hash table, in the style of the Swiss tables: slots are in groups of 16, with a control byte per
+/// slot holding 7 bits of the hash of its key, so that a lookup compares the 16 control bytes of a group at once (with
+/// SSE2 where available) and only compares the keys whose bytes match. Slots are stored inline, without a node per
+/// entry. Inserting or erasing invalidates the iterators, and inserting the references.
+///
+/// The Policy gives the key of a value, and moves a value to another slot.
+/// This is the common implementation of HashMap and HashSet.
+
+template <typename Policy, typename Hash, typename Equal>
+class HashTable {
+public:  // types
+    typedef typename Policy::key_type key_type;
+    typedef typename Policy::value_type value_type;
+
+    static constexpr size_t GROUP = 16;
+
+private:  // types
+    typedef int8_t ctrl_t;
+
+    static constexpr ctrl_t EMPTY    = -128;
+    static constexpr ctrl_t DELETED  = -2;
+    static constexpr ctrl_t SENTINEL = -1;  ///< After the last slot, stops iterations
+
+    /// Control bytes of a group, and bitmasks of those matching
+    class Group {
+    public:
+        explicit Group(const ctrl_t* ctrl) {
+#if defined(__SSE2__)
+            ctrl_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+            std::memcpy(ctrl_, ctrl, GROUP);
+#endif
+        }
+
+        uint32_t match(ctrl_t h2) const {
+#if defined(__SSE2__)
+            return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+#else
+            uint32_t m = 0;
+            for (size_t i = 0; i < GROUP; ++i) {
+                m |= uint32_t(ctrl_[i] == h2) << i;
+            }
+            return m;
+#endif
+        }
+
+        uint32_t matchEmpty() const { return match(EMPTY); }
+
+        /// Empty or deleted: the sign bit is set, and not all bits as in the sentinel
+        uint32_t matchFree() const {
+#if defined(__SSE2__)
+            return uint32_t(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(SENTINEL), ctrl_)));
+#else
+            uint32_t m = 0;
+            for (size_t i = 0; i < GROUP; ++i) {
+                m |= uint32_t(ctrl_[i] < SENTINEL) << i;
+            }
+            return m;
+#endif
+        }
+
+    private:
+#if defined(__SSE2__)
+        __m128i ctrl_;
+#else
+        ctrl_t ctrl_[GROUP];
+#endif
+    };
+
+    template <bool Const>
+    class Iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename HashTable::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::conditional_t<Const, const value_type*, value_type*> pointer;
+        typedef std::conditional_t<Const, const value_type&, value_type&> reference;
+
+        Iterator() = default;
+
+        /// Non-const to const
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other) :
+            ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+        reference operator*() const { return *slot_; }
+        pointer operator->() const { return slot_; }
+
+        Iterator& operator++() {
+            ++ctrl_;
+            ++slot_;
+            skip();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator i = *this;
+            ++*this;
+            return i;
+        }
+
+        bool operator==(const Iterator& other) const { return ctrl_ == other.ctrl_; }
+        bool operator!=(const Iterator& other) const { return ctrl_ != other.ctrl_; }
+
+    private:
+        Iterator(const ctrl_t* ctrl, pointer slot) :
+            ctrl_(ctrl), slot_(slot) {}
+
+        void skip() {
+            while (*ctrl_ < SENTINEL) {
+                ++ctrl_;
+                ++slot_;
+            }
+        }
+
+        const ctrl_t* ctrl_ = nullptr;
+        pointer slot_       = nullptr;
+
+        friend class HashTable;
+        friend class Iterator<!Const>;
+    };
+
+public:  // types
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+public:  // methods
+    explicit HashTable(size_t capacity = 0, const Hash& hash = Hash(), const Equal& equal = Equal()) :
+        hash_(hash), equal_(equal) {
+        reserve(capacity);
+    }
+
+    HashTable(const HashTable& other) :
+        hash_(other.hash_), equal_(other.equal_) {
+        reserve(other.size_);
+        for (const value_type& v : other) {
+            size_t h = hashOf(Policy::key(v));
+            size_t s = findFree(h);
+            new (slots_ + s) value_type(v);
+            setFull(s, h);
+        }
+    }
+
+    HashTable(HashTable&& other) noexcept :
+        hash_(std::move(other.hash_)), equal_(std::move(other.equal_)) {
+        swap(other);
+    }
+
+    HashTable& operator=(const HashTable& other) {
+        if (this != &other) {
+            HashTable copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    HashTable& operator=(HashTable&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~HashTable() {
+        destroy();
+        deallocate();
+    }
+
+    void swap(HashTable& other) noexcept {
+        std::swap(ctrl_, other.ctrl_);
+        std::swap(slots_, other.slots_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+        std::swap(growthLeft_, other.growthLeft_);
+        std::swap(hash_, other.hash_);
+        std::swap(equal_, other.equal_);
+    }
+
+    iterator begin() {
+        iterator i(ctrl_, slots_);
+        i.skip();
+        return i;
+    }
+
+    iterator end() { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+
+    const_iterator begin() const { return const_cast<HashTable*>(this)->begin(); }
+    const_iterator end() const { return const_cast<HashTable*>(this)->end(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /// Number of slots, of which at most 7/8 are used
+    size_t capacity() const { return capacity_; }
+
+    double loadFactor() const { return capacity_ ? double(size_) / double(capacity_) : 0; }
+
+    /// Allocates enough slots for n values
+    void reserve(size_t n) {
+        if (n > maxLoad(capacity_)) {
+            size_t capacity = GROUP;
+            while (n > maxLoad(capacity)) {
+                capacity *= 2;
+            }
+            rehash(capacity);
+        }
+    }
+
+    iterator find(const key_type& key) {
+        size_t s = lookup(key);
+        return s == npos ? end() : iterator(ctrl_ + s, slots_ + s);
+    }
+
+    const_iterator find(const key_type& key) const { return const_cast<HashTable*>(this)->find(key); }
+
+    bool contains(const key_type& key) const { return lookup(key) != npos; }
+    size_t count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+    size_t erase(const key_type& key) {
+        size_t s = lookup(key);
+        if (s == npos) {
+            return 0;
+        }
+        eraseSlot(s);
+        return 1;
+    }
+
+    void erase(const_iterator i) { eraseSlot(size_t(i.slot_ - slots_)); }
+
+    /// Removes all values, keeps the slots
+    void clear() {
+        destroy();
+        if (capacity_) {
+            std::memset(ctrl_, EMPTY, capacity_);
+        }
+        size_       = 0;
+        growthLeft_ = maxLoad(capacity_);
+    }
+
+    void print(std::ostream& s) const {
+        s << "HashTable(size=" << size_ << ",capacity=" << capacity_ << ")";
+    }
+
+protected:  // types
+    struct Slot {
+        size_t slot;
+        size_t hash;
+        bool free;  ///< The key is not in the table, a value is to be constructed with emplaceAt
+    };
+
+protected:  // methods
+    Slot findOrPrepare(const key_type& key) {
+        size_t h = hashOf(key);
+        size_t s = lookup(key, h);
+        if (s != npos) {
+            return {s, h, false};
+        }
+
+        s = findFree(h);
+        if (s == npos || (growthLeft_ == 0 && ctrl_[s] != DELETED)) {
+            // Grow, unless most of the slots are only deleted
+            rehash(capacity_ == 0 ? GROUP : size_ * 2 > maxLoad(capacity_) ? capacity_ * 2 : capacity_);
+            s = findFree(h);
+        }
+        return {s, h, true};
+    }
+
+    /// Constructs the value of a free slot returned by findOrPrepare
+    template <typename... Args>
+    value_type& emplaceAt(const Slot& s, Args&&... args) {
+        new (slots_ + s.slot) value_type(std::forward<Args>(args)...);
+        setFull(s.slot, s.hash);
+        return slots_[s.slot];
+    }
+
+    value_type& slot(size_t s) { return slots_[s]; }
+    iterator iteratorAt(size_t s) { return iterator(ctrl_ + s, slots_ + s); }
+
+private:  // methods
+    static constexpr size_t npos = size_t(-1);
+
+    static size_t maxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+    size_t hashOf(const key_type& key) const {
+        // Spreads the bits of weak hashes, such as those of integers
+        uint64_t h = uint64_t(hash_(key)) * 0x9e3779b97f4a7c15ULL;
+        return size_t(h ^ (h >> 29));
+    }
+
+    static ctrl_t h2(size_t h) { return ctrl_t(h & 0x7f); }
+
+    size_t lookup(const key_type& key) const { return capacity_ ? lookup(key, hashOf(key)) : npos; }
+
+    size_t lookup(const key_type& key, size_t h) const {
+        if (capacity_ == 0) {
+            return npos;
+        }
+        size_t mask = capacity_ / GROUP - 1;
+        size_t g    = (h >> 7) & mask;
+        for (size_t i = 1;; ++i) {
+            Group group(ctrl_ + g * GROUP);
+            for (uint32_t m = group.match(h2(h)); m; m &= m - 1) {
+                size_t s = g * GROUP + __builtin_ctz(m);
+                if (equal_(key, Policy::key(slots_[s]))) {
+                    return s;
+                }
+            }
+            // A probe sequence ends at a group that was never full
+            if (group.matchEmpty()) {
+                return npos;
+            }
+            g = (g + i) & mask;
+        }
+    }
+
+    /// The first empty or deleted slot of the probe sequence of a hash
+    size_t findFree(size_t h) const {
+        if (capacity_ == 0) {
+            return npos;
+        }
+        size_t mask = capacity_ / GROUP - 1;
+        size_t g    = (h >> 7) & mask;
+        for (size_t i = 1;; ++i) {
+            uint32_t m = Group(ctrl_ + g * GROUP).matchFree();
+            if (m) {
+                return g * GROUP + __builtin_ctz(m);
+            }
+            g = (g + i) & mask;
+        }
+    }
+
+    void setFull(size_t s, size_t h) {
+        growthLeft_ -= ctrl_[s] == EMPTY;
+        ctrl_[s] = h2(h);
+        size_++;
+    }
+
+    void eraseSlot(size_t s) {
+        slots_[s].~value_type();
+        size_--;
+
+        // Probes for other keys stop at a group with an empty slot, so this one can be empty too
+        size_t g = s / GROUP * GROUP;
+        if (Group(ctrl_ + g).matchEmpty()) {
+            ctrl_[s] = EMPTY;
+            growthLeft_++;
+        }
+        else {
+            ctrl_[s] = DELETED;
+        }
+    }
+
+    void rehash(size_t capacity) {
+        ctrl_t* oldCtrl     = ctrl_;
+        value_type* oldSlots = slots_;
+        size_t oldCapacity  = capacity_;
+
+        slots_ = std::allocator<value_type>().allocate(capacity);
+        ctrl_  = new ctrl_t[capacity + 1];
+        std::memset(ctrl_, EMPTY, capacity);
+        ctrl_[capacity] = SENTINEL;
+
+        capacity_   = capacity;
+        size_       = 0;
+        growthLeft_ = maxLoad(capacity);
+
+        for (size_t i = 0; i < oldCapacity; ++i) {
+            if (oldCtrl[i] >= 0) {
+                size_t h = hashOf(Policy::key(oldSlots[i]));
+                size_t s = findFree(h);
+                Policy::transfer(slots_ + s, oldSlots + i);
+                setFull(s, h);
+            }
+        }
+
+        if (oldCapacity) {
+            std::allocator<value_type>().deallocate(oldSlots, oldCapacity);
+            delete[] oldCtrl;
+        }
+    }
+
+    void destroy() {
+        if (!std::is_trivially_destructible<value_type>::value) {
+            for (size_t i = 0; i < capacity_; ++i) {
+                if (ctrl_[i] >= 0) {
+                    slots_[i].~value_type();
+                }
+            }
+        }
+    }
+
+    void deallocate() {
+        if (capacity_) {
+            std::allocator<value_type>().deallocate(slots_, capacity_);
+            delete[] ctrl_;
+        }
+        ctrl_     = emptyGroup();
+        slots_    = nullptr;
+        capacity_ = 0;
+    }
+
+    /// Of tables with no slots, so that iterations stop at once
+    static ctrl_t* emptyGroup() {
+        static ctrl_t sentinel = SENTINEL;
+        return &sentinel;
+    }
+
+private:  // members
+    ctrl_t* ctrl_       = emptyGroup();
+    value_type* slots_  = nullptr;
+    size_t capacity_    = 0;
+    size_t size_        = 0;
+    size_t growthLeft_  = 0;
+
+    Hash hash_;
+    Equal equal_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::detail
@@ -78,6 +78,15 @@ const char* Actor::tagName(int tag) {
     case STATISTICS:
         return "STATISTICS";
 
+    case BYE:
+        return "BYE";
+
+    case CREDIT:
+        return "CREDIT";
+
+    case BATCH:
+        return "BATCH";
+
     default:
         return "UNKNOWN";
     }
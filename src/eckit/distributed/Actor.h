@@ -38,7 +38,9 @@ public:
         WRITE,
         CLOSE,
         STATISTICS,
-        BYE
+        BYE,
+        CREDIT,
+        BATCH
     };
 
 public: // methods
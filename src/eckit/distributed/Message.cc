@@ -9,6 +9,7 @@
  */
 
 #include <cstring>
+#include <utility>
 
 #include "eckit/log/Log.h"
 #include "eckit/log/Bytes.h"
@@ -17,6 +18,7 @@
 
 #include "eckit/distributed/Message.h"
 #include "eckit/distributed/Actor.h"
+#include "eckit/distributed/MessagePool.h"
 
 using eckit::Log;
 using eckit::Bytes;
@@ -60,12 +62,22 @@ void Message::print(std::ostream& out) const
 Message::Message(int tag, size_t size) :
     tag_(tag),
     source_(-1),
-    buffer_(eckit::round(size, 1024 * 1024)),
+    buffer_(MessagePool::instance().acquire(size)),
     position_(0),
     blob_(false) {
 }
 
 Message::~Message() {
+    MessagePool::instance().release(std::move(buffer_));
+}
+
+void Message::grow(size_t size, bool preserveData) {
+    eckit::Buffer buffer(MessagePool::instance().acquire(size));
+    if (preserveData) {
+        ::memcpy(buffer, buffer_, position_);
+    }
+    std::swap(buffer, buffer_);
+    MessagePool::instance().release(std::move(buffer));
 }
 
 void Message::rewind() {
@@ -121,7 +133,7 @@ long Message::read(void *buffer, long length) {
 
 void Message::reserve(size_t size) {
     if (buffer_.size() < size) {
-        buffer_.resize(eckit::round(size, 1024 * 1024));
+        grow(size, false);
     }
 }
 
@@ -129,9 +141,8 @@ void Message::reserve(size_t size) {
 long Message::write(const void *buffer, long length) {
 
     if (position_ + length > buffer_.size()) {
-        size_t newsize = eckit::round(position_ + length, 1024 * 1024);
-        buffer_.resize(newsize, true);
-        Log::debug() << "Message::write() resizing buffer to " << Bytes(newsize) << std::endl;
+        grow(position_ + length, true);
+        Log::debug() << "Message::write() resizing buffer to " << Bytes(buffer_.size()) << std::endl;
     }
 
     // ASSERT(!command_.empty());
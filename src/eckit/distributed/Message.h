@@ -71,6 +71,8 @@ private:  // members
 
 private:  // methods
 
+    void grow(size_t, bool preserveData);
+
     // From Stream
     virtual std::string name() const;
     virtual long write(const void *, long);
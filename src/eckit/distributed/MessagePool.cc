@@ -0,0 +1,89 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <algorithm>
+#include <ostream>
+
+#include "eckit/config/Resource.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/maths/Functions.h"
+#include "eckit/thread/AutoLock.h"
+
+#include "eckit/distributed/MessagePool.h"
+
+namespace eckit::distributed {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static const size_t allocationUnit = 1024 * 1024;
+
+MessagePool& MessagePool::instance() {
+    static MessagePool pool;
+    return pool;
+}
+
+MessagePool::MessagePool() :
+    capacity_(eckit::Resource<size_t>("distributedMessagePoolSize;$ECKIT_DISTRIBUTED_MESSAGE_POOL_SIZE",
+                                      64 * 1024 * 1024)),
+    cached_(0),
+    hits_(0),
+    misses_(0) {
+}
+
+eckit::Buffer MessagePool::acquire(size_t size) {
+
+    size = eckit::round(std::max(size, size_t(1)), allocationUnit);
+
+    {
+        eckit::AutoLock<eckit::Mutex> lock(mutex_);
+
+        // Take the smallest free buffer large enough, but do not waste buffers much larger than needed
+        auto j = free_.lower_bound(size);
+        if (j != free_.end() && j->first <= 2 * size) {
+            eckit::Buffer buffer(std::move(j->second));
+            cached_ -= j->first;
+            free_.erase(j);
+            hits_++;
+            return buffer;
+        }
+
+        misses_++;
+    }
+
+    return eckit::Buffer(size);
+}
+
+void MessagePool::release(eckit::Buffer&& buffer) {
+
+    size_t size = buffer.size();
+    if (size == 0) {
+        return;
+    }
+
+    eckit::AutoLock<eckit::Mutex> lock(mutex_);
+
+    if (cached_ + size <= capacity_) {
+        free_.emplace(size, std::move(buffer));
+        cached_ += size;
+    }
+}
+
+void MessagePool::print(std::ostream &out) const {
+    eckit::AutoLock<eckit::Mutex> lock(mutex_);
+    out << "MessagePool[cached=" << eckit::Bytes(cached_)
+        << ",capacity=" << eckit::Bytes(capacity_)
+        << ",hits=" << hits_
+        << ",misses=" << misses_
+        << "]";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // namespace eckit::distributed
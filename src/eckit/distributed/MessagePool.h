@@ -0,0 +1,73 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   MessagePool.h
+/// @date   October 2026
+
+#ifndef eckit_MessagePool_H
+#define eckit_MessagePool_H
+
+#include <iosfwd>
+#include <map>
+
+#include "eckit/io/Buffer.h"
+#include "eckit/memory/NonCopyable.h"
+#include "eckit/thread/Mutex.h"
+
+namespace eckit::distributed {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Recycles the buffers of Messages, which are short-lived and large (1 MiB at least), so that a
+/// producer/worker/writer pipeline does not allocate a buffer per message.
+/// The pool keeps at most capacity() bytes of free buffers (resource distributedMessagePoolSize).
+
+class MessagePool : private eckit::NonCopyable {
+public: // methods
+
+    static MessagePool& instance();
+
+    /// @returns a buffer of at least size bytes, rounded up to the allocation unit
+    eckit::Buffer acquire(size_t size);
+
+    /// Returns a buffer to the pool, or frees it if the pool is full
+    void release(eckit::Buffer&& buffer);
+
+    size_t capacity() const { return capacity_; }
+
+    void print(std::ostream &out) const;
+
+    friend std::ostream &operator<<(std::ostream &s, const MessagePool &x) {
+        x.print(s);
+        return s;
+    }
+
+private: // methods
+
+    MessagePool();
+
+private: // members
+
+    mutable eckit::Mutex mutex_;
+
+    std::multimap<size_t, eckit::Buffer> free_;
+
+    size_t capacity_;
+    size_t cached_;
+
+    size_t hits_;
+    size_t misses_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // namespace eckit::distributed
+
+#endif
@@ -12,10 +12,14 @@
 
 #include <map>
 
+#include "eckit/config/Resource.h"
 #include "eckit/exception/Exceptions.h"
+#include "eckit/system/DeferredPlugins.h"
 #include "eckit/thread/AutoLock.h"
 #include "eckit/thread/Mutex.h"
 #include "eckit/option/CmdArgs.h"
+#include "eckit/option/FactoryOption.h"
+#include "eckit/option/SimpleOption.h"
 
 
 namespace eckit::distributed {
@@ -44,8 +48,14 @@ static void init() {
 
 Transport::Transport(const eckit::option::CmdArgs &args):
     title_("eckit-run"),
-    id_("no-id") {
+    id_("no-id"),
+    credits_(eckit::Resource<size_t>("distributedCredits;$ECKIT_DISTRIBUTED_CREDITS", 8)),
+    batchSize_(eckit::Resource<size_t>("distributedBatchSize;$ECKIT_DISTRIBUTED_BATCH_SIZE", 64 * 1024)) {
 
+    args.get("credits", credits_);
+    args.get("batch-size", batchSize_);
+
+    ASSERT(credits_ > 0);
 }
 
 Transport::~Transport() {
@@ -98,6 +108,16 @@ Transport *TransportFactory::build( const eckit::option::CmdArgs &args) {
     //     throw eckit::SeriousBug("TransportFactory cannot get gridType");
     // }
 
+    // The factory may come from a plugin not loaded yet
+    bool found;
+    {
+        eckit::AutoLock<eckit::Mutex> lock(local_mutex);
+        found = m->find(name) != m->end();
+    }
+    if (!found) {
+        eckit::system::loadPluginsForMissingBuilder();
+    }
+
     eckit::AutoLock<eckit::Mutex> lock(local_mutex);
     std::map<std::string, TransportFactory *>::const_iterator j = m->find(name);
 
@@ -125,6 +145,26 @@ void TransportFactory::list(std::ostream& out) {
     }
 }
 
+void TransportFactory::options(std::vector<eckit::option::Option*>& options) {
+    using eckit::option::FactoryOption;
+    using eckit::option::SimpleOption;
+
+    options.push_back(new FactoryOption<TransportFactory>("transport", "Transport between the producer and the workers"));
+    options.push_back(new SimpleOption<std::string>("host", "Host of the producer, for workers and writers"));
+    options.push_back(new SimpleOption<size_t>("port", "Port of the producer (default 7777)"));
+    options.push_back(new SimpleOption<size_t>("writer", "Writer number, for writers (from 1)"));
+
+    // Producer side
+    options.push_back(new SimpleOption<size_t>("workers", "Maximum number of workers (shm, default: the number of cores)"));
+    options.push_back(new SimpleOption<size_t>("writers", "Number of writers (shm, default 0)"));
+    options.push_back(new SimpleOption<size_t>("ring-size", "Size of the rings in bytes (shm)"));
+    options.push_back(new SimpleOption<std::string>("segment", "Name of the shared memory segment (shm)"));
+
+    // Flow control
+    options.push_back(new SimpleOption<size_t>("credits", "Messages a worker accepts ahead of consuming them (default 8)"));
+    options.push_back(new SimpleOption<size_t>("batch-size", "Size of the frames batching small messages in bytes, 0 to disable (default 64 KiB)"));
+}
+
 
 
 
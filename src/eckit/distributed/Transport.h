@@ -17,6 +17,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <vector>
 
 #include "eckit/memory/NonCopyable.h"
 #include "eckit/distributed/TransportStatistics.h"
@@ -69,6 +70,11 @@ protected:
 
     TransportStatistics statistics_;
 
+    // Flow control: number of messages a receiver accepts ahead of consuming them (option --credits),
+    // and size of the frames batching small messages (option --batch-size, 0 to disable batching)
+    size_t credits_;
+    size_t batchSize_;
+
 private: // methods
 
     virtual void print(std::ostream &out) const = 0;
@@ -95,6 +101,9 @@ public:
     static Transport* build(const eckit::option::CmdArgs &args);
     static void list(std::ostream &);
 
+    /// Adds the command line options of the transports (--transport, --host, --port, --credits, --batch-size...)
+    static void options(std::vector<eckit::option::Option*>&);
+
 };
 
 
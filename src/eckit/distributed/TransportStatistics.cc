@@ -8,6 +8,8 @@
  * does it submit to any jurisdiction.
  */
 
+#include <algorithm>
+
 #include "eckit/distributed/TransportStatistics.h"
 #include "eckit/serialisation/Stream.h"
 
@@ -20,7 +22,13 @@ TransportStatistics::TransportStatistics():
     sendCount_(0),
     receiveCount_(0),
     sendSize_(0),
-    receiveSize_(0)
+    receiveSize_(0),
+    frameCount_(0),
+    stallCount_(0),
+    maxQueueDepth_(0),
+    queueDepth_(0),
+    resendCount_(0),
+    lostCount_(0)
 {
 }
 
@@ -34,6 +42,13 @@ TransportStatistics::TransportStatistics(eckit::Stream &s) {
     s >> receiveTiming_;
     s >> barrierTiming_;
     s >> shutdownTiming_;
+    s >> frameCount_;
+    s >> stallCount_;
+    s >> stallTiming_;
+    s >> maxQueueDepth_;
+    s >> queueDepth_;
+    s >> resendCount_;
+    s >> lostCount_;
 }
 
 void TransportStatistics::encode(eckit::Stream &s) const {
@@ -46,6 +61,13 @@ void TransportStatistics::encode(eckit::Stream &s) const {
     s << receiveTiming_;
     s << barrierTiming_;
     s << shutdownTiming_;
+    s << frameCount_;
+    s << stallCount_;
+    s << stallTiming_;
+    s << maxQueueDepth_;
+    s << queueDepth_;
+    s << resendCount_;
+    s << lostCount_;
 }
 
 TransportStatistics &TransportStatistics::operator+=(const TransportStatistics &other) {
@@ -58,6 +80,13 @@ TransportStatistics &TransportStatistics::operator+=(const TransportStatistics &
     receiveTiming_ += other.receiveTiming_;
     barrierTiming_ += other.barrierTiming_;
     shutdownTiming_ += other.shutdownTiming_;
+    frameCount_ += other.frameCount_;
+    stallCount_ += other.stallCount_;
+    stallTiming_ += other.stallTiming_;
+    maxQueueDepth_ = std::max(maxQueueDepth_, other.maxQueueDepth_);
+    queueDepth_ += other.queueDepth_;
+    resendCount_ += other.resendCount_;
+    lostCount_ += other.lostCount_;
 
     return *this;
 }
@@ -76,6 +105,12 @@ TransportStatistics &TransportStatistics::operator/=(size_t n) {
     receiveTiming_ /= n;
     barrierTiming_ /= n;
     shutdownTiming_ /= n;
+    divide(frameCount_, n);
+    divide(stallCount_, n);
+    stallTiming_ /= n;
+    queueDepth_ /= n;
+    divide(resendCount_, n);
+    divide(lostCount_, n);
 
     return *this;
 }
@@ -98,10 +133,20 @@ void TransportStatistics::report(std::ostream &out, const char *indent) const {
     reportTime(out, "Transport: barrier", barrierTiming_, indent);
     reportTime(out, "Transport: shutdown", shutdownTiming_, indent);
 
+    reportCount(out, "Transport: frames sent", frameCount_, indent);
+    reportCount(out, "Transport: stalls", stallCount_, indent);
+    reportTime(out, "Transport: time stalled", stallTiming_, indent);
+    reportCount(out, "Transport: max queue depth", maxQueueDepth_, indent);
+    if (sendCount_) {
+        reportUnit(out, "Transport: average queue depth", "message", double(queueDepth_) / sendCount_, indent);
+    }
+    reportCount(out, "Transport: messages resent", resendCount_, indent);
+    reportCount(out, "Transport: messages lost", lostCount_, indent);
+
 }
 
 void TransportStatistics::csvHeader(std::ostream& out) const {
-    out << "sends,sendSize,send,receives,receiveSize,receive,barrier,shutdown";
+    out << "sends,sendSize,send,receives,receiveSize,receive,barrier,shutdown,frames,stalls,stalled,maxQueueDepth,queueDepth,resent,lost";
 }
 
 void TransportStatistics::csvRow(std::ostream& out) const {
@@ -112,7 +157,14 @@ void TransportStatistics::csvRow(std::ostream& out) const {
         << receiveSize_ << ","
         << receiveTiming_ << ","
         << barrierTiming_ << ","
-        << shutdownTiming_;
+        << shutdownTiming_ << ","
+        << frameCount_ << ","
+        << stallCount_ << ","
+        << stallTiming_ << ","
+        << maxQueueDepth_ << ","
+        << queueDepth_ << ","
+        << resendCount_ << ","
+        << lostCount_;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
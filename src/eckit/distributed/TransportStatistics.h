@@ -47,6 +47,22 @@ public:
     eckit::Timing barrierTiming_;
     eckit::Timing shutdownTiming_;
 
+    // Flow control: frames may batch several messages, a sender stalls when its receiver has no credit left
+
+    size_t frameCount_;
+    size_t stallCount_;
+    eckit::Timing stallTiming_;
+
+    // Messages sent but not yet consumed by the receiver, sampled at each send
+
+    size_t maxQueueDepth_;
+    unsigned long long queueDepth_;
+
+    // Messages queued to a lost receiver, sent again to another one, or lost
+
+    size_t resendCount_;
+    size_t lostCount_;
+
 
     TransportStatistics &operator+=(const TransportStatistics &other) ;
     TransportStatistics &operator/=(size_t) ;
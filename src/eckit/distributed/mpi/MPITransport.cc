@@ -13,6 +13,7 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -35,6 +36,7 @@ namespace eckit::distributed {
 
 MPITransport::MPITransport(const eckit::option::CmdArgs& args) :
     Transport(args),
+    creditTo_(-1),
     comm_(eckit::mpi::comm("world")) {
 
 
@@ -196,6 +198,8 @@ void MPITransport::synchronise() {
 }
 
 void MPITransport::sendStatisticsToProducer(const Message& message) {
+    drainCredits();
+
     int producer = 0;
     send(message, producer, Actor::STATISTICS);
 }
@@ -205,14 +209,81 @@ void MPITransport::sendToWriter(size_t writer, const Message& message) {
 
     auto j = writersToRanks_.find(writer);
     ASSERT(j != writersToRanks_.end());
+
+    // The producer is not flow-controlled, as it receives from any source
+    if (!producer()) {
+        acquireCredit((*j).second);
+    }
+
     send(message, (*j).second, message.tag());
 }
 
+// Flow control with writers: a sender has credits_ messages in flight at most to each writer, so a slow
+// writer cannot be overrun. A writer returns a credit (tag CREDIT) when it asks for its next message, i.e.
+// once the previous one has been processed.
+
+void MPITransport::acquireCredit(int writer) {
+
+    writerCredits_.emplace(writer, credits_);
+
+    collectCredits(writer, false);
+
+    size_t& credits = writerCredits_[writer];
+    if (credits == 0) {
+        eckit::AutoTiming timing(statistics_.stallTiming_);
+        statistics_.stallCount_++;
+        collectCredits(writer, true);
+    }
+
+    ASSERT(credits > 0);
+    credits--;
+
+    size_t depth               = credits_ - credits;
+    statistics_.maxQueueDepth_ = std::max(statistics_.maxQueueDepth_, depth);
+    statistics_.queueDepth_ += depth;
+}
+
+void MPITransport::collectCredits(int writer, bool wait) {
+    size_t& credits = writerCredits_[writer];
+
+    if (wait) {
+        int n = 0;
+        comm_.receive(n, writer, Actor::CREDIT);
+        credits += n;
+    }
+
+    while (comm_.iProbe(writer, Actor::CREDIT).source() == writer) {
+        int n = 0;
+        comm_.receive(n, writer, Actor::CREDIT);
+        credits += n;
+    }
+}
+
+void MPITransport::returnCredit() {
+    if (creditTo_ >= 0) {
+        int n = 1;
+        comm_.send(n, creditTo_, Actor::CREDIT);
+        creditTo_ = -1;
+    }
+}
+
+void MPITransport::drainCredits() {
+    // Wait for the writers to have processed all our messages, so no credit is left in flight
+    eckit::AutoLock<eckit::Mutex> lock(mutex_);
+    for (auto& j : writerCredits_) {
+        while (j.second < credits_) {
+            collectCredits(j.first, true);
+        }
+    }
+}
+
 void MPITransport::getNextWriteMessage(Message& message) {
     // eckit::Log::info()
     //           << " getNextWriteMessage"
     //           << std::endl;
 
+    returnCredit();
+
     int source = comm_.anySource();
     int tag    = comm_.anyTag();
 
@@ -220,6 +291,9 @@ void MPITransport::getNextWriteMessage(Message& message) {
 
     ASSERT(ranksToWriters_.find(source) == ranksToWriters_.end());
 
+    if (source != 0 && tag != Actor::SHUTDOWN) {
+        creditTo_ = source;
+    }
 
     message.rewind();
     message.messageReceived(tag, source);
@@ -60,6 +60,12 @@ private:  // methods
     void receive(Message& message, int& source, int& tag);
     void synchronisedSend(const Message& message, int target, int tag);
 
+    // Flow control with writers
+    void acquireCredit(int writer);
+    void collectCredits(int writer, bool wait);
+    void returnCredit();
+    void drainCredits();
+
 private:  // members
     int totalRanks_;
     int rank_;
@@ -69,6 +75,10 @@ private:  // members
 
     std::string hostname_;
 
+    // Credits left for each writer, and on a writer the rank owed a credit for the last message
+    std::map<int, size_t> writerCredits_;
+    int creditTo_;
+
     mutable eckit::Mutex mutex_;
 
     eckit::mpi::Comm& comm_;
@@ -0,0 +1,1136 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+#include "eckit/log/Plural.h"
+#include "eckit/log/Statistics.h"
+#include "eckit/log/TimeStamp.h"
+#include "eckit/maths/Functions.h"
+#include "eckit/memory/MMap.h"
+#include "eckit/option/CmdArgs.h"
+#include "eckit/runtime/Main.h"
+
+#include "eckit/distributed/Actor.h"
+#include "eckit/distributed/Message.h"
+#include "eckit/distributed/shm/ShmTransport.h"
+#include "eckit/distributed/tcp/TCPTransport.h"
+
+using namespace eckit;
+
+namespace eckit::distributed {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace shm {
+
+constexpr uint64_t MAGIC    = 0x65636b69742d7368ULL;  // "eckit-sh"
+constexpr uint64_t FALLBACK = 0x65636b69742d7463ULL;  // "eckit-tc"
+
+enum State
+{
+    FREE,
+    ATTACHED,
+    DETACHED
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex words are 32 bits");
+
+/// Wakes up a process waiting for a change: the sequence number is bumped on every change that may unblock it,
+/// and the process sleeps (futex on Linux, polling elsewhere) while it is unchanged
+struct Doorbell {
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> sleepers;
+
+    uint32_t current() const { return sequence.load(); }
+
+    void ring() {
+        sequence.fetch_add(1);
+        if (sleepers.load()) {
+#if defined(__linux__)
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+        }
+    }
+
+    /// @returns false on timeout
+    bool wait(uint32_t seen, long milliseconds) {
+        bool woken = false;
+        sleepers.fetch_add(1);
+#if defined(__linux__)
+        struct timespec timeout = {milliseconds / 1000, (milliseconds % 1000) * 1000000};
+        long rc = ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence), FUTEX_WAIT, seen, &timeout, nullptr, 0);
+        woken   = rc == 0 || errno != ETIMEDOUT;
+#else
+        for (long i = 0; i < milliseconds * 10 && !woken; ++i) {
+            ::usleep(100);
+            woken = sequence.load() != seen;
+        }
+#endif
+        sleepers.fetch_sub(1);
+        return woken;
+    }
+};
+
+struct alignas(64) Participant {
+    Doorbell doorbell;
+    std::atomic<int32_t> pid;
+    std::atomic<int32_t> state;
+    std::atomic<uint64_t> received;  // messages taken from the producer
+};
+
+struct RingHeader {
+    alignas(64) std::atomic<uint64_t> head;  // bytes written
+    alignas(64) std::atomic<uint64_t> tail;  // bytes read
+};
+
+/// Messages are framed as (tag, size, payload); payloads larger than the ring are streamed through it
+struct Frame {
+    uint32_t tag;
+    uint32_t unused;
+    uint64_t size;
+};
+
+/// Left in place of the segment by a producer that cannot create it, so that its workers use TCPTransport as well
+struct Fallback {
+    uint64_t magic;
+    int64_t pid;
+};
+
+/// Layout of the segment: this header, the participants (the producer, then workers and writers), then the rings
+/// from the producer to each participant and back, and from each worker to each writer. The header starts as
+/// Fallback does, with the magic number and the pid of the producer.
+struct Segment {
+    std::atomic<uint64_t> magic;
+    int64_t owner;
+    uint64_t size;
+    uint64_t workers;
+    uint64_t writers;
+    uint64_t ringSize;
+    std::atomic<uint32_t> nextWorker;
+    std::atomic<uint32_t> closed;
+
+    static size_t participantsOffset() { return eckit::round(sizeof(Segment), 64); }
+
+    static size_t ringsOffset(size_t workers, size_t writers) {
+        return eckit::round(participantsOffset() + (1 + workers + writers) * sizeof(Participant), 4096);
+    }
+
+    static size_t ringStride(size_t ringSize) { return sizeof(RingHeader) + eckit::round(ringSize, 64); }
+
+    static size_t rings(size_t workers, size_t writers) { return 2 * (workers + writers) + workers * writers; }
+
+    static size_t bytes(size_t workers, size_t writers, size_t ringSize) {
+        return ringsOffset(workers, writers) + rings(workers, writers) * ringStride(ringSize);
+    }
+
+    Participant& participant(size_t i) {
+        return reinterpret_cast<Participant*>(reinterpret_cast<char*>(this) + participantsOffset())[i];
+    }
+
+    RingHeader& ring(size_t i) {
+        return *reinterpret_cast<RingHeader*>(reinterpret_cast<char*>(this) + ringsOffset(workers, writers)
+                                              + i * ringStride(ringSize));
+    }
+};
+
+/// Single-producer/single-consumer byte ring, the writer and the reader ring each other's doorbell
+class Ring {
+public:
+    Ring(RingHeader& header, size_t capacity, Doorbell& reader, Doorbell& writer) :
+        header_(header),
+        data_(reinterpret_cast<char*>(&header) + sizeof(RingHeader)),
+        capacity_(capacity),
+        reader_(reader),
+        writer_(writer) {}
+
+    size_t capacity() const { return capacity_; }
+
+    // Writer side
+
+    uint64_t head() const { return header_.head.load(std::memory_order_relaxed); }
+
+    /// Copies bytes written from position, still in the ring if head() - position <= capacity()
+    void copy(uint64_t position, void* buffer, size_t length) const {
+        size_t offset = position % capacity_;
+        size_t first  = std::min(length, capacity_ - offset);
+        ::memcpy(buffer, data_ + offset, first);
+        ::memcpy(static_cast<char*>(buffer) + first, data_, length - first);
+    }
+
+    size_t writable() const {
+        return capacity_ - (header_.head.load(std::memory_order_relaxed) - header_.tail.load(std::memory_order_acquire));
+    }
+
+    void put(const void* buffer, size_t length) {
+        uint64_t head = header_.head.load(std::memory_order_relaxed);
+        size_t offset = head % capacity_;
+        size_t first  = std::min(length, capacity_ - offset);
+        ::memcpy(data_ + offset, buffer, first);
+        ::memcpy(data_, static_cast<const char*>(buffer) + first, length - first);
+        header_.head.store(head + length, std::memory_order_release);
+        reader_.ring();
+    }
+
+    // Reader side
+
+    size_t readable() const {
+        return header_.head.load(std::memory_order_acquire) - header_.tail.load(std::memory_order_relaxed);
+    }
+
+    void get(void* buffer, size_t length) {
+        uint64_t tail = header_.tail.load(std::memory_order_relaxed);
+        size_t offset = tail % capacity_;
+        size_t first  = std::min(length, capacity_ - offset);
+        ::memcpy(buffer, data_ + offset, first);
+        ::memcpy(static_cast<char*>(buffer) + first, data_, length - first);
+        header_.tail.store(tail + length, std::memory_order_release);
+        writer_.ring();
+    }
+
+private:
+    RingHeader& header_;
+    char* data_;
+    size_t capacity_;
+    Doorbell& reader_;
+    Doorbell& writer_;
+};
+
+}  // namespace shm
+
+using shm::Frame;
+using shm::Participant;
+using shm::Ring;
+using shm::Segment;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+class PeerLost : public eckit::Exception {
+public:
+    PeerLost(const std::string& what) :
+        Exception(what) {}
+};
+
+// The producer cannot create the segment, ShmTransportBuilder falls back to TCPTransport
+class ShmUnavailable : public eckit::Exception {
+public:
+    ShmUnavailable(const std::string& what) :
+        Exception(what) {}
+};
+
+// A process waits on its doorbell for that long before checking that its peer is still alive
+constexpr long TIMEOUT = 1000;
+
+// Time for a worker to find the segment of the producer
+constexpr long ATTACH_TIMEOUT = 10;
+
+bool alive(pid_t pid) {
+    return ::kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+bool alive(Participant& p) {
+    if (p.state.load() == shm::DETACHED) {
+        return false;
+    }
+    pid_t pid = p.pid.load();
+    return pid == 0 || alive(pid);
+}
+
+/// Fallback markers left by this process, removed when it exits (but not by its forked children)
+class FallbackMarkers {
+public:
+    static void add(const std::string& name) {
+        static FallbackMarkers markers;
+        markers.names_.emplace_back(::getpid(), name);
+    }
+
+    ~FallbackMarkers() {
+        for (const auto& n : names_) {
+            if (n.first == ::getpid()) {
+                ::shm_unlink(n.second.c_str());
+            }
+        }
+    }
+
+private:
+    std::vector<std::pair<pid_t, std::string>> names_;
+};
+
+/// An existing segment (or fallback marker) can be removed only if the producer that created it is dead. Unknown
+/// content, or a segment too short to tell, is left alone.
+bool stale(const std::string& name, pid_t& owner) {
+    owner  = 0;
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return errno == ENOENT;
+    }
+
+    shm::Fallback header = {0, 0};
+    bool complete        = ::pread(fd, &header, sizeof(header), 0) == sizeof(header);
+    ::close(fd);
+
+    if (!complete || (header.magic != shm::MAGIC && header.magic != shm::FALLBACK && header.magic != 0)
+        || header.pid <= 0) {
+        return false;
+    }
+
+    owner = pid_t(header.pid);
+    return !alive(owner);
+}
+
+/// Replaces the content of the segment being created by a fallback marker
+void publishFallback(int fd, const std::string& name) {
+    shm::Fallback fallback = {shm::FALLBACK, ::getpid()};
+    if (::ftruncate(fd, sizeof(fallback)) == 0 && ::pwrite(fd, &fallback, sizeof(fallback), 0) == sizeof(fallback)) {
+        FallbackMarkers::add(name);
+        return;
+    }
+    Log::error() << "ShmTransport: cannot publish the fallback in " << name << Log::syserr << std::endl;
+    ::shm_unlink(name.c_str());
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ShmTransport::ShmTransport(const eckit::option::CmdArgs& args) :
+    Transport(args), segment_(nullptr), size_(0), self_(0), writer_(0), owner_(false), scan_(0) {
+
+    size_t port = 7777;
+    args.get("port", port);
+
+    std::ostringstream name;
+    name << "/eckit-distributed-" << port;
+    name_ = name.str();
+    args.get("segment", name_);
+
+    std::string hostname = Main::hostname();
+
+    try {
+        std::string host;
+        if (args.get("host", host)) {
+            // We are a consumer, on the node of the producer
+            if (host != "localhost" && host != hostname) {
+                throw UserError("ShmTransport: producer on host " + host + " is not local");
+            }
+            args.get("writer", writer_);
+            attach(writer_);
+        }
+        else {
+            size_t workers  = std::max(std::thread::hardware_concurrency(), 1U);
+            size_t writers  = 0;
+            size_t ringSize = Resource<size_t>("distributedRingSize;$ECKIT_DISTRIBUTED_RING_SIZE", 1024 * 1024);
+            args.get("workers", workers);
+            args.get("writers", writers);
+            args.get("ring-size", ringSize);
+            create(workers, writers, ringSize);
+        }
+    }
+    catch (...) {
+        detach();
+        throw;
+    }
+
+    std::ostringstream oss;
+    oss << peerName(self_) << "-" << ::getpid() << "@" << hostname;
+    title_ = oss.str();
+
+    std::ostringstream oid;
+    oid << hostname << "@" << ::getpid();
+    id_ = oid.str();
+}
+
+ShmTransport::~ShmTransport() {
+    detach();
+}
+
+void ShmTransport::create(size_t workers, size_t writers, size_t ringSize) {
+
+    ASSERT(workers > 0);
+    ASSERT(ringSize >= 4096);
+
+    size_ = Segment::bytes(workers, writers, ringSize);
+
+    int fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        pid_t pid;
+        if (!stale(name_, pid)) {
+            std::ostringstream oss;
+            oss << "ShmTransport: cannot create " << name_ << ", in use";
+            if (pid) {
+                oss << " by process " << pid;
+            }
+            throw ShmUnavailable(oss.str());
+        }
+        Log::warning() << "ShmTransport: removing stale segment " << name_ << " of process " << pid << std::endl;
+        ::shm_unlink(name_.c_str());
+        fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    }
+    if (fd < 0) {
+        Log::error() << "shm_open(" << name_ << ')' << Log::syserr << std::endl;
+        throw ShmUnavailable("ShmTransport: cannot create " + name_);
+    }
+
+    // Claim the segment first, for another producer to leave it alone
+    shm::Fallback header = {0, ::getpid()};
+    if (::pwrite(fd, &header, sizeof(header), 0) != sizeof(header)) {
+        Log::error() << "ShmTransport: cannot write to " << name_ << Log::syserr << std::endl;
+        ::close(fd);
+        ::shm_unlink(name_.c_str());
+        throw ShmUnavailable("ShmTransport: cannot create " + name_);
+    }
+
+    // Reserve the memory now: on a full /dev/shm, touching the pages later would raise SIGBUS
+#if defined(__linux__)
+    int err = ::posix_fallocate(fd, 0, size_);
+#else
+    int err = ::ftruncate(fd, size_) < 0 ? errno : 0;
+#endif
+    if (err) {
+        errno = err;
+        Log::error() << "ShmTransport: cannot allocate " << Bytes(size_) << " for " << name_ << Log::syserr
+                     << std::endl;
+        publishFallback(fd, name_);
+        ::close(fd);
+        throw ShmUnavailable("ShmTransport: cannot create " + name_);
+    }
+
+    void* address = MMap::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (address == MAP_FAILED) {
+        Log::error() << "ShmTransport: cannot mmap " << Bytes(size_) << " for " << name_ << Log::syserr << std::endl;
+        publishFallback(fd, name_);
+        ::close(fd);
+        throw ShmUnavailable("ShmTransport: cannot create " + name_);
+    }
+
+    ::close(fd);
+    owner_ = true;
+
+    segment_ = new (address) Segment;
+
+    segment_->owner    = ::getpid();
+    segment_->size     = size_;
+    segment_->workers  = workers;
+    segment_->writers  = writers;
+    segment_->ringSize = ringSize;
+    segment_->nextWorker.store(0);
+    segment_->closed.store(0);
+
+    for (size_t i = 0; i < 1 + workers + writers; ++i) {
+        Participant* p = new (&segment_->participant(i)) Participant;
+        p->doorbell.sequence.store(0);
+        p->doorbell.sleepers.store(0);
+        p->pid.store(0);
+        p->state.store(shm::FREE);
+        p->received.store(0);
+    }
+
+    for (size_t i = 0; i < Segment::rings(workers, writers); ++i) {
+        shm::RingHeader* r = new (&segment_->ring(i)) shm::RingHeader;
+        r->head.store(0);
+        r->tail.store(0);
+    }
+
+    self_ = 0;
+    participant(0).pid.store(::getpid());
+    participant(0).state.store(shm::ATTACHED);
+
+    sent_.resize(1 + workers, 0);
+    lost_.resize(1 + workers, false);
+    queued_.resize(1 + workers);
+
+    segment_->magic.store(shm::MAGIC, std::memory_order_release);
+
+    Log::info() << TimeStamp() << " ShmTransport: created " << name_ << ", " << Bytes(size_) << " for "
+                << Plural(workers, "worker");
+    if (writers) {
+        Log::info() << " and " << Plural(writers, "writer");
+    }
+    Log::info() << std::endl;
+}
+
+void ShmTransport::attach(size_t writer) {
+
+    time_t deadline = ::time(nullptr) + ATTACH_TIMEOUT;
+
+    // Wait for the producer to create the segment, or to leave a fallback marker in its place. Shared memory being
+    // unsupported, the producer fell back too; any other error is fatal, as the producer may well be using it.
+    for (;;) {
+        int fd = ::shm_open(name_.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            if (errno == ENOSYS) {
+                throw ShmUnavailable("ShmTransport: shared memory not supported");
+            }
+            if (errno != ENOENT) {
+                throw FailedSystemCall("shm_open(" + name_ + ")", Here());
+            }
+        }
+        else {
+            struct stat s;
+            if (::fstat(fd, &s) < 0) {
+                ::close(fd);
+                throw FailedSystemCall("fstat(" + name_ + ")", Here());
+            }
+
+            shm::Fallback fallback = {0, 0};
+            if (size_t(s.st_size) >= sizeof(fallback)
+                && ::pread(fd, &fallback, sizeof(fallback), 0) == sizeof(fallback) && fallback.magic == shm::FALLBACK
+                && alive(pid_t(fallback.pid))) {
+                ::close(fd);
+                std::ostringstream oss;
+                oss << "ShmTransport: producer " << fallback.pid << " cannot create " << name_;
+                throw ShmUnavailable(oss.str());
+            }
+
+            if (size_t(s.st_size) >= sizeof(Segment)) {
+                void* address = MMap::mmap(nullptr, s.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (address == MAP_FAILED) {
+                    ::close(fd);
+                    throw FailedSystemCall("mmap(" + name_ + ")", Here());
+                }
+                Segment* segment = static_cast<Segment*>(address);
+                if (segment->magic.load(std::memory_order_acquire) == shm::MAGIC && segment->size == size_t(s.st_size)) {
+                    segment_ = segment;
+                    size_    = s.st_size;
+                    ::close(fd);
+                    break;
+                }
+                MMap::munmap(address, s.st_size);
+            }
+            ::close(fd);
+        }
+
+        if (::time(nullptr) > deadline) {
+            throw TimeOut("ShmTransport: cannot attach to " + name_, ATTACH_TIMEOUT);
+        }
+        ::usleep(10000);
+    }
+
+    if (writer) {
+        if (writer > segment_->writers) {
+            std::ostringstream oss;
+            oss << "ShmTransport: writer " << writer << " out of range, " << name_ << " has "
+                << Plural(segment_->writers, "writer");
+            throw UserError(oss.str());
+        }
+
+        self_ = 1 + segment_->workers + writer - 1;
+
+        int32_t none = 0;
+        if (!participant(self_).pid.compare_exchange_strong(none, ::getpid())) {
+            self_ = 0;
+            throw UserError("ShmTransport: writer already attached");
+        }
+    }
+    else {
+        if (segment_->closed.load()) {
+            throw UserError("ShmTransport: producer is shutting down");
+        }
+
+        size_t n = segment_->nextWorker.fetch_add(1);
+        if (n >= segment_->workers) {
+            std::ostringstream oss;
+            oss << "ShmTransport: too many workers, " << name_ << " is sized for " << Plural(segment_->workers, "worker")
+                << " (option --workers)";
+            throw UserError(oss.str());
+        }
+
+        self_ = 1 + n;
+        participant(self_).pid.store(::getpid());
+    }
+
+    participant(self_).state.store(shm::ATTACHED);
+    participant(0).doorbell.ring();
+}
+
+void ShmTransport::detach() {
+    if (segment_) {
+        if (self_ || owner_) {
+            participant(self_).state.store(shm::DETACHED);
+            participant(0).doorbell.ring();
+        }
+        MMap::munmap(segment_, size_);
+        segment_ = nullptr;
+    }
+
+    if (owner_) {
+        ::shm_unlink(name_.c_str());
+        owner_ = false;
+    }
+}
+
+Participant& ShmTransport::participant(size_t i) const {
+    return segment_->participant(i);
+}
+
+Ring ShmTransport::ring(size_t from, size_t to) const {
+
+    size_t all = segment_->workers + segment_->writers;
+    size_t index;
+
+    if (from == 0) {
+        ASSERT(to > 0 && to <= all);
+        index = 2 * (to - 1);
+    }
+    else if (to == 0) {
+        ASSERT(from <= all);
+        index = 2 * (from - 1) + 1;
+    }
+    else {
+        ASSERT(from <= segment_->workers && to > segment_->workers && to <= all);
+        index = 2 * all + (from - 1) * segment_->writers + (to - 1 - segment_->workers);
+    }
+
+    return Ring(segment_->ring(index), segment_->ringSize, participant(to).doorbell, participant(from).doorbell);
+}
+
+std::string ShmTransport::peerName(size_t i) const {
+    std::ostringstream oss;
+    if (i == 0) {
+        oss << "Producer";
+    }
+    else if (i <= segment_->workers) {
+        oss << "Worker-" << i;
+    }
+    else {
+        oss << "Writer-" << i - segment_->workers;
+    }
+    return oss.str();
+}
+
+size_t ShmTransport::workers() const {
+    return std::min<size_t>(segment_->nextWorker.load(), segment_->workers);
+}
+
+template <class Condition>
+void ShmTransport::wait(Condition ready, size_t peer) const {
+    shm::Doorbell& doorbell = participant(self_).doorbell;
+
+    for (size_t spin = 0;; ++spin) {
+        uint32_t seen = doorbell.current();
+        if (ready()) {
+            return;
+        }
+        if (spin < 16) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (!doorbell.wait(seen, TIMEOUT) && !alive(participant(peer))) {
+            throw PeerLost("ShmTransport: lost " + peerName(peer));
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Messages are copied into the ring by the sender and out of it by the receiver, which both only wait when the ring
+// is full or empty. Large messages are streamed through the ring by quarters, so that both sides copy in parallel.
+
+void ShmTransport::send(Ring& ring, const void* buffer, size_t size, int tag, size_t peer) {
+
+    Frame frame = {uint32_t(tag), 0, size};
+
+    wait([&] { return ring.writable() >= sizeof(Frame); }, peer);
+    ring.put(&frame, sizeof(Frame));
+
+    const char* data = static_cast<const char*>(buffer);
+    size_t left      = frame.size;
+    size_t chunk     = ring.capacity() / 4;
+
+    while (left) {
+        wait([&] { return ring.writable() >= std::min(left, chunk); }, peer);
+        size_t n = std::min(left, ring.writable());
+        ring.put(data, n);
+        data += n;
+        left -= n;
+    }
+}
+
+void ShmTransport::receive(Ring& ring, Message& message, size_t peer) {
+
+    Frame frame;
+
+    wait([&] { return ring.readable() >= sizeof(Frame); }, peer);
+    ring.get(&frame, sizeof(Frame));
+
+    message.reserve(frame.size);
+
+    char* data   = static_cast<char*>(message.messageData());
+    size_t left  = frame.size;
+    size_t chunk = ring.capacity() / 4;
+
+    while (left) {
+        wait([&] { return ring.readable() >= std::min(left, chunk); }, peer);
+        size_t n = std::min(left, ring.readable());
+        ring.get(data, n);
+        data += n;
+        left -= n;
+    }
+
+    if (frame.tag != Actor::SHUTDOWN) {
+        statistics_.receiveCount_++;
+        statistics_.receiveSize_ += frame.size;
+    }
+
+    message.rewind();
+    message.messageReceived(frame.tag, peer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool ShmTransport::producer() const {
+    return self_ == 0;
+}
+
+bool ShmTransport::single() const {
+    return false;
+}
+
+bool ShmTransport::writer() const {
+    return writer_ != 0;
+}
+
+void ShmTransport::initialise() {
+    if (producer()) {
+        Log::info() << TimeStamp() << " " << title() << ", waiting for a worker" << std::endl;
+        wait([this] { return workers() > 0; }, 0);
+    }
+}
+
+void ShmTransport::synchronise() {}
+
+void ShmTransport::abort() {
+    detach();
+}
+
+void ShmTransport::print(std::ostream& out) const {
+    out << "ShmTransport[" << name_ << "]";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Producer to worker: the producer sends each message to the least loaded worker, which can have up to credits_
+// messages queued in its ring (the ring being empty for a message larger than the ring)
+
+bool ShmTransport::available(size_t worker, size_t size) const {
+    Participant& p = participant(worker);
+    if (lost_[worker] || p.state.load() != shm::ATTACHED) {
+        return false;
+    }
+    Ring r = ring(0, worker);
+    return sent_[worker] - p.received.load() < credits_ && r.writable() >= std::min(sizeof(Frame) + size, r.capacity());
+}
+
+size_t ShmTransport::nextWorker(size_t size) {
+
+    auto find = [this, size]() {
+        size_t best = 0;
+        for (size_t w = 1; w <= workers(); ++w) {
+            if (available(w, size)
+                && (!best || sent_[w] - participant(w).received.load() < sent_[best] - participant(best).received.load())) {
+                best = w;
+            }
+        }
+        return best;
+    };
+
+    size_t worker = find();
+    if (worker) {
+        return worker;
+    }
+
+    // Stall: all workers are busy
+
+    eckit::AutoTiming timing(statistics_.stallTiming_);
+    statistics_.stallCount_++;
+
+    shm::Doorbell& doorbell = participant(self_).doorbell;
+    for (;;) {
+        uint32_t seen = doorbell.current();
+        if ((worker = find())) {
+            return worker;
+        }
+
+        if (!doorbell.wait(seen, TIMEOUT)) {
+            size_t active = 0;
+            for (size_t w = 1; w <= workers(); ++w) {
+                if (!lost_[w] && !alive(participant(w))) {
+                    PeerLost e("ShmTransport: lost " + peerName(w));
+                    disconnect(e, w);
+                }
+                active += lost_[w] ? 0 : 1;
+            }
+            if (!active) {
+                throw SeriousBug("ShmTransport: no more workers");
+            }
+        }
+    }
+}
+
+// The messages queued to a lost worker are taken back from its ring, those whose bytes have not been overwritten yet
+// (all of them, unless it died reading a message larger than the ring), and sent to the other workers. A worker that
+// dies between reading a message and counting it gets it sent twice.
+
+void ShmTransport::disconnect(std::exception& e, size_t worker) {
+    Log::error() << TimeStamp() << " " << title() << " " << e.what() << std::endl;
+    lost_[worker] = true;
+
+    Ring r                       = ring(0, worker);
+    std::deque<uint64_t>& queued = queued_[worker];
+
+    while (queued.size() > sent_[worker] - participant(worker).received.load()) {
+        queued.pop_front();
+    }
+
+    size_t lost = 0;
+    for (uint64_t start : queued) {
+        if (r.head() - start > r.capacity()) {
+            lost++;
+            continue;
+        }
+        Frame frame;
+        r.copy(start, &frame, sizeof(Frame));
+        pending_.push_back(Pending{int(frame.tag), std::vector<char>(frame.size)});
+        r.copy(start + sizeof(Frame), pending_.back().data.data(), frame.size);
+    }
+
+    if (queued.size() > lost) {
+        Log::info() << TimeStamp() << " " << title() << ", taking back " << Plural(queued.size() - lost, "message")
+                    << " queued to " << peerName(worker) << std::endl;
+    }
+    if (lost) {
+        Log::error() << TimeStamp() << " " << title() << ", " << Plural(lost, "message") << " queued to "
+                     << peerName(worker) << " lost" << std::endl;
+        statistics_.lostCount_ += lost;
+    }
+
+    queued.clear();
+}
+
+void ShmTransport::sendToWorker(const void* buffer, size_t size, int tag) {
+    for (;;) {
+        size_t worker  = nextWorker(size);
+        Ring r         = ring(0, worker);
+        uint64_t start = r.head();
+
+        try {
+            eckit::AutoTiming timing(statistics_.sendTiming_);
+            send(r, buffer, size, tag, worker);
+        }
+        catch (PeerLost& e) {
+            disconnect(e, worker);
+            Log::info() << TimeStamp() << " " << title() << ", resending..." << std::endl;
+            continue;
+        }
+
+        // Keep the position of the messages the worker has not received yet
+        size_t depth = ++sent_[worker] - participant(worker).received.load();
+        queued_[worker].push_back(start);
+        while (queued_[worker].size() > depth) {
+            queued_[worker].pop_front();
+        }
+
+        statistics_.frameCount_++;
+        statistics_.maxQueueDepth_ = std::max<unsigned long long>(statistics_.maxQueueDepth_, depth);
+        statistics_.queueDepth_ += depth;
+        return;
+    }
+}
+
+void ShmTransport::resend() {
+    while (!pending_.empty()) {
+        Pending p = std::move(pending_.front());
+        pending_.pop_front();
+        sendToWorker(p.data.data(), p.data.size(), p.tag);
+        statistics_.resendCount_++;
+    }
+}
+
+void ShmTransport::sendMessageToNextWorker(const Message& message) {
+
+    sendToWorker(message.messageData(), message.messageSize(), message.tag());
+
+    statistics_.sendCount_++;
+    statistics_.sendSize_ += message.messageSize();
+
+    resend();
+}
+
+void ShmTransport::getNextWorkMessage(Message& message) {
+    Ring r = ring(0, self_);
+
+    eckit::AutoTiming timing(statistics_.receiveTiming_);
+    receive(r, message, 0);
+
+    participant(self_).received++;
+}
+
+void ShmTransport::sendStatisticsToProducer(const Message& message) {
+    Ring r = ring(self_, 0);
+    send(r, message.messageData(), message.messageSize(), Actor::STATISTICS, 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Workers (and the producer) to writers, each writer reads from the workers in turn, and from the producer
+
+void ShmTransport::sendToWriter(size_t writer, const Message& message) {
+
+    ASSERT(writer > 0 && writer <= segment_->writers);
+    ASSERT(!this->writer());
+
+    size_t peer = 1 + segment_->workers + writer - 1;
+    Ring r      = ring(self_, peer);
+
+    eckit::AutoTiming timing(statistics_.sendTiming_);
+    send(r, message.messageData(), message.messageSize(), message.tag(), peer);
+
+    statistics_.sendCount_++;
+    statistics_.sendSize_ += message.messageSize();
+}
+
+void ShmTransport::getNextWriteMessage(Message& message) {
+
+    ASSERT(writer());
+
+    eckit::AutoTiming timing(statistics_.receiveTiming_);
+
+    shm::Doorbell& doorbell = participant(self_).doorbell;
+
+    auto fromWorkers = [&]() -> size_t {
+        size_t n = workers();
+        for (size_t i = 0; i < n; ++i) {
+            size_t w = 1 + (scan_ + i) % n;
+            if (ring(w, self_).readable() >= sizeof(Frame)) {
+                scan_ = w % n;
+                return w;
+            }
+        }
+        return 0;
+    };
+
+    for (;;) {
+        uint32_t seen = doorbell.current();
+
+        if (size_t w = fromWorkers()) {
+            Ring r = ring(w, self_);
+            receive(r, message, w);
+            break;
+        }
+
+        // The producer sends SHUTDOWN after the last worker is done, check again the workers for messages
+        // sent before that
+        Ring r = ring(0, self_);
+        if (r.readable() >= sizeof(Frame) && !fromWorkers()) {
+            receive(r, message, 0);
+            break;
+        }
+
+        if (!doorbell.wait(seen, TIMEOUT) && !alive(participant(0))) {
+            throw PeerLost("ShmTransport: lost " + peerName(0));
+        }
+    }
+
+    ASSERT(message.tag() == Actor::WRITE || message.tag() == Actor::OPEN || message.tag() == Actor::CLOSE
+           || message.tag() == Actor::SHUTDOWN);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ShmTransport::collectStatistics(const Actor& actor, size_t first, size_t last) {
+
+    std::set<size_t> pending;
+    for (size_t i = first; i <= last; ++i) {
+        if (i > segment_->workers || !lost_[i]) {
+            pending.insert(i);
+        }
+    }
+
+    // Workers lost now still give back their messages, but these can no longer be sent
+    auto lost = [this](std::exception& e, size_t i) {
+        if (i <= segment_->workers) {
+            disconnect(e, i);
+        }
+        else {
+            Log::error() << TimeStamp() << " " << title() << " " << e.what() << std::endl;
+        }
+    };
+
+    shm::Doorbell& doorbell = participant(self_).doorbell;
+    Message message;
+    size_t waiting = 0;
+
+    while (!pending.empty()) {
+        uint32_t seen = doorbell.current();
+
+        for (auto j = pending.begin(); j != pending.end();) {
+            size_t i = *j;
+            Ring r   = ring(i, 0);
+
+            if (r.readable() < sizeof(Frame)) {
+                ++j;
+                continue;
+            }
+
+            try {
+                receive(r, message, i);
+                ASSERT(message.tag() == Actor::STATISTICS);
+                if (i <= segment_->workers) {
+                    actor.messageFromWorker(message, i);
+                }
+                else {
+                    actor.messageFromWriter(message, i - segment_->workers);
+                }
+            }
+            catch (PeerLost& e) {
+                lost(e, i);
+            }
+            j = pending.erase(j);
+        }
+
+        if (pending.empty() || doorbell.wait(seen, TIMEOUT)) {
+            continue;
+        }
+
+        for (auto j = pending.begin(); j != pending.end();) {
+            if (!alive(participant(*j))) {
+                PeerLost e("ShmTransport: lost " + peerName(*j));
+                lost(e, *j);
+                j = pending.erase(j);
+            }
+            else {
+                ++j;
+            }
+        }
+
+        if (++waiting % 30 == 0) {
+            Log::info() << TimeStamp() << " " << title() << ", waiting... " << Plural(pending.size(), "peer")
+                        << " still active" << std::endl;
+        }
+    }
+}
+
+void ShmTransport::sendShutDownMessage(const Actor& actor) {
+
+    eckit::AutoTiming timing(statistics_.shutdownTiming_);
+
+    // No more workers can attach
+    segment_->closed.store(1);
+
+    // Messages queued to workers lost by now are sent to the others before these are shut down
+
+    size_t count = workers();
+    for (size_t w = 1; w <= count; ++w) {
+        if (!lost_[w] && !alive(participant(w))) {
+            PeerLost e("ShmTransport: lost " + peerName(w));
+            disconnect(e, w);
+        }
+    }
+    resend();
+
+    // SHUTDOWN is queued after the last messages sent to each worker
+
+    for (size_t w = 1; w <= count; ++w) {
+        if (!lost_[w]) {
+            Log::info() << TimeStamp() << " " << title() << " shutdown " << peerName(w) << std::endl;
+            Ring r = ring(0, w);
+            try {
+                send(r, Message::shutdownMessage().messageData(), Message::shutdownMessage().messageSize(),
+                     Actor::SHUTDOWN, w);
+            }
+            catch (PeerLost& e) {
+                disconnect(e, w);
+            }
+        }
+    }
+
+    collectStatistics(actor, 1, count);
+
+    if (!pending_.empty()) {
+        Log::error() << TimeStamp() << " " << title() << ", " << Plural(pending_.size(), "message")
+                     << " lost, no worker left to send them to" << std::endl;
+        statistics_.lostCount_ += pending_.size();
+        pending_.clear();
+    }
+
+    // Writers are shut down once all the workers are done
+
+    size_t first = 1 + segment_->workers;
+    size_t last  = segment_->workers + segment_->writers;
+
+    for (size_t w = first; w <= last; ++w) {
+        Log::info() << TimeStamp() << " " << title() << " shutdown " << peerName(w) << std::endl;
+        Ring r = ring(0, w);
+        try {
+            send(r, Message::shutdownMessage().messageData(), Message::shutdownMessage().messageSize(),
+                 Actor::SHUTDOWN, w);
+        }
+        catch (PeerLost& e) {
+            Log::error() << TimeStamp() << " " << title() << " " << e.what() << std::endl;
+        }
+    }
+
+    collectStatistics(actor, first, last);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Falls back to TCPTransport, with the same options, when the producer cannot create the segment; its workers find
+// that out in place of the segment, and follow. Any other error, in particular of a worker attaching, is fatal.
+
+class ShmTransportBuilder : public TransportFactory {
+    Transport* make(const eckit::option::CmdArgs& args) override {
+        try {
+            return new ShmTransport(args);
+        }
+        catch (ShmUnavailable& e) {
+            Log::warning() << e.what() << ", falling back to TCPTransport" << std::endl;
+            return new TCPTransport(args);
+        }
+    }
+
+public:
+    ShmTransportBuilder() :
+        TransportFactory("shm") {}
+};
+
+static ShmTransportBuilder builder;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::distributed
@@ -0,0 +1,140 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   ShmTransport.h
+
+#ifndef eckit_ShmTransport_H
+#define eckit_ShmTransport_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "eckit/distributed/Transport.h"
+
+namespace eckit::option {
+class Option;
+class CmdArgs;
+}
+
+namespace eckit::distributed {
+
+class Message;
+
+namespace shm {
+struct Segment;
+struct Participant;
+class Ring;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Transport between the processes of a single node, through single-producer/single-consumer ring buffers in a
+/// POSIX shared memory segment: messages are copied into and out of the segment, without system calls other than
+/// to wake up a waiting process.
+///
+/// It is started like TCPTransport:
+///  - the producer is started with --transport=shm [--port=7777] [--workers=<cores>] [--writers=0] [--ring-size=<bytes>],
+///    it creates the segment named after the port (or --segment), sized for at most --workers workers;
+///  - workers are started with --transport=shm --host=localhost [--port=7777];
+///  - writers are started as workers, with --writer=<n>, 1 <= n <= writers.
+///
+/// A producer that cannot create the segment falls back to TCPTransport, and leaves a marker in place of the segment
+/// for its workers to fall back as well. A worker that cannot attach to the segment otherwise fails.
+///
+/// Messages queued to a worker that dies are sent to the other workers, or reported as lost.
+
+class ShmTransport : public Transport {
+public: // methods
+
+    ShmTransport(const eckit::option::CmdArgs &args);
+    virtual ~ShmTransport() override;
+
+protected: // methods
+
+    virtual void sendMessageToNextWorker(const Message &message) override;
+    virtual void getNextWorkMessage(Message &message) override;
+    virtual void sendStatisticsToProducer(const Message &message) override;
+    virtual void sendShutDownMessage(const Actor&) override;
+
+    virtual bool producer() const override;
+    virtual bool single() const override;
+    virtual void initialise() override;
+    virtual void abort() override;
+    virtual void synchronise() override;
+    virtual bool writer() const override;
+    virtual void sendToWriter(size_t writer, const Message &message) override;
+    virtual void getNextWriteMessage(Message &message) override;
+
+    void print(std::ostream& out) const override;
+
+private: // methods
+
+    void create(size_t workers, size_t writers, size_t ringSize);
+    void attach(size_t writer);
+    void detach();
+
+    shm::Participant& participant(size_t) const;
+    shm::Ring ring(size_t from, size_t to) const;
+    std::string peerName(size_t) const;
+    size_t workers() const;
+
+    void send(shm::Ring&, const void* buffer, size_t size, int tag, size_t peer);
+    void receive(shm::Ring&, Message &message, size_t peer);
+
+    bool available(size_t worker, size_t size) const;
+    size_t nextWorker(size_t size);
+    void sendToWorker(const void* buffer, size_t size, int tag);
+    void resend();
+    void disconnect(std::exception& e, size_t worker);
+    void collectStatistics(const Actor&, size_t first, size_t last);
+
+    template <class Condition>
+    void wait(Condition ready, size_t peer) const;
+
+private: // types
+
+    struct Pending {
+        int tag;
+        std::vector<char> data;
+    };
+
+private: // members
+
+    std::string name_;
+
+    shm::Segment* segment_;
+    size_t size_;
+
+    // 0 for the producer, then workers and writers
+    size_t self_;
+    size_t writer_;
+
+    bool owner_;
+
+    // Writer side: next worker to read from
+    size_t scan_;
+
+    // Producer side: messages sent to each worker, and workers lost
+    std::vector<size_t> sent_;
+    std::vector<bool> lost_;
+
+    // Producer side: position in the ring of the messages not yet received by each worker, and messages taken back
+    // from lost workers
+    std::vector<std::deque<uint64_t>> queued_;
+    std::deque<Pending> pending_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // namespace eckit::distributed
+
+#endif
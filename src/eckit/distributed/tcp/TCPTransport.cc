@@ -11,9 +11,14 @@
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <deque>
+#include <vector>
+
 #include "eckit/log/Log.h"
 #include "eckit/log/Seconds.h"
 #include "eckit/log/Plural.h"
+#include "eckit/log/Statistics.h"
 #include "eckit/log/TimeStamp.h"
 #include "eckit/runtime/Main.h"
 
@@ -41,6 +46,9 @@ class Connection : public InstantTCPStream {
     TCPSocket socket_;
     size_t id_;
     bool active_;
+    size_t credits_;
+    size_t inflight_;
+    std::deque<std::vector<char>> unacknowledged_;
 
 private:
 
@@ -52,7 +60,9 @@ public:
         select_(select),
         socket_(socket),
         id_(id),
-        active_(true) {
+        active_(true),
+        credits_(0),
+        inflight_(0) {
         select_.add(socket_);
     }
 
@@ -66,6 +76,41 @@ public:
 
     bool active() const { return active_; }
 
+    // Flow control, on the producer side: the worker grants credits for the messages it has consumed,
+    // a message can only be sent against a credit
+
+    size_t credits() const { return credits_; }
+
+    size_t inflight() const { return inflight_; }
+
+    void credit(size_t n) {
+        credits_ += n;
+        inflight_ -= std::min(inflight_, n);
+        while (n-- && !unacknowledged_.empty()) {
+            unacknowledged_.pop_front();
+        }
+    }
+
+    void debit(size_t n) {
+        ASSERT(credits_ >= n);
+        credits_ -= n;
+        inflight_ += n;
+    }
+
+    // A copy of each message sent is kept until the worker returns its credit, to be sent to another worker if this
+    // one is lost
+
+    void sent(std::vector<char>&& message) { unacknowledged_.push_back(std::move(message)); }
+
+    size_t takeBack(std::deque<std::vector<char>>& messages) {
+        size_t n = unacknowledged_.size();
+        for (auto& m : unacknowledged_) {
+            messages.push_back(std::move(m));
+        }
+        unacknowledged_.clear();
+        return n;
+    }
+
     void disconnect() {
         active_ = false;
         select_.remove(socket_);
@@ -90,7 +135,14 @@ TCPTransport::TCPTransport(const option::CmdArgs &args):
     nextId_(0),
     master_(false),
     worker_(false),
-    writer_(false) {
+    writer_(false),
+    batch_(Actor::WORK, batchSize_),
+    batchCount_(0),
+    batchTarget_(nullptr),
+    frame_(Actor::WORK, batchSize_),
+    frameLeft_(0),
+    consumed_(0),
+    granted_(false) {
 
 
     size_t port = 7777;
@@ -141,30 +193,192 @@ void TCPTransport::initialise() {
 void TCPTransport::synchronise() {
 }
 
+// Producer to worker protocol, with credit-based flow control:
+//
+//  - the worker sends READY with a number of credits: the size of its queue on its first request, then the number
+//    of messages consumed since;
+//  - the producer sends messages against credits, either one message (WORK, size, blob), or a frame batching small
+//    messages up to batchSize_ bytes (BATCH, count, size, blob of (size, blob) pairs);
+//  - at the end, the producer sends SHUTDOWN, queued after the last messages.
+//
+// The producer keeps a copy of the messages sent to a worker until their credits are returned. The messages of a
+// worker that is lost are sent to the others; a worker lost between consuming a message and returning its credit
+// gets it sent twice.
+
 void TCPTransport::sendMessageToNextWorker(const Message &message) {
-    while (!send(message)) {
-        cleanup();
-        Log::info() << TimeStamp()
-                  << " "
-                  << title()
-                  << ", resending..."
-                  << std::endl;
-        if (connections_.empty()) {
-            throw  SeriousBug("TCPTransport: no more workers");
+
+    statistics_.sendCount_++;
+    statistics_.sendSize_ += message.messageSize();
+
+    send(message.messageData(), message.messageSize());
+
+    resend();
+}
+
+void TCPTransport::send(const void* data, size_t size) {
+
+    const char* p = static_cast<const char*>(data);
+
+    // Keep batching for the current target while it has credits, otherwise send what is batched before
+    // (possibly) waiting for credits
+
+    pollCredits(0);
+    Connection* worker = findWorker(1);
+    if (batchCount_ && worker != batchTarget_) {
+        flushBatch();
+    }
+
+    if (size >= batchSize_) {
+        flushBatch();
+        for (;;) {
+            Connection& connection = nextWorker(1);
+            debit(connection, 1);
+            if (sendFrame(connection, data, size, 0)) {
+                connection.sent(std::vector<char>(p, p + size));
+                return;
+            }
+            resending();
         }
     }
+
+    Connection& connection = nextWorker(1);
+    debit(connection, 1);
+
+    batch_ << size;
+    batch_.writeBlob(data, size);
+    batched_.emplace_back(p, p + size);
+    batchCount_++;
+    batchTarget_ = &connection;
+
+    // Send when the frame is full, or when no more can be added to it. A worker waits at most for as many messages
+    // as it has credits, use batch-size=0 where latency matters more than throughput
+
+    if (connection.credits() == 0 || batch_.messageSize() >= batchSize_) {
+        flushBatch();
+    }
 }
 
+void TCPTransport::resend() {
+    while (!resend_.empty()) {
+        std::vector<char> message = std::move(resend_.front());
+        resend_.pop_front();
+        send(message.data(), message.size());
+        statistics_.resendCount_++;
+    }
+}
+
+void TCPTransport::flushBatch() {
+
+    if (!batchCount_) {
+        return;
+    }
+
+    Connection* connection = batchTarget_;
+    while (!sendFrame(*connection, batch_.messageData(), batch_.messageSize(), batchCount_)) {
+        resending();
+        batchTarget_ = nullptr;
+        connection   = &nextWorker(batchCount_);
+        debit(*connection, batchCount_);
+    }
+
+    for (auto& m : batched_) {
+        connection->sent(std::move(m));
+    }
+    batched_.clear();
+
+    batch_.rewind();
+    batchCount_  = 0;
+    batchTarget_ = nullptr;
+}
 
-bool TCPTransport::send(const Message &message) {
+bool TCPTransport::sendFrame(Connection& connection, const void* data, size_t size, size_t count) {
+    try {
+        eckit::AutoTiming timing(statistics_.sendTiming_);
+
+        if (count == 0) {
+            connection << size_t(Actor::WORK);
+        }
+        else {
+            connection << size_t(Actor::BATCH);
+            connection << count;
+        }
+        connection << size;
+        connection.writeBlob(data, size);
+
+        statistics_.frameCount_++;
+        return true;
+
+    } catch (std::exception &e) {
+        disconnect(e, connection);
+        return false;
+    }
+}
+
+void TCPTransport::debit(Connection& connection, size_t count) {
+    connection.debit(count);
+    statistics_.maxQueueDepth_ = std::max(statistics_.maxQueueDepth_, connection.inflight());
+    statistics_.queueDepth_ += connection.inflight();
+}
 
+void TCPTransport::resending() {
     cleanup();
+    Log::info() << TimeStamp()
+              << " "
+              << title()
+              << ", resending..."
+              << std::endl;
+    if (connections_.empty()) {
+        throw  SeriousBug("TCPTransport: no more workers");
+    }
+}
 
-    bool more = true;
-    while (more) {
-        more = false;
+Connection* TCPTransport::findWorker(size_t credits) const {
 
-        while (!select_.ready(30)) {
+    if (batchTarget_ && batchTarget_->active() && batchTarget_->credits() >= credits) {
+        return batchTarget_;
+    }
+
+    Connection* best = nullptr;
+    for (auto j = connections_.begin(); j != connections_.end(); ++j) {
+        Connection* connection = *j;
+        if (connection->active() && connection->credits() >= credits) {
+            if (!best || connection->credits() > best->credits()) {
+                best = connection;
+            }
+        }
+    }
+    return best;
+}
+
+Connection& TCPTransport::nextWorker(size_t credits) {
+
+    pollCredits(0);
+
+    Connection* worker = findWorker(credits);
+    if (worker) {
+        return *worker;
+    }
+
+    // Stall: all workers are busy
+
+    eckit::AutoTiming timing(statistics_.stallTiming_);
+    statistics_.stallCount_++;
+
+    while (!(worker = findWorker(credits))) {
+        cleanup();
+        if (connections_.empty()) {
+            throw  SeriousBug("TCPTransport: no more workers");
+        }
+        pollCredits(30);
+    }
+
+    return *worker;
+}
+
+void TCPTransport::pollCredits(long timeout) {
+
+    if (!select_.ready(timeout)) {
+        if (timeout) {
             Log::info() <<  TimeStamp()
                       << " "
                       << title()
@@ -173,14 +387,14 @@ bool TCPTransport::send(const Message &message) {
                       << " still active"
                       << std::endl;
         }
+        return;
+    }
 
-        if (select_.set(*accept_)) {
-            accept();
-            more = true;
-        }
+    if (select_.set(*accept_)) {
+        accept();
     }
 
-    for (auto j = connections_.rbegin(); j != connections_.rend(); ++j) {
+    for (auto j = connections_.begin(); j != connections_.end(); ++j) {
         Connection &connection = **j;
         if (connection.ready()) {
             try {
@@ -190,30 +404,15 @@ bool TCPTransport::send(const Message &message) {
 
                 ASSERT(tag == Actor::READY);
 
-                // Log::info() << TimeStamp()
-                //           << " "
-                //           << title()
-                //           << " sending to worker "
-                //           << connection.id()
-                //           << " tag " << message.tag()
-                //           << std::endl;
-
-                connection << size_t(message.tag());
-                connection << message.messageSize();
-                connection.writeBlob(message.messageData(), message.messageSize());
-
-                // Next time, we consider other connections first
-                std::swap(*j, connections_[0]);
-
-                return true;
+                size_t credits;
+                connection >> credits;
+                connection.credit(credits);
 
             } catch (std::exception &e) {
                 disconnect(e, connection);
-                continue;
             }
         }
     }
-    return false;
 }
 
 
@@ -250,43 +449,85 @@ void TCPTransport::getNextWorkMessage(Message &message) {
 
     auto& connection = producerConnection();
 
-    Log::info() << TimeStamp()
-              << " "
-              << title()
-              << " TCPTransport::getNextWorkMessage -> send"
-              << std::endl;
+    if (frameLeft_ == 0) {
 
-    connection << size_t(Actor::READY);
+        // Return the credits before waiting for more work, so the producer can refill the queue
 
-    size_t tag;
-    connection >> tag;
-    Log::info() << TimeStamp()
-              << " "
-              << title()
-              << " TCPTransport::getNextWorkMessage got reply"
-              << std::endl;
+        grantCredits(connection);
 
-    size_t size;
+        eckit::AutoTiming timing(statistics_.receiveTiming_);
 
-    switch (tag) {
+        size_t tag;
+        connection >> tag;
 
-    case Actor::WORK:
-        connection >> size;
-        ASSERT(size <= message.bufferSize());
-        connection.readBlob(message.messageData(), size);
-        break;
+        switch (tag) {
 
-    case Actor::SHUTDOWN:
-        break;
+        case Actor::WORK: {
+            // Single message, read in place
+            size_t size;
+            connection >> size;
+            message.reserve(size);
+            connection.readBlob(message.messageData(), size);
+            received(message, connection.id(), size);
+            return;
+        }
+
+        case Actor::BATCH: {
+            size_t size;
+            connection >> frameLeft_;
+            connection >> size;
+
+            ASSERT(frameLeft_ > 0);
+
+            frame_.reserve(size);
+            connection.readBlob(frame_.messageData(), size);
+            frame_.rewind();
+            break;
+        }
 
-    default:
-        ASSERT(tag == Actor::WORK || tag == Actor::SHUTDOWN);
-        break;
+        case Actor::SHUTDOWN:
+            message.rewind();
+            message.messageReceived(tag, connection.id());
+            return;
+
+        default:
+            ASSERT(tag == Actor::WORK || tag == Actor::BATCH || tag == Actor::SHUTDOWN);
+            break;
+        }
+    }
+    else if (consumed_ >= credits_ / 2) {
+        grantCredits(connection);
     }
 
+    size_t size;
+    frame_ >> size;
+    message.reserve(size);
+    frame_.readBlob(message.messageData(), size);
+    frameLeft_--;
+
+    received(message, connection.id(), size);
+}
+
+void TCPTransport::received(Message &message, size_t source, size_t size) {
+    consumed_++;
+    statistics_.receiveCount_++;
+    statistics_.receiveSize_ += size;
+
     message.rewind();
-    message.messageReceived(tag, connection.id());
+    message.messageReceived(Actor::WORK, source);
+}
 
+void TCPTransport::grantCredits(Connection& connection) {
+
+    size_t credits = granted_ ? consumed_ : credits_;
+
+    if (credits) {
+        connection << size_t(Actor::READY);
+        connection << credits;
+    }
+
+    consumed_ = 0;
+    granted_  = true;
 }
 
 void TCPTransport::sendStatisticsToProducer(const Message &message) {
@@ -392,33 +633,62 @@ void TCPTransport::disconnect(std::exception& e, Connection& connection) const {
 
     disconnect(connection);
 
+    size_t n = connection.takeBack(resend_);
+    if (n) {
+        Log::info() << TimeStamp()
+                    << " "
+                    << title()
+                    << ", taking back "
+                    << Plural(n, "message")
+                    << " sent to worker "
+                    << connection.id()
+                    << std::endl;
+    }
 }
 
 
 void TCPTransport::sendShutDownMessage(const Actor& actor) {
 
+    eckit::AutoTiming timing(statistics_.shutdownTiming_);
+
+    flushBatch();
+
+    // Messages sent to workers lost by now go to the others before these are shut down
+    pollCredits(0);
+    resend();
+    flushBatch();
+
     select_.remove(*accept_);
 
-    while (connections_.size()) {
+    // SHUTDOWN is queued after the last frames sent to each worker
 
-        bool more = true;
-        while (more) {
-            more = false;
-
-            while (!select_.ready(30)) {
-                Log::info() <<  TimeStamp()
-                          << " "
-                          << title()
-                          << ", waiting... "
-                          << Plural(connections_.size(), "worker")
-                          << " still active"
-                          << std::endl;
-            }
+    for (auto j = connections_.begin(); j != connections_.end(); ++j) {
+        Connection &connection = **j;
+        try {
+            Log::info() << TimeStamp()
+                      << " "
+                      << title()
+                      << " shutdown worker "
+                      << connection.id()
+                      << std::endl;
+            connection << size_t(Actor::SHUTDOWN);
+        } catch (std::exception &e) {
+            disconnect(e, connection);
+        }
+    }
+
+    cleanup();
+
+    while (connections_.size()) {
 
-            // if (select_.set(*accept_)) {
-            //     accept();
-            //     more = true;
-            // }
+        while (!select_.ready(30)) {
+            Log::info() <<  TimeStamp()
+                      << " "
+                      << title()
+                      << ", waiting... "
+                      << Plural(connections_.size(), "worker")
+                      << " still active"
+                      << std::endl;
         }
 
         Log::info() << TimeStamp()
@@ -445,13 +715,9 @@ void TCPTransport::sendShutDownMessage(const Actor& actor) {
                     switch (tag) {
 
                     case Actor::READY:
-                        Log::info() << TimeStamp()
-                                  << " "
-                                  << title()
-                                  << " shutdown worker "
-                                  << connection.id()
-                                  << std::endl;
-                        connection << size_t(Actor::SHUTDOWN);
+                        // credits returned while the last frames were consumed
+                        connection >> size;
+                        connection.credit(size);
                         break;
 
                     case Actor::STATISTICS:
@@ -476,6 +742,18 @@ void TCPTransport::sendShutDownMessage(const Actor& actor) {
 
         cleanup();
     }
+
+    if (!resend_.empty()) {
+        Log::error() << TimeStamp()
+                     << " "
+                     << title()
+                     << ", "
+                     << Plural(resend_.size(), "message")
+                     << " lost, no worker left to send them to"
+                     << std::endl;
+        statistics_.lostCount_ += resend_.size();
+        resend_.clear();
+    }
 }
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -16,12 +16,14 @@
 #ifndef eckit_TCPTransport_H
 #define eckit_TCPTransport_H
 
-#include <vector>
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "eckit/net/TCPServer.h"
 #include "eckit/io/Select.h"
 
+#include "eckit/distributed/Message.h"
 #include "eckit/distributed/Transport.h"
 
 namespace eckit {
@@ -35,8 +37,6 @@ class CmdArgs;
 
 namespace eckit::distributed {
 
-class Message;
-
 //----------------------------------------------------------------------------------------------------------------------
 
 class Connection;
@@ -83,9 +83,23 @@ private: // members
     void accept();
     void connect();
 
-    bool send(const Message &message);
     void cleanup();
 
+    // Producer side
+    void send(const void* data, size_t size);
+    void resend();
+    void flushBatch();
+    bool sendFrame(Connection&, const void* data, size_t size, size_t count);  // count 0 for a single message
+    void debit(Connection&, size_t count);
+    void resending();
+    Connection* findWorker(size_t credits) const;
+    Connection& nextWorker(size_t credits);
+    void pollCredits(long timeout);
+
+    // Worker side
+    void received(Message &message, size_t source, size_t size);
+    void grantCredits(Connection&);
+
     mutable std::unique_ptr<Connection> producer_;
 
     mutable std::unique_ptr<eckit::net::TCPServer> accept_;
@@ -100,6 +114,21 @@ private: // members
     bool worker_;
     bool writer_;
 
+    // Producer side: messages batched for the next frame
+    Message batch_;
+    size_t batchCount_;
+    Connection* batchTarget_;
+    std::vector<std::vector<char>> batched_;
+
+    // Producer side: messages taken back from lost workers, to send to the others
+    mutable std::deque<std::vector<char>> resend_;
+
+    // Worker side: the last frame received, and credits to return
+    Message frame_;
+    size_t frameLeft_;
+    size_t consumed_;
+    bool granted_;
+
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -16,6 +16,7 @@
 #include "eckit/config/Resource.h"
 #include "eckit/filesystem/FileSpace.h"
 #include "eckit/filesystem/FileSpaceStrategies.h"
+#include "eckit/filesystem/FileSystemSizeCache.h"
 #include "eckit/io/cluster/ClusterDisks.h"
 #include "eckit/thread/AutoLock.h"
 #include "eckit/thread/StaticMutex.h"
@@ -50,7 +51,7 @@ const PathName& FileSpace::selectFileSystem(const std::string& s) const {
         throw Retry(std::string("FileSpace [") + name_ + "] is empty");
     }
 
-    return FileSpaceStrategies::selectFileSystem(fileSystems_, s);
+    return FileSpaceStrategies::selectFileSystem(fileSystems_, s, maxAge());
 }
 
 const std::string& FileSpace::selectionStrategy() const {
@@ -69,6 +70,22 @@ const std::string& FileSpace::selectionStrategy() const {
     return strategy_;
 }
 
+double FileSpace::maxAge() const {
+    if (maxAge_ >= 0) {
+        return maxAge_;
+    }
+
+    static double maxAge = Resource<double>("fileSystemSizeMaxAge", 0);
+
+    maxAge_ = Resource<double>(std::string(name_ + "FileSystemSizeMaxAge").c_str(), maxAge);
+
+    return maxAge_;
+}
+
+void FileSpace::reserve(const PathName& fileSystem, unsigned long long bytes) const {
+    FileSystemSizeCache::instance().reserve(fileSystem, bytes);
+}
+
 const PathName& FileSpace::selectFileSystem() const {
     return selectFileSystem(selectionStrategy());
 }
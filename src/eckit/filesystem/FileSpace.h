@@ -36,6 +36,12 @@ public:  // methods
 
     const std::string& selectionStrategy() const;
 
+    /// How old, in seconds, the sizes of the filesystems may be when selecting one (0: always read them)
+    double maxAge() const;
+
+    /// Accounts for bytes about to be written to one of the filesystems, until its size is read again
+    void reserve(const PathName& fileSystem, unsigned long long bytes) const;
+
     const std::string& name() const { return name_; }
 
     static bool exists(const std::string&);
@@ -56,6 +62,7 @@ private:  // members
     std::vector<PathName> fileSystems_;
 
     mutable std::string strategy_;  ///< default strategy to use when selecting filesystem
+    mutable double maxAge_ = -1;    ///< of the filesystem sizes, negative until read
 };
 
 
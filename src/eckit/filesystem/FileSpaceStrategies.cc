@@ -15,6 +15,7 @@
 
 #include "eckit/config/Resource.h"
 #include "eckit/filesystem/FileSpaceStrategies.h"
+#include "eckit/filesystem/FileSystemSizeCache.h"
 #include "eckit/log/Bytes.h"
 
 namespace eckit {
@@ -56,33 +57,34 @@ struct Candidate {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-const PathName& FileSpaceStrategies::selectFileSystem(const std::vector<PathName>& fileSystems, const std::string& s) {
+const PathName& FileSpaceStrategies::selectFileSystem(const std::vector<PathName>& fileSystems, const std::string& s,
+                                                      double maxAge) {
     Log::info() << "FileSpace::selectFileSystem is " << s << std::endl;
 
     if (s == "roundRobin") {
-        return FileSpaceStrategies::roundRobin(fileSystems);
+        return FileSpaceStrategies::roundRobin(fileSystems, maxAge);
     }
 
     if (s == "weightedRandom") {
-        return FileSpaceStrategies::weightedRandom(fileSystems);
+        return FileSpaceStrategies::weightedRandom(fileSystems, maxAge);
     }
 
     if (s == "pureRandom") {
-        return FileSpaceStrategies::pureRandom(fileSystems);
+        return FileSpaceStrategies::pureRandom(fileSystems, maxAge);
     }
 
     if (s == "weightedRandomPercent") {
-        return FileSpaceStrategies::weightedRandomPercent(fileSystems);
+        return FileSpaceStrategies::weightedRandomPercent(fileSystems, maxAge);
     }
 
     if (s == "leastUsedPercent") {
-        return FileSpaceStrategies::leastUsedPercent(fileSystems);
+        return FileSpaceStrategies::leastUsedPercent(fileSystems, maxAge);
     }
 
-    return FileSpaceStrategies::leastUsed(fileSystems);
+    return FileSpaceStrategies::leastUsed(fileSystems, maxAge);
 }
 
-const PathName& FileSpaceStrategies::leastUsed(const std::vector<PathName>& fileSystems) {
+const PathName& FileSpaceStrategies::leastUsed(const std::vector<PathName>& fileSystems, double maxAge) {
     unsigned long long free = 0;
     Ordinal best            = 0;
     Ordinal checked         = 0;
@@ -95,7 +97,7 @@ const PathName& FileSpaceStrategies::leastUsed(const std::vector<PathName>& file
             FileSystemSize fs;
 
             try {
-                fileSystems[i].fileSystemSize(fs);
+                FileSystemSizeCache::instance().fileSystemSize(fileSystems[i], fs, maxAge);
             }
             catch (std::exception& e) {
                 Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
@@ -122,7 +124,7 @@ const PathName& FileSpaceStrategies::leastUsed(const std::vector<PathName>& file
     return fileSystems[best];
 }
 
-const PathName& FileSpaceStrategies::leastUsedPercent(const std::vector<PathName>& fileSystems) {
+const PathName& FileSpaceStrategies::leastUsedPercent(const std::vector<PathName>& fileSystems, double maxAge) {
     long percent = 0;
     size_t best  = 0;
 
@@ -136,7 +138,7 @@ const PathName& FileSpaceStrategies::leastUsedPercent(const std::vector<PathName
             FileSystemSize fs;
 
             try {
-                fileSystems[i].fileSystemSize(candidate.size_);
+                FileSystemSizeCache::instance().fileSystemSize(fileSystems[i], candidate.size_, maxAge);
             }
             catch (std::exception& e) {
                 Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
@@ -177,7 +179,7 @@ static void computeNull(Candidate& c) {
 }
 
 static std::vector<Candidate> findCandidates(const std::vector<PathName>& fileSystems,
-                                             compute_probability_t probability) {
+                                             compute_probability_t probability, double maxAge) {
 
     ASSERT(fileSystems.size() != 0);
 
@@ -192,7 +194,7 @@ static std::vector<Candidate> findCandidates(const std::vector<PathName>& fileSy
         if (fileSystems[i].available()) {
 
             try {
-                fileSystems[i].fileSystemSize(candidate.size_);
+                FileSystemSizeCache::instance().fileSystemSize(fileSystems[i], candidate.size_, maxAge);
             }
             catch (std::exception& e) {
                 Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
@@ -220,11 +222,11 @@ static std::vector<Candidate> findCandidates(const std::vector<PathName>& fileSy
     return result;
 }
 
-const PathName& FileSpaceStrategies::roundRobin(const std::vector<PathName>& fileSystems) {
-    std::vector<Candidate> candidates = findCandidates(fileSystems, &computeNull);
+const PathName& FileSpaceStrategies::roundRobin(const std::vector<PathName>& fileSystems, double maxAge) {
+    std::vector<Candidate> candidates = findCandidates(fileSystems, &computeNull, maxAge);
 
     if (candidates.empty()) {
-        return leastUsed(fileSystems);
+        return leastUsed(fileSystems, maxAge);
     }
 
     static long value = -1;
@@ -334,11 +336,11 @@ static const PathName& chooseByProbabylity(const char* strategy, const std::vect
     return select->path();
 }
 
-const PathName& FileSpaceStrategies::pureRandom(const std::vector<PathName>& fileSystems) {
-    std::vector<Candidate> candidates = findCandidates(fileSystems, &computeIdentity);
+const PathName& FileSpaceStrategies::pureRandom(const std::vector<PathName>& fileSystems, double maxAge) {
+    std::vector<Candidate> candidates = findCandidates(fileSystems, &computeIdentity, maxAge);
 
     if (candidates.empty()) {
-        return leastUsed(fileSystems);
+        return leastUsed(fileSystems, maxAge);
     }
 
     attenuateProbabilities(candidates); /* has no effect */
@@ -346,11 +348,11 @@ const PathName& FileSpaceStrategies::pureRandom(const std::vector<PathName>& fil
     return chooseByProbabylity("pureRandom", candidates);
 }
 
-const PathName& FileSpaceStrategies::weightedRandom(const std::vector<PathName>& fileSystems) {
-    std::vector<Candidate> candidates = findCandidates(fileSystems, &computeAvailable);
+const PathName& FileSpaceStrategies::weightedRandom(const std::vector<PathName>& fileSystems, double maxAge) {
+    std::vector<Candidate> candidates = findCandidates(fileSystems, &computeAvailable, maxAge);
 
     if (candidates.empty()) {
-        return leastUsed(fileSystems);
+        return leastUsed(fileSystems, maxAge);
     }
 
     attenuateProbabilities(candidates);
@@ -358,11 +360,11 @@ const PathName& FileSpaceStrategies::weightedRandom(const std::vector<PathName>&
     return chooseByProbabylity("weightedRandom", candidates);
 }
 
-const PathName& FileSpaceStrategies::weightedRandomPercent(const std::vector<PathName>& fileSystems) {
-    std::vector<Candidate> candidates = findCandidates(fileSystems, &computePercent);
+const PathName& FileSpaceStrategies::weightedRandomPercent(const std::vector<PathName>& fileSystems, double maxAge) {
+    std::vector<Candidate> candidates = findCandidates(fileSystems, &computePercent, maxAge);
 
     if (candidates.empty()) {
-        return leastUsed(fileSystems);
+        return leastUsed(fileSystems, maxAge);
     }
 
     attenuateProbabilities(candidates);
@@ -23,16 +23,20 @@ namespace eckit {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// Strategies to select one of the filesystems of a FileSpace. Their sizes are read each time, or taken from the
+/// FileSystemSizeCache when they may be up to maxAge seconds old.
+
 class FileSpaceStrategies : private NonCopyable {
 public:
-    static const PathName& selectFileSystem(const std::vector<PathName>& fileSystems, const std::string& s);
-
-    static const PathName& leastUsed(const std::vector<PathName>& fileSystems);
-    static const PathName& leastUsedPercent(const std::vector<PathName>& fileSystems);
-    static const PathName& roundRobin(const std::vector<PathName>& fileSystems);
-    static const PathName& pureRandom(const std::vector<PathName>& fileSystems);
-    static const PathName& weightedRandom(const std::vector<PathName>& fileSystems);
-    static const PathName& weightedRandomPercent(const std::vector<PathName>& fileSystems);
+    static const PathName& selectFileSystem(const std::vector<PathName>& fileSystems, const std::string& s,
+                                            double maxAge = 0);
+
+    static const PathName& leastUsed(const std::vector<PathName>& fileSystems, double maxAge = 0);
+    static const PathName& leastUsedPercent(const std::vector<PathName>& fileSystems, double maxAge = 0);
+    static const PathName& roundRobin(const std::vector<PathName>& fileSystems, double maxAge = 0);
+    static const PathName& pureRandom(const std::vector<PathName>& fileSystems, double maxAge = 0);
+    static const PathName& weightedRandom(const std::vector<PathName>& fileSystems, double maxAge = 0);
+    static const PathName& weightedRandomPercent(const std::vector<PathName>& fileSystems, double maxAge = 0);
 };
 
 //----------------------------------------------------------------------------------------------------------------------
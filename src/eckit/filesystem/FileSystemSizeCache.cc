@@ -0,0 +1,203 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/filesystem/FileSystemSizeCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/log/Log.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/Thread.h"
+#include "eckit/thread/ThreadControler.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class FileSystemSizeRefresh : public Thread {
+    void run() override {
+        FileSystemSizeCache& cache = FileSystemSizeCache::instance();
+        for (;;) {
+            double period = 1;
+            {
+                AutoLock<Mutex> lock(cache.mutex_);
+                for (const auto& e : cache.entries_) {
+                    if (e.second.maxAge > 0) {
+                        period = std::min(period, e.second.maxAge / 2);
+                    }
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::duration<double>(period));
+            cache.refresh();
+        }
+    }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+FileSystemSizeCache& FileSystemSizeCache::instance() {
+    // Never deleted, the refresh thread may outlive static destruction
+    static FileSystemSizeCache* cache = new FileSystemSizeCache();
+    return *cache;
+}
+
+FileSystemSizeCache::FileSystemSizeCache() :
+    stat_([](const PathName& path, FileSystemSize& fs) { path.fileSystemSize(fs); }) {}
+
+double FileSystemSizeCache::now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FileSystemSizeCache::fileSystemSize(const PathName& path, FileSystemSize& fs, double maxAge) {
+    if (maxAge <= 0) {
+        Stat stat;
+        {
+            AutoLock<Mutex> lock(mutex_);
+            stat = stat_;
+        }
+        stat(path, fs);
+        return;
+    }
+
+    std::string key = path.asString();
+
+    {
+        AutoLock<Mutex> lock(mutex_);
+        auto j   = entries_.find(key);
+        double t = now();
+        if (j != entries_.end() && j->second.updated > 0 && t - j->second.updated <= maxAge) {
+            Entry& e     = j->second;
+            e.used       = t;
+            e.maxAge     = e.maxAge > 0 ? std::min(e.maxAge, maxAge) : maxAge;
+            fs.total     = e.size.total;
+            fs.available = e.size.available > e.reserved ? e.size.available - e.reserved : 0;
+            return;
+        }
+    }
+
+    startRefresh();
+
+    Entry e      = update(path, maxAge);
+    fs.total     = e.size.total;
+    fs.available = e.size.available > e.reserved ? e.size.available - e.reserved : 0;
+}
+
+FileSystemSizeCache::Entry FileSystemSizeCache::update(const PathName& path, double maxAge) {
+    std::string key = path.asString();
+
+    Stat stat;
+    unsigned long long reserved = 0;
+    {
+        AutoLock<Mutex> lock(mutex_);
+        stat   = stat_;
+        auto j = entries_.find(key);
+        if (j != entries_.end()) {
+            reserved = j->second.reserved;
+        }
+    }
+
+    // Not under the lock, this may be slow
+    FileSystemSize size;
+    try {
+        stat(path, size);
+    }
+    catch (...) {
+        AutoLock<Mutex> lock(mutex_);
+        auto j = entries_.find(key);
+        if (j != entries_.end()) {
+            j->second.updated = 0;
+        }
+        throw;
+    }
+
+    AutoLock<Mutex> lock(mutex_);
+    Entry& e  = entries_[key];
+    e.size    = size;
+    e.updated = now();
+    if (maxAge > 0) {
+        e.used   = e.updated;
+        e.maxAge = e.maxAge > 0 ? std::min(e.maxAge, maxAge) : maxAge;
+    }
+    // What was reserved before the size was read is now accounted for
+    e.reserved -= std::min(e.reserved, reserved);
+    return e;
+}
+
+void FileSystemSizeCache::reserve(const PathName& path, unsigned long long bytes) {
+    AutoLock<Mutex> lock(mutex_);
+    auto j = entries_.find(path.asString());
+    if (j != entries_.end()) {
+        j->second.reserved += bytes;
+    }
+}
+
+void FileSystemSizeCache::clear() {
+    AutoLock<Mutex> lock(mutex_);
+    entries_.clear();
+}
+
+void FileSystemSizeCache::stat(Stat stat) {
+    AutoLock<Mutex> lock(mutex_);
+    stat_ = stat;
+    entries_.clear();
+}
+
+void FileSystemSizeCache::startRefresh() {
+    static bool background = Resource<bool>("fileSystemSizeBackgroundRefresh", true);
+    if (!background) {
+        return;
+    }
+
+    AutoLock<Mutex> lock(mutex_);
+    if (refreshing_) {
+        return;
+    }
+
+    refreshing_ = true;
+    ThreadControler t(new FileSystemSizeRefresh());
+    t.start();
+}
+
+void FileSystemSizeCache::refresh() {
+    std::vector<std::string> paths;
+    {
+        AutoLock<Mutex> lock(mutex_);
+        double t = now();
+        for (auto j = entries_.begin(); j != entries_.end();) {
+            // Filesystems no longer selected from are forgotten
+            if (t - j->second.used > std::max(60., 100 * j->second.maxAge)) {
+                j = entries_.erase(j);
+                continue;
+            }
+            if (t - j->second.updated >= j->second.maxAge / 2) {
+                paths.push_back(j->first);
+            }
+            ++j;
+        }
+    }
+
+    for (const auto& p : paths) {
+        try {
+            update(PathName(p), 0);
+        }
+        catch (std::exception& e) {
+            Log::warning() << "Cannot refresh size of " << p << ": " << e.what() << std::endl;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
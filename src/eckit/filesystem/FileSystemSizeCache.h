@@ -0,0 +1,88 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   FileSystemSizeCache.h
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+
+#include "eckit/filesystem/FileSystemSize.h"
+#include "eckit/memory/NonCopyable.h"
+#include "eckit/thread/Mutex.h"
+
+namespace eckit {
+
+class PathName;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Sizes of filesystems shared by the FileSpace selection strategies, so that a selection does not statvfs every
+/// candidate. Sizes are served while younger than the maximum age given by the caller, and a background thread
+/// refreshes the ones in use at half their smallest such age, so that callers seldom wait for a statvfs.
+///
+/// Bytes handed out on a filesystem since its last refresh can be reserved, and are deducted from its available space
+/// until a refresh accounts for them.
+
+class FileSystemSizeCache : private NonCopyable {
+public:  // types
+    typedef std::function<void(const PathName&, FileSystemSize&)> Stat;
+
+public:  // methods
+    static FileSystemSizeCache& instance();
+
+    /// Size of the filesystem of the path, at most maxAge seconds old, less the bytes reserved on it.
+    /// With a maxAge of 0, the size is always read and nothing is cached.
+    void fileSystemSize(const PathName&, FileSystemSize&, double maxAge);
+
+    /// Accounts for bytes about to be written on the filesystem of the path
+    void reserve(const PathName&, unsigned long long bytes);
+
+    /// Forgets all sizes and reservations
+    void clear();
+
+    /// Sets how sizes are read, PathName::fileSystemSize by default (e.g. to simulate slow filesystems)
+    void stat(Stat);
+
+private:  // types
+    struct Entry {
+        FileSystemSize size;
+        unsigned long long reserved = 0;
+        double updated              = 0;  ///< When the size was read
+        double used                 = 0;  ///< When the size was last asked for
+        double maxAge               = 0;  ///< Smallest asked for
+    };
+
+private:  // methods
+    FileSystemSizeCache();
+
+    /// Reads the size, and records it as used with this maximum age if positive
+    Entry update(const PathName&, double maxAge);
+    void startRefresh();
+    void refresh();
+
+    static double now();
+
+    friend class FileSystemSizeRefresh;
+
+private:  // members
+    Mutex mutex_;
+    std::map<std::string, Entry> entries_;
+
+    Stat stat_;
+
+    bool refreshing_ = false;  ///< Whether the background refresh is running
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -31,6 +31,7 @@
 #include "eckit/filesystem/BasePathNameT.h"
 #include "eckit/filesystem/PathNameFactory.h"
 #include "eckit/filesystem/StdDir.h"
+#include "eckit/filesystem/TreeWalker.h"
 #include "eckit/io/FileHandle.h"
 #include "eckit/io/Length.h"
 #include "eckit/io/PartFileHandle.h"
@@ -738,6 +739,11 @@ void LocalPathName::children(std::vector<LocalPathName>& files, std::vector<Loca
     }
 }
 
+void LocalPathName::childrenRecursive(std::vector<LocalPathName>& files, std::vector<LocalPathName>& dirs,
+                                      size_t threads) const {
+    TreeWalker(threads).children(*this, files, dirs);
+}
+
 void LocalPathName::touch() const {
     dirName().mkdir();
 
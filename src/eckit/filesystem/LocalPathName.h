@@ -233,6 +233,14 @@ public:  // methods
     /// @param directories vector to be filled with child diretories of path
     void children(std::vector<LocalPathName>& files, std::vector<LocalPathName>& dirs) const;
 
+    /// Get all files and directories below path, sorted, walking the tree with TreeWalker
+    /// Throws FailedSystemCall if a directory below path cannot be read, as children() does
+    /// @param files vector to be filled with files below path
+    /// @param directories vector to be filled with diretories below path
+    /// @param threads number of threads walking the tree, 0 for the resource treeWalkerThreads
+    void childrenRecursive(std::vector<LocalPathName>& files, std::vector<LocalPathName>& dirs,
+                           size_t threads = 1) const;
+
     const std::string& node() const;
 
     /// String representation
@@ -194,7 +194,26 @@ void PathName::children(std::vector<PathName>& files, std::vector<PathName>& dir
     }
 }
 
-void PathName::childrenRecursive(std::vector<PathName>& files, std::vector<PathName>& dirs) const {
+void PathName::childrenRecursive(std::vector<PathName>& files, std::vector<PathName>& dirs, size_t threads) const {
+
+    if (::strcmp(type(), LocalPathName::type()) == 0) {
+        std::vector<LocalPathName> f;
+        std::vector<LocalPathName> d;
+
+        LocalPathName(localPath()).childrenRecursive(f, d, threads);
+
+        files.reserve(files.size() + f.size());
+        for (const auto& j : f) {
+            files.push_back(PathName(j));
+        }
+
+        dirs.reserve(dirs.size() + d.size());
+        for (const auto& j : d) {
+            dirs.push_back(PathName(j));
+        }
+        return;
+    }
+
     std::vector<PathName> f;
     std::vector<PathName> d;
 
@@ -206,7 +225,7 @@ void PathName::childrenRecursive(std::vector<PathName>& files, std::vector<PathN
 
     for (std::vector<PathName>::iterator j = d.begin(); j != d.end(); ++j) {
         dirs.push_back(*j);
-        j->childrenRecursive(files, dirs);
+        j->childrenRecursive(files, dirs, threads);
     }
 }
 
@@ -23,6 +23,7 @@
 #include "eckit/serialisation/Stream.h"
 #include "eckit/types/Types.h"
 
+#include <functional>
 #include <map>
 #include <mutex>
 
@@ -224,7 +225,8 @@ public:
     /// Get child files and directories descending recursively on all sub directories
     /// @param files vector to be filled with child files of path
     /// @param directories vector to be filled with child diretories of path
-    void childrenRecursive(std::vector<PathName>& files, std::vector<PathName>& dirs) const;
+    /// @param threads number of threads walking a local tree, 0 for the resource treeWalkerThreads
+    void childrenRecursive(std::vector<PathName>& files, std::vector<PathName>& dirs, size_t threads = 1) const;
 
     void fileSystemSize(FileSystemSize&) const;
 
@@ -274,4 +276,14 @@ struct VectorPrintSelector<PathName> {
 
 }  // namespace eckit
 
+namespace std {
+
+/// For PathName keys of unordered containers, e.g. eckit::HashMap
+template <>
+struct hash<eckit::PathName> {
+    size_t operator()(const eckit::PathName& p) const { return hash<std::string>()(p.asString()); }
+};
+
+}  // namespace std
+
 #endif
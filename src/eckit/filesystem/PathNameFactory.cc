@@ -13,6 +13,7 @@
 #include "eckit/config/LibEcKit.h"
 #include "eckit/filesystem/BasePathNameT.h"
 #include "eckit/filesystem/LocalPathName.h"
+#include "eckit/system/DeferredPlugins.h"
 #include "eckit/thread/AutoLock.h"
 #include "eckit/thread/StaticMutex.h"
 
@@ -88,16 +89,25 @@ BasePathName* PathNameFactoryImpl::build(const std::string& type, const std::str
         return localBuilder.make(path, tildeIsUserHome);
     }
 
-    AutoLock<StaticMutex> lock(static_mutex_);
+    // The builder may come from a plugin not loaded yet, then look again
+    for (bool retry = true;; retry = false) {
+        {
+            AutoLock<StaticMutex> lock(static_mutex_);
 
-    auto it = builders_.find(type);
-    if (it == builders_.end()) {
-        std::ostringstream ss;
-        ss << "PathNameBuilder '" << type << "' not found";
-        throw SeriousBug(ss.str(), Here());
+            auto it = builders_.find(type);
+            if (it != builders_.end()) {
+                return it->second->make(path, tildeIsUserHome);
+            }
+        }
+
+        if (!retry || !system::loadPluginsForMissingBuilder()) {
+            break;
+        }
     }
 
-    return it->second->make(path, tildeIsUserHome);
+    std::ostringstream ss;
+    ss << "PathNameBuilder '" << type << "' not found";
+    throw SeriousBug(ss.str(), Here());
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,510 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/filesystem/TreeWalker.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <memory>
+
+#include "eckit/eckit.h"
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/log/Log.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/Mutex.h"
+#include "eckit/thread/ThreadPool.h"
+
+#if defined(__linux__) && defined(SYS_getdents64)
+#define ECKIT_TREEWALKER_GETDENTS 1
+#else
+#define ECKIT_TREEWALKER_GETDENTS 0
+#endif
+
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+#define ECKIT_TREEWALKER_STATX 1
+#else
+#define ECKIT_TREEWALKER_STATX 0
+#endif
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/// Reads a directory from its descriptor, one buffer at a time
+class DirectoryReader {
+public:
+    DirectoryReader(int fd, std::vector<char>& buffer) :
+        fd_(fd), buffer_(buffer) {
+#if !ECKIT_TREEWALKER_GETDENTS
+        dir_ = ::fdopendir(::dup(fd));
+        if (!dir_) {
+            throw FailedSystemCall("fdopendir");
+        }
+#endif
+    }
+
+    ~DirectoryReader() {
+#if !ECKIT_TREEWALKER_GETDENTS
+        ::closedir(dir_);
+#endif
+    }
+
+    /// Reads the next buffer, @returns false at the end of the directory
+    bool fill() {
+        position_ = 0;
+#if ECKIT_TREEWALKER_GETDENTS
+        long n = ::syscall(SYS_getdents64, fd_, buffer_.data(), buffer_.size());
+        if (n < 0) {
+            throw FailedSystemCall("getdents64");
+        }
+        length_ = n;
+#else
+        // Entries are packed as (type, name, '\0')
+        length_ = 0;
+        for (;;) {
+            // Where to come back to if the entry does not fit (struct dirent has no d_off on all systems)
+            long where       = ::telldir(dir_);
+            errno            = 0;
+            struct dirent* e = ::readdir(dir_);
+            if (!e) {
+                if (errno) {
+                    throw FailedSystemCall("readdir");
+                }
+                break;
+            }
+            size_t len = ::strlen(e->d_name);
+            if (length_ + len + 2 > buffer_.size()) {
+                ::seekdir(dir_, where);
+                break;
+            }
+#if eckit_HAVE_DIRENT_D_TYPE
+            buffer_[length_] = char(e->d_type);
+#else
+            buffer_[length_] = char(DT_UNKNOWN);
+#endif
+            ::memcpy(&buffer_[length_ + 1], e->d_name, len + 1);
+            length_ += len + 2;
+        }
+#endif
+        return length_ > 0;
+    }
+
+    /// @returns the next name in the buffer, or nullptr at the end of the buffer
+    const char* next(unsigned char& type) {
+        if (position_ >= length_) {
+            return nullptr;
+        }
+#if ECKIT_TREEWALKER_GETDENTS
+        // struct linux_dirent64: inode (8), offset (8), record length (2), type (1), name
+        const char* p = &buffer_[position_];
+        unsigned short reclen;
+        ::memcpy(&reclen, p + 16, sizeof(reclen));
+        type = static_cast<unsigned char>(p[18]);
+        position_ += reclen;
+        return p + 19;
+#else
+        const char* p = &buffer_[position_];
+        type          = static_cast<unsigned char>(p[0]);
+        position_ += ::strlen(p + 1) + 2;
+        return p + 1;
+#endif
+    }
+
+private:
+    int fd_;
+    std::vector<char>& buffer_;
+    size_t length_   = 0;
+    size_t position_ = 0;
+#if !ECKIT_TREEWALKER_GETDENTS
+    DIR* dir_;
+#endif
+};
+
+TreeWalker::Type typeOf(mode_t mode) {
+    if (S_ISREG(mode)) {
+        return TreeWalker::REGULAR;
+    }
+    if (S_ISDIR(mode)) {
+        return TreeWalker::DIRECTORY;
+    }
+    if (S_ISLNK(mode)) {
+        return TreeWalker::LINK;
+    }
+    return TreeWalker::OTHER;
+}
+
+TreeWalker::Type typeOf(unsigned char type) {
+    switch (type) {
+        case DT_REG:
+            return TreeWalker::REGULAR;
+        case DT_DIR:
+            return TreeWalker::DIRECTORY;
+        case DT_LNK:
+            return TreeWalker::LINK;
+        case DT_UNKNOWN:
+            return TreeWalker::UNKNOWN;
+        default:
+            return TreeWalker::OTHER;
+    }
+}
+
+#if ECKIT_TREEWALKER_STATX
+/// Fills the fields of an entry with statx(), restricted to the fields requested
+bool lookupStatx(int fd, const char* name, unsigned fields, TreeWalker::Entry& e) {
+    unsigned mask = STATX_TYPE;
+    mask |= (fields & TreeWalker::MODE) ? STATX_MODE : 0;
+    mask |= (fields & TreeWalker::SIZE) ? STATX_SIZE : 0;
+    mask |= (fields & TreeWalker::TIMES) ? (STATX_ATIME | STATX_MTIME | STATX_CTIME) : 0;
+    mask |= (fields & TreeWalker::INODE) ? STATX_INO : 0;
+    mask |= (fields & TreeWalker::LINKS) ? STATX_NLINK : 0;
+
+    struct statx s;
+    if (::statx(fd, name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &s) != 0) {
+        return false;
+    }
+
+    e.type         = typeOf(mode_t(s.stx_mode));
+    e.mode         = s.stx_mode;
+    e.size         = s.stx_size;
+    e.lastAccess   = s.stx_atime.tv_sec;
+    e.lastModified = s.stx_mtime.tv_sec;
+    e.created      = s.stx_ctime.tv_sec;
+    e.inode        = s.stx_ino;
+    e.links        = s.stx_nlink;
+    return true;
+}
+#endif
+
+/// Fills the fields of an entry with a lookup relative to its directory, @returns false on error, with errno set
+bool lookup(int fd, const char* name, unsigned fields, TreeWalker::Entry& e) {
+#if ECKIT_TREEWALKER_STATX
+    // Set once statx() is found missing (ENOSYS), or denied by a seccomp filter (EPERM): fstatat() from then on
+    static std::atomic<bool> noStatx(false);
+    if (!noStatx.load(std::memory_order_relaxed)) {
+        if (lookupStatx(fd, name, fields, e)) {
+            return true;
+        }
+        if (errno != ENOSYS && errno != EPERM) {
+            return false;
+        }
+        noStatx.store(true, std::memory_order_relaxed);
+    }
+#endif
+
+    struct stat s;
+    if (::fstatat(fd, name, &s, AT_SYMLINK_NOFOLLOW) != 0) {
+        return false;
+    }
+
+    e.type         = typeOf(s.st_mode);
+    e.mode         = s.st_mode;
+    e.size         = s.st_size;
+    e.lastAccess   = s.st_atime;
+    e.lastModified = s.st_mtime;
+    e.created      = s.st_ctime;
+    e.inode        = s.st_ino;
+    e.links        = s.st_nlink;
+    return true;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// State of one walk, shared by the tasks of the thread pool
+class TreeWalk {
+public:
+    TreeWalk(const TreeWalker& walker, TreeVisitor& visitor) :
+        walker_(walker), visitor_(visitor), queued_(0), stop_(false) {
+        if (walker_.threads_ > 1) {
+            pool_.reset(new ThreadPool("TreeWalker", walker_.threads_));
+        }
+    }
+
+    void walk(const std::string& root) {
+        int fd = ::open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            Log::error() << "open(" << root << ")" << Log::syserr << std::endl;
+            throw FailedSystemCall("open(" + root + ")");
+        }
+
+        // Paths of the entries are built by appending to the root, which must not end with a slash
+        std::string prefix(root);
+        while (!prefix.empty() && prefix.back() == '/') {
+            prefix.pop_back();
+        }
+
+        run(fd, prefix, 0);
+
+        if (pool_) {
+            pool_->wait();
+            pool_->waitForThreads();
+        }
+
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    /// A directory, walked by the next available thread
+    void run(const std::string& path, size_t depth) {
+        queued_--;
+        if (stop_) {
+            return;
+        }
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOFOLLOW);
+        if (fd < 0) {
+            try {
+                failed("open", path);
+            }
+            catch (...) {
+                stop();
+            }
+            return;
+        }
+
+        run(fd, path, depth);
+    }
+
+private:
+    void run(int fd, const std::string& path, size_t depth) {
+        try {
+            process(fd, path, depth);
+        }
+        catch (...) {
+            stop();
+        }
+        ::close(fd);
+    }
+
+    /// Records the current exception, the first one is rethrown by walk()
+    void stop() {
+        AutoLock<Mutex> lock(mutex_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+        stop_ = true;
+    }
+
+    /// A directory or an entry below the root cannot be read, with errno set: skipped if the visitor says so
+    void failed(const char* call, const std::string& path) {
+        int err = errno;
+        if (!visitor_.skip(path, err)) {
+            errno = err;
+            throw FailedSystemCall(std::string(call) + "(" + path + ")");
+        }
+    }
+
+    bool queue(const std::string& path, size_t depth);
+
+    void process(int fd, const std::string& path, size_t depth);
+
+private:
+    const TreeWalker& walker_;
+    TreeVisitor& visitor_;
+
+    std::unique_ptr<ThreadPool> pool_;
+    std::atomic<size_t> queued_;
+    std::atomic<bool> stop_;
+
+    Mutex mutex_;
+    std::exception_ptr error_;
+};
+
+class TreeWalkTask : public ThreadPoolTask {
+public:
+    TreeWalkTask(TreeWalk& walk, const std::string& path, size_t depth) :
+        walk_(walk), path_(path), depth_(depth) {}
+
+private:
+    void execute() override { walk_.run(path_, depth_); }
+
+    TreeWalk& walk_;
+    std::string path_;
+    size_t depth_;
+};
+
+bool TreeWalk::queue(const std::string& path, size_t depth) {
+    if (!pool_ || queued_ >= walker_.maxQueued_) {
+        return false;
+    }
+    queued_++;
+    pool_->push(new TreeWalkTask(*this, path, depth));
+    return true;
+}
+
+void TreeWalk::process(int fd, const std::string& path, size_t depth) {
+
+    thread_local std::vector<char> buffer;
+    if (buffer.size() < walker_.bufferSize_) {
+        buffer.resize(walker_.bufferSize_);
+    }
+
+    const unsigned fields = walker_.fields_;
+    const bool stat       = fields & ~unsigned(TreeWalker::TYPE);
+
+    // Subdirectories that could not be queued, walked by this thread once this directory is read
+    std::vector<std::string> deferred;
+
+    std::vector<TreeWalker::Entry> entries;
+
+    {
+        DirectoryReader reader(fd, buffer);
+
+        while (reader.fill() && !stop_) {
+
+            unsigned char type;
+            while (const char* name = reader.next(type)) {
+
+                if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) {
+                    continue;
+                }
+
+                entries.emplace_back();
+                TreeWalker::Entry& e = entries.back();
+
+                e.path.reserve(path.size() + 1 + ::strlen(name));
+                e.path.append(path).append(1, '/').append(name);
+                e.depth = depth + 1;
+                e.type  = typeOf(type);
+
+                if ((stat || e.type == TreeWalker::UNKNOWN) && !lookup(fd, name, fields, e)) {
+                    // An entry removed since the directory was read is simply not there any more
+                    if (errno != ENOENT) {
+                        failed("stat", e.path);
+                    }
+                    entries.pop_back();
+                    continue;
+                }
+
+                if (e.type == TreeWalker::DIRECTORY && visitor_.enter(e) && !queue(e.path, e.depth)) {
+                    deferred.emplace_back(name);
+                }
+            }
+
+            // The entries of a buffer are passed to the visitor before the next one is read,
+            // the visitor may modify the directory
+            if (!entries.empty()) {
+                visitor_.visit(entries);
+                entries.clear();
+            }
+        }
+    }
+
+    for (const auto& name : deferred) {
+        if (stop_) {
+            return;
+        }
+
+        std::string subpath;
+        subpath.reserve(path.size() + 1 + name.size());
+        subpath.append(path).append(1, '/').append(name);
+
+        int sub = ::openat(fd, name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOFOLLOW);
+        if (sub < 0) {
+            failed("open", subpath);
+            continue;
+        }
+
+        run(sub, subpath, depth + 1);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::string TreeWalker::Entry::name() const {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+TreeWalker::TreeWalker(size_t threads, unsigned fields) :
+    threads_(threads ? threads : Resource<size_t>("treeWalkerThreads;$ECKIT_TREE_WALKER_THREADS", 8)),
+    fields_(fields | TYPE),
+    bufferSize_(Resource<size_t>("treeWalkerBufferSize;$ECKIT_TREE_WALKER_BUFFER_SIZE", 256 * 1024)),
+    maxQueued_(Resource<size_t>("treeWalkerMaxQueued;$ECKIT_TREE_WALKER_MAX_QUEUED", 1024)) {
+    ASSERT(threads_ > 0);
+}
+
+void TreeWalker::bufferSize(size_t size) {
+    ASSERT(size >= 4096);
+    bufferSize_ = size;
+}
+
+void TreeWalker::maxQueued(size_t n) {
+    maxQueued_ = n;
+}
+
+void TreeWalker::walk(const LocalPathName& root, TreeVisitor& visitor) const {
+    TreeWalk walk(*this, visitor);
+    walk.walk(root.path());
+}
+
+namespace {
+
+class Collector : public TreeVisitor {
+public:
+    void visit(const std::vector<TreeWalker::Entry>& entries) override {
+        AutoLock<Mutex> lock(mutex_);
+        for (const auto& e : entries) {
+            (e.type == TreeWalker::DIRECTORY ? dirs_ : files_).push_back(e.path);
+        }
+    }
+
+    Mutex mutex_;
+    std::vector<std::string> files_;
+    std::vector<std::string> dirs_;
+};
+
+}  // namespace
+
+void TreeWalker::children(const LocalPathName& root, std::vector<LocalPathName>& files,
+                          std::vector<LocalPathName>& dirs) const {
+    Collector collector;
+    walk(root, collector);
+
+    std::sort(collector.files_.begin(), collector.files_.end());
+    std::sort(collector.dirs_.begin(), collector.dirs_.end());
+
+    files.reserve(files.size() + collector.files_.size());
+    for (const auto& f : collector.files_) {
+        files.emplace_back(f);
+    }
+
+    dirs.reserve(dirs.size() + collector.dirs_.size());
+    for (const auto& d : collector.dirs_) {
+        dirs.emplace_back(d);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TreeVisitor::~TreeVisitor() = default;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,139 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   TreeWalker.h
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "eckit/memory/NonCopyable.h"
+
+namespace eckit {
+
+class LocalPathName;
+class TreeVisitor;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Walks a local directory tree with several threads.
+///
+/// Directories are read with large getdents64() batches (readdir() where not available), and entries are looked up
+/// relative to the descriptor of their directory (openat/fstatat, or statx restricted to the fields requested), so
+/// that no path is resolved more than once. Only the type of the entries is needed by default, which the directory
+/// listing provides on most file systems without a stat at all.
+///
+/// Memory is bounded: at most maxQueued() directories wait for a thread, further directories are walked depth-first
+/// by the thread that found them, and entries are passed to the visitor one directory batch at a time.
+/// Symbolic links are reported, never followed.
+///
+/// A directory that cannot be opened, or an entry that cannot be looked up, stops the walk with FailedSystemCall,
+/// unless TreeVisitor::skip() says otherwise. An entry removed between the read of its directory and its lookup is
+/// left out.
+
+class TreeWalker : private NonCopyable {
+public:  // types
+    enum Type
+    {
+        UNKNOWN,
+        REGULAR,
+        DIRECTORY,
+        LINK,
+        OTHER
+    };
+
+    /// Fields of Entry to fill, besides path and depth
+    enum Fields
+    {
+        TYPE  = 1 << 0,
+        MODE  = 1 << 1,
+        SIZE  = 1 << 2,
+        TIMES = 1 << 3,
+        INODE = 1 << 4,
+        LINKS = 1 << 5,
+        ALL   = TYPE | MODE | SIZE | TIMES | INODE | LINKS
+    };
+
+    struct Entry {
+        std::string path;
+        size_t depth = 0;  ///< 1 for the children of the root
+        Type type    = UNKNOWN;
+
+        mode_t mode            = 0;
+        unsigned long long size = 0;
+        time_t lastAccess      = 0;
+        time_t lastModified    = 0;
+        time_t created         = 0;
+        ino_t inode            = 0;
+        nlink_t links          = 0;
+
+        /// @returns the last component of the path
+        std::string name() const;
+    };
+
+public:  // methods
+    /// @param threads number of threads, resource treeWalkerThreads by default
+    /// @param fields bitmask of Fields
+    explicit TreeWalker(size_t threads = 0, unsigned fields = TYPE);
+
+    size_t threads() const { return threads_; }
+    unsigned fields() const { return fields_; }
+
+    /// Size of the buffer of each directory read, resource treeWalkerBufferSize
+    size_t bufferSize() const { return bufferSize_; }
+    void bufferSize(size_t);
+
+    /// Maximum number of directories queued for the threads, resource treeWalkerMaxQueued
+    size_t maxQueued() const { return maxQueued_; }
+    void maxQueued(size_t);
+
+    /// Walks the tree below root (excluded), the visitor is called concurrently from all threads.
+    /// An exception thrown by the visitor stops the walk and is rethrown.
+    void walk(const LocalPathName& root, TreeVisitor&) const;
+
+    /// Convenience: all files (anything but directories) and directories below root, sorted.
+    /// Throws FailedSystemCall if any directory cannot be read, as LocalPathName::children() does
+    void children(const LocalPathName& root, std::vector<LocalPathName>& files,
+                  std::vector<LocalPathName>& dirs) const;
+
+private:  // members
+    size_t threads_;
+    unsigned fields_;
+    size_t bufferSize_;
+    size_t maxQueued_;
+
+    friend class TreeWalk;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class TreeVisitor {
+public:
+    virtual ~TreeVisitor();
+
+    /// @returns whether to walk below a directory, all directories by default
+    virtual bool enter(const TreeWalker::Entry&) { return true; }
+
+    /// Receives the entries of one directory (directories included), by batches of one buffer
+    virtual void visit(const std::vector<TreeWalker::Entry>&) = 0;
+
+    /// Called when a directory below the root cannot be opened, or an entry cannot be looked up
+    /// @param error the errno of the failure
+    /// @returns whether to leave it out and go on; by default, the walk stops with FailedSystemCall
+    virtual bool skip(const std::string& /*path*/, int /*error*/) { return false; }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
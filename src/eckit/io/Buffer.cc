@@ -12,6 +12,7 @@
 
 #include "eckit/exception/Exceptions.h"
 #include "eckit/io/Buffer.h"
+#include "eckit/memory/BufferPool.h"
 
 namespace eckit {
 
@@ -20,11 +21,11 @@ namespace eckit {
 namespace {
 
 static char* allocate(size_t size) {
-    return new char[size];
+    return BufferPool::allocate(size);
 }
 
-static void deallocate(char* buffer) {
-    delete[] buffer;
+static void deallocate(char* buffer, size_t size) {
+    BufferPool::deallocate(buffer, size);
 }
 
 }  // namespace
@@ -59,7 +60,7 @@ Buffer& Buffer::operator=(Buffer&& rhs) noexcept {
         return *this;
     }
 
-    deallocate(buffer_);
+    deallocate(buffer_, size_);
 
     buffer_ = rhs.buffer_;
     size_   = rhs.size_;
@@ -86,7 +87,7 @@ void Buffer::create() {
 
 void Buffer::destroy() {
     if (buffer_) {
-        deallocate(buffer_);
+        deallocate(buffer_, size_);
         buffer_ = nullptr;
         size_   = 0;
     }
@@ -106,15 +107,21 @@ void Buffer::copy(const void* p, size_t size, size_t pos) {
 
 void Buffer::resize(size_t size, bool preserveData) {
     if (size != size_) {
+        // Within the same pooled block
+        if (buffer_ && BufferPool::pooled(size) && BufferPool::pooled(size_) &&
+            BufferPool::capacity(size) == BufferPool::capacity(size_)) {
+            size_ = size;
+            return;
+        }
         if (preserveData) {
             char* newbuffer = allocate(size);
             ::memcpy(newbuffer, buffer_, std::min(size_, size));
-            deallocate(buffer_);
+            deallocate(buffer_, size_);
             size_   = size;
             buffer_ = newbuffer;
         }
         else {
-            deallocate(buffer_);
+            deallocate(buffer_, size_);
             size_   = size;
             buffer_ = allocate(size);
         }
@@ -0,0 +1,331 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <thread>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/ByteRing.h"
+#include "eckit/thread/AutoLock.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/// Times a waiting thread yields before it sleeps on the condition
+constexpr int yields = 16;
+
+size_t roundUp(size_t size) {
+    size_t capacity = size_t(::sysconf(_SC_PAGESIZE));
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+/// Maps the same memory twice, back to back, or returns nullptr
+char* mapMirrored(size_t capacity) {
+#if defined(__linux__) && defined(SYS_memfd_create)
+    int fd = int(::syscall(SYS_memfd_create, "eckit::ByteRing", 0));
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    char* base = nullptr;
+    if (::ftruncate(fd, off_t(capacity)) == 0) {
+        void* p = ::mmap(nullptr, 2 * capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED) {
+            base = static_cast<char*>(p);
+            for (char* half : {base, base + capacity}) {
+                if (::mmap(half, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                    ::munmap(base, 2 * capacity);
+                    base = nullptr;
+                    break;
+                }
+            }
+        }
+    }
+
+    ::close(fd);
+    return base;
+#else
+    return nullptr;
+#endif
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ByteRing::ByteRing(size_t capacity, bool mirror) :
+    buffer_(nullptr),
+    capacity_(roundUp(capacity)),
+    mask_(capacity_ - 1),
+    mirrored_(false),
+    head_(0),
+    tail_(0),
+    writeClosed_(false),
+    readClosed_(false),
+    writerWaiting_(false),
+    readerWaiting_(false) {
+
+    if (mirror) {
+        buffer_   = mapMirrored(capacity_);
+        mirrored_ = buffer_ != nullptr;
+    }
+
+    if (!buffer_) {
+        void* p = ::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw FailedSystemCall("mmap", Here());
+        }
+        buffer_ = static_cast<char*>(p);
+    }
+}
+
+ByteRing::~ByteRing() {
+    ::munmap(buffer_, mirrored_ ? 2 * capacity_ : capacity_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+size_t ByteRing::freeSpace(char*& data) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t free = capacity_ - (head - tail_.load(std::memory_order_acquire));
+    size_t pos  = head & mask_;
+
+    data = buffer_ + pos;
+    return mirrored_ ? free : std::min(free, capacity_ - pos);
+}
+
+size_t ByteRing::usedSpace(const char*& data) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t used = head_.load(std::memory_order_acquire) - tail;
+    size_t pos  = tail & mask_;
+
+    data = buffer_ + pos;
+    return mirrored_ ? used : std::min(used, capacity_ - pos);
+}
+
+// The waiting thread raises its flag then checks the counter, the other thread moves the counter then checks the
+// flag; the fences make sure that at least one of them sees the other.
+
+void ByteRing::wakeReader() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (readerWaiting_.load(std::memory_order_relaxed)) {
+        AutoLock<MutexCond> lock(cond_);
+        cond_.broadcast();
+    }
+}
+
+void ByteRing::wakeWriter() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerWaiting_.load(std::memory_order_relaxed)) {
+        AutoLock<MutexCond> lock(cond_);
+        cond_.broadcast();
+    }
+}
+
+void ByteRing::waitWritable() {
+    char* data;
+    for (int i = 0; i < yields; ++i) {
+        if (freeSpace(data) > 0 || readClosed()) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    AutoLock<MutexCond> lock(cond_);
+    writerWaiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (freeSpace(data) == 0 && !readClosed()) {
+        cond_.wait();
+    }
+    writerWaiting_.store(false, std::memory_order_relaxed);
+}
+
+void ByteRing::waitReadable() {
+    const char* data;
+    for (int i = 0; i < yields; ++i) {
+        if (usedSpace(data) > 0 || writeClosed()) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    AutoLock<MutexCond> lock(cond_);
+    readerWaiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (usedSpace(data) == 0 && !writeClosed()) {
+        cond_.wait();
+    }
+    readerWaiting_.store(false, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+size_t ByteRing::reserve(char*& data) {
+    ASSERT(!writeClosed());
+    for (;;) {
+        if (readClosed()) {
+            return 0;
+        }
+        if (size_t n = freeSpace(data)) {
+            return n;
+        }
+        waitWritable();
+    }
+}
+
+void ByteRing::commit(size_t length) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    ASSERT(length <= capacity_ - (head - tail_.load(std::memory_order_acquire)));
+    head_.store(head + length, std::memory_order_release);
+    wakeReader();
+}
+
+size_t ByteRing::tryWrite(const void* buffer, size_t length) {
+    ASSERT(!writeClosed());
+
+    const char* p = static_cast<const char*>(buffer);
+    size_t done   = 0;
+
+    // Twice, for the end of the memory and its start, if not mirrored
+    for (int i = 0; i < 2 && done < length; ++i) {
+        char* data;
+        size_t n = std::min(freeSpace(data), length - done);
+        if (n == 0) {
+            break;
+        }
+        ::memcpy(data, p + done, n);
+        head_.store(head_.load(std::memory_order_relaxed) + n, std::memory_order_release);
+        done += n;
+    }
+
+    if (done) {
+        wakeReader();
+    }
+    return done;
+}
+
+void ByteRing::write(const void* buffer, size_t length) {
+    const char* p = static_cast<const char*>(buffer);
+    while (length > 0) {
+        char* data;
+        size_t n = reserve(data);
+        if (n == 0) {
+            throw WriteError("ByteRing: closed by the reader", Here());
+        }
+        n = std::min(n, length);
+        ::memcpy(data, p, n);
+        commit(n);
+        p += n;
+        length -= n;
+    }
+}
+
+void ByteRing::closeWrite() {
+    writeClosed_.store(true, std::memory_order_release);
+    AutoLock<MutexCond> lock(cond_);
+    cond_.broadcast();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+size_t ByteRing::peek(const char*& data) {
+    ASSERT(!readClosed());
+    for (;;) {
+        if (size_t n = usedSpace(data)) {
+            return n;
+        }
+        // Whatever was committed before the close is visible now
+        if (writeClosed()) {
+            return usedSpace(data);
+        }
+        waitReadable();
+    }
+}
+
+void ByteRing::consume(size_t length) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    ASSERT(length <= head_.load(std::memory_order_acquire) - tail);
+    tail_.store(tail + length, std::memory_order_release);
+    wakeWriter();
+}
+
+size_t ByteRing::tryRead(void* buffer, size_t length) {
+    ASSERT(!readClosed());
+
+    char* p     = static_cast<char*>(buffer);
+    size_t done = 0;
+
+    for (int i = 0; i < 2 && done < length; ++i) {
+        const char* data;
+        size_t n = std::min(usedSpace(data), length - done);
+        if (n == 0) {
+            break;
+        }
+        ::memcpy(p + done, data, n);
+        tail_.store(tail_.load(std::memory_order_relaxed) + n, std::memory_order_release);
+        done += n;
+    }
+
+    if (done) {
+        wakeWriter();
+    }
+    return done;
+}
+
+size_t ByteRing::read(void* buffer, size_t length) {
+    char* p     = static_cast<char*>(buffer);
+    size_t done = 0;
+    while (done < length) {
+        const char* data;
+        size_t n = peek(data);
+        if (n == 0) {
+            break;
+        }
+        n = std::min(n, length - done);
+        ::memcpy(p + done, data, n);
+        consume(n);
+        done += n;
+    }
+    return done;
+}
+
+void ByteRing::closeRead() {
+    readClosed_.store(true, std::memory_order_release);
+    AutoLock<MutexCond> lock(cond_);
+    cond_.broadcast();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+size_t ByteRing::length() const {
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return head_.load(std::memory_order_acquire) - tail;
+}
+
+void ByteRing::print(std::ostream& s) const {
+    s << "ByteRing[capacity=" << capacity_ << ",mirrored=" << mirrored_ << ",length=" << length()
+      << ",writeClosed=" << writeClosed() << ",readClosed=" << readClosed() << "]";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,130 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_io_ByteRing_h
+#define eckit_io_ByteRing_h
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+
+#include "eckit/memory/NonCopyable.h"
+#include "eckit/thread/MutexCond.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// A bounded ring of bytes between one producer thread and one consumer thread.
+///
+/// The two threads exchange data through two atomic counters, without a lock, and only wait on a condition when the
+/// ring is full or empty. The capacity is rounded up to a power of two and at least a page. Where the system allows
+/// it (Linux), the memory of the ring is mapped twice, back to back, so that any free or used region is contiguous:
+/// reserve() and peek() then give the whole of it, and copies never wrap. Otherwise, they give the region up to the
+/// end of the memory.
+///
+/// The producer calls closeWrite() at the end of the data; the consumer then reads what is left, then nothing. The
+/// consumer calls closeRead() to give up; the producer's writes then throw.
+///
+/// @note Unlike CircularBuffer, the ring does not grow, and only one thread may write and one thread may read.
+
+class ByteRing : private NonCopyable {
+public:  // methods
+    explicit ByteRing(size_t capacity = 4 * 1024 * 1024, bool mirror = true);
+
+    ~ByteRing();
+
+    // -- Producer
+
+    /// @return the bytes written, up to length, without waiting
+    size_t tryWrite(const void* buffer, size_t length);
+
+    /// Waits until all the bytes are written
+    void write(const void* buffer, size_t length);
+
+    /// Waits for free space, and gives it to be written in place
+    /// @return the contiguous bytes free from data, zero if the consumer has closed
+    size_t reserve(char*& data);
+
+    /// Makes bytes written in place after reserve() visible to the consumer
+    void commit(size_t length);
+
+    void closeWrite();
+
+    // -- Consumer
+
+    /// @return the bytes read, up to length, without waiting
+    size_t tryRead(void* buffer, size_t length);
+
+    /// Waits until length bytes are read, or the producer has closed
+    /// @return the bytes read
+    size_t read(void* buffer, size_t length);
+
+    /// Waits for data, and gives it to be read in place
+    /// @return the contiguous bytes available from data, zero at the end of the data
+    size_t peek(const char*& data);
+
+    /// Releases bytes read in place after peek()
+    void consume(size_t length);
+
+    void closeRead();
+
+    // -- Either thread
+
+    size_t capacity() const { return capacity_; }
+    bool mirrored() const { return mirrored_; }
+
+    /// @return the bytes written and not yet read
+    size_t length() const;
+
+    bool writeClosed() const { return writeClosed_.load(std::memory_order_acquire); }
+    bool readClosed() const { return readClosed_.load(std::memory_order_acquire); }
+
+    void print(std::ostream&) const;
+
+private:  // methods
+    size_t freeSpace(char*& data);
+    size_t usedSpace(const char*& data);
+
+    void waitWritable();
+    void waitReadable();
+
+    void wakeWriter();
+    void wakeReader();
+
+    friend std::ostream& operator<<(std::ostream& s, const ByteRing& r) {
+        r.print(s);
+        return s;
+    }
+
+private:  // members
+    char* buffer_;
+    size_t capacity_;
+    size_t mask_;
+    bool mirrored_;
+
+    // Each counter is written by one thread only, and kept on its own cache line
+
+    alignas(64) std::atomic<size_t> head_;  ///< Bytes written, by the producer
+    alignas(64) std::atomic<size_t> tail_;  ///< Bytes read, by the consumer
+
+    alignas(64) std::atomic<bool> writeClosed_;
+    std::atomic<bool> readClosed_;
+    std::atomic<bool> writerWaiting_;
+    std::atomic<bool> readerWaiting_;
+
+    MutexCond cond_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
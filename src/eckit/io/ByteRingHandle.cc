@@ -0,0 +1,87 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <ostream>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/ByteRing.h"
+#include "eckit/io/ByteRingHandle.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ByteRingHandle::ByteRingHandle(ByteRing& ring) :
+    ring_(ring), mode_(Mode::Closed), position_(0) {}
+
+ByteRingHandle::~ByteRingHandle() {
+    close();
+}
+
+Length ByteRingHandle::openForRead() {
+    ASSERT(mode_ == Mode::Closed);
+    mode_     = Mode::Read;
+    position_ = 0;
+    return 0;
+}
+
+void ByteRingHandle::openForWrite(const Length&) {
+    ASSERT(mode_ == Mode::Closed);
+    mode_     = Mode::Write;
+    position_ = 0;
+}
+
+long ByteRingHandle::read(void* buffer, long length) {
+    ASSERT(mode_ == Mode::Read);
+    ASSERT(length >= 0);
+    long n = long(ring_.read(buffer, size_t(length)));
+    position_ += n;
+    return n;
+}
+
+long ByteRingHandle::write(const void* buffer, long length) {
+    ASSERT(mode_ == Mode::Write);
+    ASSERT(length >= 0);
+    ring_.write(buffer, size_t(length));
+    position_ += length;
+    return length;
+}
+
+void ByteRingHandle::close() {
+    switch (mode_) {
+        case Mode::Read:
+            ring_.closeRead();
+            break;
+        case Mode::Write:
+            ring_.closeWrite();
+            break;
+        case Mode::Closed:
+            break;
+    }
+    mode_ = Mode::Closed;
+}
+
+void ByteRingHandle::flush() {}
+
+Offset ByteRingHandle::position() {
+    return position_;
+}
+
+void ByteRingHandle::print(std::ostream& s) const {
+    s << "ByteRingHandle[ring=" << ring_ << "]";
+}
+
+std::string ByteRingHandle::title() const {
+    return "ByteRing";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
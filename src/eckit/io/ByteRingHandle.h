@@ -0,0 +1,70 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_io_ByteRingHandle_h
+#define eckit_io_ByteRingHandle_h
+
+#include "eckit/io/DataHandle.h"
+
+namespace eckit {
+
+class ByteRing;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// One end of a ByteRing, not owned: the producer's once opened for write, the consumer's once opened for read.
+///
+/// read() waits for the bytes asked for, and returns fewer only at the end of the data. close(), or the destructor of
+/// a handle still open, closes that end of the ring, so that the other thread does not wait for ever.
+
+class ByteRingHandle : public DataHandle {
+public:
+    explicit ByteRingHandle(ByteRing&);
+
+    ~ByteRingHandle() override;
+
+    // -- Overridden methods
+
+    // From DataHandle
+
+    Length openForRead() override;
+    void openForWrite(const Length&) override;
+
+    long read(void*, long) override;
+    long write(const void*, long) override;
+    void close() override;
+    void flush() override;
+    void print(std::ostream&) const override;
+
+    bool canSeek() const override { return false; }
+
+    Offset position() override;
+
+private:  // types
+    enum class Mode
+    {
+        Closed,
+        Read,
+        Write
+    };
+
+private:  // members
+    ByteRing& ring_;
+    Mode mode_;
+    Offset position_;
+
+    std::string title() const override;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
@@ -26,6 +26,7 @@ namespace eckit {
 
 
 // A simple class to implement buffers
+// For a bounded buffer between a producer thread and a consumer thread, see ByteRing
 
 class CircularBuffer : public eckit::NonCopyable {
 
@@ -21,6 +21,7 @@
 #include "eckit/io/DataHandle.h"
 #include "eckit/io/DblBuffer.h"
 #include "eckit/io/MoverTransfer.h"
+#include "eckit/io/TransferEngine.h"
 #include "eckit/log/Bytes.h"
 #include "eckit/log/Progress.h"
 #include "eckit/log/Timer.h"
@@ -103,8 +104,6 @@ Length DataHandle::saveInto(DataHandle& other, TransferWatcher& watcher) {
     static const long bufsize = Resource<long>("bufferSize;$ECKIT_DATAHANDLE_SAVEINTO_BUFFER_SIZE",
                                                64 * 1024 * 1024);
 
-    Buffer buffer(bufsize);
-
     watcher.watch(0, 0);
 
     Length estimate = openForRead();
@@ -116,39 +115,17 @@ Length DataHandle::saveInto(DataHandle& other, TransferWatcher& watcher) {
 
     Progress progress("Moving data", 0, estimate);
 
-    Length total     = 0;
-    long length      = -1;
-    double readTime  = 0;
-    double lastRead  = 0;
-    double writeTime = 0;
-    double lastWrite = 0;
+    TransferEngine engine(bufsize, watcher);
+    engine.progress(&progress);
+
+    Length total = 0;
     Timer timer("Save into");
     bool more = true;
 
     while (more) {
         more = false;
         try {
-            while ((length = read(buffer, buffer.size())) > 0) {
-                double r = timer.elapsed() - lastRead;
-                readTime += r;
-                lastWrite = timer.elapsed();
-
-                if (other.write((const char*)buffer, length) != length) {
-                    throw WriteError(name() + " into " + other.name());
-                }
-
-                double w = timer.elapsed() - lastWrite;
-                writeTime += w;
-                total += length;
-                progress(total);
-                watcher.watch(buffer, length);
-                lastRead = timer.elapsed();
-
-                Bytes rRate(total, readTime);
-                Bytes wRate(total, writeTime);
-
-                Log::message() << rRate.shorten() << " " << wRate.shorten() << std::endl;
-            }
+            total += engine.copy(*this, other);
         }
         catch (RestartTransfer& retry) {
             Log::warning() << "Retrying transfer from " << retry.from() << " ("
@@ -157,6 +134,7 @@ Length DataHandle::saveInto(DataHandle& other, TransferWatcher& watcher) {
             restartReadFrom(retry.from());
             other.restartWriteFrom(retry.from());
             watcher.restartFrom(retry.from());
+            engine.restartFrom(retry.from());
 
             Log::warning() << "Total so far " << total << std::endl;
             total = Length(0) + retry.from();
@@ -165,13 +143,12 @@ Length DataHandle::saveInto(DataHandle& other, TransferWatcher& watcher) {
         }
     }
 
-    Log::message() << "" << std::endl;
-
-    Log::info() << "Read  rate: " << Bytes(total, readTime) << std::endl;
-    Log::info() << "Write rate: " << Bytes(total, writeTime) << std::endl;
-
-    if (length < 0) {
-        throw ReadError(name() + " into " + other.name());
+    if (engine.method() == TransferEngine::RING || engine.method() == TransferEngine::BUFFER) {
+        Log::info() << "Read  rate: " << Bytes(total, engine.readTime()) << std::endl;
+        Log::info() << "Write rate: " << Bytes(total, engine.writeTime()) << std::endl;
+    }
+    else {
+        Log::info() << "Transfer rate: " << Bytes(total, timer.elapsed()) << std::endl;
     }
 
     if (estimate != 0 && estimate != total) {
@@ -184,9 +161,9 @@ Length DataHandle::saveInto(DataHandle& other, TransferWatcher& watcher) {
     other.collectMetrics("target");
     Metrics::set("size", total);
     Metrics::set("time", timer.elapsed());
-    Metrics::set("read_time", readTime);
-    Metrics::set("write_time", writeTime);
-    Metrics::set("double_buffering", false);
+    Metrics::set("read_time", engine.readTime());
+    Metrics::set("write_time", engine.writeTime());
+    Metrics::set("double_buffering", engine.method() == TransferEngine::RING);
 
     return total;
 }
@@ -201,7 +178,6 @@ Length DataHandle::copyTo(DataHandle& other, long bufsize, Length maxsize, Trans
     if (bufsize == -1) {
         bufsize = Resource<long>("bufferSize;$ECKIT_DATAHANDLE_COPYTO_BUFFER_SIZE", 64 * 1024 * 1024);
     }
-    Buffer buffer(bufsize);
 
     Length estimate = openForRead();
     watcher.fromHandleOpened();
@@ -213,22 +189,8 @@ Length DataHandle::copyTo(DataHandle& other, long bufsize, Length maxsize, Trans
     watcher.toHandleOpened();
     AutoClose closer2(other);
 
-    Length total = 0;
-    long length  = -1;
-
-    while ((toRead <= Length(0) || total < toRead) && (length = read(buffer, toRead <= Length(0) ? bufsize : std::min(bufsize, (long)(toRead - total)))) > 0) {
-
-        if (other.write((const char*)buffer, length) != length) {
-            throw WriteError(name() + " into " + other.name());
-        }
-
-        watcher.watch(buffer, length);
-        total += length;
-    }
-
-    if (length < 0) {
-        throw ReadError(name() + " into " + other.name());
-    }
+    TransferEngine engine(bufsize, watcher);
+    Length total = engine.copy(*this, other, toRead > Length(0) ? toRead : Length(0));
 
     if (toRead != 0 && toRead != total) {
         std::ostringstream os;
@@ -388,6 +350,12 @@ void DataHandle::skip(const Length& len) {
     seek(position() + len);
 }
 
+void DataHandle::transferred(const Length&) {
+    std::ostringstream os;
+    os << "DataHandle::transferred() [" << *this << "]";
+    throw NotImplemented(os.str(), Here());
+}
+
 void DataHandle::restartReadFrom(const Offset& from) {
     std::ostringstream os;
     os << "DataHandle::restartReadFrom(" << from << ") [" << *this << "]";
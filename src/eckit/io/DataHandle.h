@@ -98,7 +98,7 @@ public:
     virtual Length saveInto(const PathName&, TransferWatcher& = TransferWatcher::dummy());
 
     /// Quiet version of saveInto
-    /// Does not support progess, restart and double buffering
+    /// Does not support progress and restart
     virtual Length copyTo(DataHandle&, long bufsize = -1, Length maxsize = -1, TransferWatcher& = TransferWatcher::dummy());
 
 
@@ -147,6 +147,12 @@ public:
 
     virtual bool doubleBufferOK() const { return true; }
 
+    // A descriptor the kernel can copy from or into, the next byte being at position() for regular files,
+    // -1 if none. After such a copy, transferred() is called with the number of bytes copied
+
+    virtual int transferDescriptor() { return -1; }
+    virtual void transferred(const Length&);
+
     // -- Overridden methods
 
     // From Streamble
@@ -16,7 +16,10 @@
 #include "eckit/io/EasyCURL.h"
 
 #include <unistd.h>
+#include <cstring>
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include <curl/curl.h>
 
@@ -25,11 +28,15 @@
 #include "eckit/utils/Tokenizer.h"
 #include "eckit/utils/Translator.h"
 
+#include "eckit/io/Buffer.h"
 #include "eckit/io/BufferedHandle.h"
 #include "eckit/io/CircularBuffer.h"
+#include "eckit/io/URLHandle.h"
 #include "eckit/log/Bytes.h"
 #include "eckit/log/Timer.h"
 #include "eckit/parser/JSONParser.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/Mutex.h"
 #include "eckit/utils/StringTools.h"
 #include "eckit/utils/Tokenizer.h"
 
@@ -426,6 +433,14 @@ static void call(const char* what, CURLMcode code) {
     }
 }
 
+static void call(const char* what, CURLSHcode code) {
+    if (code != CURLSHE_OK) {
+        std::ostringstream oss;
+        oss << what << " failed: " << curl_share_strerror(code);
+        throw SeriousBug(oss.str());
+    }
+}
+
 static pthread_once_t once = PTHREAD_ONCE_INIT;
 static CURLM* multi        = 0;
 
@@ -795,6 +810,324 @@ void EasyCURLHandle::close() {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// Connections, DNS entries and SSL sessions of ranged downloads, kept between downloads. libcurl does not support
+/// sharing connections between threads, so each is used by one download at a time
+class CURLSharePool {
+public:
+    static CURLSharePool& instance() {
+        static CURLSharePool pool;
+        return pool;
+    }
+
+    CURLSH* checkout() {
+        {
+            AutoLock<Mutex> lock(mutex_);
+            if (!idle_.empty()) {
+                CURLSH* share = idle_.back();
+                idle_.pop_back();
+                return share;
+            }
+        }
+
+        CURLSH* share = curl_share_init();
+        ASSERT(share);
+#if LIBCURL_VERSION_NUM >= 0x073900
+        _(curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT));
+#endif
+        _(curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS));
+        _(curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION));
+        return share;
+    }
+
+    void checkin(CURLSH* share) {
+        AutoLock<Mutex> lock(mutex_);
+        if (idle_.size() < 16) {
+            idle_.push_back(share);
+        }
+        else {
+            curl_share_cleanup(share);
+        }
+    }
+
+private:
+    CURLSharePool() = default;
+
+    ~CURLSharePool() {
+        for (CURLSH* share : idle_) {
+            curl_share_cleanup(share);
+        }
+    }
+
+    Mutex mutex_;
+    std::vector<CURLSH*> idle_;
+};
+
+/// A byte range of a ranged download, and the easy handle fetching it
+struct EasyCURLRange {
+    CURL* curl_ = nullptr;
+    Buffer data_{0};
+    unsigned long long offset_ = 0;
+    size_t length_             = 0;
+    size_t filled_             = 0;
+    size_t consumed_           = 0;
+    bool done_                 = false;
+    bool overflow_             = false;
+
+    static size_t _writeCallback(void* ptr, size_t size, size_t nmemb, void* userdata) {
+        EasyCURLRange* r = reinterpret_cast<EasyCURLRange*>(userdata);
+        size_t n         = size * nmemb;
+        // More than asked for: the server ignored the range
+        if (r->filled_ + n > r->length_) {
+            r->overflow_ = true;
+            return 0;
+        }
+        ::memcpy(static_cast<char*>(r->data_.data()) + r->filled_, ptr, n);
+        r->filled_ += n;
+        return n;
+    }
+};
+
+class EasyCURLRangedHandle : public DataHandle {
+public:
+    EasyCURLRangedHandle(CURLHandle* ch, const std::string& url, const Length& length, size_t connections,
+                         size_t rangeSize);
+    ~EasyCURLRangedHandle() override;
+
+private:
+    CURLHandle* ch_;
+    std::string url_;
+    unsigned long long length_;
+    size_t connections_;
+    size_t rangeSize_;
+
+    CURLM* multi_;
+    CURLSH* share_;
+    unsigned long long next_;
+    Offset position_;
+
+    // In order of offsets, the first one being read
+    std::deque<std::unique_ptr<EasyCURLRange>> ranges_;
+    std::vector<std::unique_ptr<EasyCURLRange>> idle_;
+
+    bool start();
+    void perform();
+    void finished(CURL*, CURLcode);
+    void cleanup();
+
+    void print(std::ostream& s) const override;
+    Length openForRead() override;
+    long read(void*, long) override;
+    void close() override;
+    Length size() override { return length_; }
+    Length estimate() override { return length_; }
+    Offset position() override { return position_; }
+    bool canSeek() const override { return false; }
+};
+
+EasyCURLRangedHandle::EasyCURLRangedHandle(CURLHandle* ch, const std::string& url, const Length& length,
+                                           size_t connections, size_t rangeSize) :
+    ch_(ch),
+    url_(url),
+    length_(length),
+    connections_(std::max<size_t>(connections, 1)),
+    rangeSize_(rangeSize),
+    multi_(nullptr),
+    share_(nullptr),
+    next_(0) {
+    ASSERT(rangeSize_ > 0);
+    // The easy handles are copies of this one, sharing its headers
+    ch_->attach();
+}
+
+EasyCURLRangedHandle::~EasyCURLRangedHandle() {
+    cleanup();
+    ch_->detach();
+}
+
+void EasyCURLRangedHandle::print(std::ostream& s) const {
+    s << "EasyCURLRangedHandle[" << url_ << ",connections=" << connections_ << ",rangeSize=" << rangeSize_ << "]";
+}
+
+Length EasyCURLRangedHandle::openForRead() {
+    ASSERT(!multi_);
+
+    multi_ = curl_multi_init();
+    ASSERT(multi_);
+    share_ = CURLSharePool::instance().checkout();
+
+    next_     = 0;
+    position_ = 0;
+
+    while (ranges_.size() < connections_ && start()) {
+    }
+
+    return length_;
+}
+
+bool EasyCURLRangedHandle::start() {
+    if (next_ >= length_) {
+        return false;
+    }
+
+    std::unique_ptr<EasyCURLRange> r;
+    if (idle_.empty()) {
+        r.reset(new EasyCURLRange());
+        r->curl_ = curl_easy_duphandle(ch_->curl_);
+        ASSERT(r->curl_);
+        _(curl_easy_setopt(r->curl_, CURLOPT_URL, url_.c_str()));
+        _(curl_easy_setopt(r->curl_, CURLOPT_CUSTOMREQUEST, NULL));
+        _(curl_easy_setopt(r->curl_, CURLOPT_HTTPGET, 1L));
+        _(curl_easy_setopt(r->curl_, CURLOPT_FOLLOWLOCATION, 1L));
+        _(curl_easy_setopt(r->curl_, CURLOPT_HEADERFUNCTION, NULL));
+        _(curl_easy_setopt(r->curl_, CURLOPT_HEADERDATA, NULL));
+        _(curl_easy_setopt(r->curl_, CURLOPT_WRITEFUNCTION, &EasyCURLRange::_writeCallback));
+        _(curl_easy_setopt(r->curl_, CURLOPT_WRITEDATA, r.get()));
+        _(curl_easy_setopt(r->curl_, CURLOPT_PRIVATE, r.get()));
+        _(curl_easy_setopt(r->curl_, CURLOPT_SHARE, share_));
+    }
+    else {
+        r = std::move(idle_.back());
+        idle_.pop_back();
+    }
+
+    r->offset_   = next_;
+    r->length_   = size_t(std::min<unsigned long long>(rangeSize_, length_ - next_));
+    r->filled_   = 0;
+    r->consumed_ = 0;
+    r->done_     = false;
+    r->overflow_ = false;
+    if (r->data_.size() < r->length_) {
+        r->data_.resize(r->length_);
+    }
+
+    std::ostringstream range;
+    range << r->offset_ << "-" << (r->offset_ + r->length_ - 1);
+    _(curl_easy_setopt(r->curl_, CURLOPT_RANGE, range.str().c_str()));
+    _(curl_multi_add_handle(multi_, r->curl_));
+
+    next_ += r->length_;
+    ranges_.push_back(std::move(r));
+    return true;
+}
+
+void EasyCURLRangedHandle::perform() {
+    int running = 0;
+    _(curl_multi_perform(multi_, &running));
+
+    CURLMsg* msg;
+    int left = 0;
+    while ((msg = curl_multi_info_read(multi_, &left))) {
+        if (msg->msg == CURLMSG_DONE) {
+            finished(msg->easy_handle, msg->data.result);
+        }
+    }
+}
+
+void EasyCURLRangedHandle::finished(CURL* curl, CURLcode result) {
+    EasyCURLRange* r = nullptr;
+    _(curl_easy_getinfo(curl, CURLINFO_PRIVATE, &r));
+    ASSERT(r);
+
+    _(curl_multi_remove_handle(multi_, curl));
+    r->done_ = true;
+
+    std::ostringstream oss;
+    oss << url_ << " bytes " << r->offset_ << "-" << (r->offset_ + r->length_ - 1) << ": ";
+
+    if (r->overflow_) {
+        oss << "server does not honour range requests";
+        throw SeriousBug(oss.str());
+    }
+
+    if (result != CURLE_OK) {
+        oss << curl_easy_strerror(result);
+        throw SeriousBug(oss.str());
+    }
+
+    long code = 0;
+    _(curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code));
+
+    if (code >= 400) {
+        oss << "HTTP error " << code;
+        throw URLException(oss.str(), int(code));
+    }
+
+    // A range of the whole resource may be answered in full
+    if (code != 206 && !(code == 200 && r->offset_ == 0 && r->length_ == length_)) {
+        oss << "unexpected HTTP code " << code;
+        throw SeriousBug(oss.str());
+    }
+
+    if (r->filled_ != r->length_) {
+        oss << "got only " << r->filled_ << " bytes";
+        throw ReadError(oss.str());
+    }
+}
+
+long EasyCURLRangedHandle::read(void* buffer, long length) {
+    // URLHandle does not open its handle
+    if (!multi_) {
+        openForRead();
+    }
+
+    char* p   = static_cast<char*>(buffer);
+    long done = 0;
+
+    while (done < length && !ranges_.empty()) {
+        EasyCURLRange& r = *ranges_.front();
+
+        while (r.filled_ == r.consumed_ && !r.done_) {
+            _(curl_multi_wait(multi_, nullptr, 0, 1000, nullptr));
+            perform();
+        }
+
+        size_t n = std::min(size_t(length - done), r.filled_ - r.consumed_);
+        ::memcpy(p + done, static_cast<const char*>(r.data_.data()) + r.consumed_, n);
+        r.consumed_ += n;
+        done += long(n);
+
+        if (r.done_ && r.consumed_ == r.length_) {
+            idle_.push_back(std::move(ranges_.front()));
+            ranges_.pop_front();
+            start();
+        }
+    }
+
+    position_ += done;
+    return done;
+}
+
+void EasyCURLRangedHandle::close() {
+    cleanup();
+}
+
+void EasyCURLRangedHandle::cleanup() {
+    for (auto& r : ranges_) {
+        if (!r->done_) {
+            curl_multi_remove_handle(multi_, r->curl_);
+        }
+        idle_.push_back(std::move(r));
+    }
+    ranges_.clear();
+
+    for (auto& r : idle_) {
+        curl_easy_cleanup(r->curl_);
+    }
+    idle_.clear();
+
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+        multi_ = nullptr;
+    }
+
+    if (share_) {
+        CURLSharePool::instance().checkin(share_);
+        share_ = nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 EasyCURLResponse::EasyCURLResponse(EasyCURLResponseImp* imp) :
     imp_(imp) {
     imp_->attach();
@@ -906,7 +1239,7 @@ EasyCURLResponse EasyCURL::request(const std::string& url, bool stream) {
             r.reset(new EasyCURLResponseStream(location, ch_));
         }
         else {
-            r.reset(new EasyCURLResponseDirect(url, ch_));
+            r.reset(new EasyCURLResponseDirect(location, ch_));
         }
 
         r->perform();
@@ -925,6 +1258,11 @@ EasyCURLResponse EasyCURL::GET(const std::string& url, bool stream) {
     return request(url, stream);
 }
 
+DataHandle* EasyCURL::rangedGET(const std::string& url, const Length& length, size_t connections,
+                                size_t rangeSize) {
+    return new EasyCURLRangedHandle(ch_, url, length, connections, rangeSize);
+}
+
 EasyCURLResponse EasyCURL::HEAD(const std::string& url) {
     _(curl_easy_setopt(ch_->curl_, CURLOPT_CUSTOMREQUEST, NULL));
     _(curl_easy_setopt(ch_->curl_, CURLOPT_NOBODY, 1L));
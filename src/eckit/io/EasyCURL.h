@@ -71,6 +71,11 @@ public:
     EasyCURLResponse POST(const std::string& url, const std::string& data);
     EasyCURLResponse DELETE(const std::string& url);
 
+    /// Fetches a resource of known length as byte ranges of rangeSize, up to `connections` of them at a time over
+    /// as many connections, kept for the next downloads. The handle returns the bytes in order, holding at most
+    /// `connections` ranges in memory
+    DataHandle* rangedGET(const std::string& url, const Length& length, size_t connections, size_t rangeSize);
+
     void verbose(bool on);
     void followLocation(bool on);
     void sslVerifyPeer(bool on);
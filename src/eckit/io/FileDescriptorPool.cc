@@ -0,0 +1,288 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ostream>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/FileDescriptorPool.h"
+#include "eckit/thread/AutoLock.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+FileDescriptorPool::Lease::Lease(Lease&& other) noexcept :
+    pool_(other.pool_), entry_(other.entry_) {
+    other.pool_  = nullptr;
+    other.entry_ = nullptr;
+}
+
+FileDescriptorPool::Lease& FileDescriptorPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        std::swap(pool_, other.pool_);
+        std::swap(entry_, other.entry_);
+    }
+    return *this;
+}
+
+FileDescriptorPool::Lease::~Lease() {
+    release();
+}
+
+void FileDescriptorPool::Lease::release() {
+    if (entry_) {
+        pool_->release(entry_);
+        pool_  = nullptr;
+        entry_ = nullptr;
+    }
+}
+
+int FileDescriptorPool::Lease::fd() const {
+    ASSERT(entry_);
+    return entry_->fd;
+}
+
+const PathName& FileDescriptorPool::Lease::path() const {
+    ASSERT(entry_);
+    return entry_->path;
+}
+
+long FileDescriptorPool::Lease::read(void* buffer, long length, off_t offset) const {
+    ASSERT(entry_);
+    ASSERT(length >= 0);
+
+    char* out = static_cast<char*>(buffer);
+    long done = 0;
+    while (done < length) {
+        ssize_t n = ::pread(entry_->fd, out + done, size_t(length - done), offset + done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw ReadError(entry_->path.asString() + ": " + std::strerror(errno), Here());
+        }
+        if (n == 0) {
+            break;
+        }
+        done += long(n);
+    }
+    return done;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+FileDescriptorPool::FileDescriptorPool(size_t capacity) :
+    capacity_(std::max(capacity, size_t(1))), open_(0), leased_(0) {}
+
+FileDescriptorPool::~FileDescriptorPool() {
+    for (auto& e : entries_) {
+        if (e.second->fd >= 0) {
+            ::close(e.second->fd);
+        }
+    }
+    for (auto& e : removed_) {
+        ::close(e->fd);
+    }
+}
+
+FileDescriptorPool& FileDescriptorPool::instance() {
+    static FileDescriptorPool pool(
+        Resource<size_t>("fileDescriptorPoolCapacity;$ECKIT_FILE_DESCRIPTOR_POOL_CAPACITY", 256));
+    return pool;
+}
+
+FileDescriptorPool::Lease FileDescriptorPool::checkout(const PathName& path) {
+    Entry* entry = nullptr;
+
+    {
+        AutoLock<MutexCond> lock(cond_);
+
+        bool waited = false;
+        for (;;) {
+            auto j = entries_.find(path.asString());
+            if (j != entries_.end()) {
+                Entry* e = j->second.get();
+
+                // Being opened by another thread
+                if (e->fd < 0) {
+                    waited = true;
+                    cond_.wait();
+                    continue;
+                }
+
+                if (e->refs++ == 0) {
+                    idle_.erase(e->idle);
+                    leased_++;
+                }
+                statistics_.hits++;
+                statistics_.waits += waited;
+                return Lease(this, e);
+            }
+
+            if (open_ >= capacity_) {
+                if (!idle_.empty()) {
+                    evict(capacity_ - 1);
+                    continue;
+                }
+                waited = true;
+                cond_.wait();
+                continue;
+            }
+
+            entry       = new Entry(path);
+            entry->refs = 1;
+            entries_.emplace(path.asString(), std::unique_ptr<Entry>(entry));
+            open_++;
+            leased_++;
+            statistics_.opens++;
+            statistics_.waits += waited;
+            break;
+        }
+    }
+
+    // Other files are leased and opened meanwhile
+    int fd    = ::open(path.localPath(), O_RDONLY);
+    int error = errno;
+
+    AutoLock<MutexCond> lock(cond_);
+    cond_.broadcast();
+
+    if (fd < 0) {
+        entries_.erase(path.asString());
+        open_--;
+        leased_--;
+        errno = error;
+        throw CantOpenFile(path, Here());
+    }
+
+    entry->fd = fd;
+    return Lease(this, entry);
+}
+
+long FileDescriptorPool::read(const PathName& path, void* buffer, long length, off_t offset) {
+    return checkout(path).read(buffer, length, offset);
+}
+
+void FileDescriptorPool::release(Entry* e) {
+    AutoLock<MutexCond> lock(cond_);
+
+    ASSERT(e->refs > 0);
+    if (--e->refs > 0) {
+        return;
+    }
+
+    leased_--;
+
+    if (e->removed) {
+        ::close(e->fd);
+        open_--;
+        removed_.remove_if([e](const std::unique_ptr<Entry>& r) { return r.get() == e; });
+    }
+    else {
+        idle_.push_back(e);
+        e->idle = std::prev(idle_.end());
+        evict(capacity_);
+    }
+
+    cond_.broadcast();
+}
+
+void FileDescriptorPool::evict(size_t target) {
+    while (open_ > target && !idle_.empty()) {
+        Entry* e = idle_.front();
+        idle_.pop_front();
+        ::close(e->fd);
+        open_--;
+        statistics_.evictions++;
+        entries_.erase(e->path.asString());
+    }
+}
+
+bool FileDescriptorPool::remove(const PathName& path) {
+    AutoLock<MutexCond> lock(cond_);
+
+    for (;;) {
+        auto j = entries_.find(path.asString());
+        if (j == entries_.end()) {
+            return false;
+        }
+
+        Entry* e = j->second.get();
+        if (e->fd < 0) {
+            cond_.wait();
+            continue;
+        }
+
+        if (e->refs == 0) {
+            idle_.erase(e->idle);
+            ::close(e->fd);
+            open_--;
+        }
+        else {
+            e->removed = true;
+            removed_.push_back(std::move(j->second));
+        }
+        entries_.erase(j);
+
+        cond_.broadcast();
+        return true;
+    }
+}
+
+size_t FileDescriptorPool::size() const {
+    AutoLock<MutexCond> lock(cond_);
+    return open_;
+}
+
+void FileDescriptorPool::capacity(size_t size) {
+    AutoLock<MutexCond> lock(cond_);
+    capacity_ = std::max(size, size_t(1));
+    evict(capacity_);
+    cond_.broadcast();
+}
+
+size_t FileDescriptorPool::capacity() const {
+    AutoLock<MutexCond> lock(cond_);
+    return capacity_;
+}
+
+size_t FileDescriptorPool::usage() const {
+    AutoLock<MutexCond> lock(cond_);
+    return leased_;
+}
+
+FileDescriptorPool::Statistics FileDescriptorPool::statistics() const {
+    AutoLock<MutexCond> lock(cond_);
+    return statistics_;
+}
+
+void FileDescriptorPool::print(std::ostream& os) const {
+    AutoLock<MutexCond> lock(cond_);
+    os << "FileDescriptorPool("
+       << "open=" << open_ << ", "
+       << "leased=" << leased_ << ", "
+       << "capacity=" << capacity_ << ", "
+       << "opens=" << statistics_.opens << ", "
+       << "hits=" << statistics_.hits << ", "
+       << "waits=" << statistics_.waits << ", "
+       << "evictions=" << statistics_.evictions << ")";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
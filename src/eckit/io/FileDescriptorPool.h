@@ -0,0 +1,153 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_io_FileDescriptorPool_h
+#define eckit_io_FileDescriptorPool_h
+
+#include <sys/types.h>
+
+#include <iosfwd>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/memory/NonCopyable.h"
+#include "eckit/thread/MutexCond.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Pool of read-only file descriptors, shared by any number of threads.
+///
+/// Unlike FilePool, which lends a DataHandle to one thread at a time, a descriptor is lent to every thread that asks
+/// for the same file: reads are positional (pread), so there is no shared offset to protect. Each open file counts
+/// the leases on it; files no longer leased stay open, up to the capacity of the pool, and the least recently used
+/// are closed first. A thread waits only when a file has to be opened, the pool is full and all its files are leased.
+///
+/// @note this class is thread-safe
+/// @note the capacity must be more than the number of files leased at once by a single thread
+///
+class FileDescriptorPool : private NonCopyable {
+private:
+    struct Entry;
+
+public:  // types
+    /// An open descriptor, returned to the pool when the lease is destroyed or released
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&&) noexcept;
+        Lease& operator=(Lease&&) noexcept;
+        ~Lease();
+
+        /// Reads up to length bytes at offset, fewer only at the end of the file
+        /// @throws ReadError
+        long read(void* buffer, long length, off_t offset) const;
+
+        int fd() const;
+        const PathName& path() const;
+
+        void release();
+
+        explicit operator bool() const { return entry_ != nullptr; }
+
+    private:
+        friend class FileDescriptorPool;
+        Lease(FileDescriptorPool* pool, Entry* entry) :
+            pool_(pool), entry_(entry) {}
+
+        FileDescriptorPool* pool_ = nullptr;
+        Entry* entry_             = nullptr;
+    };
+
+    struct Statistics {
+        size_t opens     = 0;  ///< Files opened
+        size_t hits      = 0;  ///< Leases of files already open
+        size_t waits     = 0;  ///< Leases that had to wait, for a file being opened or for room in the pool
+        size_t evictions = 0;  ///< Files closed to make room
+    };
+
+public:  // methods
+    explicit FileDescriptorPool(size_t capacity);
+
+    /// @pre no lease outstanding
+    ~FileDescriptorPool();
+
+    /// A pool for the process, its capacity from the resource fileDescriptorPoolCapacity (256)
+    static FileDescriptorPool& instance();
+
+    /// Leases a descriptor of the file, opening it if needed
+    /// @throws CantOpenFile
+    Lease checkout(const PathName& path);
+
+    /// Reads up to length bytes of the file at offset, fewer only at the end of the file
+    long read(const PathName& path, void* buffer, long length, off_t offset);
+
+    /// Closes the file, now or when its last lease is released, so that it is opened again on the next checkout
+    bool remove(const PathName& path);
+
+    /// Number of open files
+    size_t size() const;
+
+    void capacity(size_t size);
+    size_t capacity() const;
+
+    /// Number of files leased
+    size_t usage() const;
+
+    Statistics statistics() const;
+
+    void print(std::ostream& os) const;
+
+    friend std::ostream& operator<<(std::ostream& s, const FileDescriptorPool& p) {
+        p.print(s);
+        return s;
+    }
+
+private:  // methods
+    void release(Entry*);
+    void evict(size_t target);
+
+private:  // members
+    struct Entry {
+        PathName path;
+        int fd       = -1;  ///< Still being opened while negative
+        size_t refs  = 0;
+        bool removed = false;
+        std::list<Entry*>::iterator idle;
+
+        explicit Entry(const PathName& p) :
+            path(p) {}
+    };
+
+    std::unordered_map<std::string, std::unique_ptr<Entry>> entries_;
+
+    /// Removed while leased, closed when released
+    std::list<std::unique_ptr<Entry>> removed_;
+
+    /// Open files not leased, least recently used first
+    std::list<Entry*> idle_;
+
+    size_t capacity_;
+    size_t open_;
+    size_t leased_;
+    Statistics statistics_;
+
+    mutable MutexCond cond_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
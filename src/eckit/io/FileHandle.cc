@@ -21,6 +21,7 @@
 #include "eckit/log/Bytes.h"
 #include "eckit/log/Log.h"
 #include "eckit/os/Stat.h"
+#include "eckit/runtime/Monitor.h"
 #include "eckit/utils/MD5.h"
 #include "eckit/io/MoverTransferSelection.h"
 
@@ -107,7 +108,11 @@ void FileHandle::openForAppend(const Length&) {
 }
 
 long FileHandle::read(void* buffer, long length) {
-    return ::fread(buffer, 1, length, file_);
+    long len = long(::fread(buffer, 1, length, file_));
+    if (Monitor* monitor = Monitor::current()) {
+        monitor->bytesRead(len);
+    }
+    return len;
 }
 
 long FileHandle::write(const void* buffer, long length) {
@@ -135,6 +140,9 @@ long FileHandle::write(const void* buffer, long length) {
         } while (len != length && errno == ENOSPC);
     }
 
+    if (Monitor* monitor = Monitor::current()) {
+        monitor->bytesWritten(written);
+    }
     return written;
 }
 
@@ -269,6 +277,19 @@ void FileHandle::skip(const Length& n) {
     }
 }
 
+int FileHandle::transferDescriptor() {
+    ASSERT(file_);
+    // So that the descriptor is where position() says
+    if (!read_ && ::fflush(file_)) {
+        throw WriteError(std::string("fflush(") + name_ + ")", Here());
+    }
+    return fileno(file_);
+}
+
+void FileHandle::transferred(const Length& n) {
+    advance(n);
+}
+
 void FileHandle::toRemote(Stream& s) const {
     PathName p(PathName(name_).clusterName());
     std::unique_ptr<DataHandle> remote(p.fileHandle());
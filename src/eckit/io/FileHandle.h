@@ -67,6 +67,9 @@ public:
     bool canSeek() const override;
     void skip(const Length&) override;
 
+    int transferDescriptor() override;
+    void transferred(const Length&) override;
+
     DataHandle* clone() const override;
     void hash(MD5& md5) const override;
 
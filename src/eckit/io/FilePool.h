@@ -34,6 +34,7 @@ namespace eckit {
 /// Handles must be checked-out before usage, should be checked back in once writing finished.
 /// No limit to number of checked out handles.
 /// Handles are closed when purged from pool due to LRU or when pool is destroyed.
+/// For files read by several threads at once, see FileDescriptorPool.
 ///
 /// @note this class is thread-safe
 ///
@@ -8,15 +8,16 @@
  * does it submit to any jurisdiction.
  */
 
-// #include <dirent.h>
-// #include <sys/stat.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstring>
+
+#include "eckit/config/Resource.h"
 #include "eckit/exception/Exceptions.h"
 #include "eckit/io/MMappedFileHandle.h"
-#include "eckit/io/MemoryHandle.h"
 #include "eckit/memory/MMap.h"
 #include "eckit/os/Stat.h"
 #include "eckit/utils/MD5.h"
@@ -31,6 +32,8 @@ ClassSpec MMappedFileHandle::classSpec_ = {
 };
 Reanimator<MMappedFileHandle> MMappedFileHandle::reanimator_;
 
+const off_t MMappedFileHandle::page_ = ::sysconf(_SC_PAGESIZE);
+
 void MMappedFileHandle::print(std::ostream& s) const {
     s << "MMappedFileHandle[file=" << path_ << ']';
 }
@@ -41,18 +44,54 @@ void MMappedFileHandle::encode(Stream& s) const {
 }
 
 MMappedFileHandle::MMappedFileHandle(Stream& s) :
-    DataHandle(s), mmap_(nullptr), fd_(-1) {
+    DataHandle(s) {
     s >> path_;
+    defaults();
 }
 
 MMappedFileHandle::MMappedFileHandle(const std::string& path) :
-    path_(path), mmap_(nullptr), fd_(-1) {}
+    path_(path) {
+    defaults();
+}
 
 MMappedFileHandle::~MMappedFileHandle() {}
 
+void MMappedFileHandle::defaults() {
+    static size_t window     = Resource<size_t>("mmapHandleWindow;$ECKIT_MMAP_HANDLE_WINDOW", 0);
+    static std::string mode  = Resource<std::string>("mmapHandleAccess;$ECKIT_MMAP_HANDLE_ACCESS", "sequential");
+    static size_t readAhead  = Resource<size_t>("mmapHandleReadAhead;$ECKIT_MMAP_HANDLE_READ_AHEAD", 8 * 1024 * 1024);
+    static bool populate     = Resource<bool>("mmapHandlePopulate;$ECKIT_MMAP_HANDLE_POPULATE", false);
+    static const Access used = [] {
+        if (mode == "normal") {
+            return Access::Normal;
+        }
+        if (mode == "sequential") {
+            return Access::Sequential;
+        }
+        if (mode == "random") {
+            return Access::Random;
+        }
+        throw UserError("mmapHandleAccess should be normal, sequential or random, not " + mode);
+    }();
+
+    mmap_     = nullptr;
+    fd_       = -1;
+    opened_   = false;
+    length_   = 0;
+    position_ = 0;
+    base_     = 0;
+    mapped_   = 0;
+    advised_  = 0;
+
+    window_    = window;
+    access_    = used;
+    readAhead_ = readAhead;
+    populate_  = populate;
+}
+
 
 Length MMappedFileHandle::openForRead() {
-    ASSERT(!handle_.get());
+    ASSERT(!opened_);
 
     Stat::Struct info;
     SYSCALL(Stat::stat(path_.c_str(), &info));
@@ -60,19 +99,83 @@ Length MMappedFileHandle::openForRead() {
 
     SYSCALL2(fd_ = ::open(path_.c_str(), O_RDONLY), path_);
 
-    mmap_ = MMap::mmap(0, length_, PROT_READ, MAP_SHARED, fd_, 0);
-    if (mmap_ == MAP_FAILED) {
-        Log::error() << "MMappedFileHandle path=" << path_ << " size=" << length_
-                     << " fails to mmap(0,length,PROT_READ,MAP_SHARED,fd_,0)" << Log::syserr << std::endl;
+    opened_   = true;
+    position_ = 0;
+
+    if (length_ > 0) {
+        map(0);
+    }
+
+    return length_;
+}
+
+void MMappedFileHandle::map(off_t offset) {
+    unmap();
+
+    // The window covers at least a page, and starts on one
+    size_t window = window_ ? std::max(window_, size_t(page_)) : size_t(length_);
+    base_         = window < size_t(length_) ? offset / page_ * page_ : 0;
+    mapped_       = std::min(window, size_t(length_ - base_));
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    if (populate_) {
+        flags |= MAP_POPULATE;
+    }
+#endif
+
+    void* addr = MMap::mmap(nullptr, mapped_, PROT_READ, flags, fd_, base_);
+    if (addr == MAP_FAILED) {
+        Log::error() << "MMappedFileHandle path=" << path_ << " offset=" << base_ << " size=" << mapped_
+                     << " fails to mmap(0,size,PROT_READ,MAP_SHARED,fd_,offset)" << Log::syserr << std::endl;
         throw FailedSystemCall("mmap", Here());
     }
+    mmap_ = static_cast<char*>(addr);
+
+    // Advice only, failures are ignored
+    switch (access_) {
+        case Access::Sequential:
+            ::posix_madvise(mmap_, mapped_, POSIX_MADV_SEQUENTIAL);
+            break;
+        case Access::Random:
+            ::posix_madvise(mmap_, mapped_, POSIX_MADV_RANDOM);
+            break;
+        default:
+            break;
+    }
+
+#ifndef MAP_POPULATE
+    if (populate_) {
+        ::posix_madvise(mmap_, mapped_, POSIX_MADV_WILLNEED);
+    }
+#endif
+
+    advised_ = populate_ ? base_ + off_t(mapped_) : base_;
+}
+
+void MMappedFileHandle::unmap() {
+    if (mmap_) {
+        SYSCALL2(MMap::munmap(mmap_, mapped_), path_);
+        mmap_   = nullptr;
+        mapped_ = 0;
+    }
+}
 
-    handle_.reset(new MemoryHandle(mmap_, length_));
+void MMappedFileHandle::advance(off_t position) {
+    // Requests the pages up to readAhead_ bytes beyond the position, half of it at a time
+    off_t end    = base_ + off_t(mapped_);
+    off_t target = std::min(position + off_t(readAhead_), end);
+    if (target <= advised_ || (target < end && target - advised_ < off_t(readAhead_ / 2))) {
+        return;
+    }
 
-    return handle_->openForRead();
+    off_t from = std::max(advised_, position) - base_;
+    from       = from / page_ * page_;
+    ::posix_madvise(mmap_ + from, size_t(target - base_ - from), POSIX_MADV_WILLNEED);
+    advised_ = target;
 }
 
-void MMappedFileHandle::openForWrite(const Length& length) {
+void MMappedFileHandle::openForWrite(const Length&) {
     NOTIMP;
 }
 
@@ -80,79 +183,112 @@ void MMappedFileHandle::openForAppend(const Length&) {
     NOTIMP;
 }
 
+long MMappedFileHandle::view(const void*& data, long length) {
+    ASSERT(opened_);
+    ASSERT(length >= 0);
+
+    if (position_ >= length_ || length == 0) {
+        return 0;
+    }
+
+    if (!mmap_ || position_ < base_ || position_ >= base_ + off_t(mapped_)) {
+        map(position_);
+    }
+
+    long n = long(std::min(off_t(length), base_ + off_t(mapped_) - position_));
+    data   = mmap_ + (position_ - base_);
+
+    if (access_ == Access::Random && n > page_) {
+        // Without read-ahead, each page would otherwise be read from the disk by its own fault
+        off_t from = (position_ - base_) / page_ * page_;
+        ::posix_madvise(mmap_ + from, size_t(position_ - base_ + n - from), POSIX_MADV_WILLNEED);
+    }
+
+    position_ += n;
+
+    if (access_ == Access::Sequential && readAhead_) {
+        advance(position_);
+    }
+
+    return n;
+}
+
 long MMappedFileHandle::read(void* buffer, long length) {
-    ASSERT(handle_.get());
-    return handle_->read(buffer, length);
+    char* out = static_cast<char*>(buffer);
+    long done = 0;
+    while (done < length) {
+        const void* data;
+        long n = view(data, length - done);
+        if (n == 0) {
+            break;
+        }
+        ::memcpy(out + done, data, n);
+        done += n;
+    }
+    return done;
 }
 
-long MMappedFileHandle::write(const void* buffer, long length) {
-    ASSERT(handle_.get());
-    return handle_->write(buffer, length);
+long MMappedFileHandle::write(const void*, long) {
+    NOTIMP;
 }
 
 void MMappedFileHandle::flush() {
-    ASSERT(handle_.get());
-    return handle_->flush();
+    ASSERT(opened_);
 }
 
 void MMappedFileHandle::close() {
-    if (handle_.get()) {
-        handle_->close();
-        handle_.reset(0);
-    }
-    if (mmap_) {
-        SYSCALL2(MMap::munmap(mmap_, length_), path_);
-        mmap_ = nullptr;
-    }
+    unmap();
     if (fd_ >= 0) {
         SYSCALL2(::close(fd_), path_);
         fd_ = -1;
     }
+    opened_ = false;
 }
 
 void MMappedFileHandle::rewind() {
-    ASSERT(handle_.get());
-    return handle_->rewind();
+    seek(0);
 }
 
 Length MMappedFileHandle::size() {
-    ASSERT(handle_.get());
-    return handle_->size();
+    if (opened_) {
+        return length_;
+    }
+    Stat::Struct info;
+    SYSCALL(Stat::stat(path_.c_str(), &info));
+    return info.st_size;
 }
 
 Length MMappedFileHandle::estimate() {
-    ASSERT(handle_.get());
-    return handle_->estimate();
+    return size();
 }
 
 bool MMappedFileHandle::isEmpty() const {
-    ASSERT(handle_.get());
-    return handle_->isEmpty();
+    ASSERT(opened_);
+    return length_ == 0;
 }
 
 Offset MMappedFileHandle::position() {
-    ASSERT(handle_.get());
-    return handle_->position();
+    ASSERT(opened_);
+    return position_;
 }
 
 void MMappedFileHandle::restartReadFrom(const Offset& from) {
-    ASSERT(handle_.get());
-    handle_->restartReadFrom(from);
+    seek(from);
 }
 
-void MMappedFileHandle::restartWriteFrom(const Offset& from) {
-    ASSERT(handle_.get());
-    handle_->restartWriteFrom(from);
+void MMappedFileHandle::restartWriteFrom(const Offset&) {
+    NOTIMP;
 }
 
 Offset MMappedFileHandle::seek(const Offset& from) {
-    ASSERT(handle_.get());
-    return handle_->seek(from);
+    ASSERT(opened_);
+    ASSERT(off_t(from) <= length_);
+    position_ = from;
+    return position_;
 }
 
 void MMappedFileHandle::skip(const Length& n) {
-    ASSERT(handle_.get());
-    handle_->skip(n);
+    seek(position() + n);
 }
 
 
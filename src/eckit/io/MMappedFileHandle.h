@@ -14,15 +14,29 @@
 #ifndef eckit_io_MMappedFileHandle_h
 #define eckit_io_MMappedFileHandle_h
 
-#include <memory>
+#include <sys/types.h>
+
 #include "eckit/io/DataHandle.h"
 
 
 namespace eckit {
 
+/// Reads a file through a memory mapping. A file larger than the window is mapped one window at a time, the window
+/// sliding along with the reads. The mapping is advised of the expected access: for sequential access, the pages ahead
+/// of the reads are requested in advance and, for random access, the pages of each read are requested together. The
+/// defaults are from the resources mmapHandleWindow (0, the whole file), mmapHandleAccess (sequential),
+/// mmapHandleReadAhead (8 MiB) and mmapHandlePopulate (off).
+
 class MMappedFileHandle : public DataHandle {
 
 public:
+    enum class Access
+    {
+        Normal,
+        Sequential,
+        Random
+    };
+
     MMappedFileHandle(const std::string&);
     MMappedFileHandle(Stream&);
 
@@ -30,6 +44,19 @@ public:
 
     const std::string& path() const { return path_; }
 
+    // -- Methods
+
+    /// Before openForRead()
+    void window(size_t bytes) { window_ = bytes; }
+    void access(Access access) { access_ = access; }
+    void readAhead(size_t bytes) { readAhead_ = bytes; }
+    void populate(bool on) { populate_ = on; }
+
+    /// Points data into the mapping at the current position, for up to length bytes, and moves past them. Fewer bytes
+    /// are returned at the end of the file or of the window. The data remains valid until the next read(), view(),
+    /// seek() or close(), or until close() if the whole file is mapped.
+    long view(const void*& data, long length);
+
     // -- Overridden methods
 
     // From DataHandle
@@ -73,14 +100,29 @@ public:
 private:  // members
     std::string path_;
 
-
-    std::unique_ptr<DataHandle> handle_;
-    void* mmap_;
+    char* mmap_;
     int fd_;
+    bool opened_;
+
     off_t length_;
+    off_t position_;
+
+    off_t base_;
+    size_t mapped_;
+    off_t advised_;
+
+    size_t window_;
+    Access access_;
+    size_t readAhead_;
+    bool populate_;
 
 private:  // methods
-    void open(const char*);
+    void defaults();
+    void map(off_t);
+    void unmap();
+    void advance(off_t);
+
+    static const off_t page_;
 
     static ClassSpec classSpec_;
     static Reanimator<MMappedFileHandle> reanimator_;
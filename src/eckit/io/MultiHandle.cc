@@ -12,6 +12,8 @@
 
 #include "eckit/config/Resource.h"
 #include "eckit/io/MultiHandle.h"
+#include "eckit/io/PartFileHandle.h"
+#include "eckit/io/RangeReader.h"
 #include "eckit/log/Timer.h"
 #include "eckit/runtime/Metrics.h"
 #include "eckit/types/Types.h"
@@ -93,6 +95,7 @@ void MultiHandle::operator+=(const Length& length) {
 Length MultiHandle::openForRead() {
 
     read_ = true;
+    reader_.reset(PartFileHandle::rangeReader());
 
     current_ = datahandles_.begin();
     openCurrent();
@@ -160,12 +163,54 @@ long MultiHandle::read1(char* buffer, long length) {
     return n;
 }
 
+long MultiHandle::readRanges(char* buffer, long length) {
+    if (!reader_) {
+        return 0;
+    }
+
+    // Consecutive PartFileHandles are read together, within the limit of open files of PooledHandle
+    const size_t maxOpen = 128;
+
+    std::vector<RangeReader::Range> ranges;
+    std::vector<DataHandle*> done;
+
+    long total = 0;
+    while (length > 0 && current_ != datahandles_.end() && done.size() < maxOpen) {
+        PartFileHandle* part = dynamic_cast<PartFileHandle*>(*current_);
+        if (!part || !part->rangeReads()) {
+            break;
+        }
+
+        long n = part->readRanges(buffer + total, length, ranges);
+        total += n;
+        length -= n;
+
+        // Closed once read
+        if (length > 0) {
+            done.push_back(part);
+            current_++;
+            openCurrent();
+        }
+    }
+
+    reader_->read(ranges);
+
+    for (DataHandle* h : done) {
+        h->close();
+    }
+
+    return total;
+}
+
 long MultiHandle::read(void* buffer, long length) {
     char* p    = static_cast<char*>(buffer);
     long n     = 0;
     long total = 0;
 
-    while (length > 0 && (n = read1(p, length)) > 0) {
+    while (length > 0) {
+        if ((n = readRanges(p, length)) == 0 && (n = read1(p, length)) <= 0) {
+            break;
+        }
         length -= n;
         total += n;
         p += n;
@@ -225,6 +270,7 @@ void MultiHandle::close() {
         (*current_)->close();
     }
     current_ = datahandles_.end();
+    reader_.reset();
 }
 
 void MultiHandle::flush() {
@@ -17,10 +17,14 @@
 #ifndef eckit_filesystem_MultiHandle_h
 #define eckit_filesystem_MultiHandle_h
 
+#include <memory>
+
 #include "eckit/io/DataHandle.h"
 
 namespace eckit {
 
+class RangeReader;
+
 //----------------------------------------------------------------------------------------------------------------------
 
 class MultiHandle : public DataHandle {
@@ -97,12 +101,14 @@ private:
     Length written_;
     mutable std::set<std::string> requiredAttributes_;
     bool read_;
+    std::unique_ptr<RangeReader> reader_;
 
     // -- Methods
 
     void openCurrent();
     void open();
     long read1(char*, long);
+    long readRanges(char*, long);
 
     // -- Class members
 
@@ -9,8 +9,12 @@
  */
 
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <numeric>
 
+#include "eckit/config/Resource.h"
 #include "eckit/io/cluster/NodeInfo.h"
 #include "eckit/log/Log.h"
 
@@ -48,7 +52,7 @@ void PartFileHandle::encode(Stream& s) const {
 }
 
 PartFileHandle::PartFileHandle(Stream& s) :
-    DataHandle(s), pos_(0), index_(0) {
+    DataHandle(s), fd_(-1), pos_(0), index_(0) {
     s >> path_;
     s >> offset_;
     s >> length_;
@@ -57,14 +61,14 @@ PartFileHandle::PartFileHandle(Stream& s) :
 }
 
 PartFileHandle::PartFileHandle(const PathName& name, const OffsetList& offset, const LengthList& length) :
-    path_(name), handle_(), pos_(0), index_(0), offset_(offset), length_(length) {
+    path_(name), handle_(), fd_(-1), pos_(0), index_(0), offset_(offset), length_(length) {
     //    Log::info() << "PartFileHandle::PartFileHandle " << name << std::endl;
     ASSERT(offset_.size() == length_.size());
     compress(false);
 }
 
 PartFileHandle::PartFileHandle(const PathName& name, const Offset& offset, const Length& length) :
-    path_(name), handle_(), pos_(0), index_(0), offset_(1, offset), length_(1, length) {}
+    path_(name), handle_(), fd_(-1), pos_(0), index_(0), offset_(1, offset), length_(1, length) {}
 
 
 DataHandle* PartFileHandle::clone() const {
@@ -79,9 +83,36 @@ bool PartFileHandle::compress(bool sorted) {
     return eckit::compress(offset_, length_);
 }
 
-PartFileHandle::~PartFileHandle() {}
+PartFileHandle::~PartFileHandle() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+RangeReader* PartFileHandle::rangeReader() {
+    static size_t threads = Resource<size_t>("partFileHandleThreads;$ECKIT_PART_FILE_HANDLE_THREADS", 1);
+    static size_t maxGap  = Resource<size_t>("partFileHandleMaxGap;$ECKIT_PART_FILE_HANDLE_MAX_GAP", 64 * 1024);
+    static size_t maxRequest =
+        Resource<size_t>("partFileHandleMaxRequest;$ECKIT_PART_FILE_HANDLE_MAX_REQUEST", 8 * 1024 * 1024);
+    return threads > 1 ? new RangeReader(threads, maxGap, maxRequest) : nullptr;
+}
 
 Length PartFileHandle::openForRead() {
+    if (!reader_) {
+        reader_.reset(rangeReader());
+    }
+
+    if (reader_) {
+        if (fd_ < 0) {
+            fd_ = ::open(path_.localPath(), O_RDONLY | O_CLOEXEC);
+            if (fd_ < 0) {
+                throw CantOpenFile(path_);
+            }
+        }
+        rewind();
+        return estimate();
+    }
+
     if (!handle_) {
         // The handle may already exists if a  restartReadFrom()
         // is requested
@@ -141,7 +172,48 @@ long PartFileHandle::read1(char* buffer, long length) {
 }
 
 
+long PartFileHandle::readRanges(char* buffer, long length, std::vector<RangeReader::Range>& ranges) {
+    ASSERT(fd_ >= 0);
+
+    long total = 0;
+    while (length > 0) {
+        // skip empty entries if any
+        while (index_ < offset_.size() && length_[index_] == Length(0)) {
+            index_++;
+        }
+
+        if (index_ == offset_.size()) {
+            break;
+        }
+
+        long long left = (long long)length_[index_] - pos_;
+        long size      = long(std::min<long long>(length, left));
+
+        ranges.push_back(
+            RangeReader::Range{fd_, off_t((long long)offset_[index_] + pos_), size_t(size), buffer, &path_});
+
+        buffer += size;
+        length -= size;
+        total += size;
+
+        pos_ += size;
+        if (pos_ >= length_[index_]) {
+            index_++;
+            pos_ = 0;
+        }
+    }
+
+    return total;
+}
+
 long PartFileHandle::read(void* buffer, long length) {
+    if (fd_ >= 0) {
+        std::vector<RangeReader::Range> ranges;
+        long n = readRanges(static_cast<char*>(buffer), length, ranges);
+        reader_->read(ranges);
+        return n;
+    }
+
     char* p = (char*)buffer;
 
     long n     = 0;
@@ -161,6 +233,13 @@ long PartFileHandle::write(const void*, long) {
 }
 
 void PartFileHandle::close() {
+    if (fd_ >= 0) {
+        int fd = fd_;
+        fd_    = -1;
+        reader_.reset();
+        SYSCALL(::close(fd));
+    }
+
     if (handle_) {
         handle_->close();
         // Don't delete the handle here so the PooledHandle entry continues
@@ -18,9 +18,11 @@
 #define eckit_filesystem_PartFileHandle_h
 
 #include <memory>
+#include <vector>
 
 #include "eckit/filesystem/PathName.h"
 #include "eckit/io/DataHandle.h"
+#include "eckit/io/RangeReader.h"
 #include "eckit/types/Types.h"
 
 namespace eckit {
@@ -29,6 +31,11 @@ class PooledHandle;
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// Reads parts of a local file, one after the other through a PooledHandle.
+///
+/// If the resource partFileHandleThreads is more than 1, the file is instead opened on its own and the parts are read
+/// with a RangeReader, all the parts that fit in the buffer given to read() at the same time.
+
 class PartFileHandle : public DataHandle {
 public:  // methods
     PartFileHandle(const PathName&, const OffsetList&, const LengthList&);
@@ -39,6 +46,18 @@ public:  // methods
 
     const PathName& path() const { return path_; }
 
+    /// @returns whether the handle, open for reading, reads with a RangeReader
+    bool rangeReads() const { return fd_ >= 0; }
+
+    /// Advances as read() would, but leaves the reading to the caller
+    /// @pre rangeReads()
+    /// @returns the number of bytes to read, the ranges must be read before closing the handle
+    long readRanges(char*, long, std::vector<RangeReader::Range>&);
+
+    /// @returns a reader configured by the resources, partFileHandleThreads, partFileHandleMaxGap and
+    /// partFileHandleMaxRequest, or null if the parts are read one after the other
+    static RangeReader* rangeReader();
+
     // -- Overridden methods
 
     // From DataHandle
@@ -84,6 +103,8 @@ public:  // methods
 private:  // members
     PathName path_;
     std::unique_ptr<PooledHandle> handle_;
+    std::unique_ptr<RangeReader> reader_;
+    int fd_;
     long long pos_;
     Ordinal index_;
     OffsetList offset_;
@@ -26,6 +26,8 @@ namespace eckit {
 
 //-----------------------------------------------------------------------------
 
+// For a chain of stages, each on its own thread, see StagedPipeline
+
 class Pipeline : private NonCopyable {
 public:
     // -- Contructors
@@ -0,0 +1,224 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <sstream>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/RangeReader.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/MutexCond.h"
+#include "eckit/thread/ThreadPool.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+typedef RangeReader::Range Range;
+
+/// Ranges read by one pread(), the bytes between them are read and dropped
+struct Request {
+    int fd;
+    off_t offset;
+    size_t length;
+    const PathName* path;
+    std::vector<Range> ranges;
+};
+
+void plan(const std::vector<Range>& ranges, size_t maxGap, size_t maxRequest, std::vector<Request>& requests) {
+    std::vector<Range> pieces;
+    pieces.reserve(ranges.size());
+    for (const Range& r : ranges) {
+        for (size_t done = 0; done < r.length; done += maxRequest) {
+            pieces.push_back(
+                Range{r.fd, r.offset + off_t(done), std::min(maxRequest, r.length - done), r.buffer + done, r.path});
+        }
+    }
+
+    std::sort(pieces.begin(), pieces.end(),
+              [](const Range& a, const Range& b) { return a.fd != b.fd ? a.fd < b.fd : a.offset < b.offset; });
+
+    // Ranges may overlap, a request ends with the furthest end of its ranges
+    for (const Range& p : pieces) {
+        off_t end = p.offset + off_t(p.length);
+        if (!requests.empty()) {
+            Request& r  = requests.back();
+            off_t until = r.offset + off_t(r.length);
+            if (r.fd == p.fd && (p.offset <= until || size_t(p.offset - until) <= maxGap) &&
+                size_t(std::max(until, end) - r.offset) <= maxRequest) {
+                r.length = size_t(std::max(until, end) - r.offset);
+                r.ranges.push_back(p);
+                continue;
+            }
+        }
+        requests.push_back(Request{p.fd, p.offset, p.length, p.path, {p}});
+    }
+}
+
+std::string describe(const Request& r) {
+    std::ostringstream s;
+    if (r.path) {
+        s << *r.path;
+    }
+    else {
+        s << "fd=" << r.fd;
+    }
+    s << ": cannot read " << r.length << " bytes at offset " << r.offset;
+    return s.str();
+}
+
+void preadFully(const Request& r, char* buffer) {
+    size_t done = 0;
+    while (done < r.length) {
+        ssize_t n = ::pread(r.fd, buffer + done, r.length - done, r.offset + off_t(done));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw ReadError(describe(r) + ": " + std::strerror(errno), Here());
+        }
+        if (n == 0) {
+            std::ostringstream s;
+            s << describe(r) << ", got only " << done;
+            throw ShortFile(s.str(), Here());
+        }
+        done += size_t(n);
+    }
+}
+
+void execute(const Request& r) {
+    // In place, or through a buffer of this thread
+    if (r.ranges.size() == 1) {
+        preadFully(r, r.ranges[0].buffer);
+        return;
+    }
+
+    thread_local std::vector<char> buffer;
+    if (buffer.size() < r.length) {
+        buffer.resize(r.length);
+    }
+
+    preadFully(r, buffer.data());
+
+    for (const Range& p : r.ranges) {
+        ::memcpy(p.buffer, buffer.data() + (p.offset - r.offset), p.length);
+    }
+}
+
+/// Requests of one read, shared between the calling thread and the threads of the pool
+class Batch {
+public:
+    Batch(const std::vector<Request>& requests, size_t helpers) :
+        requests_(requests), next_(0), helpers_(helpers) {}
+
+    void work() {
+        size_t i;
+        while ((i = next_++) < requests_.size()) {
+            try {
+                execute(requests_[i]);
+            }
+            catch (...) {
+                AutoLock<MutexCond> lock(cond_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+                next_ = requests_.size();
+            }
+        }
+    }
+
+    void done() {
+        AutoLock<MutexCond> lock(cond_);
+        helpers_--;
+        cond_.signal();
+    }
+
+    /// @throws the first error of any thread, once they are all finished
+    void wait() {
+        AutoLock<MutexCond> lock(cond_);
+        while (helpers_) {
+            cond_.wait();
+        }
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    const std::vector<Request>& requests_;
+    std::atomic<size_t> next_;
+    size_t helpers_;
+
+    MutexCond cond_;
+    std::exception_ptr error_;
+};
+
+class BatchTask : public ThreadPoolTask {
+public:
+    explicit BatchTask(Batch& batch) :
+        batch_(batch) {}
+
+private:
+    void execute() override {
+        batch_.work();
+        batch_.done();
+    }
+
+    Batch& batch_;
+};
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+RangeReader::RangeReader(size_t threads, size_t maxGap, size_t maxRequest) :
+    threads_(std::max<size_t>(threads, 1)), maxGap_(maxGap), maxRequest_(maxRequest) {
+    ASSERT(maxRequest_ > 0);
+}
+
+RangeReader::~RangeReader() = default;
+
+void RangeReader::read(const std::vector<Range>& ranges) {
+    std::vector<Request> requests;
+    plan(ranges, maxGap_, maxRequest_, requests);
+
+    nbRequests_ += requests.size();
+    for (const Request& r : requests) {
+        nbBytes_ += r.length;
+    }
+
+    // The calling thread reads too
+    size_t helpers = requests.size() > 1 ? std::min(threads_, requests.size()) - 1 : 0;
+
+    if (helpers > 0 && !pool_) {
+        pool_.reset(new ThreadPool("RangeReader", threads_ - 1));
+    }
+
+    Batch batch(requests, helpers);
+    for (size_t i = 0; i < helpers; ++i) {
+        pool_->push(new BatchTask(batch));
+    }
+
+    batch.work();
+    batch.wait();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,85 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   RangeReader.h
+
+#ifndef eckit_io_RangeReader_h
+#define eckit_io_RangeReader_h
+
+#include <sys/types.h>
+
+#include <memory>
+#include <vector>
+
+#include "eckit/memory/NonCopyable.h"
+
+namespace eckit {
+
+class PathName;
+class ThreadPool;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Reads many byte ranges of local files with pread(2), concurrently.
+///
+/// The ranges are sorted by file and offset, and ranges closer than maxGap bytes are read by a single request, up to
+/// maxRequest bytes (larger ranges are split). The requests are then shared between the calling thread and a pool
+/// of threads, started on the first read that needs them and stopped with the reader.
+///
+/// Reading a file with many small parts, for example fields scattered in large files on a parallel filesystem, then
+/// costs a few large requests in flight at the same time instead of a seek and a read per part, one after the other.
+
+class RangeReader : private NonCopyable {
+public:  // types
+    struct Range {
+        int fd;
+        off_t offset;
+        size_t length;
+        char* buffer;  ///< Where the bytes go, length bytes
+        const PathName* path = nullptr;  ///< For error messages only
+    };
+
+public:  // methods
+    /// @param threads reading at the same time, including the calling thread
+    /// @param maxGap largest gap between two ranges read by the same request
+    /// @param maxRequest largest request, at least 1 byte
+    RangeReader(size_t threads, size_t maxGap, size_t maxRequest);
+
+    ~RangeReader();
+
+    /// Reads all the ranges, in any order, and returns once they are all read
+    /// @throws ReadError or ShortFile, once all the requests are finished
+    void read(const std::vector<Range>&);
+
+    size_t threads() const { return threads_; }
+    size_t maxGap() const { return maxGap_; }
+    size_t maxRequest() const { return maxRequest_; }
+
+    // for testing
+
+    size_t nbRequests() const { return nbRequests_; }
+    size_t nbBytes() const { return nbBytes_; }
+
+private:  // members
+    size_t threads_;
+    size_t maxGap_;
+    size_t maxRequest_;
+
+    std::unique_ptr<ThreadPool> pool_;
+
+    size_t nbRequests_ = 0;
+    size_t nbBytes_    = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
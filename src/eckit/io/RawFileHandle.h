@@ -44,6 +44,9 @@ public:
     bool canSeek() const override { return true; }
     void skip(const Length&) override;
 
+    int transferDescriptor() override { return fd_; }
+    void transferred(const Length& n) override { skip(n); }
+
     void encode(Stream&) const override;
 
 private:
@@ -0,0 +1,373 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <iomanip>
+#include <ostream>
+#include <thread>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/DataHandle.h"
+#include "eckit/io/StagedPipeline.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/MutexCond.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+PipelineStage::PipelineStage(const std::string& name) :
+    name_(name) {}
+
+PipelineStage::~PipelineStage() = default;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Item {
+    Buffer buffer;
+    size_t size;
+};
+
+/// Thrown out of a stage waiting to emit, when another has failed
+struct Aborted {};
+
+class Run;
+
+/// The reader (first), a stage, or the writer (last), with its input queue
+struct Node : public PipelineStage::Output {
+    Run& run;
+    size_t index;
+    PipelineStage* stage;
+    StagedPipeline::Statistics& statistics;
+
+    std::deque<Item> input;
+    bool inputClosed = false;
+    bool running     = false;
+    bool finished    = false;
+
+    Node(Run& r, size_t i, PipelineStage* s, StagedPipeline::Statistics& st) :
+        run(r), index(i), stage(s), statistics(st) {}
+
+    void emit(Buffer&&, size_t size) override;
+};
+
+enum class Take
+{
+    None,
+    Item,
+    End
+};
+
+class Run {
+public:
+    Run(DataHandle& in, DataHandle& out, const std::vector<std::unique_ptr<PipelineStage>>& stages,
+        std::vector<StagedPipeline::Statistics>& statistics, size_t threads, size_t queueLength, size_t bufferSize) :
+        in_(in), out_(out), pool_(threads > 0), threads_(threads), queueLength_(queueLength), bufferSize_(bufferSize) {
+        size_t count = stages.size() + 2;
+        for (size_t i = 0; i < count; ++i) {
+            PipelineStage* stage = (i == 0 || i == count - 1) ? nullptr : stages[i - 1].get();
+            nodes_.emplace_back(new Node(*this, i, stage, statistics[i]));
+        }
+    }
+
+    void execute() {
+        std::vector<std::thread> threads;
+        if (pool_) {
+            for (size_t i = 1; i < threads_; ++i) {
+                threads.emplace_back([this] { work(); });
+            }
+            work();
+        }
+        else {
+            for (size_t i = 0; i + 1 < nodes_.size(); ++i) {
+                threads.emplace_back([this, i] { loop(*nodes_[i]); });
+            }
+            loop(*nodes_.back());
+        }
+
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    void emit(Node& node, Buffer&& buffer, size_t size) {
+        ASSERT(node.index + 1 < nodes_.size());
+        Node& next = *nodes_[node.index + 1];
+
+        AutoLock<MutexCond> lock(cond_);
+
+        // With shared threads, back-pressure comes from the scheduling instead
+        if (!pool_) {
+            Clock::time_point start = Clock::now();
+            while (next.input.size() >= queueLength_ && !error_) {
+                cond_.wait();
+            }
+            node.statistics.outputWait += since(start);
+        }
+
+        if (error_) {
+            throw Aborted();
+        }
+
+        next.input.push_back(Item{std::move(buffer), size});
+        node.statistics.buffersOut++;
+        node.statistics.bytesOut += size;
+        cond_.broadcast();
+    }
+
+private:
+    /// A thread per node
+    void loop(Node& node) {
+        for (;;) {
+            Item item{Buffer(), 0};
+            Take take;
+            {
+                AutoLock<MutexCond> lock(cond_);
+                Clock::time_point start = Clock::now();
+                while ((take = next(node, item)) == Take::None && !error_) {
+                    cond_.wait();
+                }
+                node.statistics.inputWait += since(start);
+                if (error_) {
+                    return;
+                }
+            }
+            if (!step(node, take, item)) {
+                return;
+            }
+        }
+    }
+
+    /// Shared threads, taking the steps of the nodes ready, the last ones first
+    void work() {
+        for (;;) {
+            Node* node = nullptr;
+            Item item{Buffer(), 0};
+            Take take = Take::None;
+            {
+                AutoLock<MutexCond> lock(cond_);
+                for (;;) {
+                    if (error_ || finished_ == nodes_.size()) {
+                        return;
+                    }
+                    for (size_t i = nodes_.size(); i-- > 0 && !node;) {
+                        Node& n = *nodes_[i];
+                        if (n.running || n.finished) {
+                            continue;
+                        }
+                        if (i + 1 < nodes_.size() && nodes_[i + 1]->input.size() >= queueLength_) {
+                            continue;
+                        }
+                        if ((take = next(n, item)) != Take::None) {
+                            node = &n;
+                        }
+                    }
+                    if (node) {
+                        break;
+                    }
+                    cond_.wait();
+                }
+                node->running = true;
+            }
+
+            step(*node, take, item);
+
+            AutoLock<MutexCond> lock(cond_);
+            node->running = false;
+            cond_.broadcast();
+        }
+    }
+
+    /// Takes the next input of a node, with the lock held
+    Take next(Node& node, Item& item) {
+        if (node.index == 0) {
+            return Take::Item;
+        }
+        if (!node.input.empty()) {
+            item = std::move(node.input.front());
+            node.input.pop_front();
+            node.statistics.buffersIn++;
+            node.statistics.bytesIn += item.size;
+            cond_.broadcast();
+            return Take::Item;
+        }
+        return node.inputClosed ? Take::End : Take::None;
+    }
+
+    /// Reads a buffer, processes one or writes one, without the lock
+    /// @return false once the node is finished, or has failed
+    bool step(Node& node, Take take, Item& item) {
+        bool more = true;
+        try {
+            Clock::time_point start = Clock::now();
+            double waited           = node.statistics.outputWait;
+
+            if (node.index == 0) {
+                Buffer buffer(bufferSize_);
+                long len = in_.read(buffer, long(buffer.size()));
+                if (len > 0) {
+                    node.statistics.buffersIn++;
+                    node.statistics.bytesIn += size_t(len);
+                    node.emit(std::move(buffer), size_t(len));
+                }
+                else {
+                    more = false;
+                }
+            }
+            else if (node.index + 1 == nodes_.size()) {
+                if (take == Take::Item) {
+                    long len = out_.write(item.buffer, long(item.size));
+                    if (len != long(item.size)) {
+                        throw WriteError("StagedPipeline: short write to " + out_.title(), Here());
+                    }
+                    node.statistics.buffersOut++;
+                    node.statistics.bytesOut += item.size;
+                }
+                else {
+                    more = false;
+                }
+            }
+            else {
+                if (take == Take::Item) {
+                    node.stage->process(std::move(item.buffer), item.size, node);
+                }
+                else {
+                    node.stage->finish(node);
+                    more = false;
+                }
+            }
+
+            node.statistics.busy += since(start) - (node.statistics.outputWait - waited);
+        }
+        catch (Aborted&) {
+            return false;
+        }
+        catch (...) {
+            AutoLock<MutexCond> lock(cond_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+            cond_.broadcast();
+            return false;
+        }
+
+        if (!more) {
+            AutoLock<MutexCond> lock(cond_);
+            if (node.index + 1 < nodes_.size()) {
+                nodes_[node.index + 1]->inputClosed = true;
+            }
+            node.finished = true;
+            finished_++;
+            cond_.broadcast();
+        }
+        return more;
+    }
+
+private:
+    DataHandle& in_;
+    DataHandle& out_;
+
+    bool pool_;
+    size_t threads_;
+    size_t queueLength_;
+    size_t bufferSize_;
+
+    std::vector<std::unique_ptr<Node>> nodes_;
+    size_t finished_ = 0;
+
+    MutexCond cond_;
+    std::exception_ptr error_;
+};
+
+void Node::emit(Buffer&& buffer, size_t size) {
+    run.emit(*this, std::move(buffer), size);
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+StagedPipeline::StagedPipeline() :
+    threads_(Resource<size_t>("stagedPipelineThreads;$ECKIT_STAGED_PIPELINE_THREADS", 0)),
+    queueLength_(Resource<size_t>("stagedPipelineQueueLength;$ECKIT_STAGED_PIPELINE_QUEUE_LENGTH", 4)),
+    bufferSize_(Resource<size_t>("stagedPipelineBufferSize;$ECKIT_STAGED_PIPELINE_BUFFER_SIZE", 1024 * 1024)) {
+    queueLength(queueLength_);
+    bufferSize(bufferSize_);
+}
+
+StagedPipeline::~StagedPipeline() = default;
+
+StagedPipeline& StagedPipeline::add(PipelineStage* stage) {
+    ASSERT(stage);
+    stages_.emplace_back(stage);
+    return *this;
+}
+
+void StagedPipeline::queueLength(size_t n) {
+    queueLength_ = std::max(n, size_t(1));
+}
+
+void StagedPipeline::bufferSize(size_t n) {
+    bufferSize_ = std::max(n, size_t(1));
+}
+
+Length StagedPipeline::copy(DataHandle& in, DataHandle& out) {
+    statistics_.clear();
+    statistics_.resize(stages_.size() + 2);
+    statistics_.front().name = "read";
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        statistics_[i + 1].name = stages_[i]->name();
+    }
+    statistics_.back().name = "write";
+
+    Length estimate = in.openForRead();
+    AutoClose c1(in);
+    out.openForWrite(estimate);
+    AutoClose c2(out);
+
+    Run run(in, out, stages_, statistics_, threads_, queueLength_, bufferSize_);
+    run.execute();
+
+    return statistics_.back().bytesOut;
+}
+
+void StagedPipeline::print(std::ostream& s) const {
+    s << "StagedPipeline[threads=" << threads_ << ",queueLength=" << queueLength_ << ",bufferSize=" << bufferSize_
+      << "]";
+    for (const auto& st : statistics_) {
+        s << std::endl
+          << "    " << std::setw(20) << std::left << st.name << std::right << " in " << std::setw(6) << st.buffersIn
+          << " buffers, " << Bytes(st.bytesIn) << ", out " << std::setw(6) << st.buffersOut << " buffers, "
+          << Bytes(st.bytesOut) << ", busy " << std::fixed << std::setprecision(3) << st.busy << " s, waiting "
+          << st.inputWait << " s for input, " << st.outputWait << " s for output";
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,128 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_io_StagedPipeline_h
+#define eckit_io_StagedPipeline_h
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/io/Length.h"
+#include "eckit/memory/NonCopyable.h"
+
+namespace eckit {
+
+class Buffer;
+class DataHandle;
+class PipelineStage;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Copies a DataHandle into another through a chain of stages, each transforming the data as it goes.
+///
+/// The input is read in buffers of bufferSize() bytes, which are passed from stage to stage, and written into the
+/// output. Buffers are moved, never copied: a stage passes on the buffers it is given, changed in place or not, or new
+/// ones. Consecutive stages are connected by queues of queueLength() buffers; a stage whose output queue is full
+/// waits, so that a slow stage holds back the stages before it, and the memory used stays bounded.
+///
+/// With threads() at 0, the reader, each stage and the writer run on a thread of their own. Otherwise they share
+/// that many threads: a thread runs the step of a stage that has input and room for its output, the last stages
+/// first, one step at a time per stage, so that each stage still sees the buffers in order.
+///
+/// The defaults are from the resources stagedPipelineThreads (0), stagedPipelineQueueLength (4) and
+/// stagedPipelineBufferSize (1 MiB). The first exception thrown by a stage, the reader or the writer stops the copy
+/// and is rethrown by copy().
+
+class StagedPipeline : private NonCopyable {
+public:  // types
+    struct Statistics {
+        std::string name;
+        size_t buffersIn  = 0;
+        size_t buffersOut = 0;
+        size_t bytesIn    = 0;
+        size_t bytesOut   = 0;
+        double busy       = 0;  ///< Seconds in the stage
+        double inputWait  = 0;  ///< Seconds waiting for input, with a thread per stage
+        double outputWait = 0;  ///< Seconds waiting for room in the output queue, with a thread per stage
+    };
+
+public:  // methods
+    StagedPipeline();
+
+    ~StagedPipeline();
+
+    /// Adds a stage after the others, taking ownership
+    StagedPipeline& add(PipelineStage*);
+
+    /// Before copy()
+    void threads(size_t n) { threads_ = n; }
+    void queueLength(size_t n);
+    void bufferSize(size_t n);
+
+    Length copy(DataHandle& in, DataHandle& out);
+
+    /// Of the last copy(): the reader, the stages in order, and the writer
+    const std::vector<Statistics>& statistics() const { return statistics_; }
+
+    void print(std::ostream&) const;
+
+private:  // members
+    std::vector<std::unique_ptr<PipelineStage>> stages_;
+    std::vector<Statistics> statistics_;
+
+    size_t threads_;
+    size_t queueLength_;
+    size_t bufferSize_;
+
+    friend std::ostream& operator<<(std::ostream& s, const StagedPipeline& p) {
+        p.print(s);
+        return s;
+    }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// A stage of a StagedPipeline, called by one thread at a time
+
+class PipelineStage {
+public:
+    class Output {
+    public:
+        /// Passes on a buffer holding size bytes of data to the next stage
+        virtual void emit(Buffer&&, size_t size) = 0;
+
+    protected:
+        ~Output() = default;
+    };
+
+public:
+    explicit PipelineStage(const std::string& name);
+
+    virtual ~PipelineStage();
+
+    const std::string& name() const { return name_; }
+
+    /// Receives each buffer in order, holding size bytes of data
+    virtual void process(Buffer&&, size_t size, Output&) = 0;
+
+    /// At the end of the data
+    virtual void finish(Output&) {}
+
+private:
+    std::string name_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
@@ -8,6 +8,8 @@
  * does it submit to any jurisdiction.
  */
 
+#include <chrono>
+
 #include "eckit/eckit.h"
 
 #include "eckit/config/Resource.h"
@@ -19,6 +21,7 @@
 #include "eckit/log/BigNum.h"
 #include "eckit/log/Bytes.h"
 #include "eckit/log/Seconds.h"
+#include "eckit/runtime/Metrics.h"
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -27,6 +30,33 @@ namespace eckit {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+namespace {
+
+/// Times an operation into a histogram (nanoseconds) and a total (seconds)
+class Latency {
+public:
+    Latency(Histogram& histogram, double& total) :
+        histogram_(histogram), total_(total), start_(std::chrono::steady_clock::now()) {}
+
+    ~Latency() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+        histogram_.record(ns.count());
+        total_ += ns.count() * 1e-9;
+    }
+
+private:
+    Histogram& histogram_;
+    double& total_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+void report(const char* title, const Histogram& h) {
+    std::cout << title << eckit::Seconds(h.percentile(50) * 1e-9) << " (p50), " << eckit::Seconds(h.percentile(99) * 1e-9)
+              << " (p99), " << eckit::Seconds(h.max() * 1e-9) << " (max)" << std::endl;
+}
+
+}  // namespace
+
 StatsHandle::StatsHandle(DataHandle& handle) :
     HandleHolder(handle),
     reads_(0),
@@ -63,6 +93,7 @@ StatsHandle::~StatsHandle() {
         std::cout << "  Average read: " << eckit::Bytes(bytesRead_ / reads_) << std::endl;
         std::cout << "     Read time: " << eckit::Seconds(readTime_) << std::endl;
         std::cout << "     Read rate: " << eckit::Bytes(bytesRead_, readTime_) << std::endl;
+        report("  Read latency: ", readLatency_);
     }
 
     if (writes_) {
@@ -71,11 +102,13 @@ StatsHandle::~StatsHandle() {
         std::cout << " Average write: " << eckit::Bytes(bytesWritten_ / writes_) << std::endl;
         std::cout << "    Write time: " << eckit::Seconds(writeTime_) << std::endl;
         std::cout << "    Write rate: " << eckit::Bytes(bytesWritten_, writeTime_) << std::endl;
+        report(" Write latency: ", writeLatency_);
     }
 
     if (seeks_) {
         std::cout << "  No. of seeks: " << eckit::BigNum(seeks_) << std::endl;
         std::cout << "     Seek time: " << eckit::Seconds(seekTime_) << std::endl;
+        report("  Seek latency: ", seekLatency_);
     }
 }
 
@@ -100,21 +133,17 @@ void StatsHandle::openForAppend(const Length& l) {
 }
 
 long StatsHandle::read(void* data, long len) {
-    double x = timer_.elapsed();
+    Latency latency(readLatency_, readTime_);
     reads_++;
     bytesRead_ += len;
-    long ret = handle().read(data, len);
-    readTime_ += timer_.elapsed() - x;
-    return ret;
+    return handle().read(data, len);
 }
 
 long StatsHandle::write(const void* data, long len) {
-    double x = timer_.elapsed();
+    Latency latency(writeLatency_, writeTime_);
     writes_++;
     bytesWritten_ += len;
-    long ret = handle().write(data, len);
-    writeTime_ += timer_.elapsed() - x;
-    return ret;
+    return handle().write(data, len);
 }
 
 void StatsHandle::close() {
@@ -134,25 +163,21 @@ Offset StatsHandle::position() {
 }
 
 Offset StatsHandle::seek(const Offset& o) {
-    double x = timer_.elapsed();
+    Latency latency(seekLatency_, seekTime_);
     seeks_++;
-    Offset ret = handle().seek(o);
-    seekTime_ += timer_.elapsed() - x;
-    return ret;
+    return handle().seek(o);
 }
 
 void StatsHandle::skip(const Length& n) {
-    double x = timer_.elapsed();
+    Latency latency(seekLatency_, seekTime_);
     seeks_++;
     handle().skip(n);
-    seekTime_ += timer_.elapsed() - x;
 }
 
 void StatsHandle::rewind() {
-    double x = timer_.elapsed();
+    Latency latency(seekLatency_, seekTime_);
     seeks_++;
     handle().rewind();
-    seekTime_ += timer_.elapsed() - x;
 }
 
 void StatsHandle::restartReadFrom(const Offset& o) {
@@ -210,6 +235,15 @@ std::string StatsHandle::title() const {
 }
 
 void StatsHandle::collectMetrics(const std::string& what) const {
+    if (reads_) {
+        Metrics::setHistogram(what + "_read_latency", readLatency_, 1e-9);
+    }
+    if (writes_) {
+        Metrics::setHistogram(what + "_write_latency", writeLatency_, 1e-9);
+    }
+    if (seeks_) {
+        Metrics::setHistogram(what + "_seek_latency", seekLatency_, 1e-9);
+    }
     handle().collectMetrics(what);
 }
 
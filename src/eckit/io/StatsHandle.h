@@ -17,6 +17,7 @@
 #include "eckit/filesystem/PathName.h"
 #include "eckit/io/Buffer.h"
 #include "eckit/io/HandleHolder.h"
+#include "eckit/log/Histogram.h"
 #include "eckit/log/Timer.h"
 #include "eckit/types/Types.h"
 
@@ -107,6 +108,11 @@ private:
     double readTime_;
     double writeTime_;
     double seekTime_;
+
+    // Latencies in nanoseconds
+    Histogram readLatency_;
+    Histogram writeLatency_;
+    Histogram seekLatency_;
 };
 
 
@@ -53,6 +53,9 @@ public:
 
     bool canSeek() const override { return false; }
 
+    int transferDescriptor() override { return connection_.socket(); }
+    void transferred(const Length&) override {}
+
     virtual void selectMover(eckit::MoverTransferSelection&, bool) const override;
 
     // From Streamable
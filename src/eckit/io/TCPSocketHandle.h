@@ -53,6 +53,9 @@ public:
     Offset seek(const Offset&) override;
     bool canSeek() const override { return true; }
 
+    int transferDescriptor() override { return connection_.socket(); }
+    void transferred(const Length& n) override { position_ += n; }
+
     // From Streamable
 
 
@@ -8,8 +8,18 @@
  * does it submit to any jurisdiction.
  */
 
-#include "eckit/io/TeeHandle.h"
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <thread>
+
+#include "eckit/config/Resource.h"
 #include "eckit/exception/Exceptions.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/TeeHandle.h"
+#include "eckit/memory/NonCopyable.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/MutexCond.h"
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -17,18 +27,172 @@ namespace eckit {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// Feeds each handle from its own thread, in the order of the writes
+class TeeHandleFanOut : private NonCopyable {
+public:
+    TeeHandleFanOut(const TeeHandle::HandleList& handles, size_t window) :
+        window_(window), inFlight_(0), stop_(false) {
+        for (DataHandle* h : handles) {
+            branches_.emplace_back(new Branch(h));
+        }
+        for (auto& b : branches_) {
+            Branch* branch = b.get();
+            branch->thread_ = std::thread([this, branch] { run(*branch); });
+        }
+    }
+
+    ~TeeHandleFanOut() { stop(); }
+
+    void write(const void* buffer, long length) {
+        // Buffers are reused rather than allocated and faulted in again for each write
+        Buffer data;
+        {
+            AutoLock<MutexCond> lock(cond_);
+            if (!spare_.empty()) {
+                data = std::move(spare_.back());
+                spare_.pop_back();
+            }
+        }
+        if (data.size() < size_t(length)) {
+            data.resize(length);
+        }
+        ::memcpy(data.data(), buffer, length);
+
+        std::shared_ptr<Block> block(new Block(std::move(data), length, branches_.size()));
+
+        AutoLock<MutexCond> lock(cond_);
+
+        // A write larger than the window is let through on its own
+        while (inFlight_ > 0 && inFlight_ + size_t(length) > window_ && !error_) {
+            cond_.wait();
+        }
+
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+
+        inFlight_ += length;
+        for (auto& b : branches_) {
+            b->queue_.push_back(block);
+        }
+        cond_.broadcast();
+    }
+
+    /// Waits for all the handles to have been written
+    void drain() {
+        AutoLock<MutexCond> lock(cond_);
+        while (inFlight_ > 0) {
+            cond_.wait();
+        }
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    void stop() {
+        {
+            AutoLock<MutexCond> lock(cond_);
+            stop_ = true;
+            cond_.broadcast();
+        }
+        for (auto& b : branches_) {
+            if (b->thread_.joinable()) {
+                b->thread_.join();
+            }
+        }
+    }
+
+private:
+    /// Written into all the handles, counted in the window until the last one is done with it
+    struct Block {
+        Block(Buffer&& data, long length, size_t pending) :
+            data_(std::move(data)), length_(length), pending_(pending) {}
+        Buffer data_;
+        long length_;
+        size_t pending_;
+    };
+
+    struct Branch {
+        explicit Branch(DataHandle* handle) :
+            handle_(handle), failed_(false) {}
+        DataHandle* handle_;
+        std::deque<std::shared_ptr<Block>> queue_;
+        std::thread thread_;
+        bool failed_;
+    };
+
+    void run(Branch& b) {
+        for (;;) {
+            std::shared_ptr<Block> block;
+            {
+                AutoLock<MutexCond> lock(cond_);
+                while (b.queue_.empty() && !stop_) {
+                    cond_.wait();
+                }
+                if (b.queue_.empty()) {
+                    return;
+                }
+                block = b.queue_.front();
+            }
+
+            // After an error, the following blocks are dropped so that the writer does not wait for them
+            if (!b.failed_) {
+                try {
+                    if (b.handle_->write(block->data_.data(), block->length_) != block->length_) {
+                        throw WriteError(b.handle_->name());
+                    }
+                }
+                catch (...) {
+                    b.failed_ = true;
+                    AutoLock<MutexCond> lock(cond_);
+                    if (!error_) {
+                        error_ = std::current_exception();
+                    }
+                }
+            }
+
+            AutoLock<MutexCond> lock(cond_);
+            b.queue_.pop_front();
+            if (--block->pending_ == 0) {
+                inFlight_ -= block->length_;
+                if (spare_.size() < maxSpare_) {
+                    spare_.push_back(std::move(block->data_));
+                }
+            }
+            cond_.broadcast();
+        }
+    }
+
+    static constexpr size_t maxSpare_ = 16;
+
+    MutexCond cond_;
+    std::vector<std::unique_ptr<Branch>> branches_;
+    std::vector<Buffer> spare_;
+    size_t window_;
+    size_t inFlight_;
+    bool stop_;
+    std::exception_ptr error_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
 ClassSpec TeeHandle::classSpec_ = {
     &DataHandle::classSpec(),
     "TeeHandle",
 };
 Reanimator<TeeHandle> TeeHandle::reanimator_;
 
-TeeHandle::TeeHandle() {}
+TeeHandle::TeeHandle() {
+    defaults();
+}
 
 TeeHandle::TeeHandle(const std::vector<DataHandle*>& v) :
-    datahandles_(v) {}
+    datahandles_(v) {
+    defaults();
+}
 
 TeeHandle::TeeHandle(DataHandle* a, DataHandle* b) {
+    defaults();
     datahandles_.push_back(a);
     datahandles_.push_back(b);
 }
@@ -36,6 +200,8 @@ TeeHandle::TeeHandle(DataHandle* a, DataHandle* b) {
 
 TeeHandle::TeeHandle(Stream& s) :
     DataHandle(s) {
+    defaults();
+
     unsigned long size;
     s >> size;
 
@@ -56,7 +222,16 @@ void TeeHandle::encode(Stream& s) const {
     }
 }
 
+void TeeHandle::defaults() {
+    static bool concurrent = Resource<bool>("teeHandleConcurrent;$ECKIT_TEE_HANDLE_CONCURRENT", false);
+    static size_t window   = Resource<size_t>("teeHandleWindow;$ECKIT_TEE_HANDLE_WINDOW", 64 * 1024 * 1024);
+    concurrent_            = concurrent;
+    window_                = window;
+}
+
 TeeHandle::~TeeHandle() {
+    // Before the handles it writes into
+    fanOut_.reset();
     for (size_t i = 0; i < datahandles_.size(); i++) {
         delete datahandles_[i];
     }
@@ -75,6 +250,10 @@ void TeeHandle::openForWrite(const Length& length) {
     for (size_t i = 0; i < datahandles_.size(); i++) {
         datahandles_[i]->openForWrite(length);
     }
+
+    if (concurrent_ && datahandles_.size() > 1) {
+        fanOut_.reset(new TeeHandleFanOut(datahandles_, window_));
+    }
 }
 
 void TeeHandle::openForAppend(const Length&) {
@@ -86,6 +265,11 @@ long TeeHandle::read(void*, long) {
 }
 
 long TeeHandle::write(const void* buffer, long length) {
+    if (fanOut_) {
+        fanOut_->write(buffer, length);
+        return length;
+    }
+
     long len = 0;
     for (size_t i = 0; i < datahandles_.size(); i++) {
         long l = datahandles_[i]->write(buffer, length);
@@ -98,12 +282,31 @@ long TeeHandle::write(const void* buffer, long length) {
 }
 
 void TeeHandle::close() {
+    // The handles are closed even if one of them failed
+    std::exception_ptr error;
+    if (fanOut_) {
+        try {
+            fanOut_->drain();
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        fanOut_.reset();
+    }
+
     for (size_t i = 0; i < datahandles_.size(); i++) {
         datahandles_[i]->close();
     }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
 }
 
 void TeeHandle::flush() {
+    if (fanOut_) {
+        fanOut_->drain();
+    }
     for (size_t i = 0; i < datahandles_.size(); i++) {
         datahandles_[i]->flush();
     }
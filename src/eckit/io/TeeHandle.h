@@ -14,14 +14,23 @@
 #ifndef eckit_filesystem_TeeHandle_h
 #define eckit_filesystem_TeeHandle_h
 
+#include <memory>
+
 #include "eckit/io/DataHandle.h"
 
 //-----------------------------------------------------------------------------
 
 namespace eckit {
 
+class TeeHandleFanOut;
+
 //-----------------------------------------------------------------------------
 
+/// Writes the same data into several handles. Optionally, each handle is written by its own thread, so that a slow
+/// handle does not hold the others back; the data is then copied into buffers shared by the threads, up to a window
+/// of bytes not yet written into all the handles, and errors are reported by the following write(), flush() or
+/// close(). The defaults are from the resources teeHandleConcurrent (off) and teeHandleWindow (64 MiB).
+
 class TeeHandle : public DataHandle {
 public:
     typedef std::vector<DataHandle*> HandleList;
@@ -41,6 +50,12 @@ public:
 
     virtual void operator+=(DataHandle*);
 
+    // -- Methods
+
+    /// Before openForWrite()
+    void concurrent(bool on) { concurrent_ = on; }
+    void window(size_t bytes) { window_ = bytes; }
+
     // -- Overridden methods
 
     // From DataHandle
@@ -80,8 +95,14 @@ private:
 
     HandleList datahandles_;
 
+    bool concurrent_;
+    size_t window_;
+    std::unique_ptr<TeeHandleFanOut> fanOut_;
+
     // -- Methods
 
+    void defaults();
+
     // -- Class members
 
     static ClassSpec classSpec_;
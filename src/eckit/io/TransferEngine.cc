@@ -0,0 +1,472 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/DataHandle.h"
+#include "eckit/io/TransferEngine.h"
+#include "eckit/log/Progress.h"
+#include "eckit/log/Timer.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/MutexCond.h"
+
+#if defined(__linux__) && defined(SYS_copy_file_range)
+#define ECKIT_TRANSFER_COPY_FILE_RANGE 1
+#else
+#define ECKIT_TRANSFER_COPY_FILE_RANGE 0
+#endif
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/// Buffers on page boundaries, as O_DIRECT and some filesystems prefer
+class AlignedBuffer {
+public:
+    explicit AlignedBuffer(size_t size) {
+        void* p = nullptr;
+        if (::posix_memalign(&p, 4096, std::max<size_t>(size, 1)) != 0) {
+            throw FailedSystemCall("posix_memalign");
+        }
+        data_.reset(static_cast<char*>(p));
+    }
+
+    char* data() { return data_.get(); }
+
+private:
+    struct Free {
+        void operator()(char* p) const { ::free(p); }
+    };
+    std::unique_ptr<char, Free> data_;
+};
+
+#if defined(__linux__)
+
+/// Errors for which the kernel cannot copy between these descriptors, the copy continuing with read() and write()
+bool unsupported(int err) {
+    return err == ENOSYS || err == EXDEV || err == EINVAL || err == EOPNOTSUPP || err == EBADF || err == ETXTBSY;
+}
+
+#if ECKIT_TRANSFER_COPY_FILE_RANGE
+ssize_t copyFileRange(int in, off_t* inOffset, int out, off_t* outOffset, size_t length) {
+    return ::syscall(SYS_copy_file_range, in, inOffset, out, outOffset, length, 0U);
+}
+#endif
+
+#endif
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TransferEngine::TransferEngine(long bufferSize, TransferWatcher& watcher) :
+    bufferSize_(bufferSize),
+    buffers_(Resource<long>("transferBuffers;$ECKIT_TRANSFER_BUFFERS", 4)),
+    zeroCopy_(Resource<bool>("transferZeroCopy;$ECKIT_TRANSFER_ZERO_COPY", true)),
+    threads_(Resource<long>("transferThreads;$ECKIT_TRANSFER_THREADS", 4)),
+    watcher_(watcher),
+    progress_(nullptr),
+    total_(0),
+    readTime_(0),
+    writeTime_(0),
+    method_(NONE) {
+    ASSERT(bufferSize_ > 0);
+}
+
+void TransferEngine::restartFrom(const Offset& from) {
+    total_ = Length(0) + from;
+}
+
+void TransferEngine::copied(const void* buffer, long length) {
+    total_ += length;
+    watcher_.watch(buffer, length);
+    if (progress_) {
+        (*progress_)(total_);
+    }
+}
+
+Length TransferEngine::copy(DataHandle& in, DataHandle& out, const Length& length) {
+    method_ = NONE;
+
+    Length copied = 0;
+    if (zeroCopy_ && !watcher_.needsData()) {
+        bool done = false;
+        copied    = copyDescriptors(in, out, length, done);
+        if (done) {
+            return copied;
+        }
+    }
+
+    Length rest = 0;
+    if (length != Length(0)) {
+        rest = length - copied;
+    }
+
+    // Another thread is not worth it for a single buffer
+    long slot = bufferSize_ / std::max(buffers_, 1L);
+    if (buffers_ > 1 && slot > 0 && in.doubleBufferOK() && out.doubleBufferOK() &&
+        (rest == Length(0) || rest > Length(slot))) {
+        return copied + copyRing(in, out, rest);
+    }
+
+    return copied + copyBuffer(in, out, rest);
+}
+
+Length TransferEngine::copyDescriptors(DataHandle& in, DataHandle& out, const Length& length, bool& done) {
+    done = false;
+
+#if defined(__linux__)
+    int from = in.transferDescriptor();
+    int to   = out.transferDescriptor();
+    if (from < 0 || to < 0) {
+        return 0;
+    }
+
+    struct stat fromStat;
+    struct stat toStat;
+    if (::fstat(from, &fromStat) < 0 || ::fstat(to, &toStat) < 0 || !S_ISREG(fromStat.st_mode)) {
+        return 0;
+    }
+
+    const bool file = S_ISREG(toStat.st_mode);
+    if (!file && !S_ISSOCK(toStat.st_mode) && !S_ISFIFO(toStat.st_mode)) {
+        return 0;
+    }
+
+#if !ECKIT_TRANSFER_COPY_FILE_RANGE
+    if (file) {
+        return 0;
+    }
+#endif
+
+    off_t fromOffset = off_t(in.position());
+    off_t toOffset   = file ? off_t(out.position()) : 0;
+
+    // As read() would, until the end of the input as it is now
+    unsigned long long todo = fromStat.st_size > fromOffset ? fromStat.st_size - fromOffset : 0;
+    if (length != Length(0)) {
+        todo = std::min<unsigned long long>(todo, length);
+    }
+
+    const size_t chunk = size_t(bufferSize_);
+    Length copied      = 0;
+
+#if ECKIT_TRANSFER_COPY_FILE_RANGE
+    // Ranges at the same offsets in both files, copied concurrently once the first one shows it is supported
+    if (file && threads_ > 1 && todo >= 2 * chunk) {
+        off_t a       = fromOffset;
+        off_t b       = toOffset;
+        ssize_t first = copyFileRange(from, &a, to, &b, chunk);
+        if (first < 0 && unsupported(errno)) {
+            return 0;
+        }
+        if (first < 0) {
+            throw FailedSystemCall("copy_file_range");
+        }
+
+        method_ = COPY_FILE_RANGE;
+
+        const unsigned long long start = first;
+        const size_t ranges            = size_t((todo - start + chunk - 1) / chunk);
+        std::atomic<size_t> next(0);
+        std::exception_ptr error;
+        Mutex mutex;
+
+        auto work = [&]() {
+            size_t i;
+            while ((i = next++) < ranges) {
+                unsigned long long at  = start + i * chunk;
+                unsigned long long end = std::min<unsigned long long>(at + chunk, todo);
+                off_t f                = fromOffset + off_t(at);
+                off_t t                = toOffset + off_t(at);
+                while (f < fromOffset + off_t(end)) {
+                    ssize_t n = copyFileRange(from, &f, to, &t, size_t(fromOffset + off_t(end) - f));
+                    if (n < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (n <= 0) {
+                        AutoLock<Mutex> lock(mutex);
+                        if (!error && n < 0) {
+                            error = std::make_exception_ptr(FailedSystemCall("copy_file_range"));
+                        }
+                        if (!error) {
+                            error = std::make_exception_ptr(
+                                ShortFile(in.name() + ": end of file while copying into " + out.name()));
+                        }
+                        next = ranges;
+                        return;
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (long i = 1; i < std::min<long>(threads_, long(ranges)); ++i) {
+            threads.emplace_back(work);
+        }
+        work();
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        in.transferred(todo);
+        out.transferred(todo);
+        this->copied(nullptr, long(todo));
+
+        done = true;
+        return todo;
+    }
+#endif
+
+    while (copied < Length(todo)) {
+        size_t n = size_t(std::min<unsigned long long>(chunk, todo - (unsigned long long)copied));
+        ssize_t r;
+#if ECKIT_TRANSFER_COPY_FILE_RANGE
+        if (file) {
+            r = copyFileRange(from, &fromOffset, to, &toOffset, n);
+        }
+        else
+#endif
+        {
+            r = ::sendfile(to, from, &fromOffset, n);
+        }
+
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // A socket in non-blocking mode
+            if (errno == EAGAIN && !file) {
+                struct pollfd p = {to, POLLOUT, 0};
+                ::poll(&p, 1, -1);
+                continue;
+            }
+            if (unsupported(errno) && method_ == NONE) {
+                return 0;
+            }
+            throw FailedSystemCall(file ? "copy_file_range" : "sendfile");
+        }
+
+        method_ = file ? COPY_FILE_RANGE : SENDFILE;
+
+        // End of the input
+        if (r == 0) {
+            break;
+        }
+
+        in.transferred(r);
+        out.transferred(r);
+        copied += r;
+        this->copied(nullptr, long(r));
+    }
+
+    done = true;
+    return copied;
+#else
+    return 0;
+#endif
+}
+
+Length TransferEngine::copyRing(DataHandle& in, DataHandle& out, const Length& length) {
+    method_ = RING;
+
+    struct Slot {
+        char* data;
+        long length;
+        bool full;
+    };
+
+    const long slot = bufferSize_ / buffers_;
+    AlignedBuffer buffer(size_t(slot) * size_t(buffers_));
+
+    std::vector<Slot> slots(buffers_);
+    for (long i = 0; i < buffers_; ++i) {
+        slots[i] = Slot{buffer.data() + i * slot, 0, false};
+    }
+
+    MutexCond cond;
+    bool stop = false;
+    std::exception_ptr error;
+
+    auto failed = [&]() {
+        AutoLock<MutexCond> lock(cond);
+        if (!error) {
+            error = std::current_exception();
+        }
+        stop = true;
+        cond.broadcast();
+    };
+
+    // Writes in another thread, as DblBuffer, so that handles reading from pools of this thread keep working
+    std::thread writer([&]() {
+        Timer timer;
+        for (size_t i = 0;; i = (i + 1) % slots.size()) {
+            Slot& s = slots[i];
+            {
+                AutoLock<MutexCond> lock(cond);
+                while (!s.full && !stop) {
+                    cond.wait();
+                }
+                if (stop || s.length == 0) {
+                    return;
+                }
+            }
+
+            try {
+                double start = timer.elapsed();
+                if (out.write(s.data, s.length) != s.length) {
+                    throw WriteError(in.name() + " into " + out.name());
+                }
+                writeTime_ += timer.elapsed() - start;
+            }
+            catch (...) {
+                failed();
+                return;
+            }
+
+            AutoLock<MutexCond> lock(cond);
+            s.full = false;
+            cond.broadcast();
+        }
+    });
+
+    Length total = 0;
+    size_t i     = 0;
+    try {
+        Timer timer;
+        for (;; i = (i + 1) % slots.size()) {
+            Slot& s = slots[i];
+            {
+                AutoLock<MutexCond> lock(cond);
+                while (s.full && !stop) {
+                    cond.wait();
+                }
+                if (stop) {
+                    break;
+                }
+            }
+
+            long n = slot;
+            if (length != Length(0)) {
+                n = long(std::min<long long>(n, length - total));
+            }
+
+            double start = timer.elapsed();
+            n            = n > 0 ? in.read(s.data, n) : 0;
+            readTime_ += timer.elapsed() - start;
+
+            if (n < 0) {
+                throw ReadError(in.name() + " into " + out.name());
+            }
+
+            if (n > 0) {
+                copied(s.data, n);
+            }
+
+            AutoLock<MutexCond> lock(cond);
+            s.length = n;
+            s.full   = true;
+            cond.broadcast();
+
+            if (n == 0) {
+                break;
+            }
+            total += n;
+        }
+    }
+    catch (...) {
+        // The writer finishes with the slots already read, as a restart expects them written
+        AutoLock<MutexCond> lock(cond);
+        if (!error) {
+            error = std::current_exception();
+        }
+        slots[i].length = 0;
+        slots[i].full   = true;
+        cond.broadcast();
+    }
+
+    writer.join();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    return total;
+}
+
+Length TransferEngine::copyBuffer(DataHandle& in, DataHandle& out, const Length& length) {
+    method_ = BUFFER;
+
+    long size = bufferSize_;
+    if (length != Length(0)) {
+        size = long(std::min(Length(size), length));
+    }
+    AlignedBuffer buffer(size);
+
+    Timer timer;
+    Length total = 0;
+
+    while (length == Length(0) || total < length) {
+        long n = size;
+        if (length != Length(0)) {
+            n = long(std::min<long long>(n, length - total));
+        }
+
+        double start = timer.elapsed();
+        n            = in.read(buffer.data(), n);
+        readTime_ += timer.elapsed() - start;
+
+        if (n < 0) {
+            throw ReadError(in.name() + " into " + out.name());
+        }
+        if (n == 0) {
+            break;
+        }
+
+        start = timer.elapsed();
+        if (out.write(buffer.data(), n) != n) {
+            throw WriteError(in.name() + " into " + out.name());
+        }
+        writeTime_ += timer.elapsed() - start;
+
+        total += n;
+        copied(buffer.data(), n);
+    }
+
+    return total;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,108 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   TransferEngine.h
+
+#ifndef eckit_io_TransferEngine_h
+#define eckit_io_TransferEngine_h
+
+#include "eckit/io/Length.h"
+#include "eckit/io/Offset.h"
+#include "eckit/io/TransferWatcher.h"
+#include "eckit/memory/NonCopyable.h"
+
+namespace eckit {
+
+class DataHandle;
+class Progress;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Copies the bytes of a handle open for reading into a handle open for writing, for DataHandle::saveInto() and
+/// DataHandle::copyTo(). In order of preference:
+///
+/// - if both handles have a transferDescriptor(), the input a regular file, and the watcher does not need the bytes:
+///   copy_file_range(2) into a regular file, in parallel ranges for large copies, or sendfile(2) into a socket,
+///   without the bytes going through user space (Linux only)
+/// - if both handles are doubleBufferOK(): reads in the calling thread and writes in another, through a ring of
+///   aligned buffers
+/// - otherwise: reads and writes in turn, with one buffer
+///
+/// A RestartTransfer thrown by either handle stops the copy and is rethrown, the caller restarting the handles and
+/// the watcher before copying the rest.
+
+class TransferEngine : private NonCopyable {
+public:  // methods
+    /// @param bufferSize total size of the buffers
+    /// The other settings are from the resources transferBuffers (4), transferZeroCopy (on) and transferThreads (4)
+    explicit TransferEngine(long bufferSize, TransferWatcher& = TransferWatcher::dummy());
+
+    /// @param length bytes to copy, all until the end of the input if 0
+    /// @returns the number of bytes copied, less than length only at the end of the input
+    Length copy(DataHandle& in, DataHandle& out, const Length& length = 0);
+
+    /// After a RestartTransfer, so that the progress restarts from there
+    void restartFrom(const Offset&);
+
+    /// Reports the bytes copied so far
+    void progress(Progress* p) { progress_ = p; }
+
+    /// Number of buffers of the ring, 1 not to use another thread
+    void buffers(long n) { buffers_ = n; }
+
+    /// Not to use descriptors, even if both handles have one
+    void zeroCopy(bool on) { zeroCopy_ = on; }
+
+    /// Threads for copies between regular files
+    void threads(long n) { threads_ = n; }
+
+    /// Time spent reading and writing by all the copies, 0 for copies between descriptors
+    double readTime() const { return readTime_; }
+    double writeTime() const { return writeTime_; }
+
+    /// How the last copy was made
+    enum Method
+    {
+        NONE,
+        COPY_FILE_RANGE,
+        SENDFILE,
+        RING,
+        BUFFER,
+    };
+
+    Method method() const { return method_; }
+
+private:  // methods
+    Length copyDescriptors(DataHandle& in, DataHandle& out, const Length& length, bool& done);
+    Length copyRing(DataHandle& in, DataHandle& out, const Length& length);
+    Length copyBuffer(DataHandle& in, DataHandle& out, const Length& length);
+
+    void copied(const void*, long);
+
+private:  // members
+    long bufferSize_;
+    long buffers_;
+    bool zeroCopy_;
+    long threads_;
+
+    TransferWatcher& watcher_;
+    Progress* progress_;
+
+    Length total_;
+    double readTime_;
+    double writeTime_;
+    Method method_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
@@ -10,6 +10,7 @@
 
 
 #include "eckit/io/TransferWatcher.h"
+#include "eckit/runtime/Metrics.h"
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -20,6 +21,7 @@ namespace eckit {
 
 struct DummyTransferWatcher : public TransferWatcher {
     void watch(const void*, long) {}
+    bool needsData() const { return false; }
 };
 
 TransferWatcher& TransferWatcher::dummy() {
@@ -29,4 +31,42 @@ TransferWatcher& TransferWatcher::dummy() {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+HistogramWatcher::HistogramWatcher(TransferWatcher& next) :
+    next_(next), last_(std::chrono::steady_clock::now()) {}
+
+void HistogramWatcher::watch(const void* buffer, long length) {
+    auto now = std::chrono::steady_clock::now();
+
+    // Transfers start with watch(0, 0)
+    if (length > 0) {
+        latency_.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_).count());
+        sizes_.record(length);
+    }
+
+    last_ = now;
+    next_.watch(buffer, length);
+}
+
+void HistogramWatcher::restartFrom(const Offset& offset) {
+    last_ = std::chrono::steady_clock::now();
+    next_.restartFrom(offset);
+}
+
+void HistogramWatcher::fromHandleOpened() {
+    last_ = std::chrono::steady_clock::now();
+    next_.fromHandleOpened();
+}
+
+void HistogramWatcher::toHandleOpened() {
+    last_ = std::chrono::steady_clock::now();
+    next_.toHandleOpened();
+}
+
+void HistogramWatcher::collectMetrics(const std::string& prefix) const {
+    Metrics::setHistogram(prefix + "_block_latency", latency_, 1e-9);
+    Metrics::setHistogram(prefix + "_block_size", sizes_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 }  // namespace eckit
@@ -14,6 +14,11 @@
 #ifndef eckit_TransferWatcher_h
 #define eckit_TransferWatcher_h
 
+#include <chrono>
+#include <string>
+
+#include "eckit/log/Histogram.h"
+
 //-----------------------------------------------------------------------------
 
 namespace eckit {
@@ -31,6 +36,9 @@ public:
     virtual void fromHandleOpened() {}
     virtual void toHandleOpened() {}
 
+    /// If not, the transfer may be made without reading the bytes, and watch() called with a null buffer
+    virtual bool needsData() const { return true; }
+
     virtual ~TransferWatcher() {}
 
     // -- Class methods
@@ -38,6 +46,32 @@ public:
     static TransferWatcher& dummy();
 };
 
+//-----------------------------------------------------------------------------
+
+/// Records the time between blocks of a transfer (nanoseconds) and their sizes, and forwards to another watcher
+class HistogramWatcher : public TransferWatcher {
+public:
+    explicit HistogramWatcher(TransferWatcher& next = TransferWatcher::dummy());
+
+    void watch(const void*, long) override;
+    void restartFrom(const Offset&) override;
+    void fromHandleOpened() override;
+    void toHandleOpened() override;
+    bool needsData() const override { return next_.needsData(); }
+
+    const Histogram& latency() const { return latency_; }
+    const Histogram& sizes() const { return sizes_; }
+
+    /// Sets the histograms as metrics: latencies in seconds and sizes in bytes
+    void collectMetrics(const std::string& prefix) const;
+
+private:
+    TransferWatcher& next_;
+    std::chrono::steady_clock::time_point last_;
+    Histogram latency_;
+    Histogram sizes_;
+};
+
 
 //-----------------------------------------------------------------------------
 
@@ -12,7 +12,9 @@
 
 #include "eckit/io/URLHandle.h"
 
+#include "eckit/config/Resource.h"
 #include "eckit/io/EasyCURL.h"
+#include "eckit/utils/Translator.h"
 
 namespace eckit {
 
@@ -78,10 +80,31 @@ void URLHandle::close() {
 
 DataHandle& URLHandle::handle() {
     if (!handle_) {
+        static size_t connections = Resource<size_t>("urlHandleConnections;$ECKIT_URL_HANDLE_CONNECTIONS", 1);
+        static size_t rangeSize   = Resource<size_t>("urlHandleRangeSize;$ECKIT_URL_HANDLE_RANGE_SIZE",
+                                                     8 * 1024 * 1024);
+
         EasyCURL curl;
         /// IDEA: make the options more generic, eg. EasyCURL curl(opts)
         // curl.followLocation(true);
         curl.useSSL(useSSL_);
+
+        // Resources larger than a range are fetched over several connections, if the server accepts ranges
+        if (connections > 1) {
+            EasyCURLResponse head          = curl.HEAD(uri_);
+            const EasyCURLHeaders& headers = head.headers();
+            auto length                    = headers.find("content-length");
+            auto ranges                    = headers.find("accept-ranges");
+            if (head.code() == 200 && length != headers.end() && ranges != headers.end() &&
+                ranges->second == "bytes") {
+                unsigned long long size = Translator<std::string, unsigned long long>()(length->second);
+                if (size > rangeSize) {
+                    handle_.reset(curl.rangedGET(uri_, size, connections, rangeSize));
+                    return *handle_.get();
+                }
+            }
+        }
+
         handle_.reset(curl.GET(uri_, true).dataHandle());
     }
     return *handle_.get();
@@ -0,0 +1,355 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/log/Histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ostream>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/JSON.h"
+#include "eckit/log/Statistics.h"
+#include "eckit/runtime/Metrics.h"
+#include "eckit/runtime/Telemetry.h"
+#include "eckit/serialisation/Stream.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/value/Value.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+constexpr uint64_t NO_MIN = std::numeric_limits<uint64_t>::max();
+
+const double percentiles[] = {50, 90, 99, 99.9};
+const char* names[]        = {"p50", "p90", "p99", "p999"};
+
+}  // namespace
+
+Histogram::Histogram() :
+    buckets_(BUCKETS, 0), count_(0), sum_(0), min_(NO_MIN), max_(0) {}
+
+Histogram::Histogram(Stream& s) :
+    Histogram() {
+    size_t n;
+    s >> count_;
+    s >> sum_;
+    s >> min_;
+    s >> max_;
+    s >> n;
+    for (size_t i = 0; i < n; ++i) {
+        size_t b;
+        uint64_t c;
+        s >> b;
+        s >> c;
+        ASSERT(b < BUCKETS);
+        buckets_[b] = c;
+    }
+}
+
+Histogram::Histogram(const std::vector<uint64_t>& buckets, uint64_t count, uint64_t sum, uint64_t min, uint64_t max) :
+    buckets_(buckets), count_(count), sum_(sum), min_(min), max_(max) {
+    ASSERT(buckets_.size() == BUCKETS);
+}
+
+void Histogram::encode(Stream& s) const {
+    // Only the buckets in use
+    size_t n = std::count_if(buckets_.begin(), buckets_.end(), [](uint64_t c) { return c != 0; });
+    s << count_;
+    s << sum_;
+    s << min_;
+    s << max_;
+    s << n;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        if (buckets_[i]) {
+            s << i;
+            s << buckets_[i];
+        }
+    }
+}
+
+size_t Histogram::bucket(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return value;
+    }
+    size_t e = 63 - __builtin_clzll(value);  // e >= SUB_BITS
+    size_t m = value >> (e - SUB_BITS);      // SUB_BUCKETS <= m < 2 * SUB_BUCKETS
+    return (e - SUB_BITS + 1) * SUB_BUCKETS + (m - SUB_BUCKETS);
+}
+
+uint64_t Histogram::lowerBound(size_t b) {
+    ASSERT(b < BUCKETS);
+    if (b < SUB_BUCKETS) {
+        return b;
+    }
+    size_t e   = b / SUB_BUCKETS + SUB_BITS - 1;
+    uint64_t m = SUB_BUCKETS + b % SUB_BUCKETS;
+    return m << (e - SUB_BITS);
+}
+
+uint64_t Histogram::upperBound(size_t b) {
+    return b + 1 < BUCKETS ? lowerBound(b + 1) - 1 : std::numeric_limits<uint64_t>::max();
+}
+
+void Histogram::record(uint64_t value, uint64_t count) {
+    buckets_[bucket(value)] += count;
+    count_ += count;
+    sum_ += value * count;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+void Histogram::merge(const Histogram& other) {
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void Histogram::reset() {
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = 0;
+    sum_   = 0;
+    min_   = NO_MIN;
+    max_   = 0;
+}
+
+uint64_t Histogram::percentile(double p) const {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    ASSERT(p >= 0 && p <= 100);
+    uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(p / 100. * double(count_))));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return std::min(std::max(upperBound(i), min_), max_);
+        }
+    }
+    return max_;
+}
+
+Value Histogram::summary(double unit) const {
+    Value v = Value::makeOrderedMap();
+    v["count"] = count_;
+    v["min"]   = min() * unit;
+    v["mean"]  = mean() * unit;
+    v["max"]   = max() * unit;
+    for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); ++i) {
+        v[names[i]] = percentile(percentiles[i]) * unit;
+    }
+    return v;
+}
+
+void Histogram::json(JSON& s, double unit) const {
+    s.startObject();
+    s << "count" << count_;
+    s << "min" << min() * unit;
+    s << "mean" << mean() * unit;
+    s << "max" << max() * unit;
+    for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); ++i) {
+        s << names[i] << percentile(percentiles[i]) * unit;
+    }
+    s.endObject();
+}
+
+void Histogram::print(std::ostream& s) const {
+    s << "Histogram[count=" << count_ << ",min=" << min() << ",mean=" << mean() << ",max=" << max();
+    for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); ++i) {
+        s << "," << names[i] << "=" << percentile(percentiles[i]);
+    }
+    s << "]";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+AtomicHistogram::AtomicHistogram() :
+    buckets_(new std::atomic<uint64_t>[Histogram::BUCKETS]) {
+    reset();
+}
+
+void AtomicHistogram::record(uint64_t value) {
+    buckets_[Histogram::bucket(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t m = min_.load(std::memory_order_relaxed);
+    while (value < m && !min_.compare_exchange_weak(m, value, std::memory_order_relaxed)) {
+    }
+
+    m = max_.load(std::memory_order_relaxed);
+    while (value > m && !max_.compare_exchange_weak(m, value, std::memory_order_relaxed)) {
+    }
+}
+
+Histogram AtomicHistogram::snapshot() const {
+    Histogram h;
+    uint64_t count = 0;
+    for (size_t i = 0; i < Histogram::BUCKETS; ++i) {
+        count += h.buckets_[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    // The count is that of the buckets, which may be updated while they are read
+    h.count_ = count;
+    h.sum_   = sum_.load(std::memory_order_relaxed);
+    h.min_   = min_.load(std::memory_order_relaxed);
+    h.max_   = max_.load(std::memory_order_relaxed);
+    return h;
+}
+
+void AtomicHistogram::reset() {
+    for (size_t i = 0; i < Histogram::BUCKETS; ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(NO_MIN, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static size_t threadSlot() {
+    static std::atomic<size_t> next(0);
+    static thread_local size_t slot = next++;
+    return slot;
+}
+
+Counter::Counter() :
+    slots_(new Slot[SLOTS]), start_(Statistics::timer().elapsed()) {}
+
+Counter::~Counter() = default;
+
+void Counter::add(uint64_t n) {
+    slots_[threadSlot() % SLOTS].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+uint64_t Counter::value() const {
+    uint64_t v = 0;
+    for (size_t i = 0; i < SLOTS; ++i) {
+        v += slots_[i].value.load(std::memory_order_relaxed);
+    }
+    return v;
+}
+
+double Counter::rate() const {
+    AutoLock<Mutex> lock(mutex_);
+    double elapsed = Statistics::timer().elapsed() - start_;
+    return elapsed > 0 ? double(value()) / elapsed : 0;
+}
+
+void Counter::reset() {
+    AutoLock<Mutex> lock(mutex_);
+    for (size_t i = 0; i < SLOTS; ++i) {
+        slots_[i].value.store(0, std::memory_order_relaxed);
+    }
+    start_ = Statistics::timer().elapsed();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Instruments& Instruments::instance() {
+    static Instruments instruments;
+    return instruments;
+}
+
+AtomicHistogram& Instruments::histogram(const std::string& name) {
+    Instruments& i = instance();
+    AutoLock<Mutex> lock(i.mutex_);
+    auto& h = i.histograms_[name];
+    if (!h) {
+        h.reset(new AtomicHistogram());
+    }
+    return *h;
+}
+
+Counter& Instruments::counter(const std::string& name) {
+    Instruments& i = instance();
+    AutoLock<Mutex> lock(i.mutex_);
+    auto& c = i.counters_[name];
+    if (!c) {
+        c.reset(new Counter());
+    }
+    return *c;
+}
+
+void Instruments::json(JSON& s) {
+    Instruments& i = instance();
+    AutoLock<Mutex> lock(i.mutex_);
+
+    s.startObject();
+
+    s << "histograms";
+    s.startObject();
+    for (const auto& h : i.histograms_) {
+        s << h.first;
+        h.second->snapshot().json(s, 1e-9);
+    }
+    s.endObject();
+
+    s << "counters";
+    s.startObject();
+    for (const auto& c : i.counters_) {
+        s << c.first;
+        s.startObject();
+        s << "value" << c.second->value();
+        s << "rate" << c.second->rate();
+        s.endObject();
+    }
+    s.endObject();
+
+    s.endObject();
+}
+
+void Instruments::collect(const std::string& prefix) {
+    Instruments& i = instance();
+    AutoLock<Mutex> lock(i.mutex_);
+
+    for (const auto& h : i.histograms_) {
+        Metrics::setHistogram(prefix + "." + h.first, h.second->snapshot(), 1e-9, true);
+    }
+
+    for (const auto& c : i.counters_) {
+        Metrics::set(prefix + "." + c.first, c.second->value(), true);
+    }
+}
+
+std::string Instruments::report() {
+    return runtime::Telemetry::report(runtime::Report::METER, [](JSON& s) {
+        s << "instruments";
+        json(s);
+    });
+}
+
+void Instruments::reset() {
+    Instruments& i = instance();
+    AutoLock<Mutex> lock(i.mutex_);
+
+    for (auto& h : i.histograms_) {
+        h.second->reset();
+    }
+
+    for (auto& c : i.counters_) {
+        c.second->reset();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,197 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   Histogram.h
+
+#ifndef eckit_Histogram_h
+#define eckit_Histogram_h
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/memory/NonCopyable.h"
+#include "eckit/thread/Mutex.h"
+
+namespace eckit {
+
+class JSON;
+class Stream;
+class Value;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Log-linear (HDR-style) histogram of non-negative integer values, typically latencies in nanoseconds.
+///
+/// Each power of two is divided in SUB_BUCKETS linear buckets, so that percentiles are exact to within 1/SUB_BUCKETS
+/// (about 3%) over the whole range of 64-bit values, with a fixed number of buckets. Histograms with the same layout
+/// are merged by adding their buckets: across threads, processes (Stream) and MPI ranks (eckit/mpi/Histogram.h).
+///
+/// This class is a plain value, not thread-safe. AtomicHistogram records from several threads.
+
+class Histogram {
+public:  // types
+    static constexpr size_t SUB_BITS    = 5;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BITS;
+    static constexpr size_t BUCKETS     = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+public:  // methods
+    Histogram();
+
+    explicit Histogram(Stream&);
+
+    /// From the buckets and statistics of other histograms, e.g. reduced across MPI ranks
+    Histogram(const std::vector<uint64_t>& buckets, uint64_t count, uint64_t sum, uint64_t min, uint64_t max);
+
+    void record(uint64_t value, uint64_t count = 1);
+    void merge(const Histogram&);
+    void reset();
+
+    uint64_t count() const { return count_; }
+    uint64_t sum() const { return sum_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? double(sum_) / double(count_) : 0; }
+
+    /// @returns the value below which lie p percents of the values recorded (the upper bound of their bucket)
+    uint64_t percentile(double p) const;
+
+    const std::vector<uint64_t>& buckets() const { return buckets_; }
+
+    static size_t bucket(uint64_t value);
+    static uint64_t lowerBound(size_t bucket);
+    static uint64_t upperBound(size_t bucket);
+
+    /// Summary: count, min, mean, max and the 50th, 90th, 99th and 99.9th percentiles, scaled by unit
+    Value summary(double unit = 1) const;
+    void json(JSON&, double unit = 1) const;
+
+    void encode(Stream&) const;
+
+    friend Stream& operator<<(Stream& s, const Histogram& h) {
+        h.encode(s);
+        return s;
+    }
+
+    friend std::ostream& operator<<(std::ostream& s, const Histogram& h) {
+        h.print(s);
+        return s;
+    }
+
+private:  // methods
+    void print(std::ostream&) const;
+
+private:  // members
+    std::vector<uint64_t> buckets_;
+    uint64_t count_;
+    uint64_t sum_;
+    uint64_t min_;
+    uint64_t max_;
+
+    friend class AtomicHistogram;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Histogram recorded concurrently from several threads, with relaxed atomic increments and no lock.
+/// Snapshots are consistent per bucket, not across buckets.
+
+class AtomicHistogram : private NonCopyable {
+public:  // methods
+    AtomicHistogram();
+
+    void record(uint64_t value);
+
+    Histogram snapshot() const;
+    void reset();
+
+private:  // members
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Counter incremented from several threads without contention: each thread adds to its own cache line.
+/// rate() reports the increments per second since it was created or reset, so that reading it changes nothing.
+
+class Counter : private NonCopyable {
+public:  // methods
+    Counter();
+    ~Counter();
+
+    void add(uint64_t n = 1);
+
+    uint64_t value() const;
+    double rate() const;
+    void reset();
+
+private:  // types
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> value{0};
+    };
+
+    static constexpr size_t SLOTS = 16;
+
+private:  // members
+    std::unique_ptr<Slot[]> slots_;
+
+    mutable Mutex mutex_;
+    double start_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Named histograms and counters of the process, exported as JSON (JSON endpoint of eckit::web::MetricsResource,
+/// Telemetry) or into the current Metrics collection. Instruments are created on first use and live until exit,
+/// call sites should keep the reference:
+///
+///     static AtomicHistogram& latency = Instruments::histogram("fdb.archive.latency");
+///     latency.record(ns);
+
+class Instruments : private NonCopyable {
+public:  // methods
+    static AtomicHistogram& histogram(const std::string& name);
+    static Counter& counter(const std::string& name);
+
+    /// Histograms are in nanoseconds, exported in seconds
+    static void json(JSON&);
+
+    /// Sets the histograms and counters as metrics, under the given prefix
+    static void collect(const std::string& prefix = "instruments");
+
+    /// Sends the histograms and counters with Telemetry, as a METER report
+    /// @returns the message sent
+    static std::string report();
+
+    static void reset();
+
+private:  // methods
+    Instruments() = default;
+    static Instruments& instance();
+
+private:  // members
+    Mutex mutex_;
+    std::map<std::string, std::unique_ptr<AtomicHistogram>> histograms_;
+    std::map<std::string, std::unique_ptr<Counter>> counters_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
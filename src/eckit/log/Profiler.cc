@@ -0,0 +1,442 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/log/Profiler.h"
+
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ECKIT_PROFILER_TSC 1
+#else
+#define ECKIT_PROFILER_TSC 0
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <thread>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/JSON.h"
+#include "eckit/thread/AutoLock.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+constexpr unsigned NONE    = std::numeric_limits<unsigned>::max();
+constexpr size_t MAX_DEPTH = 256;
+
+inline uint64_t nanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+inline uint64_t ticks() {
+#if ECKIT_PROFILER_TSC
+    return __rdtsc();
+#else
+    return nanoseconds();
+#endif
+}
+
+}  // namespace
+
+/// Call tree and trace of one thread, only written by that thread
+struct ThreadProfile {
+
+    struct Node {
+        unsigned region;
+        unsigned parent;
+        unsigned child   = NONE;  ///< first child
+        unsigned sibling = NONE;  ///< next child of the parent
+        uint64_t calls   = 0;
+        uint64_t total   = 0;
+        uint64_t min     = std::numeric_limits<uint64_t>::max();
+        uint64_t max     = 0;
+
+        Node(unsigned region, unsigned parent) :
+            region(region), parent(parent) {}
+    };
+
+    struct Frame {
+        unsigned node;
+        uint64_t start;
+    };
+
+    struct Event {
+        unsigned region;
+        uint64_t start;
+        uint64_t duration;
+    };
+
+    explicit ThreadProfile(size_t index) :
+        index_(index), depth_(0), dropped_(0), used_(true) {
+        nodes_.reserve(1024);
+        clear();
+    }
+
+    void clear() {
+        nodes_.clear();
+        nodes_.emplace_back(NONE, NONE);
+        events_.clear();
+        dropped_ = 0;
+    }
+
+    unsigned child(unsigned parent, unsigned region) {
+        unsigned n = nodes_[parent].child;
+        while (n != NONE && nodes_[n].region != region) {
+            n = nodes_[n].sibling;
+        }
+        if (n == NONE) {
+            n = unsigned(nodes_.size());
+            nodes_.emplace_back(region, parent);
+            nodes_.back().sibling = nodes_[parent].child;
+            nodes_[parent].child  = n;
+        }
+        return n;
+    }
+
+    size_t index_;
+
+    std::vector<Node> nodes_;
+
+    // Regions deeper than MAX_DEPTH are counted, not recorded
+    Frame stack_[MAX_DEPTH];
+    size_t depth_;
+
+    std::vector<Event> events_;
+    size_t dropped_;
+
+    // Profiles of threads that have exited are reused by new threads, and keep their data
+    bool used_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::atomic<bool> Profiler::enabled_(false);
+std::atomic<bool> Profiler::tracing_(false);
+
+static thread_local ThreadProfile* thread_ = nullptr;
+
+/// Releases the profile of the thread when it exits
+struct ThreadProfileRelease {
+    ~ThreadProfileRelease() {
+        if (thread_) {
+            Profiler::instance().release(*thread_);
+        }
+    }
+};
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler() :
+    startTicks_(ticks()),
+    startNanoseconds_(nanoseconds()),
+    traceEvents_(Resource<size_t>("$ECKIT_PROFILER_TRACE_EVENTS", 1024 * 1024)),
+    reportPath_(Resource<std::string>("$ECKIT_PROFILER_REPORT", "")),
+    tracePath_(Resource<std::string>("$ECKIT_PROFILER_TRACE", "")) {
+
+    tracing(!tracePath_.empty());
+    enable(Resource<bool>("$ECKIT_PROFILER", false) || !reportPath_.empty() || tracing());
+}
+
+Profiler::~Profiler() {
+    enable(false);
+
+    // Log may already be gone, write to files only
+    if (!reportPath_.empty()) {
+        std::ofstream out(reportPath_.c_str());
+        report(out);
+    }
+
+    if (!tracePath_.empty()) {
+        std::ofstream out(tracePath_.c_str());
+        trace(out);
+    }
+}
+
+void Profiler::enable(bool on) {
+    enabled_.store(on, std::memory_order_relaxed);
+}
+
+void Profiler::tracing(bool on) {
+    tracing_.store(on, std::memory_order_relaxed);
+}
+
+unsigned Profiler::region(const char* name) {
+    Profiler& p = instance();
+    AutoLock<Mutex> lock(p.mutex_);
+
+    auto j = p.ids_.find(name);
+    if (j != p.ids_.end()) {
+        return j->second;
+    }
+
+    unsigned id = unsigned(p.names_.size());
+    p.names_.emplace_back(name);
+    p.ids_[name] = id;
+    return id;
+}
+
+ThreadProfile& Profiler::thread() {
+    AutoLock<Mutex> lock(mutex_);
+    for (auto& t : threads_) {
+        if (!t->used_) {
+            t->used_ = true;
+            return *t;
+        }
+    }
+    threads_.emplace_back(new ThreadProfile(threads_.size()));
+    return *threads_.back();
+}
+
+void Profiler::release(ThreadProfile& t) {
+    AutoLock<Mutex> lock(mutex_);
+    t.depth_ = 0;
+    t.used_  = false;
+}
+
+void Profiler::begin(unsigned region) {
+    ThreadProfile* t = thread_;
+    if (!t) {
+        static thread_local ThreadProfileRelease release;
+        t = thread_ = &instance().thread();
+    }
+
+    size_t depth = t->depth_++;
+    if (depth >= MAX_DEPTH) {
+        return;
+    }
+
+    unsigned parent = depth ? t->stack_[depth - 1].node : 0;
+
+    ThreadProfile::Frame& f = t->stack_[depth];
+    f.node                  = t->child(parent, region);
+    f.start                 = ticks();
+}
+
+void Profiler::end() {
+    uint64_t now = ticks();
+
+    ThreadProfile* t = thread_;
+    ASSERT(t && t->depth_ > 0);
+
+    size_t depth = --t->depth_;
+    if (depth >= MAX_DEPTH) {
+        return;
+    }
+
+    const ThreadProfile::Frame& f = t->stack_[depth];
+    uint64_t elapsed              = now - f.start;
+
+    ThreadProfile::Node& n = t->nodes_[f.node];
+    n.calls++;
+    n.total += elapsed;
+    n.min = std::min(n.min, elapsed);
+    n.max = std::max(n.max, elapsed);
+
+    if (tracing()) {
+        auto& events = t->events_;
+        if (events.size() < events.capacity()) {
+            events.push_back({n.region, f.start, elapsed});
+        }
+        else if (events.capacity() == 0) {
+            events.reserve(instance().traceEvents_);
+            events.push_back({n.region, f.start, elapsed});
+        }
+        else {
+            t->dropped_++;
+        }
+    }
+}
+
+double Profiler::secondsPerTick() const {
+#if ECKIT_PROFILER_TSC
+    // Calibrate the time stamp counter against steady_clock, over at least 10ms since the start
+    uint64_t ns = nanoseconds();
+    while (ns - startNanoseconds_ < 10000000) {
+        ns = nanoseconds();
+    }
+    uint64_t t = ticks();
+    return double(ns - startNanoseconds_) / double(t - startTicks_) / 1e9;
+#else
+    return 1e-9;
+#endif
+}
+
+namespace {
+
+void merge(const ThreadProfile& t, unsigned node, Profiler::Region& region, const std::vector<std::string>& names,
+           double scale) {
+    for (unsigned c = t.nodes_[node].child; c != NONE; c = t.nodes_[c].sibling) {
+        const ThreadProfile::Node& n = t.nodes_[c];
+        if (n.calls == 0) {
+            continue;
+        }
+
+        const std::string& name = names[n.region];
+
+        auto j = std::find_if(region.children.begin(), region.children.end(),
+                              [&name](const Profiler::Region& r) { return r.name == name; });
+
+        if (j == region.children.end()) {
+            region.children.emplace_back();
+            j       = region.children.end() - 1;
+            j->name = name;
+            j->min  = n.min * scale;
+            j->max  = n.max * scale;
+        }
+
+        j->calls += n.calls;
+        j->total += n.total * scale;
+        j->min = std::min(j->min, n.min * scale);
+        j->max = std::max(j->max, n.max * scale);
+
+        merge(t, c, *j, names, scale);
+    }
+}
+
+void finalise(Profiler::Region& region) {
+    double children = 0;
+    for (auto& c : region.children) {
+        finalise(c);
+        children += c.total;
+    }
+    region.self = std::max(0., region.total - children);
+
+    std::sort(region.children.begin(), region.children.end(),
+              [](const Profiler::Region& a, const Profiler::Region& b) { return a.total > b.total; });
+}
+
+void print(std::ostream& out, const Profiler::Region& region, size_t depth) {
+    out << std::setw(10) << region.calls << std::setw(12) << region.total << std::setw(12) << region.self
+        << std::setw(12) << region.min << std::setw(12) << region.max << "  " << std::string(2 * depth, ' ')
+        << region.name << std::endl;
+
+    for (const auto& c : region.children) {
+        print(out, c, depth + 1);
+    }
+}
+
+}  // namespace
+
+Profiler::Region Profiler::tree() const {
+    double scale = secondsPerTick();
+
+    AutoLock<Mutex> lock(mutex_);
+
+    Region root;
+    for (const auto& t : threads_) {
+        merge(*t, 0, root, names_, scale);
+    }
+
+    for (const auto& c : root.children) {
+        root.total += c.total;
+    }
+
+    finalise(root);
+    return root;
+}
+
+size_t Profiler::dropped() const {
+    AutoLock<Mutex> lock(mutex_);
+
+    size_t n = 0;
+    for (const auto& t : threads_) {
+        n += t->dropped_;
+    }
+    return n;
+}
+
+void Profiler::report(std::ostream& out) const {
+    Region root = tree();
+
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision     = out.precision();
+
+    out << std::setw(10) << "calls" << std::setw(12) << "total" << std::setw(12) << "self" << std::setw(12) << "min"
+        << std::setw(12) << "max" << "  region (seconds)" << std::endl;
+
+    out << std::scientific << std::setprecision(3);
+    for (const auto& c : root.children) {
+        print(out, c, 0);
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Profiler::trace(std::ostream& out) const {
+    double scale = secondsPerTick() * 1e6;  // microseconds
+    long pid     = ::getpid();
+
+    AutoLock<Mutex> lock(mutex_);
+
+    JSON json(out);
+    json.precision(15);
+
+    json.startObject();
+    json << "displayTimeUnit"
+         << "ns";
+    json << "traceEvents";
+    json.startList();
+
+    for (const auto& t : threads_) {
+        json.startObject();
+        json << "name"
+             << "thread_name";
+        json << "ph"
+             << "M";
+        json << "pid" << pid;
+        json << "tid" << t->index_;
+        json << "args";
+        json.startObject();
+        json << "name" << ("thread " + std::to_string(t->index_));
+        json.endObject();
+        json.endObject();
+
+        for (const auto& e : t->events_) {
+            json.startObject();
+            json << "name" << names_[e.region];
+            json << "ph"
+                 << "X";
+            json << "ts" << double(e.start - startTicks_) * scale;
+            json << "dur" << double(e.duration) * scale;
+            json << "pid" << pid;
+            json << "tid" << t->index_;
+            json.endObject();
+        }
+    }
+
+    json.endList();
+    json.endObject();
+}
+
+void Profiler::reset() {
+    AutoLock<Mutex> lock(mutex_);
+    for (auto& t : threads_) {
+        t->clear();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,157 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   Profiler.h
+
+#ifndef eckit_Profiler_h
+#define eckit_Profiler_h
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/memory/NonCopyable.h"
+#include "eckit/thread/Mutex.h"
+
+namespace eckit {
+
+struct ThreadProfile;
+struct ThreadProfileRelease;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Scoped-region profiler, cheap enough to be left in hot loops.
+///
+/// Regions are declared with ECKIT_PROFILE_REGION("name"), and are nested by scope. Each thread records into its own
+/// call tree and trace buffer, with the time stamp counter (steady_clock where not available): entering and leaving a
+/// region take no lock and, once the call tree has seen the region at this place, allocate no memory.
+/// When disabled, a region costs a relaxed atomic load (see benchmark_profiler for the overhead).
+///
+/// It is enabled at run time with $ECKIT_PROFILER, or programmatically. At exit, the aggregated call tree is written
+/// to the file named by $ECKIT_PROFILER_REPORT, and a Chrome trace (chrome://tracing, https://ui.perfetto.dev) to the
+/// one named by $ECKIT_PROFILER_TRACE, which also enables tracing. Trace buffers hold $ECKIT_PROFILER_TRACE_EVENTS
+/// events per thread, further events are counted as dropped. These are read with Resource when the first region is
+/// declared, possibly before Main is initialised, hence without configuration file.
+///
+/// report(), tree(), trace() and reset() read the buffers of all threads: they should be called while the profiled
+/// threads are not in a region.
+
+class Profiler : private NonCopyable {
+public:  // types
+    /// Statistics of a region, at one place of the call tree, merged over all threads
+    struct Region {
+        std::string name;
+        size_t calls = 0;
+        double total = 0;  ///< seconds, children included
+        double self  = 0;  ///< seconds, children excluded
+        double min   = 0;
+        double max   = 0;
+        std::vector<Region> children;
+    };
+
+public:  // methods
+    static Profiler& instance();
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    void enable(bool);
+
+    static bool tracing() { return tracing_.load(std::memory_order_relaxed); }
+    void tracing(bool);
+
+    /// @returns the identifier of a region name, for use once per call site
+    static unsigned region(const char* name);
+
+    static void begin(unsigned region);
+    static void end();
+
+    /// Call tree merged over all threads, the root has no name
+    Region tree() const;
+
+    /// Number of trace events dropped because the buffers were full
+    size_t dropped() const;
+
+    /// Prints the call tree, with calls, total, self, min and max times of each region
+    void report(std::ostream&) const;
+
+    /// Writes the trace as Chrome trace JSON
+    void trace(std::ostream&) const;
+
+    void reset();
+
+private:  // methods
+    Profiler();
+    ~Profiler();
+
+    ThreadProfile& thread();
+    void release(ThreadProfile&);
+    double secondsPerTick() const;
+
+private:  // members
+    mutable Mutex mutex_;
+
+    std::map<std::string, unsigned> ids_;
+    std::vector<std::string> names_;
+
+    std::vector<std::unique_ptr<ThreadProfile>> threads_;
+
+    // Time stamp counter and steady_clock at start, to convert ticks into seconds
+    uint64_t startTicks_;
+    uint64_t startNanoseconds_;
+
+    size_t traceEvents_;
+
+    std::string reportPath_;
+    std::string tracePath_;
+
+    static std::atomic<bool> enabled_;
+    static std::atomic<bool> tracing_;
+
+    friend struct ThreadProfileRelease;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class ProfileRegion : private NonCopyable {
+public:
+    explicit ProfileRegion(unsigned region) :
+        active_(Profiler::enabled()) {
+        if (active_) {
+            Profiler::begin(region);
+        }
+    }
+
+    ~ProfileRegion() {
+        if (active_) {
+            Profiler::end();
+        }
+    }
+
+private:
+    bool active_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#define ECKIT_PROFILE_CONCAT_(a, b) a##b
+#define ECKIT_PROFILE_CONCAT(a, b) ECKIT_PROFILE_CONCAT_(a, b)
+
+/// Profiles the enclosing scope as a region of the given name (a string literal)
+#define ECKIT_PROFILE_REGION(name)                                                                            \
+    static const unsigned ECKIT_PROFILE_CONCAT(eckit_profile_id_, __LINE__) = ::eckit::Profiler::region(name); \
+    ::eckit::ProfileRegion ECKIT_PROFILE_CONCAT(eckit_profile_region_, __LINE__)(                              \
+        ECKIT_PROFILE_CONCAT(eckit_profile_id_, __LINE__))
+
+#endif
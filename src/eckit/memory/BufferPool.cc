@@ -0,0 +1,345 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "eckit/memory/BufferPool.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+constexpr size_t hugePage = 2 * 1024 * 1024;
+
+/// Largest block kept by a thread
+constexpr size_t threadBlockMax = 8 * 1024 * 1024;
+
+size_t environment(const char* name, size_t value) {
+    const char* p = ::getenv(name);
+    return p ? size_t(::strtoull(p, nullptr, 10)) : value;
+}
+
+struct Config {
+    bool enabled;
+    bool hugePages;
+    size_t page;
+    size_t minimum;
+    size_t capacity;
+    size_t threadCapacity;
+
+    Config() :
+        enabled(environment("ECKIT_BUFFER_POOL", 1) != 0),
+        hugePages(environment("ECKIT_BUFFER_POOL_HUGE_PAGES", 0) != 0),
+        page(size_t(::sysconf(_SC_PAGESIZE))),
+        minimum(environment("ECKIT_BUFFER_POOL_MINIMUM", 64 * 1024)),
+        capacity(environment("ECKIT_BUFFER_POOL_CAPACITY", 256 * 1024 * 1024)),
+        threadCapacity(environment("ECKIT_BUFFER_POOL_THREAD_CAPACITY", 16 * 1024 * 1024)) {}
+};
+
+const Config& config() {
+    static const Config config;
+    return config;
+}
+
+/// Rounds up to a quarter of the power of two below, and to a page
+size_t roundUp(const Config& c, size_t size) {
+    size_t top = 1;
+    while (top <= size / 2) {
+        top <<= 1;
+    }
+    size_t step = std::max(top / 4, c.page);
+    return std::max((size + step - 1) / step * step, c.page);
+}
+
+struct Counters {
+    std::atomic<size_t> kept{0};  ///< Bytes kept by the shared pool and the threads, within the capacity
+    std::atomic<size_t> threadCached{0};
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> threadHits{0};
+    std::atomic<size_t> poolHits{0};
+    std::atomic<size_t> systemAllocations{0};
+    std::atomic<size_t> systemReleases{0};
+};
+
+Counters& counters() {
+    static Counters counters;
+    return counters;
+}
+
+char* systemAllocate(const Config& c, size_t size) {
+    void* p = nullptr;
+    if (::posix_memalign(&p, size >= hugePage ? hugePage : c.page, size) != 0) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if (c.hugePages && size >= hugePage) {
+        ::madvise(p, size, MADV_HUGEPAGE);
+    }
+#endif
+    counters().systemAllocations++;
+    return static_cast<char*>(p);
+}
+
+void systemRelease(char* p) {
+    ::free(p);
+}
+
+/// Takes size bytes of the capacity to keep a block
+bool reserve(size_t size) {
+    std::atomic<size_t>& kept = counters().kept;
+    size_t k                  = kept.load(std::memory_order_relaxed);
+    do {
+        if (k + size > config().capacity) {
+            return false;
+        }
+    } while (!kept.compare_exchange_weak(k, k + size, std::memory_order_relaxed));
+    return true;
+}
+
+void unreserve(size_t size) {
+    counters().kept -= size;
+}
+
+/// Never destroyed, as buffers may be released by the destructors of other static objects
+struct SharedPool {
+    std::mutex mutex;
+    std::map<size_t, std::vector<char*>> blocks;
+    size_t cached = 0;
+
+    char* take(size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto j = blocks.find(size);
+        if (j == blocks.end() || j->second.empty()) {
+            return nullptr;
+        }
+        char* p = j->second.back();
+        j->second.pop_back();
+        cached -= size;
+        unreserve(size);
+        return p;
+    }
+
+    void give(char* p, size_t size) {
+        if (reserve(size)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            blocks[size].push_back(p);
+            cached += size;
+            return;
+        }
+        counters().systemReleases++;
+        systemRelease(p);
+    }
+
+    void purge() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& b : blocks) {
+            for (char* p : b.second) {
+                systemRelease(p);
+            }
+        }
+        blocks.clear();
+        unreserve(cached);
+        cached = 0;
+    }
+};
+
+SharedPool& shared() {
+    static SharedPool* pool = new SharedPool;
+    return *pool;
+}
+
+struct ThreadCache {
+    std::vector<std::pair<size_t, char*>> blocks;
+    size_t cached = 0;
+
+    ThreadCache();
+    ~ThreadCache();
+
+    char* take(size_t size) {
+        for (auto j = blocks.begin(); j != blocks.end(); ++j) {
+            if (j->first == size) {
+                char* p = j->second;
+                blocks.erase(j);
+                release(size);
+                return p;
+            }
+        }
+        return nullptr;
+    }
+
+    bool give(char* p, size_t size) {
+        if (size > threadBlockMax || cached + size > config().threadCapacity) {
+            return false;
+        }
+        for (auto& b : blocks) {
+            if (b.first == size) {
+                return false;
+            }
+        }
+        if (!reserve(size)) {
+            return false;
+        }
+        blocks.emplace_back(size, p);
+        cached += size;
+        counters().threadCached += size;
+        return true;
+    }
+
+    void release(size_t size) {
+        cached -= size;
+        counters().threadCached -= size;
+        unreserve(size);
+    }
+
+    void purge() {
+        for (auto& b : blocks) {
+            systemRelease(b.second);
+        }
+        blocks.clear();
+        release(cached);
+    }
+};
+
+// Buffers may be released by other thread_local destructors, after the cache is gone
+enum State : char
+{
+    NONE,
+    ALIVE,
+    DESTROYED
+};
+thread_local State threadCacheState = NONE;
+
+ThreadCache::ThreadCache() {
+    threadCacheState = ALIVE;
+}
+
+ThreadCache::~ThreadCache() {
+    threadCacheState = DESTROYED;
+    release(cached);
+    for (auto& b : blocks) {
+        shared().give(b.second, b.first);
+    }
+}
+
+ThreadCache* threadCache() {
+    if (threadCacheState == DESTROYED) {
+        return nullptr;
+    }
+    thread_local ThreadCache cache;
+    return &cache;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool BufferPool::pooled(size_t size) {
+    const Config& c = config();
+    return c.enabled && size >= c.minimum;
+}
+
+size_t BufferPool::capacity(size_t size) {
+    return pooled(size) ? roundUp(config(), size) : size;
+}
+
+char* BufferPool::allocate(size_t size) {
+    if (!pooled(size)) {
+        return new char[size];
+    }
+
+    const Config& c = config();
+    size_t block    = roundUp(c, size);
+
+    counters().allocations++;
+
+    if (ThreadCache* t = threadCache()) {
+        if (char* p = t->take(block)) {
+            counters().threadHits++;
+            return p;
+        }
+    }
+
+    if (char* p = shared().take(block)) {
+        counters().poolHits++;
+        return p;
+    }
+
+    return systemAllocate(c, block);
+}
+
+void BufferPool::deallocate(char* p, size_t size) {
+    if (!p) {
+        return;
+    }
+
+    if (!pooled(size)) {
+        delete[] p;
+        return;
+    }
+
+    const Config& c = config();
+    size_t block    = roundUp(c, size);
+
+    if (ThreadCache* t = threadCache()) {
+        if (t->give(p, block)) {
+            return;
+        }
+    }
+
+    shared().give(p, block);
+}
+
+BufferPool::Statistics BufferPool::statistics() {
+    Statistics s;
+    s.allocations       = counters().allocations;
+    s.threadHits        = counters().threadHits;
+    s.poolHits          = counters().poolHits;
+    s.systemAllocations = counters().systemAllocations;
+    s.systemReleases    = counters().systemReleases;
+    s.threadCached      = counters().threadCached;
+
+    SharedPool& pool = shared();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    s.cached = pool.cached;
+    return s;
+}
+
+void BufferPool::purge() {
+    if (ThreadCache* t = threadCache()) {
+        t->purge();
+    }
+    shared().purge();
+}
+
+void BufferPool::print(std::ostream& s) {
+    Statistics st = statistics();
+    s << "BufferPool[allocations=" << st.allocations << ",threadHits=" << st.threadHits
+      << ",poolHits=" << st.poolHits << ",systemAllocations=" << st.systemAllocations
+      << ",systemReleases=" << st.systemReleases << ",cached=" << st.cached << ",threadCached=" << st.threadCached
+      << "]";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
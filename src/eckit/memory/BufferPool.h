@@ -0,0 +1,72 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_memory_BufferPool_h
+#define eckit_memory_BufferPool_h
+
+#include <cstddef>
+#include <iosfwd>
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Allocates the memory of Buffer and MemoryBuffer.
+///
+/// Blocks of at least ECKIT_BUFFER_POOL_MINIMUM bytes (64 KiB) are rounded up to a size class, a quarter of a power
+/// of two apart, and aligned on a page, or on a huge page (2 MiB) from that size on, so that they suit direct I/O.
+/// Released blocks are kept for the next allocation of the same class: first by the releasing thread, one per class
+/// of up to 8 MiB and up to ECKIT_BUFFER_POOL_THREAD_CAPACITY bytes (16 MiB), then by a pool shared by all threads.
+/// ECKIT_BUFFER_POOL_CAPACITY (256 MiB) bounds the bytes kept in total, by the pool and by all the threads, so that
+/// the memory kept does not grow with the number of threads. A buffer created for every read then costs neither an
+/// allocation nor the page faults of fresh memory, and, kept by the thread that touched it, stays on its NUMA node. With ECKIT_BUFFER_POOL_HUGE_PAGES, blocks of a huge page
+/// and more are advised to be backed by huge pages. Smaller blocks, and all blocks with ECKIT_BUFFER_POOL=0, come
+/// from new[] as before.
+///
+/// The settings come from the environment and not from resources, as reading resources may itself create buffers.
+///
+/// @note this class is thread-safe
+
+class BufferPool {
+public:  // types
+    struct Statistics {
+        size_t allocations       = 0;  ///< Blocks allocated from the pool
+        size_t threadHits        = 0;  ///< Blocks reused from the cache of the thread
+        size_t poolHits          = 0;  ///< Blocks reused from the shared pool
+        size_t systemAllocations = 0;  ///< Blocks allocated from the system
+        size_t systemReleases    = 0;  ///< Blocks returned to the system, the pool being full
+        size_t cached            = 0;  ///< Bytes kept by the shared pool
+        size_t threadCached      = 0;  ///< Bytes kept by the threads
+    };
+
+public:  // methods
+    /// @return memory for at least size bytes, to be returned with deallocate() and the same size
+    static char* allocate(size_t size);
+    static void deallocate(char*, size_t size);
+
+    /// @return the bytes usable in a block allocated for size bytes
+    static size_t capacity(size_t size);
+
+    /// @return whether blocks of that size come from the pool
+    static bool pooled(size_t size);
+
+    static Statistics statistics();
+
+    /// Returns the blocks kept by the pool and by the calling thread to the system
+    static void purge();
+
+    static void print(std::ostream&);
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "eckit/exception/Exceptions.h"
+#include "eckit/system/DeferredPlugins.h"
 #include "eckit/thread/AutoLock.h"
 #include "eckit/thread/Mutex.h"
 
@@ -137,6 +138,11 @@ size_t Factory<T>::size() const {
 
 template <class T>
 const typename Factory<T>::builder_t& Factory<T>::get(const key_t& k) const {
+    // The builder may come from a plugin not loaded yet
+    if (!exists(k)) {
+        system::loadPluginsForMissingBuilder();
+    }
+
     AutoLock<Mutex> lock(mutex_);
     if (!exists(k)) {
         throw BadParameter("Factory of " + build_type() + " has no builder for " + k, Here());
@@ -11,6 +11,7 @@
 #include <cstring>
 
 #include "eckit/exception/Exceptions.h"
+#include "eckit/memory/BufferPool.h"
 #include "eckit/memory/MemoryBuffer.h"
 
 namespace eckit {
@@ -40,13 +41,12 @@ MemoryBuffer::~MemoryBuffer() {
 }
 
 void MemoryBuffer::create() {
-    buffer_ = new char[size_];
+    buffer_ = BufferPool::allocate(size_);
     ASSERT(buffer_);
 }
 
 void MemoryBuffer::destroy() {
-    char* p = static_cast<char*>(buffer_);
-    delete[] p;
+    BufferPool::deallocate(static_cast<char*>(buffer_), size_);
 }
 
 void MemoryBuffer::copy(const std::string& s) {
@@ -12,6 +12,7 @@
 #include "eckit/exception/Exceptions.h"
 #include "eckit/io/PeekHandle.h"
 #include "eckit/message/Message.h"
+#include "eckit/system/DeferredPlugins.h"
 
 #include <algorithm>
 #include <iomanip>
@@ -52,16 +53,24 @@ SplitterBuilderBase::~SplitterBuilderBase() {
 }
 
 Splitter* SplitterFactory::lookup(eckit::PeekHandle& handle) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    size_t n = decoders_.size();
-    ASSERT(n > 0);
+    // Splitters may come from plugins not loaded yet, then look again
+    for (bool retry = true;; retry = false) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            size_t n = decoders_.size();
+
+            for (size_t i = 0; i < n; ++i) {
+                SplitterBuilderBase* builder = decoders_[(i + index_) % n];
+                if (builder->match(handle)) {
+                    index_ = i;  // Start with this index for next message
+                    return builder->make(handle);
+                }
+            }
+        }
 
-    for (size_t i = 0; i < n; ++i) {
-        SplitterBuilderBase* builder = decoders_[(i + index_) % n];
-        if (builder->match(handle)) {
-            index_ = i;  // Start with this index for next message
-            return builder->make(handle);
+        if (!retry || !eckit::system::loadPluginsForMissingBuilder()) {
+            break;
         }
     }
 
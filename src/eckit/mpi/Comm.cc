@@ -18,6 +18,7 @@
 #include "eckit/config/LibEcKit.h"
 #include "eckit/config/Resource.h"
 #include "eckit/exception/Exceptions.h"
+#include "eckit/system/DeferredPlugins.h"
 #include "eckit/thread/AutoLock.h"
 #include "eckit/thread/Mutex.h"
 #include "eckit/utils/Tokenizer.h"
@@ -236,6 +237,11 @@ public:
     }
 
     CommFactory& getFactory(std::string_view builder) const {
+        // The factory may come from a plugin not loaded yet
+        if (!has(builder)) {
+            eckit::system::loadPluginsForMissingBuilder();
+        }
+
         AutoLock<Mutex> lock(mutex_);
 
         auto j = factories.find(builder);
@@ -261,6 +267,11 @@ public:
 private:
     CommFactories() {}
 
+    bool has(std::string_view builder) const {
+        AutoLock<Mutex> lock(mutex_);
+        return factories.find(builder) != factories.end();
+    }
+
     std::map<std::string, CommFactory*, std::less<>> factories;
     mutable eckit::Mutex mutex_;
 };
@@ -289,6 +300,18 @@ Comm::Comm(std::string_view name) :
 
 Comm::~Comm() {}
 
+Comm& Comm::splitShared(const std::string&) const {
+    throw NotImplemented("Comm::splitShared() not provided by " + name_, Here());
+}
+
+SharedWindow Comm::allocateSharedWindow(size_t, size_t) const {
+    throw NotImplemented("Comm::allocateSharedWindow() not provided by " + name_, Here());
+}
+
+SharedWindow Comm::broadcastFileShared(const eckit::PathName&, size_t) const {
+    throw NotImplemented("Comm::broadcastFileShared() not provided by " + name_, Here());
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
 Comm& comm(std::string_view name) {
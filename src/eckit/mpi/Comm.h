@@ -26,6 +26,7 @@
 #include "eckit/mpi/Group.h"
 #include "eckit/mpi/Operation.h"
 #include "eckit/mpi/Request.h"
+#include "eckit/mpi/SharedWindow.h"
 #include "eckit/mpi/Status.h"
 
 namespace eckit::mpi {
@@ -388,6 +389,27 @@ public:  // methods
 
     virtual eckit::SharedBuffer broadcastFile(const eckit::PathName& filepath, size_t root) const = 0;
 
+    ///
+    /// Node-local shared memory
+    ///
+
+    /// @brief Split the communicator into communicators of the tasks that can share memory (i.e. on the same node)
+    /// Node-local shared memory is optional, communicators not providing it throw NotImplemented
+    virtual Comm& splitShared(const std::string& name) const;
+
+    /// @brief Allocate memory shared between the tasks of this communicator (collective)
+    /// The memory is allocated by root and attached by all tasks, which must be on the same node (see splitShared)
+    /// The memory is released with the last copy of the window on each task, which is collective too (see SharedWindow)
+    virtual SharedWindow allocateSharedWindow(size_t bytes, size_t root = 0) const;
+
+    /// @brief Allocate an array shared between the tasks of this communicator, see allocateSharedWindow
+    template <typename T>
+    SharedArray<T> allocateShared(size_t count, size_t root = 0) const;
+
+    /// @brief Read file on one rank, and broadcast it once per node into memory shared by the tasks of the node
+    /// Unlike allocateSharedWindow, this communicator can span several nodes; releasing the memory is collective too
+    virtual SharedWindow broadcastFileShared(const eckit::PathName& filepath, size_t root) const;
+
     /// @brief Split the communicator based on color & give the new communicator a name
     virtual Comm& split(int color, const std::string& name) const = 0;
 
@@ -1062,6 +1084,15 @@ void eckit::mpi::Comm::allToAll(const std::vector<std::vector<T> >& sendvec,
     }
 }
 
+///
+/// Node-local shared memory
+///
+
+template <typename T>
+eckit::mpi::SharedArray<T> eckit::mpi::Comm::allocateShared(size_t count, size_t root) const {
+    return SharedArray<T>(allocateSharedWindow(count * sizeof(T), root));
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
 #undef ECKIT_MPI_ASSERT
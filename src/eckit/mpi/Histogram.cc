@@ -0,0 +1,49 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/mpi/Histogram.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace eckit::mpi {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Histogram allReduce(const Histogram& h, const Comm& comm) {
+    // unsigned long is the 64 bit type known to eckit::mpi
+    std::vector<unsigned long> buckets(h.buckets().begin(), h.buckets().end());
+    buckets.push_back(h.count());
+    buckets.push_back(h.sum());
+
+    comm.allReduceInPlace(buckets.data(), buckets.size(), sum());
+
+    unsigned long sum = buckets.back();
+    buckets.pop_back();
+    unsigned long count = buckets.back();
+    buckets.pop_back();
+
+    // Minimum and maximum in one reduction, as signed values: some MPI implementations mishandle the minimum
+    // of unsigned long. Empty ranks do not contribute to the minimum.
+    constexpr long LIMIT = std::numeric_limits<long>::max();
+    long bounds[2]       = {h.count() ? long(std::min<uint64_t>(h.min(), LIMIT)) : LIMIT,
+                            -long(std::min<uint64_t>(h.max(), LIMIT))};
+    comm.allReduceInPlace(bounds, 2, mpi::min());
+
+    uint64_t min = uint64_t(bounds[0]);
+    uint64_t max = uint64_t(-bounds[1]);
+
+    return Histogram(std::vector<uint64_t>(buckets.begin(), buckets.end()), count, sum, min, max);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::mpi
@@ -0,0 +1,28 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_mpi_Histogram_h
+#define eckit_mpi_Histogram_h
+
+#include "eckit/log/Histogram.h"
+#include "eckit/mpi/Comm.h"
+
+namespace eckit::mpi {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// @returns the histogram merged over all the ranks of the communicator
+Histogram allReduce(const Histogram&, const Comm& = comm());
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::mpi
+
+#endif
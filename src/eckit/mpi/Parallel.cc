@@ -12,8 +12,11 @@
 
 #include <errno.h>
 #include <unistd.h>
+#include <algorithm>
 #include <limits>
+#include <memory>
 #include <sstream>
+#include <vector>
 
 #include "eckit/exception/Exceptions.h"
 
@@ -22,6 +25,7 @@
 #include "eckit/io/DataHandle.h"
 #include "eckit/mpi/ParallelGroup.h"
 #include "eckit/mpi/ParallelRequest.h"
+#include "eckit/mpi/ParallelSharedWindow.h"
 #include "eckit/mpi/ParallelStatus.h"
 #include "eckit/runtime/Main.h"
 #include "eckit/thread/AutoLock.h"
@@ -151,6 +155,139 @@ static MPI_Op toOp(Operation::Code code) {
     return mpi_opcode[code];
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+// Large counts
+//
+// The MPI interface takes int counts. With MPI-4 the large-count (_c) variants of the calls are used. Otherwise,
+// counts above maxCount() are handled either by describing the whole buffer as one element of a derived datatype
+// (for calls without reduction operation), or by issuing the call on consecutive chunks of the buffer.
+
+#if defined(MPI_VERSION) && MPI_VERSION >= 4
+#define ECKIT_MPI_LARGE_COUNT 1
+#else
+#define ECKIT_MPI_LARGE_COUNT 0
+#endif
+
+namespace {
+
+/// Largest count passed to a single MPI call, can be lowered to exercise the large count code paths (at least 2, for
+/// nested datatypes to describe any count)
+size_t maxCount() {
+    static const size_t max = [] {
+        long n = eckit::Resource<long>("mpiMaxCount;$ECKIT_MPI_MAX_COUNT", std::numeric_limits<int>::max());
+        return size_t(std::clamp(n, 2L, long(std::numeric_limits<int>::max())));
+    }();
+    return max;
+}
+
+MPI_Aint extentOf(MPI_Datatype type) {
+    MPI_Aint lb;
+    MPI_Aint extent;
+    MPI_CALL(MPI_Type_get_extent(type, &lb, &extent));
+    return extent;
+}
+
+/// A datatype of count contiguous elements of type, of the given extent: blocks of maxCount() elements are nested
+/// as many times as needed for the number of blocks to fit in an int, followed by the remaining elements
+MPI_Datatype contiguous(size_t count, MPI_Datatype type, MPI_Aint extent) {
+    MPI_Datatype result;
+
+    if (count <= maxCount()) {
+        MPI_CALL(MPI_Type_contiguous(int(count), type, &result));
+        return result;
+    }
+
+    const size_t chunk   = maxCount();
+    const size_t nchunks = count / chunk;
+    const size_t rest    = count % chunk;
+
+    MPI_Datatype chunkType;
+    MPI_CALL(MPI_Type_contiguous(int(chunk), type, &chunkType));
+    MPI_Datatype blocksType = contiguous(nchunks, chunkType, MPI_Aint(chunk) * extent);
+    MPI_CALL(MPI_Type_free(&chunkType));
+
+    if (rest == 0) {
+        return blocksType;
+    }
+
+    MPI_Datatype restType;
+    MPI_CALL(MPI_Type_contiguous(int(rest), type, &restType));
+
+    int blocklengths[2]   = {1, 1};
+    MPI_Aint displs[2]    = {0, MPI_Aint(nchunks * chunk) * extent};
+    MPI_Datatype types[2] = {blocksType, restType};
+    MPI_CALL(MPI_Type_create_struct(2, blocklengths, displs, types, &result));
+    MPI_CALL(MPI_Type_free(&restType));
+    MPI_CALL(MPI_Type_free(&blocksType));
+
+    return result;
+}
+
+/// Describes count elements of type, as a single element of a derived datatype if count is too large
+class LargeCount {
+public:
+    LargeCount(size_t count, MPI_Datatype type) :
+        count_(int(count)), type_(type), derived_(false) {
+        if (count <= maxCount()) {
+            return;
+        }
+
+        const MPI_Aint extent = extentOf(type);
+
+        MPI_Datatype bigType = contiguous(count, type, extent);
+
+        // the extent matters where MPI computes per-rank displacements (gather, scatter, allToAll)
+        MPI_CALL(MPI_Type_create_resized(bigType, 0, MPI_Aint(count) * extent, &type_));
+        MPI_CALL(MPI_Type_free(&bigType));
+        MPI_CALL(MPI_Type_commit(&type_));
+
+        count_   = 1;
+        derived_ = true;
+    }
+
+    ~LargeCount() {
+        // pending non-blocking operations keep a reference to the datatype, freeing it here is safe
+        if (derived_) {
+            MPI_Type_free(&type_);
+        }
+    }
+
+    LargeCount(const LargeCount&)            = delete;
+    LargeCount& operator=(const LargeCount&) = delete;
+
+    int count() const { return count_; }
+    MPI_Datatype type() const { return type_; }
+
+private:
+    int count_;
+    MPI_Datatype type_;
+    bool derived_;
+};
+
+/// Calls f(offset, n) for consecutive chunks of at most maxCount() elements, offset in bytes
+template <typename F>
+void forEachChunk(size_t count, MPI_Datatype type, F f) {
+    if (count <= maxCount()) {
+        f(0, int(count));
+        return;
+    }
+
+    const MPI_Aint extent = extentOf(type);
+    for (size_t i = 0; i < count; i += maxCount()) {
+        f(MPI_Aint(i) * extent, int(std::min(maxCount(), count - i)));
+    }
+}
+
+inline void* offsetBy(void* buffer, MPI_Aint offset) {
+    return buffer == MPI_IN_PLACE ? buffer : static_cast<char*>(buffer) + offset;
+}
+
+inline void* offsetBy(const void* buffer, MPI_Aint offset) {
+    return offsetBy(const_cast<void*>(buffer), offset);
+}
+
+}  // namespace
+
 //----------------------------------------------------------------------------------------------------------------------
 
 namespace {
@@ -432,47 +569,90 @@ int Parallel::procNull() const {
 }
 
 size_t Parallel::getCount(Status& st, Data::Code type) const {
-    int count = 0;
-
     MPI_Datatype mpitype = toType(type);
 
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_Count count = 0;
+    MPI_CALL(MPI_Get_count_c(toStatus(st), mpitype, &count));
+#else
+    int count = 0;
     MPI_CALL(MPI_Get_count(toStatus(st), mpitype, &count));
 
+    if (count == MPI_UNDEFINED) {
+        // too many elements for an int
+        MPI_Count elements = 0;
+        MPI_CALL(MPI_Get_elements_x(toStatus(st), mpitype, &elements));
+        ASSERT(elements != MPI_UNDEFINED);
+
+        // pair types count as two basic elements
+        switch (type) {
+            case Data::SHORT_INT:
+            case Data::INT_INT:
+            case Data::LONG_INT:
+            case Data::FLOAT_INT:
+            case Data::DOUBLE_INT:
+            case Data::LONG_DOUBLE_INT:
+            case Data::TWO_LONG:
+            case Data::TWO_LONG_LONG:
+                elements /= 2;
+                break;
+            default:
+                break;
+        }
+        return size_t(elements);
+    }
+#endif
+
     ASSERT(count >= 0);
     return size_t(count);
 }
 
 void Parallel::broadcast(void* buffer, size_t count, Data::Code type, size_t root) const {
     ASSERT(root < size_t(std::numeric_limits<int>::max()));
-    ASSERT(count < size_t(std::numeric_limits<int>::max()));
 
     MPI_Datatype mpitype = toType(type);
 
-    MPI_CALL(MPI_Bcast(buffer, int(count), mpitype, int(root), comm_));
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Bcast_c(buffer, MPI_Count(count), mpitype, int(root), comm_));
+#else
+    forEachChunk(count, mpitype, [&](MPI_Aint offset, int n) {
+        MPI_CALL(MPI_Bcast(offsetBy(buffer, offset), n, mpitype, int(root), comm_));
+    });
+#endif
 }
 
 void Parallel::gather(const void* sendbuf, size_t sendcount, void* recvbuf, size_t recvcount, Data::Code type,
                       size_t root) const {
-    ASSERT(sendcount < size_t(std::numeric_limits<int>::max()));
-    ASSERT(recvcount < size_t(std::numeric_limits<int>::max()));
     ASSERT(root < size_t(std::numeric_limits<int>::max()));
 
     MPI_Datatype mpitype = toType(type);
 
-    MPI_CALL(MPI_Gather(const_cast<void*>(sendbuf), int(sendcount), mpitype, recvbuf, int(recvcount), mpitype,
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Gather_c(const_cast<void*>(sendbuf), MPI_Count(sendcount), mpitype, recvbuf, MPI_Count(recvcount),
+                          mpitype, int(root), comm_));
+#else
+    LargeCount send(sendcount, mpitype);
+    LargeCount recv(recvcount, mpitype);
+    MPI_CALL(MPI_Gather(const_cast<void*>(sendbuf), send.count(), send.type(), recvbuf, recv.count(), recv.type(),
                         int(root), comm_));
+#endif
 }
 
 void Parallel::scatter(const void* sendbuf, size_t sendcount, void* recvbuf, size_t recvcount, Data::Code type,
                        size_t root) const {
-    ASSERT(sendcount < size_t(std::numeric_limits<int>::max()));
-    ASSERT(recvcount < size_t(std::numeric_limits<int>::max()));
     ASSERT(root < size_t(std::numeric_limits<int>::max()));
 
     MPI_Datatype mpitype = toType(type);
 
-    MPI_CALL(MPI_Scatter(const_cast<void*>(sendbuf), int(sendcount), mpitype, recvbuf, int(recvcount), mpitype,
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Scatter_c(const_cast<void*>(sendbuf), MPI_Count(sendcount), mpitype, recvbuf, MPI_Count(recvcount),
+                           mpitype, int(root), comm_));
+#else
+    LargeCount send(sendcount, mpitype);
+    LargeCount recv(recvcount, mpitype);
+    MPI_CALL(MPI_Scatter(const_cast<void*>(sendbuf), send.count(), send.type(), recvbuf, recv.count(), recv.type(),
                          int(root), comm_));
+#endif
 }
 
 void Parallel::gatherv(const void* sendbuf, size_t sendcount, void* recvbuf, const int recvcounts[], const int displs[],
@@ -498,57 +678,73 @@ void Parallel::scatterv(const void* sendbuf, const int sendcounts[], const int d
 }
 
 void Parallel::reduce(const void* sendbuf, void* recvbuf, size_t count, Data::Code type, Operation::Code op, size_t root) const {
-    ASSERT(count < size_t(std::numeric_limits<int>::max()));
-
     MPI_Datatype mpitype = toType(type);
     MPI_Op mpiop         = toOp(op);
-    ;
 
-    MPI_CALL(MPI_Reduce(const_cast<void*>(sendbuf), recvbuf, int(count), mpitype, mpiop, int(root), comm_));
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Reduce_c(const_cast<void*>(sendbuf), recvbuf, MPI_Count(count), mpitype, mpiop, int(root), comm_));
+#else
+    forEachChunk(count, mpitype, [&](MPI_Aint offset, int n) {
+        MPI_CALL(MPI_Reduce(offsetBy(sendbuf, offset), offsetBy(recvbuf, offset), n, mpitype, mpiop, int(root), comm_));
+    });
+#endif
 }
 
 void Parallel::reduceInPlace(void* sendrecvbuf, size_t count, Data::Code type, Operation::Code op, size_t root) const {
-    ASSERT(count < size_t(std::numeric_limits<int>::max()));
-
     MPI_Datatype mpitype = toType(type);
     MPI_Op mpiop         = toOp(op);
 
-    if (rank() == root) {
-        MPI_CALL(MPI_Reduce(MPI_IN_PLACE, sendrecvbuf, int(count), mpitype, mpiop, int(root), comm_));
-    }
-    else {
-        MPI_CALL(MPI_Reduce(sendrecvbuf, sendrecvbuf, int(count), mpitype, mpiop, int(root), comm_));
-    }
+    void* sendbuf = rank() == root ? MPI_IN_PLACE : sendrecvbuf;
+
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Reduce_c(sendbuf, sendrecvbuf, MPI_Count(count), mpitype, mpiop, int(root), comm_));
+#else
+    forEachChunk(count, mpitype, [&](MPI_Aint offset, int n) {
+        MPI_CALL(MPI_Reduce(offsetBy(sendbuf, offset), offsetBy(sendrecvbuf, offset), n, mpitype, mpiop, int(root),
+                            comm_));
+    });
+#endif
 }
 
 void Parallel::allReduce(const void* sendbuf, void* recvbuf, size_t count, Data::Code type, Operation::Code op) const {
-    ASSERT(count < size_t(std::numeric_limits<int>::max()));
-
     MPI_Datatype mpitype = toType(type);
     MPI_Op mpiop         = toOp(op);
-    ;
 
-    MPI_CALL(MPI_Allreduce(const_cast<void*>(sendbuf), recvbuf, int(count), mpitype, mpiop, comm_));
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Allreduce_c(const_cast<void*>(sendbuf), recvbuf, MPI_Count(count), mpitype, mpiop, comm_));
+#else
+    forEachChunk(count, mpitype, [&](MPI_Aint offset, int n) {
+        MPI_CALL(MPI_Allreduce(offsetBy(sendbuf, offset), offsetBy(recvbuf, offset), n, mpitype, mpiop, comm_));
+    });
+#endif
 }
 
 void Parallel::allReduceInPlace(void* sendrecvbuf, size_t count, Data::Code type, Operation::Code op) const {
-    ASSERT(count < size_t(std::numeric_limits<int>::max()));
-
     MPI_Datatype mpitype = toType(type);
     MPI_Op mpiop         = toOp(op);
 
-    MPI_CALL(MPI_Allreduce(MPI_IN_PLACE, sendrecvbuf, int(count), mpitype, mpiop, comm_));
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Allreduce_c(MPI_IN_PLACE, sendrecvbuf, MPI_Count(count), mpitype, mpiop, comm_));
+#else
+    forEachChunk(count, mpitype, [&](MPI_Aint offset, int n) {
+        MPI_CALL(MPI_Allreduce(MPI_IN_PLACE, offsetBy(sendrecvbuf, offset), n, mpitype, mpiop, comm_));
+    });
+#endif
 }
 
 void Parallel::allGather(const void* sendbuf, size_t sendcount, void* recvbuf, size_t recvcount,
                          Data::Code type) const {
-    ASSERT(sendcount < size_t(std::numeric_limits<int>::max()));
-    ASSERT(recvcount < size_t(std::numeric_limits<int>::max()));
-
     MPI_Datatype mpitype = toType(type);
 
-    MPI_CALL(
-        MPI_Allgather(const_cast<void*>(sendbuf), int(sendcount), mpitype, recvbuf, int(recvcount), mpitype, comm_));
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Allgather_c(const_cast<void*>(sendbuf), MPI_Count(sendcount), mpitype, recvbuf, MPI_Count(recvcount),
+                             mpitype, comm_));
+#else
+    LargeCount send(sendcount, mpitype);
+    LargeCount recv(recvcount, mpitype);
+    MPI_CALL(MPI_Allgather(const_cast<void*>(sendbuf), send.count(), send.type(), recvbuf, recv.count(), recv.type(),
+                           comm_));
+#endif
 }
 
 void Parallel::allGatherv(const void* sendbuf, size_t sendcount, void* recvbuf, const int recvcounts[],
@@ -562,13 +758,17 @@ void Parallel::allGatherv(const void* sendbuf, size_t sendcount, void* recvbuf,
 }
 
 void Parallel::allToAll(const void* sendbuf, size_t sendcount, void* recvbuf, size_t recvcount, Data::Code type) const {
-    ASSERT(sendcount < size_t(std::numeric_limits<int>::max()));
-    ASSERT(recvcount < size_t(std::numeric_limits<int>::max()));
-
     MPI_Datatype mpitype = toType(type);
 
-    MPI_CALL(
-        MPI_Alltoall(const_cast<void*>(sendbuf), int(sendcount), mpitype, recvbuf, int(recvcount), mpitype, comm_));
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Alltoall_c(const_cast<void*>(sendbuf), MPI_Count(sendcount), mpitype, recvbuf, MPI_Count(recvcount),
+                            mpitype, comm_));
+#else
+    LargeCount send(sendcount, mpitype);
+    LargeCount recv(recvcount, mpitype);
+    MPI_CALL(MPI_Alltoall(const_cast<void*>(sendbuf), send.count(), send.type(), recvbuf, recv.count(), recv.type(),
+                          comm_));
+#endif
 }
 
 void Parallel::allToAllv(const void* sendbuf, const int sendcounts[], const int sdispls[], void* recvbuf,
@@ -580,67 +780,86 @@ void Parallel::allToAllv(const void* sendbuf, const int sendcounts[], const int
 }
 
 Status Parallel::receive(void* recv, size_t count, Data::Code type, int source, int tag) const {
-    ASSERT(count < size_t(std::numeric_limits<int>::max()));
-
     MPI_Datatype mpitype = toType(type);
 
     Status status = createStatus();
 
-    MPI_CALL(MPI_Recv(recv, int(count), mpitype, source, tag, comm_, toStatus(status)));
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Recv_c(recv, MPI_Count(count), mpitype, source, tag, comm_, toStatus(status)));
+#else
+    LargeCount large(count, mpitype);
+    MPI_CALL(MPI_Recv(recv, large.count(), large.type(), source, tag, comm_, toStatus(status)));
+#endif
 
     return status;
 }
 
 void Parallel::send(const void* send, size_t count, Data::Code type, int dest, int tag) const {
-    ASSERT(count < size_t(std::numeric_limits<int>::max()));
-
     MPI_Datatype mpitype = toType(type);
 
-    MPI_CALL(MPI_Send(const_cast<void*>(send), int(count), mpitype, dest, tag, comm_));
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Send_c(const_cast<void*>(send), MPI_Count(count), mpitype, dest, tag, comm_));
+#else
+    LargeCount large(count, mpitype);
+    MPI_CALL(MPI_Send(const_cast<void*>(send), large.count(), large.type(), dest, tag, comm_));
+#endif
 }
 
 void Parallel::synchronisedSend(const void* send, size_t count, Data::Code type, int dest, int tag) const {
-    ASSERT(count < size_t(std::numeric_limits<int>::max()));
-
     MPI_Datatype mpitype = toType(type);
 
-    MPI_CALL(MPI_Ssend(const_cast<void*>(send), int(count), mpitype, dest, tag, comm_));
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Ssend_c(const_cast<void*>(send), MPI_Count(count), mpitype, dest, tag, comm_));
+#else
+    LargeCount large(count, mpitype);
+    MPI_CALL(MPI_Ssend(const_cast<void*>(send), large.count(), large.type(), dest, tag, comm_));
+#endif
 }
 
 Request Parallel::iReceive(void* recv, size_t count, Data::Code type, int source, int tag) const {
-    ASSERT(count < size_t(std::numeric_limits<int>::max()));
-
     Request req(new ParallelRequest());
 
     MPI_Datatype mpitype = toType(type);
 
-    MPI_CALL(MPI_Irecv(recv, int(count), mpitype, source, tag, comm_, toRequest(req)));
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Irecv_c(recv, MPI_Count(count), mpitype, source, tag, comm_, toRequest(req)));
+#else
+    LargeCount large(count, mpitype);
+    MPI_CALL(MPI_Irecv(recv, large.count(), large.type(), source, tag, comm_, toRequest(req)));
+#endif
 
     return req;
 }
 
 Request Parallel::iSend(const void* send, size_t count, Data::Code type, int dest, int tag) const {
-    ASSERT(count < size_t(std::numeric_limits<int>::max()));
-
     Request req(new ParallelRequest());
 
     MPI_Datatype mpitype = toType(type);
 
-    MPI_CALL(MPI_Isend(const_cast<void*>(send), int(count), mpitype, dest, tag, comm_, toRequest(req)));
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Isend_c(const_cast<void*>(send), MPI_Count(count), mpitype, dest, tag, comm_, toRequest(req)));
+#else
+    LargeCount large(count, mpitype);
+    MPI_CALL(MPI_Isend(const_cast<void*>(send), large.count(), large.type(), dest, tag, comm_, toRequest(req)));
+#endif
 
     return req;
 }
 
 Status Parallel::sendReceiveReplace(void* sendrecv, size_t count, Data::Code type,
                                     int dest, int sendtag, int source, int recvtag) const {
-    ASSERT(count < size_t(std::numeric_limits<int>::max()));
-
     MPI_Datatype mpitype = toType(type);
 
     Status status = createStatus();
 
-    MPI_CALL(MPI_Sendrecv_replace(sendrecv, int(count), mpitype,
+#if ECKIT_MPI_LARGE_COUNT
+    MPI_CALL(MPI_Sendrecv_replace_c(sendrecv, MPI_Count(count), mpitype,
+                                    dest, sendtag, source, recvtag, comm_, toStatus(status)));
+#else
+    LargeCount large(count, mpitype);
+    MPI_CALL(MPI_Sendrecv_replace(sendrecv, large.count(), large.type(),
                                   dest, sendtag, source, recvtag, comm_, toStatus(status)));
+#endif
 
     return status;
 }
@@ -726,13 +945,11 @@ int Parallel::communicator() const {
     return MPI_Comm_c2f(comm_);
 }
 
-eckit::SharedBuffer Parallel::broadcastFile(const PathName& filepath, size_t root) const {
-
-    ASSERT(root < size());
-
-    bool isRoot = rank() == root;
+namespace {
 
-    eckit::CountedBuffer* buffer = nullptr;
+/// Opens the file on root and broadcasts its length, throwing on all tasks if it cannot be read
+size_t openForBroadcast(const PathName& filepath, bool isRoot, int root, MPI_Comm comm,
+                        std::unique_ptr<DataHandle>& dh, std::unique_ptr<AutoClose>& closer) {
 
     struct BFileOp {
         int err_;
@@ -743,12 +960,10 @@ eckit::SharedBuffer Parallel::broadcastFile(const PathName& filepath, size_t roo
 
     if (isRoot) {
         try {
-            std::unique_ptr<DataHandle> dh(filepath.fileHandle());
+            dh.reset(filepath.fileHandle());
 
             op.len_ = dh->openForRead();
-            AutoClose closer(*dh);
-            buffer = new eckit::CountedBuffer(op.len_);
-            dh->read(buffer->data(), op.len_);
+            closer.reset(new AutoClose(*dh));
 
             if (filepath.isDir()) {
                 op.err_ = EISDIR;
@@ -759,7 +974,7 @@ eckit::SharedBuffer Parallel::broadcastFile(const PathName& filepath, size_t roo
         }
     }
 
-    broadcast(&op, sizeof(op), Data::BYTE, root);
+    MPI_CALL(MPI_Bcast(&op, int(sizeof(op)), MPI_BYTE, root, comm));
 
     errno = op.err_;  // set errno to ensure consistent error messages across MPI tasks
 
@@ -771,13 +986,146 @@ eckit::SharedBuffer Parallel::broadcastFile(const PathName& filepath, size_t roo
         throw ShortFile(filepath);
     }
 
-    if (!isRoot) {
-        buffer = new eckit::CountedBuffer(op.len_);
+    return op.len_;
+}
+
+/// Reads the file on root and broadcasts it, as a pipeline: the root reads the next chunk while the previous ones
+/// are being broadcast
+/// @returns the errno of a read error on root, on all tasks
+int readAndBroadcast(const PathName& filepath, DataHandle* dh, char* data, size_t length, int root, MPI_Comm comm) {
+
+    static const size_t chunkSize = [] {
+        long n = eckit::Resource<long>("mpiBroadcastFileChunkSize;$ECKIT_MPI_BROADCAST_FILE_CHUNK_SIZE",
+                                       64 * 1024 * 1024);
+        return std::min(size_t(std::max(n, 1L)), maxCount());
+    }();
+
+    int err = 0;
+
+    std::vector<MPI_Request> requests;
+    requests.reserve((length + chunkSize - 1) / chunkSize);
+
+    for (size_t offset = 0; offset < length; offset += chunkSize) {
+        const size_t len = std::min(chunkSize, length - offset);
+
+        // On error, keep taking part in the broadcasts, the error is reported to all tasks below
+        if (dh && !err) {
+            try {
+                size_t done = 0;
+                while (done < len) {
+                    errno  = 0;
+                    long n = dh->read(data + offset + done, long(len - done));
+                    if (n <= 0) {
+                        // A short file, or a read failing without throwing: errno is only meaningful in the latter
+                        err = (n < 0 && errno) ? errno : EIO;
+                        break;
+                    }
+                    done += n;
+                }
+            }
+            catch (Exception&) {
+                // A failing read, errno is from the read
+                err = errno ? errno : EIO;
+            }
+        }
+
+        MPI_Request request;
+        MPI_CALL(MPI_Ibcast(data + offset, int(len), MPI_BYTE, root, comm, &request));
+        requests.push_back(request);
+
+        int done = 0;
+        MPI_CALL(MPI_Testall(int(requests.size()), requests.data(), &done, MPI_STATUSES_IGNORE));
     }
 
-    broadcast(*buffer, op.len_, Data::BYTE, root);
+    MPI_CALL(MPI_Waitall(int(requests.size()), requests.data(), MPI_STATUSES_IGNORE));
+
+    MPI_CALL(MPI_Bcast(&err, 1, MPI_INT, root, comm));
+    return err;
+}
+
+}  // namespace
+
+eckit::SharedBuffer Parallel::broadcastFile(const PathName& filepath, size_t root) const {
+
+    ASSERT(root < size());
+
+    std::unique_ptr<DataHandle> dh;
+    std::unique_ptr<AutoClose> closer;
 
-    return eckit::SharedBuffer(buffer);
+    size_t length = openForBroadcast(filepath, rank() == root, int(root), comm_, dh, closer);
+
+    eckit::SharedBuffer buffer(length);
+
+    if (int err = readAndBroadcast(filepath, dh.get(), static_cast<char*>(buffer->data()), length, int(root), comm_)) {
+        errno = err;
+        throw ReadError(filepath);
+    }
+
+    return buffer;
+}
+
+SharedWindow Parallel::broadcastFileShared(const PathName& filepath, size_t root) const {
+
+    ASSERT(root < size());
+
+    std::unique_ptr<DataHandle> dh;
+    std::unique_ptr<AutoClose> closer;
+
+    const bool isRoot = rank() == root;
+
+    size_t length = openForBroadcast(filepath, isRoot, int(root), comm_, dh, closer);
+
+    // The tasks of each node, and the first task of each node (the leaders). Ordering by key makes root the
+    // leader of its node, and the first of the leaders
+
+    int key = isRoot ? 0 : int(rank()) + 1;
+
+    MPI_Comm node;
+    MPI_CALL(MPI_Comm_split_type(comm_, MPI_COMM_TYPE_SHARED, key, MPI_INFO_NULL, &node));
+
+    int nodeRank;
+    MPI_CALL(MPI_Comm_rank(node, &nodeRank));
+
+    MPI_Comm leaders;
+    MPI_CALL(MPI_Comm_split(comm_, nodeRank == 0 ? 0 : MPI_UNDEFINED, key, &leaders));
+
+    SharedWindow window(new ParallelSharedWindow(node, length, 0));
+
+    int err = 0;
+    if (leaders != MPI_COMM_NULL) {
+        err = readAndBroadcast(filepath, dh.get(), static_cast<char*>(window.data()), length, 0, leaders);
+        MPI_CALL(MPI_Comm_free(&leaders));
+    }
+
+    MPI_CALL(MPI_Bcast(&err, 1, MPI_INT, 0, node));
+    window.sync();
+
+    MPI_CALL(MPI_Comm_free(&node));
+
+    if (err) {
+        errno = err;
+        throw ReadError(filepath);
+    }
+
+    return window;
+}
+
+Comm& Parallel::splitShared(const std::string& name) const {
+
+    if (hasComm(name.c_str())) {
+        throw SeriousBug("Communicator with name " + name + " already exists");
+    }
+
+    MPI_Comm new_mpi_comm;
+    MPI_CALL(MPI_Comm_split_type(comm_, MPI_COMM_TYPE_SHARED, int(rank()), MPI_INFO_NULL, &new_mpi_comm));
+    Comm* newcomm = new Parallel(name, new_mpi_comm, true);
+    addComm(name.c_str(), newcomm);
+    return *newcomm;
+}
+
+SharedWindow Parallel::allocateSharedWindow(size_t bytes, size_t root) const {
+    ASSERT(root < size());
+    return SharedWindow(new ParallelSharedWindow(comm_, bytes, int(root)));
 }
 
 static CommBuilder<Parallel> ParallelBuilder("parallel");
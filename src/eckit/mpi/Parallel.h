@@ -119,6 +119,12 @@ protected:  // methods
 
     eckit::SharedBuffer broadcastFile(const eckit::PathName& filepath, size_t root) const override;
 
+    SharedWindow broadcastFileShared(const eckit::PathName& filepath, size_t root) const override;
+
+    Comm& splitShared(const std::string& name) const override;
+
+    SharedWindow allocateSharedWindow(size_t bytes, size_t root) const override;
+
     Comm& split(int color, const std::string& name) const override;
 
     void free() override;
@@ -155,6 +161,7 @@ public:
 
 private:                         // methods
     friend class ParallelGroup;  // Groups should not call free if mpi has been finalized. Hence PrallelGroup needs to query finalized()
+    friend class ParallelSharedWindow;  // idem for windows
 
     static void initialize();
 
@@ -0,0 +1,79 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <ostream>
+#include <string_view>
+
+#include "eckit/log/CodeLocation.h"
+#include "eckit/log/Log.h"
+#include "eckit/mpi/Parallel.h"
+#include "eckit/mpi/ParallelSharedWindow.h"
+
+namespace eckit {
+namespace mpi {
+
+void MPICall(int code, std::string_view mpifunc, const eckit::CodeLocation& loc);
+#define MPI_CALL(a) MPICall(a, #a, Here())
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ParallelSharedWindow::ParallelSharedWindow(MPI_Comm comm, size_t size, int root) :
+    win_(MPI_WIN_NULL), data_(nullptr), size_(size) {
+
+    int rank;
+    MPI_CALL(MPI_Comm_rank(comm, &rank));
+
+    // the memory is contiguous by construction (a single task allocates it), so let MPI place it optimally
+    MPI_Info info;
+    MPI_CALL(MPI_Info_create(&info));
+    MPI_CALL(MPI_Info_set(info, "alloc_shared_noncontig", "true"));
+
+    void* base     = nullptr;
+    MPI_Aint bytes = rank == root ? MPI_Aint(size_) : 0;
+    MPI_CALL(MPI_Win_allocate_shared(bytes, 1, info, comm, &base, &win_));
+    MPI_CALL(MPI_Info_free(&info));
+
+    MPI_Aint rootSize = 0;
+    int dispUnit      = 0;
+    MPI_CALL(MPI_Win_shared_query(win_, root, &rootSize, &dispUnit, &data_));
+
+    if (size_ == 0) {
+        data_ = nullptr;
+    }
+
+    // open the first epoch, so the memory can be written before the first sync()
+    MPI_CALL(MPI_Win_fence(0, win_));
+}
+
+ParallelSharedWindow::~ParallelSharedWindow() {
+    // not MPI_CALL, which throws, from a destructor
+    if (!Parallel::finalized()) {
+        if (int code = MPI_Win_free(&win_); code != MPI_SUCCESS) {
+            char error[MPI_MAX_ERROR_STRING];
+            int len = 0;
+            MPI_Error_string(code, error, &len);
+            Log::error() << "MPI call failed with error '" << std::string_view(error, size_t(len))
+                         << "' while calling MPI_Win_free in ~ParallelSharedWindow" << std::endl;
+        }
+    }
+}
+
+void ParallelSharedWindow::sync() {
+    MPI_CALL(MPI_Win_fence(0, win_));
+}
+
+void ParallelSharedWindow::print(std::ostream& os) const {
+    os << "ParallelSharedWindow(size=" << size_ << ")";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace mpi
+}  // namespace eckit
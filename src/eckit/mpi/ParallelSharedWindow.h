@@ -0,0 +1,58 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_mpi_ParallelSharedWindow_h
+#define eckit_mpi_ParallelSharedWindow_h
+
+#define OMPI_SKIP_MPICXX 1
+#define MPICH_SKIP_MPICXX 1
+
+#include <mpi.h>
+
+#include "eckit/mpi/SharedWindow.h"
+
+namespace eckit {
+namespace mpi {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// MPI-3 shared memory window (MPI_Win_allocate_shared), the memory being allocated by a single task
+/// and attached by the others
+
+class ParallelSharedWindow : public SharedWindowContent {
+public:
+    ~ParallelSharedWindow() override;
+
+private:  // constructor
+    ParallelSharedWindow(MPI_Comm, size_t size, int root);
+
+private:  // methods
+    void print(std::ostream&) const override;
+
+    void* data() const override { return data_; }
+
+    size_t size() const override { return size_; }
+
+    void sync() override;
+
+private:  // members
+    friend class Parallel;
+
+    MPI_Win win_;
+    void* data_;
+    size_t size_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace mpi
+}  // namespace eckit
+
+#endif
@@ -25,6 +25,7 @@
 #include "eckit/mpi/Group.h"
 #include "eckit/mpi/SerialData.h"
 #include "eckit/mpi/SerialRequest.h"
+#include "eckit/mpi/SerialSharedWindow.h"
 #include "eckit/mpi/SerialStatus.h"
 #include "eckit/runtime/Main.h"
 #include "eckit/thread/AutoLock.h"
@@ -386,8 +387,8 @@ Status Serial::receive(void* recv, size_t count, Data::Code type, int /*source*/
     if (tag != anyTag()) {
         ASSERT(tag == send.tag());
     }
-    ASSERT(count == send.count());
-    if (count > 0) {
+    ASSERT(count >= send.count());  // as MPI, the receive buffer may be larger than the message
+    if (send.count() > 0) {
         memcpy(recv, send.buffer(), send.count() * dataSize[send.type()]);
     }
 
@@ -409,8 +410,8 @@ Status Serial::sendReceiveReplace(void* sendrecv, size_t count, Data::Code type,
     if (recvtag != anyTag()) {
         ASSERT(recvtag == send.tag());
     }
-    ASSERT(count == send.count());
-    if (count > 0) {
+    ASSERT(count >= send.count());  // as MPI, the receive buffer may be larger than the message
+    if (send.count() > 0) {
         memcpy(sendrecv, send.buffer(), send.count() * dataSize[send.type()]);
     }
 
@@ -505,6 +506,39 @@ eckit::SharedBuffer Serial::broadcastFile(const PathName& filepath, size_t) cons
     return buffer;
 }
 
+SharedWindow Serial::broadcastFileShared(const PathName& filepath, size_t) const {
+
+    std::unique_ptr<DataHandle> dh(filepath.fileHandle());
+
+    Length len = dh->openForRead();
+    AutoClose closer(*dh);
+
+    if (filepath.isDir()) {
+        errno = EISDIR;
+        throw CantOpenFile(filepath);
+    }
+
+    if (not len) {
+        throw ShortFile(filepath);
+    }
+
+    SharedWindow window(new SerialSharedWindow(len));
+    if (dh->read(window.data(), len) != long(len)) {
+        throw ShortFile(filepath);
+    }
+
+    return window;
+}
+
+Comm& Serial::splitShared(const std::string& name) const {
+    return split(0, name);
+}
+
+SharedWindow Serial::allocateSharedWindow(size_t bytes, size_t root) const {
+    ASSERT(root == 0);
+    return SharedWindow(new SerialSharedWindow(bytes));
+}
+
 
 static CommBuilder<Serial> SerialBuilder("serial");
 
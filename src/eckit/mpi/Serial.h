@@ -123,6 +123,12 @@ protected:  // methods
 
     eckit::SharedBuffer broadcastFile(const eckit::PathName& filepath, size_t root) const override;
 
+    SharedWindow broadcastFileShared(const eckit::PathName& filepath, size_t root) const override;
+
+    Comm& splitShared(const std::string& name) const override;
+
+    SharedWindow allocateSharedWindow(size_t bytes, size_t root) const override;
+
     void print(std::ostream&) const override;
 
     Status status() const override { return createStatus(); }
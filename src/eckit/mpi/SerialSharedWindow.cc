@@ -0,0 +1,84 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <ostream>
+#include <sstream>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+#include "eckit/memory/MMap.h"
+#include "eckit/mpi/SerialSharedWindow.h"
+
+namespace eckit::mpi {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+SerialSharedWindow::SerialSharedWindow(size_t size) :
+    data_(nullptr), size_(size) {
+
+    if (size_ == 0) {
+        return;
+    }
+
+    static std::atomic<unsigned long> counter{0};
+
+    std::ostringstream name;
+    name << "/eckit-mpi-" << ::getpid() << "-" << counter++;
+
+    int fd = ::shm_open(name.str().c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        Log::error() << "shm_open(" << name.str() << ')' << Log::syserr << std::endl;
+        throw FailedSystemCall("shm_open", Here());
+    }
+    if (::shm_unlink(name.str().c_str()) < 0) {
+        Log::error() << "shm_unlink(" << name.str() << ')' << Log::syserr << std::endl;
+        ::close(fd);
+        throw FailedSystemCall("shm_unlink", Here());
+    }
+
+    if (::ftruncate(fd, size_) < 0) {
+        Log::error() << "ftruncate(" << name.str() << ", " << size_ << ')' << Log::syserr << std::endl;
+        ::close(fd);
+        throw FailedSystemCall("ftruncate", Here());
+    }
+
+    data_ = MMap::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        Log::error() << "SerialSharedWindow fails to mmap " << Bytes(size_) << Log::syserr << std::endl;
+        throw FailedSystemCall("mmap", Here());
+    }
+}
+
+SerialSharedWindow::~SerialSharedWindow() {
+    if (data_ != nullptr) {
+        MMap::munmap(data_, size_);
+    }
+}
+
+void SerialSharedWindow::sync() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void SerialSharedWindow::print(std::ostream& os) const {
+    os << "SerialSharedWindow(size=" << size_ << ")";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::mpi
@@ -0,0 +1,50 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_mpi_SerialSharedWindow_h
+#define eckit_mpi_SerialSharedWindow_h
+
+#include "eckit/mpi/SharedWindow.h"
+
+namespace eckit::mpi {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Anonymous POSIX shared memory, unlinked on creation so it is released with the mapping
+/// (or by the kernel if the process dies), and shared with forked children.
+
+class SerialSharedWindow : public SharedWindowContent {
+public:
+    ~SerialSharedWindow() override;
+
+private:  // constructor
+    SerialSharedWindow(size_t size);
+
+private:  // methods
+    void print(std::ostream&) const override;
+
+    void* data() const override { return data_; }
+
+    size_t size() const override { return size_; }
+
+    void sync() override;
+
+private:  // members
+    friend class Serial;
+
+    void* data_;
+    size_t size_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::mpi
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <ostream>
+
+#include "eckit/mpi/SharedWindow.h"
+
+namespace eckit::mpi {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class NullSharedWindowContent : public SharedWindowContent {
+public:
+    ~NullSharedWindowContent() override {}
+
+    void print(std::ostream& os) const override { os << "NullSharedWindow()"; }
+
+    void* data() const override { return nullptr; }
+
+    size_t size() const override { return 0; }
+
+    void sync() override {}
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+SharedWindow::SharedWindow() :
+    content_(new NullSharedWindowContent()) {
+    content_->attach();
+}
+
+SharedWindow::SharedWindow(SharedWindowContent* p) :
+    content_(p) {
+    content_->attach();
+}
+
+SharedWindow::~SharedWindow() {
+    content_->detach();
+}
+
+SharedWindow::SharedWindow(const SharedWindow& s) :
+    content_(s.content_) {
+    content_->attach();
+}
+
+SharedWindow& SharedWindow::operator=(const SharedWindow& s) {
+    s.content_->attach();
+    content_->detach();
+    content_ = s.content_;
+    return *this;
+}
+
+void* SharedWindow::data() const {
+    return content_->data();
+}
+
+size_t SharedWindow::size() const {
+    return content_->size();
+}
+
+void SharedWindow::sync() {
+    content_->sync();
+}
+
+void SharedWindow::print(std::ostream& out) const {
+    content_->print(out);
+}
+
+SharedWindowContent::~SharedWindowContent() {}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::mpi
@@ -0,0 +1,132 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_mpi_SharedWindow_h
+#define eckit_mpi_SharedWindow_h
+
+#include <cstddef>
+#include <iosfwd>
+
+#include "eckit/memory/Counted.h"
+
+namespace eckit::mpi {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class SharedWindowContent : public Counted {
+public:
+    ~SharedWindowContent() override;
+
+    virtual void print(std::ostream&) const = 0;
+
+    virtual void* data() const = 0;
+
+    virtual size_t size() const = 0;
+
+    virtual void sync() = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Memory shared between the tasks of a node-local communicator, see Comm::allocateSharedWindow().
+/// Copies share the same memory, which is released with the last copy.
+/// @note Releasing the last copy (including those held by SharedArray) is collective, like sync(): every task must
+///       release its last copy at the same point in its sequence of collective calls on the communicator, or they
+///       deadlock. Keep windows in objects with the same lifetime on all tasks, or reset them explicitly.
+/// SharedWindow by construction has always a valid content_
+/// @invariant content_ is not null
+
+class SharedWindow {
+
+public:  // methods
+    /// Null window constructor
+    SharedWindow();
+    /// Constructor
+    SharedWindow(SharedWindowContent*);
+
+    ~SharedWindow();
+
+    SharedWindow(const SharedWindow&);
+
+    SharedWindow& operator=(const SharedWindow&);
+
+    template <class T>
+    T& as() {
+        return dynamic_cast<T&>(*content_);
+    }
+
+    /// @returns base address of the memory, the same memory for all tasks of the communicator
+    void* data() const;
+
+    /// @returns size of the memory in bytes
+    size_t size() const;
+
+    /// @brief Make stores to the memory by any task visible to all tasks (collective)
+    /// Call after writing and before reading the memory written by another task.
+    void sync();
+
+private:  // methods
+    void print(std::ostream&) const;
+
+    friend std::ostream& operator<<(std::ostream& s, const SharedWindow& o) {
+        o.print(s);
+        return s;
+    }
+
+private:  // members
+    SharedWindowContent* content_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Typed view on a SharedWindow, keeping the memory alive
+template <typename T>
+class SharedArray {
+public:  // types
+    using value_type     = T;
+    using iterator       = T*;
+    using const_iterator = const T*;
+
+public:  // methods
+    SharedArray() = default;
+
+    explicit SharedArray(const SharedWindow& window) :
+        window_(window) {}
+
+    T* data() { return static_cast<T*>(window_.data()); }
+    const T* data() const { return static_cast<const T*>(window_.data()); }
+
+    size_t size() const { return window_.size() / sizeof(T); }
+
+    bool empty() const { return size() == 0; }
+
+    T& operator[](size_t i) { return data()[i]; }
+    const T& operator[](size_t i) const { return data()[i]; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size(); }
+
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+
+    /// @brief see SharedWindow::sync()
+    void sync() { window_.sync(); }
+
+    const SharedWindow& window() const { return window_; }
+
+private:  // members
+    SharedWindow window_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::mpi
+
+#endif
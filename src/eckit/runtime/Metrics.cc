@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include "eckit/exception/Exceptions.h"
+#include "eckit/log/Histogram.h"
 #include "eckit/log/JSON.h"
 #include "eckit/runtime/Main.h"
 #include "eckit/serialisation/Stream.h"
@@ -317,6 +318,10 @@ void Metrics::set(const std::string& name, const Offset& value, bool overrideOk)
     set(name, static_cast<long long>(value), overrideOk);
 }
 
+void Metrics::setHistogram(const std::string& name, const Histogram& value, double unit, bool overrideOk) {
+    set(name, value.summary(unit), overrideOk);
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
 CollectMetrics::CollectMetrics() :
@@ -27,6 +27,7 @@ class Stream;
 class MetricsCollector;
 class Offset;
 class Length;
+class Histogram;
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -50,6 +51,9 @@ public:  // methods
     static void set(const std::string& name, const Offset& value, bool overrideOk = false);
     static void set(const std::string& name, const Length& value, bool overrideOk = false);
 
+    /// Sets the summary of a histogram (count, min, mean, max and percentiles), scaled by unit
+    static void setHistogram(const std::string& name, const Histogram& value, double unit = 1, bool overrideOk = false);
+
     static void timestamp(const std::string& name, time_t value, bool overrideOk = false);
 
     static void error(const std::exception&);
@@ -116,15 +116,24 @@ Monitor::TaskArray& Monitor::tasks() {
 
 template class ThreadSingleton<Monitor>;
 
-Monitor& Monitor::instance() {
+static ThreadSingleton<Monitor>& monitors() {
     static ThreadSingleton<Monitor> monitor;
-    Monitor& m = monitor.instance();
+    return monitor;
+}
+
+Monitor& Monitor::instance() {
+    Monitor& m = monitors().instance();
     if (!m.ready_) {
         m.init();
     }
     return m;
 }
 
+Monitor* Monitor::current() {
+    Monitor* m = monitors().find();
+    return m && m->ready_ ? m : nullptr;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
 Monitor::Monitor() :
@@ -297,6 +306,20 @@ void Monitor::progress() {
     task().done();
 }
 
+void Monitor::bytesRead(unsigned long long n) {
+    if (!ready_) {
+        return;
+    }
+    task().bytesRead(n);
+}
+
+void Monitor::bytesWritten(unsigned long long n) {
+    if (!ready_) {
+        return;
+    }
+    task().bytesWritten(n);
+}
+
 char Monitor::state(char c) {
     char x = task().state();
     task().state(c);
@@ -56,6 +56,10 @@ public:  // types
 public:  // methods
     static Monitor& instance();
 
+    /// The monitor of the calling thread if it already has one, nullptr otherwise. Unlike instance(), never takes a
+    /// task slot, for code also run by threads that are not monitored.
+    static Monitor* current();
+
     static bool active();
     static void active(bool a);
 
@@ -72,6 +76,9 @@ public:  // methods
     void progress(unsigned long long);
     void progress();
 
+    void bytesRead(unsigned long long);
+    void bytesWritten(unsigned long long);
+
     char state(char);
 
     void message(const std::string&);
@@ -9,6 +9,7 @@
  */
 
 #include <signal.h>
+#include <sys/resource.h>
 #include <sys/time.h>
 #include <unistd.h>
 
@@ -58,32 +59,38 @@ TaskInfo::~TaskInfo() {
 
 void TaskInfo::kind(const std::string& s) {
     touch();
+    Update update(*this);
     strncpy(kind_, s.c_str(), sizeof(kind_) - 1);
 }
 
 void TaskInfo::name(const std::string& s) {
     touch();
+    Update update(*this);
     strncpy(name_, s.c_str(), sizeof(name_) - 1);
 }
 
 void TaskInfo::status(const std::string& s) {
     touch();
+    Update update(*this);
     strncpy(status_, s.c_str(), sizeof(status_) - 1);
 }
 
 void TaskInfo::message(const std::string& s) {
     touch();
+    Update update(*this);
     zero(message_);
     strncpy(message_, s.c_str(), sizeof(message_) - 1);
 }
 
 void TaskInfo::progressName(const std::string& s) {
     touch();
+    Update update(*this);
     strncpy(progress_.name_, s.c_str(), sizeof(progress_.name_) - 1);
 }
 
 void TaskInfo::out(char* from, char* to) {
     touch();
+    Update update(*this);
     for (char* p = from; p != to; p++) {
         buffer_[(pos_++) % size_] = *p;
     }
@@ -139,17 +146,20 @@ bool TaskInfo::busy(bool check) {
 }
 
 void TaskInfo::start(unsigned long long min, unsigned long long max) {
+    touch();
+    Update update(*this);
     progress_.rate_ = progress_.speed_ = 0;
     progress_.min_                     = min;
     progress_.max_                     = max;
     progress_.val_                     = min;
     ::gettimeofday(&progress_.start_, nullptr);
     ::gettimeofday(&progress_.last_, nullptr);
-
-    touch();
 }
 
 void TaskInfo::progress(unsigned long long val) {
+    touch();
+    Update update(*this);
+
     ::timeval now;
     ::gettimeofday(&now, nullptr);
 
@@ -170,7 +180,6 @@ void TaskInfo::progress(unsigned long long val) {
     progress_.val_ = val;
 
     ::gettimeofday(&progress_.last_, nullptr);
-    touch();
 }
 
 void TaskInfo::done() {
@@ -180,8 +189,12 @@ void TaskInfo::done() {
 void TaskInfo::touch() {
     checkAbort();
 
-    // FIXME: potential race condition (reported by Clang ThreadSanitizer)
-    check_ = last_ = ::time(nullptr);
+    time_t now = ::time(nullptr);
+    if (now != last_) {
+        resources();
+    }
+
+    check_ = last_ = now;
     busy_          = true;
 
     SignalHandler::checkInterrupt();
@@ -200,7 +213,48 @@ void TaskInfo::checkAbort() {
     }
 }
 
+void TaskInfo::resources() {
+#ifdef RUSAGE_THREAD
+    // Only the owning thread can measure itself
+    if (!pthread_equal(thread_, ::pthread_self()) || pid_ != ::getpid()) {
+        return;
+    }
+
+    struct rusage usage;
+    if (::getrusage(RUSAGE_THREAD, &usage) == 0) {
+        Update update(*this);
+        cpuUser_   = double(usage.ru_utime.tv_sec) + double(usage.ru_utime.tv_usec) / 1000000.;
+        cpuSystem_ = double(usage.ru_stime.tv_sec) + double(usage.ru_stime.tv_usec) / 1000000.;
+    }
+#endif
+}
+
+bool TaskInfo::snapshot(TaskInfo& into) const {
+    const size_t retries = 1000;
+
+    for (size_t i = 0; i < retries; ++i) {
+        unsigned long before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;  // being updated
+        }
+
+        ::memcpy(static_cast<void*>(&into), static_cast<const void*>(this), sizeof(TaskInfo));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TaskSnapshot::TaskSnapshot() {
+    ::memset(static_cast<void*>(&storage_), 0, sizeof(storage_));
+}
+
 void TaskInfo::parent(long p) {
+    Update update(*this);
     parent_ = p;
     depth_  = 0;
     if (p >= 0) {
@@ -211,13 +265,15 @@ void TaskInfo::parent(long p) {
 //----------------------------------------------------------------------------------------------------------------------
 
 void TaskInfo::json(JSON& json) const {
+    Monitor::TaskArray& tasks = Monitor::instance().tasks();
+    bool slot                 = this >= tasks.cbegin() && this < tasks.cend();
+    this->json(json, slot ? std::distance(tasks.cbegin(), this) : -1);
+}
 
-    Monitor& monitor = Monitor::instance();
-    auto n           = std::distance(monitor.tasks().cbegin(), this);
-
+void TaskInfo::json(JSON& json, long id) const {
     json.startObject();
 
-    json << "id" << n;
+    json << "id" << id;
     json << "busy" << busy_;
     // json << "thread" << thread_;
     json << "pid" << pid_;
@@ -273,6 +329,10 @@ void TaskInfo::json(JSON& json) const {
     json << "port" << port_;
     json << "host" << host_;
     json << "message" << message_;
+    json << "bytesRead" << bytesRead();
+    json << "bytesWritten" << bytesWritten();
+    json << "cpuUser" << cpuUser_;
+    json << "cpuSystem" << cpuSystem_;
 
     json.endObject();
 }
@@ -16,8 +16,11 @@
 #define eckit_TaskInfo_h
 
 #include <sys/time.h>
+#include <atomic>
 #include <cstring>
+#include <type_traits>
 
+#include "eckit/memory/NonCopyable.h"
 #include "eckit/memory/Padded.h"
 #include "eckit/runtime/TaskID.h"
 #include "eckit/types/Types.h"
@@ -92,8 +95,21 @@ protected:
     char host_[80];
 
     char message_[80];
+
+    // Seqlock of the fields above: odd while the owning thread updates them, see TaskInfo::snapshot()
+    std::atomic<unsigned long> sequence_;
+
+    // Resources used by the task
+    std::atomic<unsigned long long> bytesRead_;
+    std::atomic<unsigned long long> bytesWritten_;
+    double cpuUser_;
+    double cpuSystem_;
 };
 
+// The slots are shared between processes, their atomics must not rely on a process-local lock
+static_assert(std::atomic<unsigned long>::is_always_lock_free && std::atomic<unsigned long long>::is_always_lock_free,
+              "TaskInfo requires lock-free atomics");
+
 //----------------------------------------------------------------------------------------------------------------------
 
 class TaskInfo : public Padded<Info, 4096>, public NonCopyable {
@@ -115,6 +131,7 @@ public:
     unsigned long late() const { return late_; }
     void late(unsigned long n) {
         touch();
+        Update update(*this);
         late_ = n;
     }
 
@@ -155,9 +172,9 @@ public:
     void message(const std::string&);
     void progressName(const std::string&);
 
-    /// @todo FIXME potential race condition (reported by Clang ThreadSanitizer)
     void show(bool s) {
         touch();
+        Update update(*this);
         show_ = s;
     }
     bool show() const { return show_; }
@@ -186,27 +203,71 @@ public:
 
     void state(char c) {
         touch();
+        Update update(*this);
         state_ = c;
     }
     char state() const { return state_; }
 
     void port(int p) {
         touch();
+        Update update(*this);
         port_ = p;
     }
     int port() const { return port_; }
 
     void host(const std::string& h) {
         touch();
+        Update update(*this);
         strncpy(host_, h.c_str(), sizeof(host_));
         host_[sizeof(host_) - 1] = '\0';
     }
 
     std::string host() const { return host_; }
 
+    // ---------------------------------------------------------
+    // Resources
+
+    void bytesRead(unsigned long long n) { bytesRead_.fetch_add(n, std::memory_order_relaxed); }
+    void bytesWritten(unsigned long long n) { bytesWritten_.fetch_add(n, std::memory_order_relaxed); }
+
+    unsigned long long bytesRead() const { return bytesRead_.load(std::memory_order_relaxed); }
+    unsigned long long bytesWritten() const { return bytesWritten_.load(std::memory_order_relaxed); }
+
+    /// CPU time of the owning thread in seconds, refreshed at most once per second by touch()
+    double cpuUser() const { return cpuUser_; }
+    double cpuSystem() const { return cpuSystem_; }
+
+    // ---------------------------------------------------------
+
+    /// Copies a consistent view of this slot into `into`, without locking and without blocking the owning thread.
+    /// Retries while the slot is being updated.
+    /// @returns false if the slot kept changing, in which case `into` holds the last (possibly torn) copy
+    bool snapshot(TaskInfo& into) const;
+
+    void json(JSON&, long id) const;
+
+private:  // types
+    /// Marks an update of the slot by its owning thread: readers retry their snapshot() until it is complete.
+    /// Updates do not nest and are not cross-process locked, the slot has a single writer.
+    class Update {
+    public:
+        explicit Update(TaskInfo& info) :
+            info_(info) {
+            info_.sequence_.store(info_.sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+        ~Update() {
+            info_.sequence_.store(info_.sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+    private:
+        TaskInfo& info_;
+    };
+
 private:  // methods
     void print(std::ostream&) const;
     void json(JSON&) const;
+    void resources();
 
     friend std::ostream& operator<<(std::ostream& s, const TaskInfo& p) {
         p.print(s);
@@ -227,6 +288,29 @@ inline unsigned long version(TaskInfo*) {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// Private copy of a TaskInfo slot, for readers such as PsCmd:
+///
+///     TaskSnapshot copy;
+///     if (copy.take(Monitor::instance().tasks()[n])) { ... copy->status() ... }
+
+class TaskSnapshot : private NonCopyable {
+public:
+    TaskSnapshot();
+
+    bool take(const TaskInfo& info) { return info.snapshot(this->info()); }
+
+    TaskInfo& info() { return *reinterpret_cast<TaskInfo*>(&storage_); }
+    const TaskInfo& info() const { return *reinterpret_cast<const TaskInfo*>(&storage_); }
+
+    const TaskInfo* operator->() const { return &info(); }
+
+private:
+    // Not constructed: slots are plain memory, filled by TaskInfo::snapshot()
+    std::aligned_storage<sizeof(TaskInfo), alignof(TaskInfo)>::type storage_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
 }  // namespace eckit
 
 #endif
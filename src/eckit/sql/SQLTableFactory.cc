@@ -13,6 +13,7 @@
 #include <algorithm>
 
 #include "eckit/exception/Exceptions.h"
+#include "eckit/system/DeferredPlugins.h"
 
 namespace eckit::sql {
 
@@ -37,15 +38,22 @@ SQLTable* SQLTableFactory::build(SQLDatabase& owner, const std::string& name, co
     // The extra scope ensures that the mutex destructor is called _before_ the throw
     // statement.
 
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
+    // Factories may come from plugins not loaded yet, then look again
+    for (bool retry = true;; retry = false) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
 
-        for (const auto& factory : factories_) {
-            SQLTable* t = factory->build(owner, name, location2);
-            if (t) {
-                return t;
+            for (const auto& factory : factories_) {
+                SQLTable* t = factory->build(owner, name, location2);
+                if (t) {
+                    return t;
+                }
             }
         }
+
+        if (!retry || !system::loadPluginsForMissingBuilder()) {
+            break;
+        }
     }
 
     throw UserError("No SQL table could be built for " + name + " (" + location2 + ")", Here());
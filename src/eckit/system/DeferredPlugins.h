@@ -0,0 +1,36 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file DeferredPlugins.h
+///
+/// With the resource lazyPlugins ($ECKIT_LAZY_PLUGINS), LibraryManager::autoLoadPlugins only records the plugins to
+/// load. They are loaded by the first of these lookups that finds nothing, and the lookup is then repeated:
+///   - Factory<T>::get
+///   - HashFactory::build, CompressorFactory::build, PathNameFactory::build, message::SplitterFactory::lookup
+///   - LibraryManager::lookupPlugin
+///   - mpi::CommFactory (eckit_mpi), distributed::TransportFactory (eckit_distributed),
+///     sql::SQLTableFactory (eckit_sql)
+/// Other registries (has() and exists() methods included) do not load them.
+///
+/// Kept apart from LibraryManager.h, so that header-only factories do not depend on it.
+
+#pragma once
+
+namespace eckit::system {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// To be called by a factory that finds no builder, without holding its own lock, as plugins register builders
+/// @returns whether deferred plugins were loaded, and so whether the lookup is worth repeating
+bool loadPluginsForMissingBuilder();
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::system
@@ -12,6 +12,7 @@
 /// @date   November 2020
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <map>
 
@@ -34,6 +35,7 @@
 #include "eckit/os/System.h"
 #include "eckit/system/Library.h"
 #include "eckit/system/Plugin.h"
+#include "eckit/system/StartupCache.h"
 #include "eckit/system/SystemInfo.h"
 #include "eckit/thread/AutoLock.h"
 #include "eckit/thread/Mutex.h"
@@ -176,6 +178,24 @@ public:  // methods
 
         static std::vector<std::string> paths = dynamicLibraryPaths();
 
+        StartupCache& cache = StartupCache::instance();
+
+        // A path found by a previous process saves probing the directories
+        std::string cached;
+        if (cache.library(dynamicLibraryName, paths, cached)) {
+            Log::debug() << "Library " << dynamicLibraryName << " found in startup cache at '" << cached << "'"
+                         << std::endl;
+            if (cached.empty()) {
+                void* plib = ::dlopen(dynamicLibraryName.c_str(), RTLD_NOW | RTLD_GLOBAL);
+                if (plib) {
+                    return plib;
+                }
+            }
+            else if (void* plib = ::dlopen(cached.c_str(), RTLD_NOW | RTLD_GLOBAL)) {
+                return plib;
+            }
+        }
+
         // Try the various paths in the way
         for (const std::string& dir : paths) {
 
@@ -196,6 +216,7 @@ public:  // methods
                 }
 
                 Log::debug() << "Loaded library " << path_from_libhandle(dynamicLibraryName, plib) << std::endl;
+                cache.library(dynamicLibraryName, paths, path.localPath());
                 return plib;
             }
         }
@@ -206,6 +227,7 @@ public:  // methods
         void* plib = ::dlopen(dynamicLibraryName.c_str(), RTLD_NOW | RTLD_GLOBAL);
         if (plib) {
             Log::debug() << "Loaded library " << path_from_libhandle(dynamicLibraryName, plib) << std::endl;
+            cache.library(dynamicLibraryName, paths, "");
             return plib;
         }
 
@@ -308,12 +330,36 @@ public:  // methods
         return scanPaths;
     }
 
+    static LocalConfiguration manifest(const StartupCache::Manifest& m) {
+        LocalConfiguration manifest;
+        manifest.set("name", m.name);
+        manifest.set("namespace", m.namespce);
+        if (!m.library.empty()) {
+            manifest.set("library", m.library);
+        }
+        return manifest;
+    }
+
     std::map<std::string, LocalConfiguration> scanManifestPaths() {
         std::map<std::string, LocalConfiguration> manifests;
         std::vector<std::string> scanPaths = pluginManifestScanPaths();
 
         Log::debug() << "Plugins manifest candidate paths " << scanPaths << std::endl;
 
+        StartupCache& cache = StartupCache::instance();
+
+        std::vector<StartupCache::Manifest> cached;
+        if (cache.manifests(scanPaths, cached)) {
+            Log::debug() << "Plugins manifests found in startup cache" << std::endl;
+            for (const auto& m : cached) {
+                manifests[m.namespce + "." + m.name] = manifest(m);
+            }
+            return manifests;
+        }
+
+        std::vector<std::string> read;  //< manifests files, and where the cached manifests were found
+        std::vector<StartupCache::Manifest> found;
+
         std::set<LocalPathName> visited;  //< we dont visit same path twice
 
         for (const auto& path : scanPaths) {
@@ -341,6 +387,7 @@ public:  // methods
             for (const auto& p : files) {
                 PathName path(p);
                 Log::debug() << "Found plugin manifest " << path << std::endl;
+                read.push_back(p.localPath());
                 YAMLConfiguration conf(path);
                 if (conf.has("plugin")) {
                     LocalConfiguration manifest = conf.getSubConfiguration("plugin");
@@ -350,6 +397,7 @@ public:  // methods
                     std::string fullQualifiedName = namespce + "." + name;
                     if (manifests.find(fullQualifiedName) == manifests.end()) {
                         manifests[fullQualifiedName] = manifest;
+                        found.push_back({name, namespce, manifest.has("library") ? manifest.getString("library") : ""});
                     }
                     else {
                         Log::debug() << "The plugin " << fullQualifiedName
@@ -358,6 +406,8 @@ public:  // methods
                 }
             }
         }
+
+        cache.manifests(scanPaths, read, found);
         return manifests;
     }
 
@@ -377,7 +427,10 @@ public:  // methods
             }
         }
 
-        Log::debug() << "Going to load following plugins " << plugins << std::endl;
+        static bool lazy = Resource<bool>("$ECKIT_LAZY_PLUGINS;lazyPlugins", false);
+
+        Log::debug() << "Going to " << (lazy ? "defer loading of" : "load") << " following plugins " << plugins
+                     << std::endl;
 
         // loop over full qualified plugin names
         for (const auto& fqname : plugins) {
@@ -388,12 +441,59 @@ public:  // methods
                 std::string fullQualifiedName = namespce + "." + name;
                 ASSERT(fqname == fullQualifiedName);
                 std::string lib = manifest.getString("library");
-                Plugin& plugin  = loadPlugin(name, lib);
+                if (lazy) {
+                    deferred_.emplace_back(name, lib);
+                }
+                else {
+                    loadPlugin(name, lib);
+                }
             }
             else {
                 Log::warning() << "Could not find manifest file for plugin " << fqname << std::endl;
             }
         }
+
+        hasDeferred_ = !deferred_.empty();
+
+        StartupCache::instance().save();
+    }
+
+    bool loadDeferredPlugins() {
+        // Cleared only once all deferred plugins are loaded: a thread that misses meanwhile waits for them below
+        if (!hasDeferred_) {
+            return false;
+        }
+
+        AutoLock<Mutex> lockme(mutex_);
+
+        // Plugins loading may look up factories, and come back here
+        if (loading_) {
+            return false;
+        }
+
+        // Loaded by another thread while this one was waiting
+        if (deferred_.empty()) {
+            return true;
+        }
+
+        loading_ = true;
+        try {
+            while (!deferred_.empty()) {
+                std::pair<std::string, std::string> p = deferred_.front();
+                deferred_.erase(deferred_.begin());
+                Log::debug() << "Loading deferred plugin [" << p.first << "]" << std::endl;
+                loadPlugin(p.first, p.second);
+            }
+        }
+        catch (...) {
+            loading_ = false;
+            throw;
+        }
+        loading_     = false;
+        hasDeferred_ = false;
+
+        StartupCache::instance().save();
+        return true;
     }
 
 
@@ -423,6 +523,9 @@ private:  // members
     LibraryMap libs_;
     std::map<std::string, std::string> plugins_;  //< map plugin name to library
     std::map<std::string, bool> is_plugin_initialized_;
+    std::vector<std::pair<std::string, std::string>> deferred_;  //< plugins (name, library) not loaded yet
+    std::atomic<bool> hasDeferred_{false};
+    bool loading_{false};                                        //< deferred plugins being loaded, by the thread holding mutex_
     mutable Mutex mutex_;
 };
 
@@ -454,6 +557,9 @@ const Library& LibraryManager::lookup(const std::string& name) {
 
 const Plugin& LibraryManager::lookupPlugin(const std::string& name) {
     Plugin* plugin = LibraryRegistry::instance().lookupPlugin(name);
+    if (!plugin && LibraryRegistry::instance().loadDeferredPlugins()) {
+        plugin = LibraryRegistry::instance().lookupPlugin(name);
+    }
     if (plugin) {
         return *plugin;
     }
@@ -472,6 +578,10 @@ void LibraryManager::autoLoadPlugins(const std::vector<std::string>& plugins) {
     LibraryRegistry::instance().autoLoadPlugins(plugins);
 }
 
+bool LibraryManager::loadDeferredPlugins() {
+    return LibraryRegistry::instance().loadDeferredPlugins();
+}
+
 void LibraryManager::enregisterPlugin(const std::string& name, const std::string& libname) {
     LibraryRegistry::instance().enregisterPlugin(name, libname);
 }
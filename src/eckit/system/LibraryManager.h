@@ -70,9 +70,15 @@ public:  // class methods
     static Plugin& loadPlugin(const std::string& name, const std::string& library = std::string());
 
     /// @brief Scans and Auto loads Plugins
+    ///        With the resource lazyPlugins ($ECKIT_LAZY_PLUGINS), loading is deferred until loadDeferredPlugins()
     /// @param [in] dir path to scan for plugin manifests
     static void autoLoadPlugins(const std::vector<std::string>& plugins);
 
+    /// @brief Loads the plugins whose loading was deferred by autoLoadPlugins
+    ///        Factories call it through loadPluginsForMissingBuilder(), see DeferredPlugins.h
+    /// @returns true if plugins were loaded
+    static bool loadDeferredPlugins();
+
     /// @brief Registers a library as a plugin
     ///        To be called from the Plugin constructor
     /// @param [in] name Name of the library plugin to register
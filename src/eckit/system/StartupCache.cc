@@ -0,0 +1,289 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/system/StartupCache.h"
+
+#include <unistd.h>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/log/JSON.h"
+#include "eckit/log/Log.h"
+#include "eckit/os/Stat.h"
+#include "eckit/parser/JSONParser.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/value/Value.h"
+
+namespace eckit::system {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+constexpr long version = 1;
+
+void write(JSON& json, const std::vector<std::pair<std::string, long long>>& stamps) {
+    json.startList();
+    for (const auto& s : stamps) {
+        json.startList();
+        json << s.first << s.second;
+        json.endList();
+    }
+    json.endList();
+}
+
+std::vector<std::pair<std::string, long long>> read(const Value& v) {
+    std::vector<std::pair<std::string, long long>> stamps;
+    for (size_t i = 0; i < v.size(); ++i) {
+        stamps.emplace_back(std::string(v[i][0]), (long long)(v[i][1]));
+    }
+    return stamps;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+StartupCache& StartupCache::instance() {
+    static StartupCache cache(Resource<std::string>("$ECKIT_STARTUP_CACHE;startupCache", ""));
+    return cache;
+}
+
+StartupCache::StartupCache(const std::string& path) :
+    path_(path) {}
+
+long long StartupCache::mtime(const std::string& path) {
+    Stat::Struct s;
+    if (Stat::stat(LocalPathName(path).localPath(), &s) != 0) {
+        return -1;
+    }
+    return s.st_mtime;
+}
+
+StartupCache::Stamps StartupCache::stamps(const std::vector<std::string>& paths) {
+    Stamps result;
+    result.reserve(paths.size());
+    for (const auto& p : paths) {
+        result.emplace_back(p, mtime(p));
+    }
+    return result;
+}
+
+bool StartupCache::valid(const Stamps& stamps) const {
+    for (const auto& s : stamps) {
+        long long t = mtime(s.first);
+        // A path modified in the second the cache was written may have changed after it was read
+        if (t != s.second || t >= written_) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void StartupCache::load() {
+    if (loaded_) {
+        return;
+    }
+    loaded_ = true;
+
+    std::ifstream in(path_.c_str());
+    if (!in) {
+        return;
+    }
+
+    try {
+        Value v = JSONParser(in).parse();
+        if (long(v["version"]) != version) {
+            return;
+        }
+
+        written_ = (long long)(v["written"]);
+
+        Value scan = v["manifests"]["scan"];
+        for (size_t i = 0; i < scan.size(); ++i) {
+            scanPaths_.push_back(scan[i]);
+        }
+        manifestStamps_ = read(v["manifests"]["stamps"]);
+        Value plugins   = v["manifests"]["plugins"];
+        for (size_t i = 0; i < plugins.size(); ++i) {
+            manifests_.push_back({plugins[i][0], plugins[i][1], plugins[i][2]});
+        }
+
+        libraryStamps_ = read(v["libraries"]["stamps"]);
+        Value libs     = v["libraries"]["paths"];
+        Value names    = libs.keys();
+        for (size_t i = 0; i < names.size(); ++i) {
+            libraries_[names[i]] = std::string(libs[names[i]]);
+        }
+    }
+    catch (Exception& e) {
+        // A damaged cache is rebuilt
+        Log::debug() << "Ignoring startup cache " << path_ << ": " << e.what() << std::endl;
+        scanPaths_.clear();
+        manifestStamps_.clear();
+        manifests_.clear();
+        libraryStamps_.clear();
+        libraries_.clear();
+    }
+}
+
+bool StartupCache::manifests(const std::vector<std::string>& scanPaths, std::vector<Manifest>& result) {
+    if (!enabled()) {
+        return false;
+    }
+
+    AutoLock<Mutex> lock(mutex_);
+    load();
+
+    if (scanPaths != scanPaths_ || !valid(manifestStamps_)) {
+        return false;
+    }
+
+    result = manifests_;
+    return true;
+}
+
+void StartupCache::manifests(const std::vector<std::string>& scanPaths, const std::vector<std::string>& files,
+                             const std::vector<Manifest>& result) {
+    if (!enabled()) {
+        return;
+    }
+
+    AutoLock<Mutex> lock(mutex_);
+    load();
+
+    scanPaths_      = scanPaths;
+    manifestStamps_ = stamps(scanPaths);
+    for (const auto& s : stamps(files)) {
+        manifestStamps_.push_back(s);
+    }
+    manifests_ = result;
+    dirty_     = true;
+}
+
+bool StartupCache::library(const std::string& name, const std::vector<std::string>& searchPaths,
+                           std::string& result) {
+    if (!enabled()) {
+        return false;
+    }
+
+    AutoLock<Mutex> lock(mutex_);
+    load();
+
+    auto j = libraries_.find(name);
+    if (j == libraries_.end() || libraryStamps_.size() != searchPaths.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < searchPaths.size(); ++i) {
+        if (libraryStamps_[i].first != searchPaths[i]) {
+            return false;
+        }
+    }
+
+    if (!valid(libraryStamps_)) {
+        libraries_.clear();
+        return false;
+    }
+
+    result = j->second;
+    return true;
+}
+
+void StartupCache::library(const std::string& name, const std::vector<std::string>& searchPaths,
+                           const std::string& result) {
+    if (!enabled()) {
+        return;
+    }
+
+    AutoLock<Mutex> lock(mutex_);
+    load();
+
+    Stamps s = stamps(searchPaths);
+    if (s != libraryStamps_) {
+        libraries_.clear();
+        libraryStamps_ = s;
+    }
+
+    libraries_[name] = result;
+    dirty_           = true;
+}
+
+void StartupCache::save() {
+    if (!enabled()) {
+        return;
+    }
+
+    AutoLock<Mutex> lock(mutex_);
+    if (!dirty_) {
+        return;
+    }
+    dirty_ = false;
+
+    // Written aside and renamed, readers see either the old or the new cache
+    std::ostringstream tmp;
+    tmp << path_ << "." << ::getpid() << ".tmp";
+
+    {
+        std::ofstream out(tmp.str().c_str());
+        if (!out) {
+            Log::debug() << "Cannot write startup cache " << tmp.str() << std::endl;
+            return;
+        }
+
+        JSON json(out);
+        json.startObject();
+        json << "version" << version;
+        json << "written" << (long long)(::time(nullptr));
+
+        json << "manifests";
+        json.startObject();
+        json << "scan" << scanPaths_;
+        json << "stamps";
+        write(json, manifestStamps_);
+        json << "plugins";
+        json.startList();
+        for (const auto& m : manifests_) {
+            json.startList();
+            json << m.name << m.namespce << m.library;
+            json.endList();
+        }
+        json.endList();
+        json.endObject();
+
+        json << "libraries";
+        json.startObject();
+        json << "stamps";
+        write(json, libraryStamps_);
+        json << "paths";
+        json.startObject();
+        for (const auto& l : libraries_) {
+            json << l.first << l.second;
+        }
+        json.endObject();
+        json.endObject();
+
+        json.endObject();
+    }
+
+    if (::rename(tmp.str().c_str(), path_.c_str()) != 0) {
+        Log::debug() << "Cannot rename " << tmp.str() << " to " << path_ << Log::syserr << std::endl;
+        ::unlink(tmp.str().c_str());
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::system
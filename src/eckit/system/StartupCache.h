@@ -0,0 +1,97 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   StartupCache.h
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "eckit/memory/NonCopyable.h"
+#include "eckit/thread/Mutex.h"
+
+namespace eckit::system {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Opt-in on-disk cache of what LibraryManager discovers at startup: the plugin manifests found in the scan paths, and
+/// the paths where dynamic libraries were found. Enabled by setting the resource startupCache ($ECKIT_STARTUP_CACHE)
+/// to a file path.
+///
+/// Entries are validated by the modification times of the directories they were read from (and of the manifests
+/// themselves), so that adding, removing or editing a manifest or a library invalidates them. The file is replaced
+/// atomically, and can be shared by concurrent processes using the same scan paths.
+
+class StartupCache : private NonCopyable {
+public:  // types
+    struct Manifest {
+        std::string name;
+        std::string namespce;
+        std::string library;
+    };
+
+public:  // methods
+    /// The cache of the process, as configured by startupCache
+    static StartupCache& instance();
+
+    explicit StartupCache(const std::string& path);
+
+    bool enabled() const { return !path_.empty(); }
+
+    /// @returns true and the manifests found by the previous scan of these paths, if none of them changed
+    bool manifests(const std::vector<std::string>& scanPaths, std::vector<Manifest>& result);
+
+    /// Records the manifests found in the scan paths, read from the given files
+    void manifests(const std::vector<std::string>& scanPaths, const std::vector<std::string>& files,
+                   const std::vector<Manifest>& result);
+
+    /// @returns true and the path where the library was found (empty for the system search path), if none of the
+    ///          search paths changed since
+    bool library(const std::string& name, const std::vector<std::string>& searchPaths, std::string& result);
+
+    void library(const std::string& name, const std::vector<std::string>& searchPaths, const std::string& result);
+
+    /// Writes the cache if it was updated
+    void save();
+
+private:  // types
+    /// Modification times of paths, -1 for missing paths
+    typedef std::vector<std::pair<std::string, long long>> Stamps;
+
+private:  // methods
+    void load();
+    bool valid(const Stamps&) const;
+
+    static long long mtime(const std::string& path);
+    static Stamps stamps(const std::vector<std::string>& paths);
+
+private:  // members
+    Mutex mutex_;
+    std::string path_;
+
+    bool loaded_ = false;
+    bool dirty_  = false;
+
+    /// Time at which the cache was written: paths modified in that second are not trusted
+    long long written_ = 0;
+
+    std::vector<std::string> scanPaths_;
+    Stamps manifestStamps_;  ///< Scan paths and the manifests read from them
+    std::vector<Manifest> manifests_;
+
+    Stamps libraryStamps_;
+    std::map<std::string, std::string> libraries_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::system
@@ -49,6 +49,9 @@ public:
 
     T& instance();
 
+    /// @returns the instance of the calling thread, nullptr if it has not created one yet
+    T* find();
+
 private:  // members
     A alloc_;
 
@@ -100,6 +103,12 @@ T& ThreadSingleton<T, A>::instance() {
     return *value;
 }
 
+template <typename T, typename A>
+T* ThreadSingleton<T, A>::find() {
+    ::pthread_once(&once_, init);
+    return (T*)::pthread_getspecific(key_);
+}
+
 template <typename T, typename A>
 void ThreadSingleton<T, A>::cleanUp(void* data) {
     delete (T*)data;
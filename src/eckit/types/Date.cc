@@ -8,7 +8,10 @@
  * does it submit to any jurisdiction.
  */
 
+#include <cctype>
+#include <charconv>
 #include <iomanip>
+#include <string_view>
 
 #include "eckit/eckit.h"
 
@@ -61,17 +64,39 @@ Date::Date(long year, long dayOfYear) {
     ASSERT(this->year() == year);
 }
 
-long Date::parse(const std::string& s) {
-    Tokenizer parse("-");
-    std::vector<std::string> result;
+// atol() of a token, which is not null-terminated
+static long toLong(std::string_view s) {
+    size_t i = 0;
+    while (i < s.size() && isspace(s[i])) {
+        i++;
+    }
+    if (i < s.size() && s[i] == '+') {
+        i++;
+    }
+
+    long value = 0;
+    std::from_chars(s.data() + i, s.data() + s.size(), value);
+    return value;
+}
 
-    parse(s, result);
+long Date::parse(const std::string& s) {
+    static const Tokenizer parse("-");
+
+    // At most three tokens are valid, more is an error
+    std::string_view result[4];
+    size_t count = 0;
+    for (std::string_view token : parse.tokens(s)) {
+        result[count++] = token;
+        if (count == 4) {
+            break;
+        }
+    }
 
     bool err   = false;
     long value = 0;
     int i;
 
-    switch (result.size()) {
+    switch (count) {
         case 1:
             switch (s.length()) {
                 case 3:
@@ -102,8 +127,8 @@ long Date::parse(const std::string& s) {
 
             // Dates as mm-dd
             if (result[0].length() == 2 && result[1].length() == 2) {
-                long month = atol(result[0].c_str());
-                long day   = atol(result[1].c_str());
+                long month = toLong(result[0]);
+                long day   = toLong(result[1]);
 
                 Date date(2004, month, day);  // 2004 is a leap year
 
@@ -121,8 +146,8 @@ long Date::parse(const std::string& s) {
                 }
 
                 {
-                    long year = atol(result[0].c_str());
-                    long day  = atol(result[1].c_str());
+                    long year = toLong(result[0]);
+                    long day  = toLong(result[1]);
 
                     Date date(year, 1, 1);
                     date += day - 1;
@@ -146,7 +171,7 @@ long Date::parse(const std::string& s) {
                 err = true;
             }
 
-            value = atol(result[0].c_str()) * 10000 + atol(result[1].c_str()) * 100 + atol(result[2].c_str());
+            value = toLong(result[0]) * 10000 + toLong(result[1]) * 100 + toLong(result[2]);
 
             break;
 
@@ -16,6 +16,7 @@
 #include "eckit/config/Resource.h"
 #include "eckit/exception/Exceptions.h"
 #include "eckit/io/Buffer.h"
+#include "eckit/system/DeferredPlugins.h"
 #include "eckit/thread/AutoLock.h"
 #include "eckit/utils/StringTools.h"
 
@@ -78,6 +79,11 @@ Compressor* CompressorFactory::build() {
 Compressor* CompressorFactory::build(const std::string& name) {
     std::string nameLowercase = StringTools::lower(name);
 
+    // The builder may come from a plugin not loaded yet
+    if (!has(nameLowercase)) {
+        system::loadPluginsForMissingBuilder();
+    }
+
     AutoLock<Mutex> lock(mutex_);
 
     auto j = builders_.find(nameLowercase);
@@ -14,6 +14,7 @@
 
 #include "eckit/config/Resource.h"
 #include "eckit/exception/Exceptions.h"
+#include "eckit/system/DeferredPlugins.h"
 #include "eckit/thread/AutoLock.h"
 #include "eckit/thread/Mutex.h"
 #include "eckit/utils/StringTools.h"
@@ -76,6 +77,11 @@ Hash* HashFactory::build() {
 Hash* HashFactory::build(const std::string& name) {
     std::string nameLowercase = StringTools::lower(name);
 
+    // The builder may come from a plugin not loaded yet
+    if (!has(nameLowercase)) {
+        system::loadPluginsForMissingBuilder();
+    }
+
     AutoLock<Mutex> lock(mutex_);
     auto j = builders_.find(nameLowercase);
 
@@ -96,6 +102,11 @@ Hash* HashFactory::build(const std::string& name) {
 Hash* HashFactory::build(const std::string& name, const std::string& param) {
     std::string nameLowercase = StringTools::lower(name);
 
+    // The builder may come from a plugin not loaded yet
+    if (!has(nameLowercase)) {
+        system::loadPluginsForMissingBuilder();
+    }
+
     AutoLock<Mutex> lock(mutex_);
     auto j = builders_.find(nameLowercase);
 
@@ -9,16 +9,27 @@
  */
 
 #include <librsync.h>
+
+#include <algorithm>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "eckit/config/LibEcKit.h"
+#include "eckit/config/Resource.h"
 #include "eckit/exception/Exceptions.h"
 #include "eckit/filesystem/PathName.h"
 #include "eckit/filesystem/TmpFile.h"
 #include "eckit/io/Buffer.h"
 #include "eckit/io/DataHandle.h"
+#include "eckit/io/MemoryHandle.h"
 #include "eckit/io/StdFile.h"
 #include "eckit/log/Log.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/MutexCond.h"
+#include "eckit/utils/Hash.h"
 #include "eckit/utils/Tokenizer.h"
 
 #include "eckit/utils/Rsync.h"
@@ -29,7 +40,7 @@ static void handle_rs_error(rs_result res, const char* call, const char* file, i
     if (res == RS_DONE)
         return;
 
-    throw new FailedLibraryCall("librsync", call, rs_strerror(res), CodeLocation(file, line, func));
+    throw FailedLibraryCall("librsync", call, rs_strerror(res), CodeLocation(file, line, func));
 }
 
 #define RSCALL(a) handle_rs_error(a, #a, __FILE__, __LINE__, __func__)
@@ -141,8 +152,11 @@ static void runStreamedJob(rs_job_t* job, DataHandle* input, size_t ibuf_size, D
     handle_with_buffer ohwb = {output, &obuf};
 
     rs_buffers_t buf;
-    RSCALL(rs_job_drive(job, &buf, input ? fillInputBuffer : nullptr, input ? static_cast<void*>(&ihwb) : nullptr,
-                        output ? drainOutputBuffer : nullptr, output ? static_cast<void*>(&ohwb) : nullptr));
+    rs_result res = rs_job_drive(job, &buf, input ? fillInputBuffer : nullptr,
+                                 input ? static_cast<void*>(&ihwb) : nullptr, output ? drainOutputBuffer : nullptr,
+                                 output ? static_cast<void*>(&ohwb) : nullptr);
+    rs_job_free(job);
+    RSCALL(res);
 }
 
 
@@ -174,10 +188,195 @@ private:
 };
 
 Rsync::Rsync(bool statistics) :
-    block_len_(RS_DEFAULT_BLOCK_LEN), strong_len_(0), statistics_(statistics) {}
+    block_len_(RS_DEFAULT_BLOCK_LEN),
+    strong_len_(0),
+    statistics_(statistics),
+    threads_(Resource<size_t>("rsyncThreads;$ECKIT_RSYNC_THREADS", 4)),
+    chunkSize_(Resource<size_t>("rsyncChunkSize;$ECKIT_RSYNC_CHUNK_SIZE", 64 * 1024 * 1024)),
+    strongSum_(Resource<std::string>("rsyncStrongSum;$ECKIT_RSYNC_STRONG_SUM", "blake2")),
+    compareHash_(Resource<std::string>("rsyncCompareHash;$ECKIT_RSYNC_COMPARE_HASH", "")) {
+    threads(threads_);
+    chunkSize(chunkSize_);
+    strongSum(strongSum_);
+}
 
 Rsync::~Rsync() {}
 
+void Rsync::threads(size_t n) {
+    threads_ = std::max(n, size_t(1));
+}
+
+void Rsync::chunkSize(size_t size) {
+    // Chunks of whole blocks, so that their signatures add up to that of the file
+    chunkSize_ = std::max((size + block_len_ - 1) / block_len_, size_t(1)) * block_len_;
+}
+
+void Rsync::strongSum(const std::string& name) {
+    if (name != "blake2" && name != "md4") {
+        throw UserError("eckit::Rsync: unknown strong sum '" + name + "', expected 'blake2' or 'md4'", Here());
+    }
+    strongSum_ = name;
+}
+
+void Rsync::compareHash(const std::string& name) {
+    if (!name.empty() && !HashFactory::instance().has(name)) {
+        throw UserError("eckit::Rsync: unknown hash '" + name + "'", Here());
+    }
+    compareHash_ = name;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/// Runs task(i, worker) for i in [0, count) on up to threads threads
+void parallelFor(size_t count, size_t threads, const std::function<void(size_t, size_t)>& task) {
+    MutexCond cond;
+    size_t next = 0;
+    std::exception_ptr error;
+
+    auto work = [&](size_t worker) {
+        for (;;) {
+            size_t i;
+            {
+                AutoLock<MutexCond> lock(cond);
+                if (next >= count || error) {
+                    return;
+                }
+                i = next++;
+            }
+            try {
+                task(i, worker);
+            }
+            catch (...) {
+                AutoLock<MutexCond> lock(cond);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t w = 1; w < std::min(threads, count); ++w) {
+        pool.emplace_back(work, w);
+    }
+    work(0);
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/// Computes the parts of a stream into memory with part(i, worker, output) on up to threads threads, and gives them
+/// in order to write(i, data, size), from the calling thread. At most threads parts, of an expected size, are held in
+/// memory.
+void parallelParts(size_t count, size_t threads, size_t expected,
+                   const std::function<void(size_t, size_t, DataHandle&)>& part,
+                   const std::function<void(size_t, const char*, size_t)>& write) {
+    MutexCond cond;
+    std::vector<std::unique_ptr<MemoryHandle>> done(count);
+    size_t next    = 0;
+    size_t written = 0;
+    std::exception_ptr error;
+
+    auto work = [&](size_t worker) {
+        for (;;) {
+            size_t i;
+            {
+                AutoLock<MutexCond> lock(cond);
+                while (next < count && next >= written + threads && !error) {
+                    cond.wait();
+                }
+                if (next >= count || error) {
+                    return;
+                }
+                i = next++;
+            }
+            try {
+                std::unique_ptr<MemoryHandle> out(new MemoryHandle(expected));
+                out->openForWrite(0);
+                part(i, worker, *out);
+                out->close();
+
+                AutoLock<MutexCond> lock(cond);
+                done[i] = std::move(out);
+                cond.broadcast();
+            }
+            catch (...) {
+                AutoLock<MutexCond> lock(cond);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                cond.broadcast();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t w = 0; w < std::min(threads, count); ++w) {
+        pool.emplace_back(work, w);
+    }
+
+    try {
+        for (size_t i = 0; i < count; ++i) {
+            std::unique_ptr<MemoryHandle> out;
+            {
+                AutoLock<MutexCond> lock(cond);
+                while (!done[i] && !error) {
+                    cond.wait();
+                }
+                if (error) {
+                    break;
+                }
+                out = std::move(done[i]);
+            }
+
+            write(i, static_cast<const char*>(out->data()), size_t(out->size()));
+
+            AutoLock<MutexCond> lock(cond);
+            written++;
+            cond.broadcast();
+        }
+    }
+    catch (...) {
+        AutoLock<MutexCond> lock(cond);
+        if (!error) {
+            error = std::current_exception();
+        }
+        cond.broadcast();
+    }
+
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Signatures start with the magic number, the block length and the strong sum length, then have the sums of each
+// block. Deltas start with their magic number and end with RS_OP_END, with commands copying from absolute offsets
+// in the basis file in between.
+constexpr size_t signatureHeader = 12;
+constexpr size_t deltaHeader     = 4;
+constexpr size_t deltaTrailer    = 1;
+constexpr char deltaEnd          = 0;  // RS_OP_END
+
+void writeAll(DataHandle& output, const char* data, size_t size) {
+    if (size > 0 && output.write(data, long(size)) != long(size)) {
+        throw WriteError("eckit::Rsync: short write to " + output.title(), Here());
+    }
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
 void logStats(const rs_stats_t* stats, std::ostream& os) {
     char buffer[256];
     rs_format_stats(stats, buffer, sizeof(buffer) - 1);
@@ -193,27 +392,43 @@ void Rsync::syncData(const PathName& source, const PathName& target) {
                                << ")" << std::endl;
 
     rs_stats_t stats;
+    std::ostream& log = statistics_ ? Log::info() : Log::debug<LibEcKit>();
 
     target.touch();
     TmpFile signature(false);
     Log::debug<LibEcKit>() << "Rsync::syncData using signature file " << signature << std::endl;
-    {
+    if (size_t(target.size()) > chunkSize_) {
+        std::unique_ptr<DataHandle> sig(signature.fileHandle(true));
+        sig->openForWrite(0);
+        AutoClose closer(*sig);
+        computeSignature(target, *sig);
+        log << "Signature of " << target << " in chunks of " << chunkSize_ << " bytes" << std::endl;
+    }
+    else {
         AutoStdFile tgt(target);
         AutoStdFile sig(signature, "w");
-        RSCALL(rs_sig_file(tgt, sig, block_len_, strong_len_, RS_RK_BLAKE2_SIG_MAGIC, &stats));
+        RSCALL(rs_sig_file(tgt, sig, block_len_, strong_len_,
+                           strongSum_ == "md4" ? RS_RK_MD4_SIG_MAGIC : RS_RK_BLAKE2_SIG_MAGIC, &stats));
+        logStats(&stats, log);
     }
-    logStats(&stats, statistics_ ? Log::info() : Log::debug<LibEcKit>());
 
     TmpFile delta(false);
     Log::debug<LibEcKit>() << "Rsync::syncData using delta file " << delta << std::endl;
-    {
+    if (source.exists() && size_t(source.size()) > chunkSize_) {
+        std::unique_ptr<DataHandle> dlt(delta.fileHandle(true));
+        dlt->openForWrite(0);
+        AutoClose closer(*dlt);
+        computeDelta(signature, source, *dlt);
+        log << "Delta of " << source << " in chunks of " << chunkSize_ << " bytes" << std::endl;
+    }
+    else {
         Signature sig(signature);
 
         AutoStdFile src(source);
         AutoStdFile dlt(delta, "w");
         RSCALL(rs_delta_file(sig, src, dlt, &stats));
+        logStats(&stats, log);
     }
-    logStats(&stats, statistics_ ? Log::info() : Log::debug<LibEcKit>());
 
     PathName patched = PathName::unique(target);
     Log::debug<LibEcKit>() << "Rsync::syncData using temporary output file " << patched << std::endl;
@@ -223,7 +438,7 @@ void Rsync::syncData(const PathName& source, const PathName& target) {
         AutoStdFile patch(patched, "w");
         RSCALL(rs_patch_file(tgt, dlt, patch, &stats));
     }
-    logStats(&stats, statistics_ ? Log::info() : Log::debug<LibEcKit>());
+    logStats(&stats, log);
     PathName::rename(patched, target);
 }
 
@@ -258,7 +473,7 @@ void Rsync::syncRecursive(const PathName& source, const PathName& target) {
 
     std::vector<PathName> files;
     std::vector<PathName> dirs;
-    source.childrenRecursive(files, dirs);
+    source.childrenRecursive(files, dirs, threads_);
 
     for (const auto& dir : dirs) {
         PathName rebased = rebasePath(dir, source, target);
@@ -266,12 +481,7 @@ void Rsync::syncRecursive(const PathName& source, const PathName& target) {
         rebased.mkdir();
     }
 
-    for (const auto& file : files) {
-        if (file.isLink()) {
-            Log::warning() << "eckit::Rsync: skipping " << file << ", which is a symbolic link" << std::endl;
-            continue;
-        }
-
+    auto sync = [this, &source, &target](const PathName& file) {
         PathName rebased = rebasePath(file, source, target);
 
         if (!rebased.exists()) {
@@ -279,16 +489,35 @@ void Rsync::syncRecursive(const PathName& source, const PathName& target) {
             std::unique_ptr<DataHandle> in(file.fileHandle());
             std::unique_ptr<DataHandle> out(rebased.fileHandle(true));
             in->saveInto(*out);
-            continue;
+            return;
         }
 
         if (!shouldUpdate(file, rebased)) {
             Log::debug<LibEcKit>() << "eckit::Rsync: skipping " << file << " due to file size / date" << std::endl;
-            continue;
+            return;
         }
 
         Log::debug<LibEcKit>() << "Syncing " << file << " -> " << rebased << std::endl;
         syncData(file, rebased);
+    };
+
+    // Large files use all the threads by themselves
+    std::vector<PathName> small;
+    std::vector<PathName> large;
+
+    for (const auto& file : files) {
+        if (file.isLink()) {
+            Log::warning() << "eckit::Rsync: skipping " << file << ", which is a symbolic link" << std::endl;
+            continue;
+        }
+
+        (size_t(file.size()) > chunkSize_ ? large : small).push_back(file);
+    }
+
+    parallelFor(small.size(), threads_, [&](size_t i, size_t) { sync(small[i]); });
+
+    for (const auto& file : large) {
+        sync(file);
     }
 }
 
@@ -300,13 +529,14 @@ bool Rsync::shouldUpdate(const PathName& source, const PathName& target) {
         return true;
 
     if (source.lastModified() > target.lastModified())
-        return true;
+        return compareHash_.empty() || source.hash(compareHash_) != target.hash(compareHash_);
 
     return false;
 }
 
 void Rsync::computeSignature(DataHandle& input, DataHandle& output) {
-    rs_job_t* job = rs_sig_begin(block_len_, strong_len_, RS_RK_BLAKE2_SIG_MAGIC);
+    rs_job_t* job = rs_sig_begin(block_len_, strong_len_,
+                                 strongSum_ == "md4" ? RS_RK_MD4_SIG_MAGIC : RS_RK_BLAKE2_SIG_MAGIC);
     runStreamedJob(job, &input, 4 * block_len_, &output, 12 + 4 * (4 + strong_len_));
 }
 
@@ -316,6 +546,63 @@ void Rsync::computeDelta(DataHandle& signature, DataHandle& input, DataHandle& o
     runStreamedJob(job, &input, block_len_, &output, 10 + 4 * block_len_);
 }
 
+void Rsync::computeSignature(const PathName& input, DataHandle& output) {
+    size_t size  = size_t(input.size());
+    size_t count = std::max((size + chunkSize_ - 1) / chunkSize_, size_t(1));
+
+    // The sums of each block, and a header
+    size_t expected = chunkSize_ / block_len_ * (4 + 32) + signatureHeader;
+
+    parallelParts(
+        count, threads_, expected,
+        [&](size_t i, size_t, DataHandle& out) {
+            size_t offset = i * chunkSize_;
+            std::unique_ptr<DataHandle> in(input.partHandle(offset, std::min(chunkSize_, size - offset)));
+            in->openForRead();
+            AutoClose closer(*in);
+            computeSignature(*in, out);
+        },
+        [&](size_t i, const char* data, size_t length) {
+            // The same header for all the chunks
+            size_t skip = i == 0 ? 0 : signatureHeader;
+            ASSERT(length >= skip);
+            writeAll(output, data + skip, length - skip);
+        });
+}
+
+void Rsync::computeDelta(const PathName& signature, const PathName& input, DataHandle& output) {
+    size_t size  = size_t(input.size());
+    size_t count = std::max((size + chunkSize_ - 1) / chunkSize_, size_t(1));
+
+    // The lookups in a signature are not thread-safe, each thread loads its own
+    std::vector<std::unique_ptr<Signature>> signatures(std::min(threads_, count));
+
+    // At worst the whole chunk as literal data, with the commands
+    size_t expected = chunkSize_ + chunkSize_ / 64 + 1024 * 1024;
+
+    parallelParts(
+        count, threads_, expected,
+        [&](size_t i, size_t worker, DataHandle& out) {
+            if (!signatures[worker]) {
+                signatures[worker].reset(new Signature(signature));
+            }
+            rs_job_t* job = rs_delta_begin(*signatures[worker]);
+
+            size_t offset = i * chunkSize_;
+            std::unique_ptr<DataHandle> in(input.partHandle(offset, std::min(chunkSize_, size - offset)));
+            in->openForRead();
+            AutoClose closer(*in);
+            runStreamedJob(job, in.get(), block_len_, &out, 10 + 4 * block_len_);
+        },
+        [&](size_t i, const char* data, size_t length) {
+            // The commands of the chunks, between the header of the first and the end of the last
+            size_t skip = i == 0 ? 0 : deltaHeader;
+            size_t drop = i == count - 1 ? 0 : deltaTrailer;
+            ASSERT(length >= skip + drop);
+            ASSERT(drop == 0 || data[length - 1] == deltaEnd);
+            writeAll(output, data + skip, length - skip - drop);
+        });
+}
 
 static rs_result readDataHandle(void* opaque, rs_long_t pos, size_t* len, void** buf) {
     try {
@@ -11,11 +11,22 @@
 #ifndef eckit_utils_Rsync_H
 #define eckit_utils_Rsync_H
 
+#include <cstddef>
+#include <string>
+
 namespace eckit {
 
 class DataHandle;
 class PathName;
 
+/// Synchronises files and trees with librsync.
+///
+/// Files larger than chunkSize() are processed in chunks on threads() threads: the signature of each chunk of the
+/// target, which is the same as that of the whole file, and the delta of each chunk of the source against the whole
+/// target, which only misses the matches across chunks. In a tree, smaller files are synchronised concurrently, one
+/// per thread, and larger files one after the other, each with all the threads. The defaults are from the resources
+/// rsyncThreads (4), rsyncChunkSize (64 MiB), rsyncStrongSum ("blake2", or "md4") and rsyncCompareHash (none).
+
 class Rsync {
 
 public:  // methods
@@ -23,6 +34,17 @@ public:  // methods
 
     ~Rsync();
 
+    /// Before synchronising
+    void threads(size_t);
+    void chunkSize(size_t);
+
+    /// Strong sum of the signatures, "blake2" or "md4"
+    void strongSum(const std::string&);
+
+    /// Hash, from the HashFactory, telling apart files of the same size, where the source is more recent, before
+    /// synchronising them; none if empty
+    void compareHash(const std::string&);
+
     void syncData(const PathName& source, const PathName& target);
     void syncRecursive(const PathName& source, const PathName& target);
 
@@ -32,11 +54,20 @@ public:  // methods
     void computeDelta(DataHandle& signature, DataHandle& input, DataHandle& output);
     void updateData(DataHandle& input, DataHandle& delta, DataHandle& output);
 
+    /// As above, by chunks of the input on several threads
+    void computeSignature(const PathName& input, DataHandle& output);
+    void computeDelta(const PathName& signature, const PathName& input, DataHandle& output);
+
 private:  // members
     size_t block_len_;
     size_t strong_len_;
 
     bool statistics_;
+
+    size_t threads_;
+    size_t chunkSize_;
+    std::string strongSum_;
+    std::string compareHash_;
 };
 
 }  // end namespace eckit
@@ -18,30 +18,9 @@ namespace eckit {
 //----------------------------------------------------------------------------------------------------------------------
 
 template <class Container>
-void tokenizeInsert(const std::set<char, std::less<char> >& separator, const std::string& raw,
-                    std::insert_iterator<Container> ins, bool keepEmpty) {
-    int index         = 0;
-    int length        = raw.length();
-    std::string token = "";
-
-    while (index < length) {
-        char c = raw[index];
-
-        if (separator.find(c) != separator.end()) {
-            if (token.length() > 0 || keepEmpty) {
-                ins = token;
-            }
-            token = "";
-        }
-        else {
-            token += c;
-        }
-
-        index++;
-    }
-
-    if (token.length() > 0 || keepEmpty) {
-        ins = token;
+void tokenizeInsert(const Tokenizer& tokenizer, std::string_view raw, std::insert_iterator<Container> ins) {
+    for (std::string_view token : tokenizer.tokens(raw)) {
+        ins = std::string(token);
     }
 }
 
@@ -50,20 +29,26 @@ void tokenizeInsert(const std::set<char, std::less<char> >& separator, const std
 
 Tokenizer::Tokenizer(char c, bool keepEmpty) :
     keepEmpty_(keepEmpty) {
-    separator_.insert(c);
+    separator_.set(static_cast<unsigned char>(c));
 }
 
 Tokenizer::Tokenizer(const std::string& separators, bool keepEmpty) :
     keepEmpty_(keepEmpty) {
     for (std::string::size_type i = 0; i < separators.length(); i++) {
-        separator_.insert(separators[i]);
+        separator_.set(static_cast<unsigned char>(separators[i]));
     }
 }
 
 Tokenizer::~Tokenizer() {}
 
 void Tokenizer::operator()(const std::string& raw, std::vector<std::string>& v) const {
-    tokenizeInsert(separator_, raw, std::inserter(v, v.end()), keepEmpty_);
+    tokenizeInsert(*this, raw, std::inserter(v, v.end()));
+}
+
+void Tokenizer::operator()(std::string_view raw, std::vector<std::string_view>& v) const {
+    for (std::string_view token : tokens(raw)) {
+        v.push_back(token);
+    }
 }
 
 void Tokenizer::operator()(std::istream& in, std::vector<std::string>& v) const {
@@ -74,11 +59,11 @@ void Tokenizer::operator()(std::istream& in, std::vector<std::string>& v) const
         raw += c;
     }
 
-    tokenizeInsert(separator_, raw, std::inserter(v, v.end()), keepEmpty_);
+    tokenizeInsert(*this, raw, std::inserter(v, v.end()));
 }
 
 void Tokenizer::operator()(const std::string& raw, std::set<std::string>& s) const {
-    tokenizeInsert(separator_, raw, std::inserter(s, s.end()), keepEmpty_);
+    tokenizeInsert(*this, raw, std::inserter(s, s.end()));
 }
 
 void Tokenizer::operator()(std::istream& in, std::set<std::string>& s) const {
@@ -89,7 +74,7 @@ void Tokenizer::operator()(std::istream& in, std::set<std::string>& s) const {
         raw += c;
     }
 
-    tokenizeInsert(separator_, raw, std::inserter(s, s.end()), keepEmpty_);
+    tokenizeInsert(*this, raw, std::inserter(s, s.end()));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -15,8 +15,12 @@
 #ifndef eckit_Tokenizer_h
 #define eckit_Tokenizer_h
 
+#include <bitset>
+#include <cstddef>
+#include <iterator>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "eckit/memory/NonCopyable.h"
@@ -27,6 +31,9 @@ namespace eckit {
 
 class Tokenizer : private NonCopyable {
 
+public:  // types
+    class Tokens;
+
 public:  // methods
     Tokenizer(char, bool keepEmpty = false);
     Tokenizer(const std::string&, bool keepEmpty = false);
@@ -42,6 +49,14 @@ public:  // methods
     std::vector<std::string> tokenize(const std::string&) const;
     std::vector<std::string> tokenize(std::istream&) const;
 
+    /// Splits without copying: the tokens are views of the input, valid as long as it is
+    void operator()(std::string_view, std::vector<std::string_view>&) const;
+
+    /// The tokens of a string, as views of it, found as the range is iterated:
+    ///     for (std::string_view token : tokenizer.tokens(s)) { ... }
+    /// The range refers to this Tokenizer, which must outlive it
+    Tokens tokens(std::string_view) const;
+
     /**
      * Splits the given the string on the first instance of the separator.
      *
@@ -52,7 +67,7 @@ public:  // methods
     static std::vector<std::string> split_at(const std::string& s, char separator);
 
 private:
-    std::set<char, std::less<char> > separator_;  // To make searching faster
+    std::bitset<256> separator_;  // Indexed by unsigned char
     bool keepEmpty_;
 
 private:
@@ -66,6 +81,89 @@ private:
 
 //---------------------------------------------------------------------------------------------------------------------
 
+class Tokenizer::Tokens {
+public:  // types
+    class iterator {
+    public:  // types
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = std::string_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const std::string_view*;
+        using reference         = const std::string_view&;
+
+    public:  // methods
+        iterator() = default;
+
+        reference operator*() const { return token_; }
+        pointer operator->() const { return &token_; }
+
+        iterator& operator++() {
+            next();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator i = *this;
+            next();
+            return i;
+        }
+
+        bool operator==(const iterator& other) const {
+            return end_ == other.end_ && (end_ || token_.data() == other.token_.data());
+        }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:  // methods
+        friend class Tokens;
+
+        iterator(const Tokenizer& tokenizer, std::string_view s) :
+            tokenizer_(&tokenizer), string_(s), next_(0), end_(false) {
+            next();
+        }
+
+        void next() {
+            while (next_ != std::string_view::npos) {
+                size_t start = next_;
+                size_t stop  = start;
+                while (stop < string_.size() && !tokenizer_->separator_[static_cast<unsigned char>(string_[stop])]) {
+                    ++stop;
+                }
+                next_ = stop < string_.size() ? stop + 1 : std::string_view::npos;
+
+                if (stop > start || tokenizer_->keepEmpty_) {
+                    token_ = string_.substr(start, stop - start);
+                    return;
+                }
+            }
+            end_ = true;
+        }
+
+    private:  // members
+        const Tokenizer* tokenizer_ = nullptr;
+        std::string_view string_;
+        std::string_view token_;
+        size_t next_ = std::string_view::npos;  // Start of the next token
+        bool end_    = true;
+    };
+
+public:  // methods
+    Tokens(const Tokenizer& tokenizer, std::string_view s) :
+        tokenizer_(tokenizer), string_(s) {}
+
+    iterator begin() const { return iterator(tokenizer_, string_); }
+    iterator end() const { return iterator(); }
+
+private:  // members
+    const Tokenizer& tokenizer_;
+    std::string_view string_;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+inline Tokenizer::Tokens Tokenizer::tokens(std::string_view s) const {
+    return Tokens(*this, s);
+}
+
 inline std::vector<std::string> Tokenizer::tokenize(const std::string& s) const {
     std::vector<std::string> r;
     this->operator()(s, r);
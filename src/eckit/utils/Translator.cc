@@ -8,6 +8,9 @@
  * does it submit to any jurisdiction.
  */
 
+#include <cerrno>
+#include <charconv>
+#include <cmath>
 #include <cstdlib>
 
 #include "eckit/exception/Exceptions.h"
@@ -19,14 +22,14 @@ namespace eckit {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-static unsigned long long multiplier(const char* p) {
-    while (isspace(*p)) {
+static unsigned long long multiplier(const char* p, const char* end) {
+    while (p != end && isspace(*p)) {
         p++;
     }
 
-    if (*p && *(p + 1)) {
+    if (end - p >= 2) {
         // cater for GB or GiB (SI units)
-        if (towlower(*(p + 1)) == 'b' || (towlower(*(p + 1)) == 'i' && towlower(*(p + 2)) == 'b')) {
+        if (towlower(*(p + 1)) == 'b' || (end - p >= 3 && towlower(*(p + 1)) == 'i' && towlower(*(p + 2)) == 'b')) {
             switch (towlower(*p)) {
                 case 'k':
                     return (1LL << 10);
@@ -49,6 +52,86 @@ static unsigned long long multiplier(const char* p) {
     return 1;
 }
 
+// Parses the leading integer of s as strtol() and friends do (base 10), setting more past it. Plain digits go through
+// std::from_chars, which does not allocate; blanks, signs and overflows are left to the C library, for identical
+// results.
+template <typename T>
+static T parseInteger(std::string_view s, const char*& more) {
+    const char* begin = s.data();
+    const char* end   = begin + s.size();
+
+    if (begin != end && (isdigit(*begin) || (std::is_signed_v<T> && *begin == '-'))) {
+        T value;
+        auto [ptr, ec] = std::from_chars(begin, end, value);
+        if (ec == std::errc()) {
+            more = ptr;
+            return value;
+        }
+    }
+
+    std::string str(s);
+    char* p;
+    T value;
+    if constexpr (std::is_same_v<T, long>) {
+        value = ::strtol(str.c_str(), &p, 10);
+    }
+    else if constexpr (std::is_same_v<T, unsigned long>) {
+        value = ::strtoul(str.c_str(), &p, 10);
+    }
+    else if constexpr (std::is_same_v<T, long long>) {
+        value = ::strtoll(str.c_str(), &p, 10);
+    }
+    else {
+        static_assert(std::is_same_v<T, unsigned long long>);
+        value = ::strtoull(str.c_str(), &p, 10);
+    }
+    more = begin + (p - str.c_str());
+    return value;
+}
+
+// Parses the whole of s as a floating point number, with std::from_chars when it can. What it does not accept (blanks,
+// signs, hexadecimal) and what strtod() reports as out of range, including subnormals, go through strtod(), as does
+// everything where the standard library lacks floating point from_chars (__cpp_lib_to_chars: GCC 11, recent libc++).
+template <typename T>
+static T parseReal(std::string_view s, const char* type) {
+    T value;
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    const char* begin = s.data();
+    const char* end   = begin + s.size();
+
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    if (ec == std::errc() && ptr == end && std::fpclassify(value) != FP_SUBNORMAL) {
+        return value;
+    }
+#endif
+
+    std::string str(s);
+    char* pend;
+    errno = 0;
+
+    if constexpr (std::is_same_v<T, double>) {
+        value = ::strtod(str.c_str(), &pend);
+    }
+    else {
+        value = ::strtof(str.c_str(), &pend);
+    }
+
+    if (str.empty() || str[0] == ' ' || static_cast<size_t>(pend - str.c_str()) != str.size() || (errno != 0)) {
+        throw BadParameter("Bad conversion from std::string '" + str + "' to " + type, Here());
+    }
+
+    return value;
+}
+
+static bool isFalse(std::string_view s) {
+    return s == "no" || s == "off" || s == "false";
+}
+
+static bool isTrue(std::string_view s) {
+    return s == "yes" || s == "on" || s == "true";
+}
+
 std::string Translator<bool, std::string>::operator()(bool value) {
     std::ostringstream s;
     s << value;
@@ -82,31 +165,39 @@ std::string Translator<unsigned int, std::string>::operator()(unsigned int value
 }
 
 int Translator<std::string, int>::operator()(const std::string& s) {
-    if (s == "no" || s == "off" || s == "false") {
+    return Translator<std::string_view, int>{}(s);
+}
+
+int Translator<std::string_view, int>::operator()(std::string_view s) {
+    if (isFalse(s)) {
         return false;
     }
-    if (s == "yes" || s == "on" || s == "true") {
+    if (isTrue(s)) {
         return true;
     }
 
     // Catter for ints
-    char* more;
-    int result = strtol(s.c_str(), &more, 10);
-    return result * multiplier(more);
+    const char* more;
+    int result = parseInteger<long>(s, more);
+    return result * multiplier(more, s.data() + s.size());
 }
 
 unsigned int Translator<std::string, unsigned int>::operator()(const std::string& s) {
-    if (s == "no" || s == "off" || s == "false") {
+    return Translator<std::string_view, unsigned int>{}(s);
+}
+
+unsigned int Translator<std::string_view, unsigned int>::operator()(std::string_view s) {
+    if (isFalse(s)) {
         return false;
     }
-    if (s == "yes" || s == "on" || s == "true") {
+    if (isTrue(s)) {
         return true;
     }
 
     // Catter for ints
-    char* more;
-    unsigned int result = strtoul(s.c_str(), &more, 10);
-    return result * multiplier(more);
+    const char* more;
+    unsigned int result = parseInteger<unsigned long>(s, more);
+    return result * multiplier(more, s.data() + s.size());
 }
 
 std::string Translator<long, std::string>::operator()(long value) {
@@ -116,16 +207,20 @@ std::string Translator<long, std::string>::operator()(long value) {
 }
 
 long Translator<std::string, long>::operator()(const std::string& s) {
-    char* more;
-    long result = strtol(s.c_str(), &more, 10);
-    return result * multiplier(more);
+    return Translator<std::string_view, long>{}(s);
+}
+
+long Translator<std::string_view, long>::operator()(std::string_view s) {
+    const char* more;
+    long result = parseInteger<long>(s, more);
+    return result * multiplier(more, s.data() + s.size());
 }
 
 
 short Translator<std::string, short>::operator()(const std::string& s) {
-    char* more;
-    long result = strtol(s.c_str(), &more, 10);
-    result      = result * multiplier(more);
+    const char* more;
+    long result = parseInteger<long>(s, more);
+    result      = result * multiplier(more, s.data() + s.size());
 
     ASSERT(short(result) == result);
     return result;
@@ -133,9 +228,9 @@ short Translator<std::string, short>::operator()(const std::string& s) {
 
 
 unsigned char Translator<std::string, unsigned char>::operator()(const std::string& s) {
-    char* more;
-    long result = strtol(s.c_str(), &more, 10);
-    result      = result * multiplier(more);
+    const char* more;
+    long result = parseInteger<long>(s, more);
+    result      = result * multiplier(more, s.data() + s.size());
 
     ASSERT(static_cast<unsigned char>(result) == result);
     return result;
@@ -168,51 +263,29 @@ std::string Translator<double, std::string>::operator()(double value) {
 }
 
 double Translator<std::string, double>::operator()(const std::string& s) {
-    char* pend;
-    errno = 0;
-
-    double d = ::strtod(s.c_str(), &pend);
-
-    //    ECKIT_DEBUG_VAR( d );
-    //    ECKIT_DEBUG_VAR( s );
-    //    ECKIT_DEBUG_VAR( s.size() );
-    //    ECKIT_DEBUG_VAR( pend - s.c_str() );
-    //    ECKIT_DEBUG_VAR( errno );
-
-    if (s.empty() || s[0] == ' ' || static_cast<size_t>(pend - s.c_str()) != s.size() || (errno != 0)) {
-        throw BadParameter("Bad conversion from std::string '" + s + "' to double", Here());
-    }
-
-    return d;
+    return parseReal<double>(s, "double");
+}
 
-    //    return atof(s.c_str());
+double Translator<std::string_view, double>::operator()(std::string_view s) {
+    return parseReal<double>(s, "double");
 }
 
 float Translator<std::string, float>::operator()(const std::string& s) {
-    char* pend;
-    errno = 0;
-
-    float f = ::strtof(s.c_str(), &pend);
-
-    //    ECKIT_DEBUG_VAR( d );
-    //    ECKIT_DEBUG_VAR( s );
-    //    ECKIT_DEBUG_VAR( s.size() );
-    //    ECKIT_DEBUG_VAR( pend - s.c_str() );
-    //    ECKIT_DEBUG_VAR( errno );
-
-    if (s.empty() || s[0] == ' ' || static_cast<size_t>(pend - s.c_str()) != s.size() || (errno != 0)) {
-        throw BadParameter("Bad conversion from std::string '" + s + "' to float", Here());
-    }
-
-    return f;
+    return parseReal<float>(s, "float");
+}
 
-    //    return atof(s.c_str());
+float Translator<std::string_view, float>::operator()(std::string_view s) {
+    return parseReal<float>(s, "float");
 }
 
 unsigned long Translator<std::string, unsigned long>::operator()(const std::string& s) {
-    char* more;
-    unsigned long result = strtoul(s.c_str(), &more, 10);
-    return result * multiplier(more);
+    return Translator<std::string_view, unsigned long>{}(s);
+}
+
+unsigned long Translator<std::string_view, unsigned long>::operator()(std::string_view s) {
+    const char* more;
+    unsigned long result = parseInteger<unsigned long>(s, more);
+    return result * multiplier(more, s.data() + s.size());
 }
 
 std::string Translator<unsigned long, std::string>::operator()(unsigned long value) {
@@ -222,9 +295,13 @@ std::string Translator<unsigned long, std::string>::operator()(unsigned long val
 }
 
 unsigned long long Translator<std::string, unsigned long long>::operator()(const std::string& s) {
-    char* more;
-    unsigned long long result = strtoull(s.c_str(), &more, 10);
-    return result * multiplier(more);
+    return Translator<std::string_view, unsigned long long>{}(s);
+}
+
+unsigned long long Translator<std::string_view, unsigned long long>::operator()(std::string_view s) {
+    const char* more;
+    unsigned long long result = parseInteger<unsigned long long>(s, more);
+    return result * multiplier(more, s.data() + s.size());
 }
 
 std::string Translator<unsigned long long, std::string>::operator()(unsigned long long value) {
@@ -234,9 +311,13 @@ std::string Translator<unsigned long long, std::string>::operator()(unsigned lon
 }
 
 long long Translator<std::string, long long>::operator()(const std::string& s) {
-    char* more;
-    long long result = strtoll(s.c_str(), &more, 10);
-    return result * multiplier(more);
+    return Translator<std::string_view, long long>{}(s);
+}
+
+long long Translator<std::string_view, long long>::operator()(std::string_view s) {
+    const char* more;
+    long long result = parseInteger<long long>(s, more);
+    return result * multiplier(more, s.data() + s.size());
 }
 
 std::string Translator<long long, std::string>::operator()(long long value) {
@@ -254,14 +335,11 @@ std::vector<std::string> Translator<std::string, std::vector<std::string> >::ope
 }
 
 std::vector<long> Translator<std::string, std::vector<long> >::operator()(const std::string& s) {
-    std::vector<std::string> r;
     Tokenizer parse(", \t");
 
-    parse(s, r);
-
     std::vector<long> result;
-    for (size_t i = 0; i < r.size(); i++) {
-        result.push_back(Translator<std::string, long>()(r[i]));
+    for (std::string_view token : parse.tokens(s)) {
+        result.push_back(Translator<std::string_view, long>()(token));
     }
     return result;
 }
@@ -290,12 +368,10 @@ std::string Translator<std::vector<std::string>, std::string>::operator()(const
 }
 
 std::set<std::string> Translator<std::string, std::set<std::string> >::operator()(const std::string& s) {
-    std::vector<std::string> v;
+    std::set<std::string> result;
     Tokenizer parse(", \t");
 
-    parse(s, v);
-
-    std::set<std::string> result(v.begin(), v.end());
+    parse(s, result);
     return result;
 }
 
@@ -18,6 +18,7 @@
 
 #include <set>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -213,6 +214,48 @@ struct Translator<signed char, std::string> {
     std::string operator()(signed char v);
 };
 
+// Conversions of views, as from Tokenizer::tokens(), with the same rules as from std::string
+
+template <>
+struct Translator<std::string_view, int> {
+    int operator()(std::string_view);
+};
+
+template <>
+struct Translator<std::string_view, unsigned int> {
+    unsigned int operator()(std::string_view);
+};
+
+template <>
+struct Translator<std::string_view, long> {
+    long operator()(std::string_view);
+};
+
+template <>
+struct Translator<std::string_view, unsigned long> {
+    unsigned long operator()(std::string_view);
+};
+
+template <>
+struct Translator<std::string_view, long long> {
+    long long operator()(std::string_view);
+};
+
+template <>
+struct Translator<std::string_view, unsigned long long> {
+    unsigned long long operator()(std::string_view);
+};
+
+template <>
+struct Translator<std::string_view, double> {
+    double operator()(std::string_view);
+};
+
+template <>
+struct Translator<std::string_view, float> {
+    float operator()(std::string_view);
+};
+
 
 //----------------------------------------------------------------------------------------------------------------------
 
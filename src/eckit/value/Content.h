@@ -197,6 +197,7 @@ protected:
 
     virtual bool contains(const Value&) const;
     virtual Value& element(const Value&);
+    virtual const Value* find(const Value&) const { return nullptr; }
     virtual Value remove(const Value&);
     virtual void append(const Value&);
 
@@ -86,6 +86,11 @@ bool MapContent::contains(const Value& key) const {
     return value_.find(key) != value_.end();
 }
 
+const Value* MapContent::find(const Value& key) const {
+    auto j = value_.find(key);
+    return j == value_.end() ? nullptr : &(j->second);
+}
+
 int MapContent::compare(const Content& other) const {
     return -other.compareMap(*this);
 }
@@ -105,6 +105,11 @@ bool OrderedMapContent::contains(const Value& key) const {
     return value_.find(key) != value_.end();
 }
 
+const Value* OrderedMapContent::find(const Value& key) const {
+    auto j = value_.find(key);
+    return j == value_.end() ? nullptr : &(j->second);
+}
+
 int OrderedMapContent::compare(const Content& other) const {
     return -other.compareOrderedMap(*this);
 }
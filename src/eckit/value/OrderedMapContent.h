@@ -74,6 +74,7 @@ protected:
     Value keys() const override;
     Value& element(const Value&) override;
     bool contains(const Value& key) const override;
+    const Value* find(const Value& key) const override;
     Value remove(const Value&) override;
 
 
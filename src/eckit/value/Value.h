@@ -345,6 +345,10 @@ public:
     Value element(const Value&) const;
     Value remove(const Value&);
 
+    /// Non-copying lookup of a map entry, returns nullptr if this is not a map or the key is absent.
+    /// The pointer refers into this Value and is invalidated by any modification of it.
+    const Value* find(const Value& key) const { return content_->find(key); }
+
     void append(const Value&);  // List append
 
     // -- Methods
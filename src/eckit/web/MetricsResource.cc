@@ -0,0 +1,32 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/web/MetricsResource.h"
+#include "eckit/log/Histogram.h"
+
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MetricsResource::MetricsResource() :
+    JSONResource("/metrics") {}
+
+MetricsResource::~MetricsResource() {}
+
+void MetricsResource::json(JSON& s, const Value&) {
+    Instruments::json(s);
+}
+
+static MetricsResource metricsResourceInstance;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,36 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_web_MetricsResource_H
+#define eckit_web_MetricsResource_H
+
+#include "eckit/web/JSONResource.h"
+
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Histograms and counters of the process (see Instruments), as JSON at /metrics
+class MetricsResource : public JSONResource {
+public:
+    MetricsResource();
+
+    ~MetricsResource() override;
+
+private:
+    void json(eckit::JSON&, const eckit::Value&) override;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
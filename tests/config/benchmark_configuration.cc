@@ -0,0 +1,116 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <string>
+#include <vector>
+
+#include "eckit/config/ConfigurationPath.h"
+#include "eckit/config/FrozenConfiguration.h"
+#include "eckit/config/YAMLConfiguration.h"
+#include "eckit/log/Log.h"
+#include "eckit/log/Timer.h"
+#include "eckit/parser/YAMLParser.h"
+#include "eckit/utils/Tokenizer.h"
+#include "eckit/value/Value.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define NITER 1000000
+
+static const char* cfgtxt =
+    "model:\n"
+    "  name: ifs\n"
+    "  physics:\n"
+    "    radiation:\n"
+    "      frequency: 3600\n"
+    "      scheme: ecrad\n"
+    "    convection:\n"
+    "      enabled: true\n"
+    "  dynamics:\n"
+    "    timestep: 900.0\n"
+    "    levels: 137\n";
+
+/// The lookup as done before compiled paths: tokenise the key, then walk the tree copying values
+double tokenised_lookup(const Value& root, const std::string& name) {
+    Tokenizer parse('.');
+    std::vector<std::string> path;
+    parse(name, path);
+
+    Value result = root;
+    for (const auto& key : path) {
+        ASSERT(result.contains(key));
+        const Value& const_result = result;
+        result                    = const_result[key];
+    }
+    return result;
+}
+
+CASE("benchmark repeated Configuration::get") {
+    YAMLConfiguration yaml{std::string(cfgtxt)};
+    FrozenConfiguration frozen(yaml);
+
+    const std::string key = "model.physics.radiation.frequency";
+    const ConfigurationPath path(key);
+
+    double sum = 0;
+
+    {
+        Value root = YAMLParser::decodeString(cfgtxt);
+        Timer timer("tokenised lookup (reference)");
+        for (size_t i = 0; i < NITER; ++i) {
+            sum += tokenised_lookup(root, key);
+        }
+    }
+
+    {
+        Timer timer("YAMLConfiguration::getDouble(std::string)");
+        for (size_t i = 0; i < NITER; ++i) {
+            sum += yaml.getDouble(key);
+        }
+    }
+
+    {
+        Timer timer("YAMLConfiguration::getDouble(ConfigurationPath)");
+        for (size_t i = 0; i < NITER; ++i) {
+            sum += yaml.getDouble(path);
+        }
+    }
+
+    {
+        Timer timer("FrozenConfiguration::getDouble(std::string)");
+        for (size_t i = 0; i < NITER; ++i) {
+            sum += frozen.getDouble(key);
+        }
+    }
+
+    {
+        Timer timer("FrozenConfiguration::getDouble(ConfigurationPath)");
+        for (size_t i = 0; i < NITER; ++i) {
+            sum += frozen.getDouble(path);
+        }
+    }
+
+    EXPECT(sum == 5. * NITER * 3600.);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
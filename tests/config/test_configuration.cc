@@ -10,6 +10,8 @@
 
 #include <fstream>
 
+#include "eckit/config/ConfigurationPath.h"
+#include "eckit/config/FrozenConfiguration.h"
 #include "eckit/config/LocalConfiguration.h"
 #include "eckit/config/YAMLConfiguration.h"
 #include "eckit/filesystem/PathName.h"
@@ -438,6 +440,81 @@ CASE("test_local_configuration") {
 
 }
 
+CASE("Configuration lookup with a pre-parsed path") {
+    LocalConfiguration local;
+    local.set("model.timestep", 900.);
+    local.set("model.levels", 137);
+    local.set("model.name", "ifs");
+    local.set("model.grid.points", std::vector<long>{1, 2, 3});
+
+    const ConfigurationPath timestep("model.timestep");
+    const ConfigurationPath levels("model..levels");
+    const ConfigurationPath name("model/name", '/');
+    const ConfigurationPath points("model.grid.points");
+    const ConfigurationPath missing("model.grid.missing");
+
+    EXPECT(timestep.depth() == 2);
+    EXPECT(levels.depth() == 2);
+
+    EXPECT(local.has(timestep));
+    EXPECT(!local.has(missing));
+
+    EXPECT(local.getDouble(timestep) == 900.);
+    EXPECT(local.getInt(levels) == 137);
+    EXPECT(local.getString(name) == "ifs");
+
+    std::vector<long> p;
+    EXPECT(local.get(points, p));
+    EXPECT(p == std::vector<long>({1, 2, 3}));
+
+    EXPECT_THROWS(local.getDouble(missing));
+
+    // path resolution follows modifications of the configuration
+    local.set("model.timestep", 450.);
+    EXPECT(local.getDouble(timestep) == 450.);
+}
+
+CASE("FrozenConfiguration has the semantics of Configuration") {
+    const std::string cfgtxt(
+        "model:\n"
+        "  timestep: 900\n"
+        "  name: ifs\n"
+        "  grid:\n"
+        "    points: [1, 2, 3]\n"
+        "    regular: true\n"
+        "levels:\n"
+        "  - {n: 1}\n"
+        "  - {n: 2}\n");
+
+    YAMLConfiguration yaml(cfgtxt);
+    FrozenConfiguration conf(yaml);
+
+    EXPECT(conf.size() == 7);
+
+    EXPECT(conf.has("model"));
+    EXPECT(conf.has("model.grid.regular"));
+    EXPECT(conf.has("model..grid.regular"));
+    EXPECT(!conf.has("model.grid.irregular"));
+    EXPECT(!conf.has("model.name.first"));
+
+    EXPECT(conf.getLong("model.timestep") == 900);
+    EXPECT(conf.getDouble("model.timestep") == 900.);
+    EXPECT(conf.getString("model.name") == "ifs");
+    EXPECT(conf.getBool(ConfigurationPath("model.grid.regular")));
+    EXPECT(conf.getIntVector("model.grid.points") == std::vector<int>({1, 2, 3}));
+    EXPECT(conf.getInt("model.missing", 42) == 42);
+    EXPECT_THROWS(conf.getLong("model.missing"));
+
+    EXPECT(conf.isSubConfiguration("model.grid"));
+    EXPECT(conf.isSubConfigurationList("levels"));
+    EXPECT(conf.getSubConfiguration("model").getString("name") == "ifs");
+    EXPECT(conf.getSubConfigurations("levels")[1].getInt("n") == 2);
+
+    LocalConfiguration local(conf);
+    local.set("model.name", "other");
+    EXPECT(conf.getString("model.name") == "ifs");
+}
+
 CASE("Hash a configuration") {
     std::unique_ptr<Hash> h(eckit::HashFactory::instance().build("MD5"));
 
@@ -0,0 +1,91 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Lookup throughput and measured false positive rates of BlockedBloomFilter sized for several target rates, and of
+// BloomFilter with as many bits. The number of entries can be set with ECKIT_BLOOMFILTER_BENCHMARK_ENTRIES.
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/container/BlockedBloomFilter.h"
+#include "eckit/container/BloomFilter.h"
+#include "eckit/log/Log.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static std::vector<std::string> keys(size_t from, size_t to) {
+    std::vector<std::string> k;
+    k.reserve(to - from);
+    for (size_t i = from; i < to; ++i) {
+        k.push_back("param=130,level=" + std::to_string(i % 137) + ",step=" + std::to_string(i));
+    }
+    return k;
+}
+
+/// @returns lookups per second and the proportion found
+template <typename Filter>
+std::pair<double, double> lookup(const Filter& filter, const std::vector<std::string>& k) {
+    size_t found = 0;
+    auto start   = std::chrono::steady_clock::now();
+    for (const auto& key : k) {
+        found += filter.contains(key);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {k.size() / seconds, double(found) / k.size()};
+}
+
+CASE("Lookups and false positives") {
+    size_t n = Resource<size_t>("$ECKIT_BLOOMFILTER_BENCHMARK_ENTRIES", 1000000);
+
+    std::vector<std::string> present = keys(0, n);
+    std::vector<std::string> absent  = keys(n, 2 * n);
+
+    for (double rate : {0.1, 0.01, 0.001, 0.0001}) {
+        BlockedBloomFilter filter(n, rate);
+        for (const auto& key : present) {
+            filter.insert(key);
+        }
+
+        auto hits   = lookup(filter, present);
+        auto misses = lookup(filter, absent);
+        EXPECT(hits.second == 1);
+
+        Log::info() << "    " << filter << ", target " << rate << ": " << filter.footprint() / double(n)
+                    << " bytes per entry, " << size_t(hits.first / 1000) << " k lookups/s present, "
+                    << size_t(misses.first / 1000) << " k lookups/s absent, false positives " << misses.second
+                    << " (estimated " << filter.falsePositiveRate() << ")" << std::endl;
+
+        BloomFilter<std::string> old(8 * filter.footprint());
+        for (const auto& key : present) {
+            old.insert(key);
+        }
+        auto oldMisses = lookup(old, absent);
+        Log::info() << "    BloomFilter, as many bits: " << size_t(oldMisses.first / 1000)
+                    << " k lookups/s absent, false positives " << oldMisses.second << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
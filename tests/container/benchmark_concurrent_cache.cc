@@ -0,0 +1,136 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Throughput and hit ratio of a cache shared by threads looking up keys with a skewed popularity, inserting the ones
+// missing, with a CacheLRU behind a mutex and with a ConcurrentCache for each eviction. The number of lookups per
+// thread and the largest number of threads can be set with ECKIT_CACHE_BENCHMARK_LOOKUPS and
+// ECKIT_CACHE_BENCHMARK_THREADS.
+
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/container/CacheLRU.h"
+#include "eckit/container/ConcurrentCache.h"
+#include "eckit/log/Log.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static const size_t capacity = 10000;
+static const size_t keys     = 100000;
+
+class LockedCacheLRU {
+public:
+    LockedCacheLRU() :
+        cache_(capacity) {}
+
+    bool find(size_t key, size_t& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!cache_.exists(key)) {
+            return false;
+        }
+        value = cache_.access(key);
+        return true;
+    }
+
+    void insert(size_t key, size_t value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cache_.insert(key, value);
+    }
+
+private:
+    std::mutex mutex_;
+    CacheLRU<size_t, size_t> cache_;
+};
+
+/// @returns lookups per second, and the hit ratio
+template <typename Cache>
+std::pair<double, double> run(Cache& cache, size_t threads, size_t lookups) {
+    std::vector<size_t> hits(threads, 0);
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&cache, &hits, t, lookups] {
+            std::mt19937_64 random(t);
+            std::uniform_real_distribution<double> uniform;
+            size_t value;
+            size_t n = 0;
+            for (size_t i = 0; i < lookups; ++i) {
+                // Few keys are popular
+                double u   = uniform(random);
+                size_t key = size_t(keys * u * u * u);
+                if (cache.find(key, value)) {
+                    n++;
+                }
+                else {
+                    cache.insert(key, key);
+                }
+            }
+            hits[t] = n;
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t total = 0;
+    for (size_t h : hits) {
+        total += h;
+    }
+    return {threads * lookups / seconds, double(total) / double(threads * lookups)};
+}
+
+static void report(const std::string& name, size_t threads, std::pair<double, double> result) {
+    Log::info() << "    " << name << ", " << threads << " threads: " << size_t(result.first / 1000)
+                << " k lookups/s, hit ratio " << result.second << std::endl;
+}
+
+CASE("Shared cache lookups") {
+    size_t lookups    = Resource<size_t>("$ECKIT_CACHE_BENCHMARK_LOOKUPS", 200000);
+    size_t maxThreads = Resource<size_t>("$ECKIT_CACHE_BENCHMARK_THREADS", 8);
+
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        {
+            LockedCacheLRU cache;
+            report("CacheLRU and mutex", threads, run(cache, threads, lookups));
+        }
+        for (CacheEviction eviction : {CacheEviction::LRU, CacheEviction::CLOCK, CacheEviction::TinyLFU}) {
+            ConcurrentCache<size_t, size_t> cache(capacity, eviction);
+            std::ostringstream name;
+            name << "ConcurrentCache " << (eviction == CacheEviction::LRU     ? "LRU"
+                                           : eviction == CacheEviction::CLOCK ? "CLOCK"
+                                                                              : "TinyLFU")
+                 << " (" << cache.shards() << " shards)";
+            report(name.str(), threads, run(cache, threads, lookups));
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
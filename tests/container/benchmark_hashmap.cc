@@ -0,0 +1,172 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Time to insert keys, and to look them up (all found) and others (none found), with std::map, std::unordered_map,
+// DenseMap, FlatMap and HashMap, for integer, std::string and PathName keys. The number of keys can be set with
+// ECKIT_HASHMAP_BENCHMARK_KEYS.
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/container/DenseMap.h"
+#include "eckit/container/FlatMap.h"
+#include "eckit/container/HashMap.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/log/Log.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <typename K>
+K makeKey(size_t i);
+
+// Not size_t, which DenseMap does not take
+template <>
+long makeKey<long>(size_t i) {
+    return long(i * 2654435761U);
+}
+
+template <>
+std::string makeKey<std::string>(size_t i) {
+    return "class=od,expver=0001,param=" + std::to_string(i % 300) + ",step=" + std::to_string(i);
+}
+
+template <>
+PathName makeKey<PathName>(size_t i) {
+    return PathName("/data/fdb/root/od:0001:" + std::to_string(i / 100) + "/an:" + std::to_string(i) + ".data");
+}
+
+// Inserting, with DenseMap sorted once at the end, and looking up
+
+template <typename Map, typename K>
+void insert(Map& m, const K& k, size_t v) {
+    m.emplace(k, v);
+}
+
+template <typename K, typename V>
+void insert(DenseMap<K, V>& m, const K& k, size_t v) {
+    m.insert(k, v);
+}
+
+template <typename K, typename V>
+void insert(FlatMap<K, V>& m, const K& k, size_t v) {
+    m.insert(k, v);
+}
+
+template <typename Map>
+void prepare(Map&) {}
+
+template <typename K, typename V>
+void prepare(DenseMap<K, V>& m) {
+    m.sort();
+}
+
+template <typename Map, typename K>
+bool lookup(const Map& m, const K& k) {
+    return m.find(k) != m.end();
+}
+
+template <typename K, typename V>
+bool lookup(const FlatMap<K, V>& m, const K& k) {
+    return m.contains(k);
+}
+
+template <typename K, typename V>
+bool lookup(const DenseMap<K, V>& m, const K& k) {
+    return m.contains(k);
+}
+
+static double since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename Map, typename K>
+void run(const std::string& name, const std::vector<K>& keys, const std::vector<K>& lookups,
+         const std::vector<K>& others) {
+    Map m;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        insert(m, keys[i], i);
+    }
+    prepare(m);
+    double inserting = since(start) / keys.size();
+
+    size_t found = 0;
+    start        = std::chrono::steady_clock::now();
+    for (const K& k : lookups) {
+        found += lookup(m, k);
+    }
+    double hits = since(start) / lookups.size();
+    EXPECT(found == lookups.size());
+
+    start = std::chrono::steady_clock::now();
+    for (const K& k : others) {
+        found += lookup(m, k);
+    }
+    double misses = since(start) / others.size();
+    EXPECT(found == lookups.size());
+
+    Log::info() << "    " << std::setw(20) << std::left << name << std::right << std::fixed << std::setprecision(1)
+                << std::setw(8) << inserting << " ns/insert " << std::setw(8) << hits << " ns/hit " << std::setw(8)
+                << misses << " ns/miss" << std::endl;
+}
+
+template <typename K>
+void benchmark(const std::string& type, size_t n) {
+    std::vector<K> keys;
+    std::vector<K> others;
+    for (size_t i = 0; i < n; ++i) {
+        keys.push_back(makeKey<K>(i));
+        others.push_back(makeKey<K>(n + i));
+    }
+
+    // Looked up in another order than inserted
+    std::vector<K> lookups(keys);
+    std::shuffle(lookups.begin(), lookups.end(), std::mt19937(42));
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(43));
+
+    Log::info() << type << " keys, " << n << std::endl;
+    run<std::map<K, size_t>>("std::map", keys, lookups, others);
+    run<std::unordered_map<K, size_t>>("std::unordered_map", keys, lookups, others);
+    run<DenseMap<K, size_t>>("DenseMap", keys, lookups, others);
+    run<FlatMap<K, size_t>>("FlatMap", keys, lookups, others);
+    run<HashMap<K, size_t>>("HashMap", keys, lookups, others);
+}
+
+CASE("Maps") {
+    size_t n = Resource<size_t>("$ECKIT_HASHMAP_BENCHMARK_KEYS", 200000);
+
+    benchmark<long>("Integer", n);
+    benchmark<std::string>("String", n);
+    benchmark<PathName>("PathName", n / 4);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
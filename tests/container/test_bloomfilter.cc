@@ -8,7 +8,15 @@
  * does it submit to any jurisdiction.
  */
 
+#include <string>
+
+#include "eckit/container/BlockedBloomFilter.h"
 #include "eckit/container/BloomFilter.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/TmpFile.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/serialisation/MemoryStream.h"
+#include "eckit/serialisation/ResizableMemoryStream.h"
 #include "eckit/testing/Test.h"
 
 using namespace std;
@@ -33,6 +41,157 @@ CASE("test_eckit_container_bloomfilter_insert") {
     EXPECT(!f.contains("hello there again"));
 }
 
+CASE("test_eckit_container_bloomfilter_many") {
+
+    BloomFilter<std::string> f(64 * 1024);
+
+    for (size_t i = 0; i < 1000; ++i) {
+        f.insert("key" + std::to_string(i));
+    }
+
+    size_t falsePositives = 0;
+    for (size_t i = 0; i < 1000; ++i) {
+        EXPECT(f.contains("key" + std::to_string(i)));
+        falsePositives += f.contains("other" + std::to_string(i));
+    }
+    EXPECT(falsePositives < 50);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static std::string key(size_t i) {
+    return "key" + std::to_string(i);
+}
+
+CASE("test_eckit_container_blocked_bloomfilter_insert") {
+
+    BlockedBloomFilter f(1000);
+
+    EXPECT(f.empty());
+    EXPECT(!f.contains("hello there"));
+
+    f.insert("hello there");
+    f.insert(42);
+    f.insert(3.14);
+
+    EXPECT(!f.empty());
+    EXPECT(f.entries() == 3);
+    EXPECT(f.contains("hello there"));
+    EXPECT(f.contains(42));
+    EXPECT(f.contains(3.14));
+    EXPECT(!f.contains("hello there again"));
+
+    // Values hashed once
+    uint64_t h = BlockedBloomFilter::hash("abc", 3);
+    EXPECT(!f.containsHash(h));
+    f.insertHash(h);
+    EXPECT(f.contains(std::string("abc")));
+
+    f.clear();
+    EXPECT(f.empty());
+    EXPECT(!f.contains("hello there"));
+}
+
+CASE("test_eckit_container_blocked_bloomfilter_false_positives") {
+
+    for (double rate : {0.1, 0.01, 0.001}) {
+        BlockedBloomFilter f(10000, rate);
+        EXPECT(f.hashes() >= 1);
+        EXPECT(f.hashes() <= BlockedBloomFilter::WORDS);
+
+        for (size_t i = 0; i < 10000; ++i) {
+            f.insert(key(i));
+        }
+
+        size_t falsePositives = 0;
+        for (size_t i = 0; i < 10000; ++i) {
+            EXPECT(f.contains(key(i)));
+            falsePositives += f.contains(key(10000 + i));
+        }
+
+        // Within the target, with some slack for a small sample
+        EXPECT(falsePositives <= 10000 * rate * 1.5 + 3);
+        EXPECT(f.falsePositiveRate() < rate);
+    }
+}
+
+CASE("test_eckit_container_blocked_bloomfilter_union_intersection") {
+
+    BlockedBloomFilter a(1000);
+    BlockedBloomFilter b(1000);
+
+    for (size_t i = 0; i < 500; ++i) {
+        a.insert(key(i));
+        b.insert(key(i + 250));
+    }
+
+    BlockedBloomFilter both(a);
+    both &= b;
+    for (size_t i = 250; i < 500; ++i) {
+        EXPECT(both.contains(key(i)));
+    }
+
+    size_t onlyOne = 0;
+    for (size_t i = 0; i < 250; ++i) {
+        onlyOne += both.contains(key(i)) + both.contains(key(i + 500));
+    }
+    EXPECT(onlyOne < 50);
+
+    a |= b;
+    EXPECT(a.entries() == 1000);
+    for (size_t i = 0; i < 750; ++i) {
+        EXPECT(a.contains(key(i)));
+    }
+
+    BlockedBloomFilter other(100000);
+    EXPECT_THROWS_AS(a |= other, eckit::BadParameter);
+    EXPECT_THROWS_AS(a &= other, eckit::BadParameter);
+}
+
+CASE("test_eckit_container_blocked_bloomfilter_serialisation") {
+
+    BlockedBloomFilter f(1000, 0.001);
+    for (size_t i = 0; i < 1000; ++i) {
+        f.insert(key(i));
+    }
+
+    Buffer buffer(1024);
+    ResizableMemoryStream out(buffer);
+    out << f;
+
+    MemoryStream in(buffer);
+    BlockedBloomFilter g(in);
+    EXPECT(g.entries() == f.entries());
+    EXPECT(g.blocks() == f.blocks());
+    EXPECT(g.hashes() == f.hashes());
+    for (size_t i = 0; i < 1000; ++i) {
+        EXPECT(g.contains(key(i)));
+        EXPECT(g.contains(key(i + 1000)) == f.contains(key(i + 1000)));
+    }
+
+    TmpFile path;
+    f.save(path);
+    BlockedBloomFilter h = BlockedBloomFilter::load(path);
+    EXPECT(h.entries() == f.entries());
+    for (size_t i = 0; i < 1000; ++i) {
+        EXPECT(h.contains(key(i)));
+    }
+}
+
+CASE("test_eckit_container_blocked_bloomfilter_other_hash_function") {
+
+    // Encoded with a hash function that does not exist
+    Buffer buffer(1024);
+    ResizableMemoryStream out(buffer);
+    out << 0U;
+    out << 1U;
+    out << size_t(0);
+    out << size_t(1);
+
+    MemoryStream in(buffer);
+    EXPECT_THROWS_AS(BlockedBloomFilter g(in), BadValue);
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
 }  // namespace eckit::test
@@ -0,0 +1,287 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/container/ConcurrentCache.h"
+#include "eckit/exception/Exceptions.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+typedef ConcurrentCache<std::string, size_t> Cache;
+
+static std::atomic<size_t> purgeCalls(0);
+
+static void purge(std::string& key, size_t& value) {
+    ++purgeCalls;
+}
+
+static size_t length(const std::string& key, const size_t& value) {
+    return key.size();
+}
+
+static std::string key(size_t i) {
+    return "key" + std::to_string(i);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("test_concurrent_cache_basic") {
+    Cache cache(3, CacheEviction::LRU, nullptr, nullptr, 1);
+
+    EXPECT(cache.size() == 0);
+    EXPECT(cache.capacity() == 3);
+    EXPECT(cache.shards() == 1);
+
+    EXPECT(!cache.insert("ddd", 40));
+    EXPECT(!cache.insert("aaa", 5));
+    EXPECT(cache.insert("aaa", 10));
+
+    EXPECT(cache.size() == 2);
+    EXPECT(cache.exists("ddd"));
+    EXPECT(!cache.exists("bbb"));
+
+    EXPECT(cache.access("aaa") == 10);
+    EXPECT(cache.access("ddd") == 40);
+
+    size_t value = 0;
+    EXPECT(cache.find("aaa", value));
+    EXPECT(value == 10);
+    EXPECT(!cache.find("bbb", value));
+
+    // Add 3 more items, displacing first 2
+
+    EXPECT(!cache.insert("ccc", 30));
+    EXPECT(!cache.insert("eee", 50));
+    EXPECT(!cache.insert("bbb", 20));
+
+    EXPECT(cache.size() == 3);
+    EXPECT(!cache.exists("aaa"));
+    EXPECT(!cache.exists("ddd"));
+    EXPECT_THROWS_AS(cache.access("ddd"), eckit::OutOfRange);
+
+    // Reduce capacity, the least recently used is evicted
+
+    EXPECT(cache.access("ccc") == 30);
+    cache.capacity(2);
+    EXPECT(cache.size() == 2);
+    EXPECT(!cache.exists("eee"));
+    EXPECT(cache.exists("ccc"));
+
+    EXPECT(cache.extract("ccc") == 30);
+    EXPECT_THROWS_AS(cache.extract("ccc"), eckit::OutOfRange);
+    EXPECT(!cache.remove("ccc"));
+    EXPECT(cache.remove("bbb"));
+    EXPECT(cache.size() == 0);
+}
+
+CASE("test_concurrent_cache_purge") {
+    for (CacheEviction eviction : {CacheEviction::LRU, CacheEviction::CLOCK, CacheEviction::TinyLFU}) {
+        purgeCalls = 0;
+        {
+            Cache cache(4, eviction, purge, nullptr, 1);
+
+            for (size_t i = 0; i < 4; ++i) {
+                cache.insert(key(i), i);
+            }
+            EXPECT(purgeCalls == 0);
+
+            // Replacing a value does not purge, as CacheLRU
+            cache.insert(key(0), 10);
+            EXPECT(purgeCalls == 0);
+
+            cache.capacity(3);
+            EXPECT(purgeCalls == 1);
+            EXPECT(cache.size() == 3);
+
+            // Insert beyond capacity evicts, whether or not the new entry is kept
+            cache.insert(key(4), 4);
+            EXPECT(purgeCalls == 2);
+            EXPECT(cache.statistics().evictions == 2);
+
+            std::vector<std::string> present;
+            for (size_t i = 0; i < 5; ++i) {
+                if (cache.exists(key(i))) {
+                    present.push_back(key(i));
+                }
+            }
+            EXPECT(present.size() == 3);
+
+            // Extract does not purge, remove does
+            cache.extract(present[0]);
+            EXPECT(purgeCalls == 2);
+
+            EXPECT(cache.remove(present[1]));
+            EXPECT(purgeCalls == 3);
+            EXPECT(cache.size() == 1);
+        }
+
+        // Destruction purges
+        EXPECT(purgeCalls == 4);
+    }
+}
+
+CASE("test_concurrent_cache_weighed") {
+    purgeCalls = 0;
+    Cache cache(20, CacheEviction::LRU, purge, length, 1);
+
+    cache.insert("aaaaa", 1);
+    cache.insert("bbbbbbbbbb", 2);
+    EXPECT(cache.weight() == 15);
+
+    cache.insert("ccccc", 3);
+    EXPECT(cache.weight() == 20);
+    EXPECT(purgeCalls == 0);
+
+    // Two small entries make room for a large one
+    cache.insert("dddddddddd", 4);
+    EXPECT(cache.weight() == 15);
+    EXPECT(cache.size() == 2);
+    EXPECT(!cache.exists("aaaaa"));
+    EXPECT(!cache.exists("bbbbbbbbbb"));
+    EXPECT(purgeCalls == 2);
+
+    // Larger than the capacity, not kept
+    cache.insert(std::string(30, 'e'), 5);
+    EXPECT(cache.size() == 0);
+    EXPECT(cache.weight() == 0);
+}
+
+CASE("test_concurrent_cache_clock_second_chance") {
+    Cache cache(3, CacheEviction::CLOCK, nullptr, nullptr, 1);
+
+    cache.insert("aaa", 1);
+    cache.insert("bbb", 2);
+    cache.insert("ccc", 3);
+
+    size_t value;
+    EXPECT(cache.find("aaa", value));
+
+    cache.insert("ddd", 4);
+    EXPECT(cache.exists("aaa"));
+    EXPECT(!cache.exists("bbb"));
+    EXPECT(cache.exists("ccc"));
+    EXPECT(cache.exists("ddd"));
+}
+
+CASE("test_concurrent_cache_tinylfu_resists_scans") {
+    for (CacheEviction eviction : {CacheEviction::LRU, CacheEviction::TinyLFU}) {
+        Cache cache(100, eviction, nullptr, nullptr, 1);
+
+        // A few keys used often
+        size_t value;
+        for (size_t n = 0; n < 10; ++n) {
+            for (size_t i = 0; i < 10; ++i) {
+                if (!cache.find(key(i), value)) {
+                    cache.insert(key(i), i);
+                }
+            }
+        }
+
+        // Then many used once
+        for (size_t i = 1000; i < 2000; ++i) {
+            cache.insert(key(i), i);
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < 10; ++i) {
+            kept += cache.exists(key(i));
+        }
+
+        EXPECT(cache.size() == 100);
+        EXPECT(kept == (eviction == CacheEviction::TinyLFU ? 10 : 0));
+    }
+}
+
+CASE("test_concurrent_cache_statistics") {
+    Cache cache(10);
+
+    cache.insert("aaa", 1);
+    cache.insert("bbb", 2);
+
+    size_t value;
+    EXPECT(cache.find("aaa", value));
+    EXPECT(cache.find("aaa", value));
+    EXPECT(cache.find("bbb", value));
+    EXPECT(!cache.find("ccc", value));
+    EXPECT_THROWS_AS(cache.access("ddd"), eckit::OutOfRange);
+
+    // Not counted
+    EXPECT(cache.exists("aaa"));
+
+    Cache::Statistics st = cache.statistics();
+    EXPECT(st.hits == 3);
+    EXPECT(st.misses == 2);
+    EXPECT(st.insertions == 2);
+    EXPECT(st.evictions == 0);
+    EXPECT(st.hitRatio() == 0.6);
+
+    cache.resetStatistics();
+    EXPECT(cache.statistics().hits == 0);
+    EXPECT(cache.size() == 2);
+}
+
+CASE("test_concurrent_cache_threads") {
+    for (CacheEviction eviction : {CacheEviction::LRU, CacheEviction::CLOCK, CacheEviction::TinyLFU}) {
+        purgeCalls = 0;
+        Cache cache(512, eviction, purge);
+        EXPECT(cache.shards() > 1);
+
+        const size_t nthreads = 8;
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < nthreads; ++t) {
+            threads.emplace_back([&cache, t] {
+                size_t value;
+                for (size_t i = 0; i < 20000; ++i) {
+                    size_t k = (i * 7919 + t * 104729) % 2048;
+                    if (cache.find(key(k), value)) {
+                        ASSERT(value == k);
+                    }
+                    else {
+                        cache.insert(key(k), k);
+                    }
+                    if (i % 100 == 0) {
+                        cache.remove(key((k + 1) % 2048));
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        Cache::Statistics st = cache.statistics();
+        EXPECT(st.hits + st.misses == nthreads * 20000);
+        EXPECT(cache.size() <= 512);
+        EXPECT(st.evictions > 0);
+
+        // Every entry inserted is still there, or was purged once
+        EXPECT(st.insertions == cache.size() + purgeCalls);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
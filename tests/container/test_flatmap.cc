@@ -0,0 +1,119 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <map>
+#include <random>
+#include <string>
+
+#include "eckit/container/FlatMap.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/serialisation/MemoryStream.h"
+#include "eckit/serialisation/ResizableMemoryStream.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("test_flatmap_insert_find") {
+    FlatMap<std::string, int> m;
+
+    EXPECT(m.empty());
+    EXPECT(m.find("a") == m.end());
+
+    EXPECT(m.insert("b", 2));
+    EXPECT(m.insert("a", 1));
+    EXPECT(!m.insert("a", 10));
+    m["c"] = 3;
+
+    // Looked up before and after merging
+    EXPECT(m.size() == 3);
+    EXPECT(m.at("a") == 1);
+    EXPECT(m.contains("c"));
+    EXPECT(!m.contains("d"));
+    EXPECT_THROWS_AS(m.at("d"), eckit::OutOfRange);
+    EXPECT(m.find("b")->second == 2);
+    EXPECT(m.at("a") == 1);
+
+    EXPECT(!m.replace("a", 10));
+    EXPECT(m.at("a") == 10);
+
+    // In order
+    std::string keys;
+    for (const auto& kv : m) {
+        keys += kv.first;
+    }
+    EXPECT(keys == "abc");
+
+    EXPECT(m.erase("b") == 1);
+    EXPECT(m.erase("b") == 0);
+    EXPECT(m.size() == 2);
+
+    m.clear();
+    EXPECT(m.empty());
+}
+
+CASE("test_flatmap_against_std_map") {
+    FlatMap<size_t, size_t> m;
+    std::map<size_t, size_t> ref;
+
+    // Lookups interleaved with inserts, without iterating
+    std::mt19937_64 random(42);
+    for (size_t i = 0; i < 100000; ++i) {
+        size_t k = random() % 20000;
+        if (random() % 10 == 0) {
+            EXPECT(m.erase(k) == ref.erase(k));
+        }
+        else {
+            m[k] += i;
+            ref[k] += i;
+        }
+        EXPECT(m.contains(k) == (ref.count(k) == 1));
+    }
+
+    EXPECT_EQUAL(m.size(), ref.size());
+    auto j = ref.begin();
+    for (const auto& kv : m) {
+        EXPECT(kv.first == j->first);
+        EXPECT(kv.second == j->second);
+        ++j;
+    }
+    EXPECT(j == ref.end());
+}
+
+CASE("test_flatmap_stream") {
+    FlatMap<std::string, double> m{{"b", 2.5}, {"a", 1.5}};
+
+    Buffer buffer(1024);
+    ResizableMemoryStream out(buffer);
+    out << m;
+
+    MemoryStream in(buffer);
+    FlatMap<std::string, double> n;
+    in >> n;
+
+    EXPECT(n.size() == 2);
+    EXPECT(n.at("a") == 1.5);
+    EXPECT(n.begin()->first == "a");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,198 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+
+#include "eckit/container/HashMap.h"
+#include "eckit/container/HashSet.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/serialisation/MemoryStream.h"
+#include "eckit/serialisation/ResizableMemoryStream.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("test_hashmap_insert_find") {
+    HashMap<std::string, int> m;
+
+    EXPECT(m.empty());
+    EXPECT(m.find("a") == m.end());
+    EXPECT(m.begin() == m.end());
+
+    EXPECT(m.insert({"a", 1}).second);
+    EXPECT(!m.insert({"a", 2}).second);
+    EXPECT(m.emplace("b", 2).second);
+    m["c"] = 3;
+
+    EXPECT(m.size() == 3);
+    EXPECT(m.at("a") == 1);
+    EXPECT(m["b"] == 2);
+    EXPECT(m.find("c")->second == 3);
+    EXPECT(m.contains("a"));
+    EXPECT(!m.contains("d"));
+    EXPECT(m.count("d") == 0);
+    EXPECT_THROWS_AS(m.at("d"), eckit::OutOfRange);
+
+    EXPECT(!m.replace("a", 10));
+    EXPECT(m.replace("d", 4));
+    EXPECT(m.at("a") == 10);
+
+    EXPECT(m.erase("b") == 1);
+    EXPECT(m.erase("b") == 0);
+    EXPECT(!m.contains("b"));
+    EXPECT(m.size() == 3);
+
+    std::map<std::string, int> all(m.begin(), m.end());
+    EXPECT(all == (std::map<std::string, int>{{"a", 10}, {"c", 3}, {"d", 4}}));
+
+    const HashMap<std::string, int>& c = m;
+    EXPECT(c.at("c") == 3);
+    EXPECT(c.find("a") != c.end());
+
+    m.clear();
+    EXPECT(m.empty());
+    EXPECT(!m.contains("a"));
+    EXPECT(m.begin() == m.end());
+}
+
+CASE("test_hashmap_against_std_map") {
+    HashMap<size_t, size_t> m;
+    std::map<size_t, size_t> ref;
+
+    // Inserts and erases, many slots deleted and reused
+    std::mt19937_64 random(42);
+    for (size_t i = 0; i < 200000; ++i) {
+        size_t k = random() % 5000;
+        if (random() % 3 == 0) {
+            EXPECT(m.erase(k) == ref.erase(k));
+        }
+        else {
+            m[k] += i;
+            ref[k] += i;
+        }
+    }
+
+    EXPECT_EQUAL(m.size(), ref.size());
+    EXPECT(m.loadFactor() <= 0.875);
+    for (const auto& kv : ref) {
+        EXPECT(m.at(kv.first) == kv.second);
+    }
+    size_t n = 0;
+    for (const auto& kv : m) {
+        EXPECT(ref.at(kv.first) == kv.second);
+        n++;
+    }
+    EXPECT_EQUAL(n, ref.size());
+}
+
+CASE("test_hashmap_values_moved") {
+    // Values that cannot be copied, with keys moved when the table grows
+    HashMap<std::string, std::unique_ptr<int>> m;
+    for (int i = 0; i < 1000; ++i) {
+        m.emplace(std::to_string(i), new int(i));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT(*m.at(std::to_string(i)) == i);
+    }
+
+    HashMap<std::string, std::unique_ptr<int>> n(std::move(m));
+    EXPECT(n.size() == 1000);
+    EXPECT(m.empty());
+}
+
+CASE("test_hashmap_copy_reserve") {
+    HashMap<int, std::string> m(1000);
+    size_t capacity = m.capacity();
+    EXPECT(capacity >= 1000);
+
+    for (int i = 0; i < 1000; ++i) {
+        m[i] = std::to_string(i);
+    }
+    EXPECT(m.capacity() == capacity);
+
+    HashMap<int, std::string> c(m);
+    m.clear();
+    EXPECT(c.size() == 1000);
+    EXPECT(c.at(999) == "999");
+
+    m = c;
+    EXPECT(m.at(0) == "0");
+}
+
+CASE("test_hashmap_pathname_keys") {
+    HashMap<PathName, int> m;
+    m[PathName("/a/b")] = 1;
+    m[PathName("/a/c")] = 2;
+    EXPECT(m.at(PathName("/a/b")) == 1);
+    EXPECT(!m.contains(PathName("/a/d")));
+}
+
+CASE("test_hashmap_stream") {
+    HashMap<std::string, long> m{{"a", 1}, {"b", -2}, {"c", 3}};
+
+    Buffer buffer(1024);
+    ResizableMemoryStream out(buffer);
+    out << m;
+
+    MemoryStream in(buffer);
+    HashMap<std::string, long> n;
+    in >> n;
+
+    EXPECT(n.size() == 3);
+    EXPECT(n.at("b") == -2);
+}
+
+CASE("test_hashset") {
+    HashSet<std::string> s{"a", "b"};
+
+    EXPECT(s.insert("c").second);
+    EXPECT(!s.insert("a").second);
+    EXPECT(s.size() == 3);
+    EXPECT(s.contains("b"));
+    EXPECT(*s.find("b") == "b");
+    EXPECT(s.find("d") == s.end());
+
+    EXPECT(s.erase("b") == 1);
+    EXPECT(!s.contains("b"));
+
+    std::set<std::string> all(s.begin(), s.end());
+    EXPECT(all == (std::set<std::string>{"a", "c"}));
+
+    Buffer buffer(1024);
+    ResizableMemoryStream out(buffer);
+    out << s;
+
+    MemoryStream in(buffer);
+    HashSet<std::string> t;
+    in >> t;
+    EXPECT(t.size() == 2);
+    EXPECT(t.contains("c"));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,229 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// End-to-end throughput and latency of a producer feeding forked workers on a single node:
+//  - TCPTransport on loopback, one message per round-trip (--credits=1 --batch-size=0, the former protocol) against
+//    credit-based flow control and batching;
+//  - ShmTransport against TCPTransport.
+// The number of messages can be increased with ECKIT_DISTRIBUTED_BENCHMARK_MESSAGES.
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/distributed/Consumer.h"
+#include "eckit/distributed/Message.h"
+#include "eckit/distributed/Producer.h"
+#include "eckit/distributed/Transport.h"
+#include "eckit/distributed/TransportStatistics.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+#include "eckit/log/Timer.h"
+#include "eckit/option/CmdArgs.h"
+#include "eckit/option/Option.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+using namespace eckit::distributed;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static unsigned long long now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+class BenchmarkProducer : public Producer {
+public:
+    BenchmarkProducer(Transport& transport, size_t messages, size_t size) :
+        Producer(transport), messages_(messages), payload_(size, 'x') {}
+
+    bool produce(Message& message) override {
+        if (messages_ == 0) {
+            return false;
+        }
+        messages_--;
+        message << now();
+        message.writeBlob(payload_.data(), payload_.size());
+        return true;
+    }
+
+    void messageFromWorker(Message& message, int) const override {
+        TransportStatistics statistics(message);
+        workers_ += statistics;
+        consumed_ += statistics.receiveCount_;
+
+        unsigned long long latency;
+        unsigned long long maxLatency;
+        message >> latency;
+        message >> maxLatency;
+        latency_ += latency;
+        maxLatency_ = std::max(maxLatency_, maxLatency);
+    }
+
+    void finalise() override {}
+
+    const TransportStatistics& workers() const { return workers_; }
+    size_t consumed() const { return consumed_; }
+
+    /// Time from produce() to consume(), in microseconds
+    double latency() const { return consumed_ ? double(latency_) / consumed_ / 1000. : 0; }
+    double maxLatency() const { return double(maxLatency_) / 1000.; }
+
+private:
+    size_t messages_;
+    std::vector<char> payload_;
+
+    mutable TransportStatistics workers_;
+    mutable size_t consumed_                = 0;
+    mutable unsigned long long latency_    = 0;
+    mutable unsigned long long maxLatency_ = 0;
+};
+
+class BenchmarkConsumer : public Consumer {
+public:
+    BenchmarkConsumer(Transport& transport) :
+        Consumer(transport) {}
+
+    void getNextMessage(Message& message) const override { getNextWorkMessage(message); }
+
+    void consume(Message& message) override {
+        unsigned long long sent;
+        message >> sent;
+
+        unsigned long long latency = now() - sent;
+        latency_ += latency;
+        maxLatency_ = std::max(maxLatency_, latency);
+
+        size_t size;
+        message.getBlob(size);
+        ASSERT(size > 0);
+    }
+
+    void shutdown(Message& message) override {
+        message << transport_.statistics();
+        message << latency_;
+        message << maxLatency_;
+    }
+
+    void finalise() override {}
+
+private:
+    unsigned long long latency_    = 0;
+    unsigned long long maxLatency_ = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void usage(const std::string&) {}
+
+static void run(const std::string& name, size_t workers, size_t messages, size_t size, size_t credits,
+                size_t batchSize) {
+
+    static size_t port = 17000 + ::getpid() % 10000;
+    port++;
+
+    std::vector<option::Option*> options;
+    option::CmdArgs args(&usage, options, -1, 0, true);
+    args.set("transport", name);
+    args.set("workers", workers);
+    args.set("port", port);
+    args.set("credits", credits);
+    args.set("batch-size", batchSize);
+
+    // Listen before forking the workers
+    std::unique_ptr<Transport> transport(TransportFactory::build(args));
+
+    std::vector<pid_t> pids;
+    for (size_t i = 0; i < workers; ++i) {
+        pid_t pid = ::fork();
+        ASSERT(pid >= 0);
+        if (pid == 0) {
+            int status = 0;
+            try {
+                args.set("host", "localhost");
+                std::unique_ptr<Transport> worker(TransportFactory::build(args));
+                BenchmarkConsumer consumer(*worker);
+                static_cast<Actor&>(consumer).run();
+            }
+            catch (std::exception& e) {
+                Log::error() << "Worker: " << e.what() << std::endl;
+                status = 1;
+            }
+            ::_exit(status);
+        }
+        pids.push_back(pid);
+    }
+
+    BenchmarkProducer producer(*transport, messages, size);
+
+    Timer timer(name, Log::debug());
+    producer.run();
+    timer.stop();
+
+    for (pid_t pid : pids) {
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        EXPECT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    EXPECT(producer.consumed() == messages);
+
+    const TransportStatistics& s = transport->statistics();
+    double rate = double(messages) / timer.elapsed();
+
+    Log::info() << "    " << name << ", " << messages << " x " << Bytes(size) << ", credits=" << credits
+                << ", batch-size=" << batchSize << ": " << timer.elapsed() << "s, " << size_t(rate)
+                << " messages/s, " << Bytes(messages * size, timer) << ", latency " << size_t(producer.latency())
+                << "us (max " << size_t(producer.maxLatency()) << "us), frames=" << s.frameCount_
+                << ", stalls=" << s.stallCount_ << ", max queue depth=" << s.maxQueueDepth_ << std::endl;
+}
+
+static size_t messages(size_t n) {
+    static size_t scale = Resource<size_t>("$ECKIT_DISTRIBUTED_BENCHMARK_MESSAGES", 20000);
+    return n * scale / 20000;
+}
+
+CASE("tcp, small messages") {
+    run("tcp", 4, messages(20000), 1024, 1, 0);
+    run("tcp", 4, messages(20000), 1024, 8, 64 * 1024);
+}
+
+CASE("tcp, large messages") {
+    run("tcp", 4, messages(500), 1024 * 1024, 1, 0);
+    run("tcp", 4, messages(500), 1024 * 1024, 8, 64 * 1024);
+}
+
+CASE("shm against tcp, small messages") {
+    run("tcp", 4, messages(20000), 1024, 8, 64 * 1024);
+    run("shm", 4, messages(20000), 1024, 8, 64 * 1024);
+}
+
+CASE("shm against tcp, large messages") {
+    run("tcp", 4, messages(500), 4 * 1024 * 1024, 8, 64 * 1024);
+    run("shm", 4, messages(500), 4 * 1024 * 1024, 8, 64 * 1024);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
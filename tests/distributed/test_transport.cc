@@ -0,0 +1,374 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// ShmTransport between a producer and forked workers, with a ring of 4 KiB: messages wrapping around the ring,
+// messages larger than the ring, and a worker killed with messages queued in its ring. TCPTransport with a worker
+// killed with messages sent against its credits. A segment left by a dead producer is replaced, one of a live
+// producer is not.
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/distributed/Consumer.h"
+#include "eckit/distributed/Message.h"
+#include "eckit/distributed/Producer.h"
+#include "eckit/distributed/Transport.h"
+#include "eckit/distributed/TransportStatistics.h"
+#include "eckit/distributed/shm/ShmTransport.h"
+#include "eckit/log/Log.h"
+#include "eckit/option/CmdArgs.h"
+#include "eckit/option/Option.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+using namespace eckit::distributed;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr size_t RING_SIZE = 4096;
+
+static char byte(size_t message, size_t i) {
+    return char((message * 31 + i) & 0xff);
+}
+
+class TestProducer : public Producer {
+public:
+    TestProducer(Transport& transport, size_t messages, size_t minSize, size_t maxSize) :
+        Producer(transport), messages_(messages), minSize_(minSize), maxSize_(maxSize) {}
+
+    /// Killed after half the messages are sent
+    void victim(pid_t pid) { victim_ = pid; }
+
+    bool produce(Message& message) override {
+        if (sent_ == messages_) {
+            return false;
+        }
+
+        if (victim_ && sent_ == messages_ / 2) {
+            ::kill(victim_, SIGKILL);
+            ::waitpid(victim_, nullptr, 0);
+            victim_ = 0;
+        }
+
+        size_t size = minSize_ + (sent_ * 7919) % (maxSize_ - minSize_ + 1);
+        std::vector<char> payload(size);
+        for (size_t i = 0; i < size; ++i) {
+            payload[i] = byte(sent_, i);
+        }
+
+        message << sent_;
+        message.writeBlob(payload.data(), payload.size());
+        sent_++;
+        return true;
+    }
+
+    void messageFromWorker(Message& message, int) const override {
+        size_t count;
+        size_t sum;
+        bool valid;
+        message >> count;
+        message >> sum;
+        message >> valid;
+        consumed_ += count;
+        sum_ += sum;
+        valid_ = valid_ && valid;
+    }
+
+    void finalise() override {}
+
+    size_t consumed() const { return consumed_; }
+    size_t sum() const { return sum_; }
+    bool valid() const { return valid_; }
+
+private:
+    size_t messages_;
+    size_t minSize_;
+    size_t maxSize_;
+    size_t sent_   = 0;
+    pid_t victim_ = 0;
+
+    mutable size_t consumed_ = 0;
+    mutable size_t sum_      = 0;
+    mutable bool valid_      = true;
+};
+
+class TestConsumer : public Consumer {
+public:
+    TestConsumer(Transport& transport, bool stuck) :
+        Consumer(transport), stuck_(stuck) {}
+
+    void getNextMessage(Message& message) const override { getNextWorkMessage(message); }
+
+    void consume(Message& message) override {
+        // Holds the credits it was sent against
+        while (stuck_) {
+            ::pause();
+        }
+
+        size_t n;
+        message >> n;
+
+        size_t size;
+        const char* data = static_cast<const char*>(message.getBlob(size));
+        for (size_t i = 0; i < size; ++i) {
+            valid_ = valid_ && data[i] == byte(n, i);
+        }
+
+        count_++;
+        sum_ += n;
+    }
+
+    void shutdown(Message& message) override {
+        message << count_;
+        message << sum_;
+        message << valid_;
+    }
+
+    void finalise() override {}
+
+private:
+    bool stuck_;
+    size_t count_ = 0;
+    size_t sum_   = 0;
+    bool valid_   = true;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void usage(const std::string&) {}
+
+struct Run {
+    std::string transport = "shm";
+    size_t workers  = 2;
+    size_t messages = 0;
+    size_t minSize  = 1;
+    size_t maxSize  = 1;
+    bool kill       = false;
+};
+
+/// Forks a worker, which consumes the messages or, if stuck, only attaches (shm) or stops at the first message (tcp)
+static pid_t forkWorker(option::CmdArgs& args, const std::string& transport, bool stuck) {
+
+    int fds[2];
+    ASSERT(::pipe(fds) == 0);
+
+    pid_t pid = ::fork();
+    ASSERT(pid >= 0);
+
+    if (pid == 0) {
+        int status = 0;
+        try {
+            args.set("host", "localhost");
+            std::unique_ptr<Transport> worker(TransportFactory::build(args));
+            if ((transport == "shm") != bool(dynamic_cast<ShmTransport*>(worker.get()))) {
+                Log::error() << "Worker: not using the " << transport << " transport" << std::endl;
+                ::_exit(2);
+            }
+            ASSERT(::write(fds[1], "", 1) == 1);
+            if (stuck && transport == "shm") {
+                for (;;) {
+                    ::pause();
+                }
+            }
+            TestConsumer consumer(*worker, stuck);
+            static_cast<Actor&>(consumer).run();
+        }
+        catch (std::exception& e) {
+            Log::error() << "Worker: " << e.what() << std::endl;
+            status = 1;
+        }
+        ::_exit(status);
+    }
+
+    // Wait for the worker to attach, so that it gets messages
+    char c;
+    ASSERT(::read(fds[0], &c, 1) == 1);
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    return pid;
+}
+
+static TransportStatistics run(const Run& run) {
+
+    static size_t port = 27000 + ::getpid() % 10000;
+    port++;
+
+    std::vector<option::Option*> options;
+    option::CmdArgs args(&usage, options, -1, 0, true);
+    args.set("transport", run.transport);
+    args.set("workers", run.workers);
+    args.set("port", port);
+    args.set("ring-size", RING_SIZE);
+    args.set("credits", 8);
+
+    std::unique_ptr<Transport> transport(TransportFactory::build(args));
+    EXPECT((run.transport == "shm") == bool(dynamic_cast<ShmTransport*>(transport.get())));
+
+    TestProducer producer(*transport, run.messages, run.minSize, run.maxSize);
+
+    std::vector<pid_t> pids;
+    if (run.kill) {
+        pid_t victim = forkWorker(args, run.transport, true);
+        producer.victim(victim);
+    }
+    while (pids.size() + (run.kill ? 1 : 0) < run.workers) {
+        pids.push_back(forkWorker(args, run.transport, false));
+    }
+
+    producer.run();
+
+    for (pid_t pid : pids) {
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        EXPECT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    size_t consumed = producer.consumed();
+    size_t sum      = producer.sum();
+    size_t expected = run.messages * (run.messages - 1) / 2;
+
+    EXPECT_EQUAL(consumed, run.messages);
+    EXPECT_EQUAL(sum, expected);
+    EXPECT(producer.valid());
+
+    return transport->statistics();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("messages wrap around the ring") {
+    Run r;
+    r.messages = 2000;
+    r.minSize  = 1;
+    r.maxSize  = 1500;
+
+    TransportStatistics s = run(r);
+    EXPECT(s.sendSize_ > 100 * RING_SIZE);
+}
+
+CASE("messages larger than the ring") {
+    Run r;
+    r.messages = 50;
+    r.minSize  = RING_SIZE;
+    r.maxSize  = 16 * RING_SIZE;
+
+    TransportStatistics s = run(r);
+    EXPECT(s.sendSize_ > r.messages * RING_SIZE);
+}
+
+CASE("messages queued to a lost worker are sent to the others") {
+    Run r;
+    r.messages = 200;
+    r.minSize  = 1;
+    r.maxSize  = 100;
+    r.kill     = true;
+
+    TransportStatistics s = run(r);
+
+    size_t resent = s.resendCount_;
+    size_t lost   = s.lostCount_;
+    EXPECT(resent > 0);
+    EXPECT_EQUAL(lost, 0);
+}
+
+CASE("messages sent to a lost TCP worker are sent to the others") {
+    Run r;
+    r.transport = "tcp";
+    r.messages  = 200;
+    r.minSize   = 1;
+    r.maxSize   = 100;
+    r.kill      = true;
+
+    TransportStatistics s = run(r);
+
+    size_t resent = s.resendCount_;
+    size_t lost   = s.lostCount_;
+    EXPECT(resent > 0);
+    EXPECT_EQUAL(lost, 0);
+}
+
+static size_t nextPort() {
+    static size_t port = 37000 + ::getpid() % 10000;
+    return ++port;
+}
+
+static std::unique_ptr<Transport> producerTransport(size_t port) {
+    std::vector<option::Option*> options;
+    option::CmdArgs args(&usage, options, -1, 0, true);
+    args.set("transport", "shm");
+    args.set("workers", 1);
+    args.set("port", port);
+    args.set("ring-size", RING_SIZE);
+    return std::unique_ptr<Transport>(TransportFactory::build(args));
+}
+
+static std::string segmentName(size_t port) {
+    return "/eckit-distributed-" + std::to_string(port);
+}
+
+CASE("a segment left by a dead producer is replaced") {
+    size_t port = nextPort();
+
+    pid_t dead = ::fork();
+    ASSERT(dead >= 0);
+    if (dead == 0) {
+        ::_exit(0);
+    }
+    ::waitpid(dead, nullptr, 0);
+
+    // The magic number of the segment, and the pid of its producer
+    int fd = ::shm_open(segmentName(port).c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    ASSERT(fd >= 0);
+    uint64_t header[2] = {0x65636b69742d7368ULL, uint64_t(dead)};
+    ASSERT(::pwrite(fd, header, sizeof(header), 0) == sizeof(header));
+    ::close(fd);
+
+    std::unique_ptr<Transport> transport = producerTransport(port);
+    EXPECT(dynamic_cast<ShmTransport*>(transport.get()));
+}
+
+CASE("a segment of a live producer is left alone") {
+    size_t port = nextPort();
+
+    std::unique_ptr<Transport> first = producerTransport(port);
+    EXPECT(dynamic_cast<ShmTransport*>(first.get()));
+
+    std::unique_ptr<Transport> second = producerTransport(port);
+    EXPECT(!dynamic_cast<ShmTransport*>(second.get()));
+
+    // Still there, removed by its producer
+    int fd = ::shm_open(segmentName(port).c_str(), O_RDONLY, 0);
+    EXPECT(fd >= 0);
+    ::close(fd);
+
+    first.reset();
+    EXPECT(::shm_open(segmentName(port).c_str(), O_RDONLY, 0) < 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
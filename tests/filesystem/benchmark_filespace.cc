@@ -0,0 +1,86 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Time to select a filesystem with each strategy, when reading the size of a filesystem is slow (as statvfs on a
+// loaded metadata server), with sizes read every time or cached. Each selection reserves the bytes of the file about
+// to be written. The number of filesystems, the latency of a statvfs in ms and the number of selections can be set
+// with ECKIT_FILESPACE_BENCHMARK_FILESYSTEMS, ECKIT_FILESPACE_BENCHMARK_LATENCY and
+// ECKIT_FILESPACE_BENCHMARK_SELECTIONS.
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/FileSpaceStrategies.h"
+#include "eckit/filesystem/FileSystemSizeCache.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/log/Log.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static double latency = 0;
+
+static void slowStat(const PathName& path, FileSystemSize& fs) {
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(latency));
+    // Filesystems of different sizes, a third used
+    size_t n     = std::hash<std::string>()(path.asString()) % 100;
+    fs.total     = (100 + n) << 30;
+    fs.available = fs.total * 2 / 3;
+}
+
+static double run(const std::vector<PathName>& fileSystems, const std::string& strategy, size_t selections,
+                  double maxAge) {
+    FileSystemSizeCache& cache = FileSystemSizeCache::instance();
+    cache.clear();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < selections; ++i) {
+        const PathName& selected = FileSpaceStrategies::selectFileSystem(fileSystems, strategy, maxAge);
+        cache.reserve(selected, 64 << 20);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / selections;
+}
+
+CASE("Selection with slow statvfs") {
+    size_t n          = Resource<size_t>("$ECKIT_FILESPACE_BENCHMARK_FILESYSTEMS", 32);
+    latency           = Resource<double>("$ECKIT_FILESPACE_BENCHMARK_LATENCY", 2);
+    size_t selections = Resource<size_t>("$ECKIT_FILESPACE_BENCHMARK_SELECTIONS", 50);
+
+    std::vector<PathName> fileSystems;
+    for (size_t i = 0; i < n; ++i) {
+        fileSystems.emplace_back("/simulated/fs" + std::to_string(i));
+    }
+
+    FileSystemSizeCache::instance().stat(&slowStat);
+
+    for (const char* strategy : {"leastUsed", "leastUsedPercent", "roundRobin", "weightedRandom"}) {
+        double uncached = run(fileSystems, strategy, selections, 0);
+        double cached   = run(fileSystems, strategy, selections, 10);
+        Log::info() << "    " << strategy << ", " << n << " filesystems: " << uncached << " ms per selection, "
+                    << cached << " ms with cached sizes" << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
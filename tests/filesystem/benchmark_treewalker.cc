@@ -0,0 +1,113 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Time to list a synthetic tree:
+//  - the former serial recursion of LocalPathName::children (opendir/readdir and a path per entry);
+//  - TreeWalker on 1 and several threads, with the type of the entries only and with all fields (statx/fstatat).
+// The tree has ECKIT_TREE_WALKER_BENCHMARK_FANOUT directories per level (default 8) on 3 levels, with
+// ECKIT_TREE_WALKER_BENCHMARK_FILES files in each (default 20). Cold caches require dropping them between runs.
+
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/filesystem/TmpDir.h"
+#include "eckit/filesystem/TreeWalker.h"
+#include "eckit/log/Log.h"
+#include "eckit/log/Timer.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void makeTree(const LocalPathName& dir, size_t fanout, size_t depth, size_t files) {
+    for (size_t i = 0; i < files; ++i) {
+        LocalPathName file = dir + "/file." + std::to_string(i);
+        FILE* f            = ::fopen(file.localPath(), "w");
+        ::fclose(f);
+    }
+    if (depth > 0) {
+        for (size_t i = 0; i < fanout; ++i) {
+            LocalPathName sub = dir + "/dir." + std::to_string(i);
+            sub.mkdir();
+            makeTree(sub, fanout, depth - 1, files);
+        }
+    }
+}
+
+static void recurse(const LocalPathName& dir, size_t& count) {
+    std::vector<LocalPathName> files;
+    std::vector<LocalPathName> dirs;
+    dir.children(files, dirs);
+    count += files.size() + dirs.size();
+    for (const auto& d : dirs) {
+        recurse(d, count);
+    }
+}
+
+class Counter : public TreeVisitor {
+public:
+    void visit(const std::vector<TreeWalker::Entry>& entries) override { count_ += entries.size(); }
+    std::atomic<size_t> count_{0};
+};
+
+static double report(const std::string& name, Timer& timer, size_t count) {
+    double elapsed = timer.elapsed();
+    Log::info() << "    " << name << ": " << count << " entries in " << elapsed << "s, " << size_t(count / elapsed)
+                << " entries/s" << std::endl;
+    return elapsed;
+}
+
+CASE("Walk a synthetic tree") {
+    size_t fanout = Resource<size_t>("$ECKIT_TREE_WALKER_BENCHMARK_FANOUT", 8);
+    size_t files  = Resource<size_t>("$ECKIT_TREE_WALKER_BENCHMARK_FILES", 20);
+
+    TmpDir tmp;
+    LocalPathName root(tmp.localPath());
+    makeTree(root, fanout, 3, files);
+
+    size_t expected = 0;
+    {
+        Timer timer("serial", Log::debug());
+        recurse(root, expected);
+        report("LocalPathName::children, serial", timer, expected);
+    }
+
+    const size_t threads = std::max<size_t>(4, TreeWalker().threads());
+
+    for (size_t n : {size_t(1), threads}) {
+        for (unsigned fields : {unsigned(TreeWalker::TYPE), unsigned(TreeWalker::ALL)}) {
+            Counter counter;
+            Timer timer("walk", Log::debug());
+            TreeWalker(n, fields).walk(root, counter);
+            size_t count = counter.count_;
+            report("TreeWalker, " + std::to_string(n) + " threads, " + (fields == TreeWalker::TYPE ? "type" : "all fields"),
+                   timer, count);
+            EXPECT_EQUAL(count, expected);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,183 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/FileSpaceStrategies.h"
+#include "eckit/filesystem/FileSystemSizeCache.h"
+#include "eckit/filesystem/PathName.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Simulated filesystems: their available space, in bytes, also read by the refresh thread
+static std::mutex mutex;
+static std::map<std::string, unsigned long long> available;
+
+static void set(std::map<std::string, unsigned long long> sizes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    available = sizes;
+}
+
+static void set(const std::string& path, unsigned long long size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    available[path] = size;
+}
+
+static std::atomic<size_t> calls(0);
+static std::atomic<size_t> callsFromMain(0);
+static const std::thread::id mainThread = std::this_thread::get_id();
+
+static void stat(const PathName& path, FileSystemSize& fs) {
+    calls++;
+    if (std::this_thread::get_id() == mainThread) {
+        callsFromMain++;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto j = available.find(path.asString());
+    if (j == available.end()) {
+        throw FailedSystemCall("statvfs(" + path.asString() + ")");
+    }
+    fs.available = j->second;
+    fs.total     = 1000000;
+}
+
+static FileSystemSizeCache& cache() {
+    FileSystemSizeCache& cache = FileSystemSizeCache::instance();
+    cache.stat(&stat);
+    calls         = 0;
+    callsFromMain = 0;
+    return cache;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Sizes are read every time without a maximum age") {
+    set({{"/fs/a", 1000}});
+    FileSystemSizeCache& c = cache();
+
+    FileSystemSize fs;
+    for (size_t i = 0; i < 5; ++i) {
+        c.fileSystemSize("/fs/a", fs, 0);
+    }
+    EXPECT(fs.available == 1000);
+    EXPECT(callsFromMain == 5);
+}
+
+CASE("Sizes are cached up to their maximum age") {
+    set({{"/fs/a", 1000}});
+    FileSystemSizeCache& c = cache();
+
+    FileSystemSize fs;
+    for (size_t i = 0; i < 5; ++i) {
+        c.fileSystemSize("/fs/a", fs, 100);
+    }
+    EXPECT(callsFromMain == 1);
+
+    set("/fs/a", 2000);
+    c.fileSystemSize("/fs/a", fs, 100);
+    EXPECT(fs.available == 1000);
+
+    c.clear();
+    c.fileSystemSize("/fs/a", fs, 100);
+    EXPECT(fs.available == 2000);
+}
+
+CASE("Sizes in use are refreshed in the background") {
+    set({{"/fs/b", 1000}});
+    FileSystemSizeCache& c = cache();
+
+    FileSystemSize fs;
+    c.fileSystemSize("/fs/b", fs, 0.2);
+    EXPECT(callsFromMain == 1);
+
+    set("/fs/b", 3000);
+
+    // Refreshed every 0.1s, the size never gets older than 0.2s
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (std::chrono::steady_clock::now() < end) {
+        c.fileSystemSize("/fs/b", fs, 0.2);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    EXPECT(fs.available == 3000);
+    EXPECT(calls > callsFromMain);
+}
+
+CASE("Reserved bytes are deducted until the next read") {
+    set({{"/fs/a", 1000}});
+    FileSystemSizeCache& c = cache();
+
+    FileSystemSize fs;
+    c.fileSystemSize("/fs/a", fs, 100);
+
+    c.reserve("/fs/a", 300);
+    c.fileSystemSize("/fs/a", fs, 100);
+    EXPECT(fs.available == 700);
+
+    c.reserve("/fs/a", 800);
+    c.fileSystemSize("/fs/a", fs, 100);
+    EXPECT(fs.available == 0);
+    EXPECT(fs.total == 1000000);
+
+    c.clear();
+    c.fileSystemSize("/fs/a", fs, 100);
+    EXPECT(fs.available == 1000);
+}
+
+CASE("Errors are not cached") {
+    set({});
+    FileSystemSizeCache& c = cache();
+
+    FileSystemSize fs;
+    EXPECT_THROWS_AS(c.fileSystemSize("/fs/missing", fs, 100), FailedSystemCall);
+    EXPECT_THROWS_AS(c.fileSystemSize("/fs/missing", fs, 100), FailedSystemCall);
+    EXPECT(callsFromMain == 2);
+}
+
+CASE("Strategies select from cached sizes") {
+    set({{"/fs/a", 1000}, {"/fs/b", 3000}, {"/fs/c", 2000}});
+    FileSystemSizeCache& c = cache();
+
+    std::vector<PathName> fileSystems{"/fs/a", "/fs/b", "/fs/missing", "/fs/c"};
+
+    EXPECT(FileSpaceStrategies::leastUsed(fileSystems, 100) == PathName("/fs/b"));
+    EXPECT(callsFromMain == 4);
+
+    EXPECT(FileSpaceStrategies::leastUsed(fileSystems, 100) == PathName("/fs/b"));
+    EXPECT(callsFromMain == 5);  // Only the failed one is read again
+
+    // Bytes handed out on /fs/b make /fs/c the least used
+    c.reserve("/fs/b", 1500);
+    EXPECT(FileSpaceStrategies::leastUsed(fileSystems, 100) == PathName("/fs/c"));
+    EXPECT(FileSpaceStrategies::selectFileSystem(fileSystems, "leastUsed", 100) == PathName("/fs/c"));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,319 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/filesystem/TmpDir.h"
+#include "eckit/filesystem/TreeWalker.h"
+#include "eckit/os/Stat.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/Mutex.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/// Creates a tree of the given fanout and depth, with files regular files in each directory, file.i of i bytes
+void makeTree(const LocalPathName& dir, size_t fanout, size_t depth, size_t files) {
+    for (size_t i = 0; i < files; ++i) {
+        LocalPathName file = dir + "/file." + std::to_string(i);
+        std::string data(i, 'x');
+        FILE* f = ::fopen(file.localPath(), "w");
+        ::fwrite(data.data(), 1, data.size(), f);
+        ::fclose(f);
+    }
+    if (depth > 0) {
+        for (size_t i = 0; i < fanout; ++i) {
+            LocalPathName sub = dir + "/dir." + std::to_string(i);
+            sub.mkdir();
+            makeTree(sub, fanout, depth - 1, files);
+        }
+    }
+}
+
+class Recorder : public TreeVisitor {
+public:
+    explicit Recorder(const std::string& skip = "") : skip_(skip) {}
+
+    bool enter(const TreeWalker::Entry& e) override { return skip_.empty() || e.name() != skip_; }
+
+    void visit(const std::vector<TreeWalker::Entry>& entries) override {
+        AutoLock<Mutex> lock(mutex_);
+        for (const auto& e : entries) {
+            entries_[e.path] = e;
+        }
+    }
+
+    std::map<std::string, TreeWalker::Entry> entries_;
+
+private:
+    std::string skip_;
+    Mutex mutex_;
+};
+
+class Thrower : public TreeVisitor {
+    void visit(const std::vector<TreeWalker::Entry>&) override { throw UserError("Thrower"); }
+};
+
+/// Removes the directories named victim as it sees them, before the walker opens them
+class Remover : public Recorder {
+public:
+    Remover(const std::string& victim, bool skip) :
+        victim_(victim), skip_(skip) {}
+
+    void visit(const std::vector<TreeWalker::Entry>& entries) override {
+        Recorder::visit(entries);
+        for (const auto& e : entries) {
+            if (e.name() == victim_) {
+                LocalPathName(e.path).rmdir();
+            }
+        }
+    }
+
+    bool skip(const std::string& path, int error) override {
+        AutoLock<Mutex> lock(mutex_);
+        skipped_.emplace_back(path, error);
+        return skip_;
+    }
+
+    std::vector<std::pair<std::string, int>> skipped_;
+
+private:
+    std::string victim_;
+    bool skip_;
+    Mutex mutex_;
+};
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Walk a tree") {
+    TmpDir tmp;
+    LocalPathName root(tmp.localPath());
+
+    makeTree(root, 3, 3, 2);
+    ::symlink("dir.0", (root + "/link").localPath());
+
+    const size_t dirs  = 3 + 9 + 27;
+    const size_t files = 2 * (1 + dirs);
+
+    for (size_t threads : {1, 4}) {
+        SECTION("Threads " + std::to_string(threads)) {
+            Recorder r;
+            TreeWalker(threads).walk(root, r);
+
+            size_t d = 0;
+            size_t f = 0;
+            size_t l = 0;
+            for (const auto& e : r.entries_) {
+                d += e.second.type == TreeWalker::DIRECTORY;
+                f += e.second.type == TreeWalker::REGULAR;
+                l += e.second.type == TreeWalker::LINK;
+            }
+
+            EXPECT_EQUAL(d, dirs);
+            EXPECT_EQUAL(f, files);
+            EXPECT_EQUAL(l, 1);
+
+            const auto& e = r.entries_.at(root.path() + "/dir.1/dir.2/file.1");
+            EXPECT_EQUAL(e.depth, 3);
+            EXPECT_EQUAL(e.name(), "file.1");
+        }
+    }
+}
+
+CASE("Do not enter directories") {
+    TmpDir tmp;
+    LocalPathName root(tmp.localPath());
+
+    makeTree(root, 3, 2, 1);
+
+    Recorder r("dir.1");
+    TreeWalker(4).walk(root, r);
+
+    // dir.1 is reported but not walked, at both levels
+    EXPECT(r.entries_.count(root.path() + "/dir.1"));
+    EXPECT(!r.entries_.count(root.path() + "/dir.1/file.0"));
+    EXPECT(r.entries_.count(root.path() + "/dir.0/dir.1"));
+    EXPECT(!r.entries_.count(root.path() + "/dir.0/dir.1/file.0"));
+    size_t count = r.entries_.size();
+    EXPECT_EQUAL(count, 1 + 3 + 2 * (1 + 3 + 2));
+}
+
+CASE("Fields") {
+    TmpDir tmp;
+    LocalPathName root(tmp.localPath());
+
+    makeTree(root, 1, 1, 4);
+
+    Recorder type;
+    TreeWalker(2).walk(root, type);
+    unsigned long long size = type.entries_.at(root.path() + "/file.3").size;
+    EXPECT_EQUAL(size, 0);
+
+    Recorder all;
+    TreeWalker(2, TreeWalker::ALL).walk(root, all);
+
+    for (const auto& e : all.entries_) {
+        Stat::Struct s;
+        EXPECT(Stat::lstat(e.first.c_str(), &s) == 0);
+        EXPECT_EQUAL(e.second.inode, s.st_ino);
+        EXPECT_EQUAL(e.second.mode, s.st_mode);
+        EXPECT_EQUAL(e.second.size, (unsigned long long)s.st_size);
+        EXPECT_EQUAL(e.second.links, s.st_nlink);
+        EXPECT_EQUAL(e.second.lastModified, s.st_mtime);
+    }
+}
+
+CASE("Small queue and buffer") {
+    TmpDir tmp;
+    LocalPathName root(tmp.localPath());
+
+    makeTree(root, 4, 3, 50);
+
+    TreeWalker walker(4);
+    walker.maxQueued(1);
+    walker.bufferSize(4096);
+
+    Recorder r;
+    walker.walk(root, r);
+    size_t count = r.entries_.size();
+    EXPECT_EQUAL(count, (4 + 16 + 64) + 50 * (1 + 4 + 16 + 64));
+}
+
+CASE("Directories larger than the buffer") {
+    TmpDir tmp;
+    LocalPathName root(tmp.localPath());
+
+    // Many buffers of 4 KiB, none of the entries lost or repeated at their boundaries
+    makeTree(root, 0, 0, 2000);
+
+    TreeWalker walker(1);
+    walker.bufferSize(4096);
+
+    Recorder r;
+    walker.walk(root, r);
+    size_t count = r.entries_.size();
+    EXPECT_EQUAL(count, 2000);
+}
+
+CASE("Exceptions from the visitor are rethrown") {
+    TmpDir tmp;
+    LocalPathName root(tmp.localPath());
+
+    makeTree(root, 3, 3, 1);
+
+    Thrower t;
+    EXPECT_THROWS_AS(TreeWalker(1).walk(root, t), UserError);
+    EXPECT_THROWS_AS(TreeWalker(4).walk(root, t), UserError);
+
+    Recorder r;
+    EXPECT_THROWS_AS(TreeWalker(4).walk(root + "/missing", r), FailedSystemCall);
+}
+
+CASE("Directories that cannot be read stop the walk, unless skipped") {
+    TmpDir tmp;
+    LocalPathName root(tmp.localPath());
+
+    makeTree(root, 2, 1, 1);
+    (root + "/empty").mkdir();
+
+    // With one thread, subdirectories are opened once their parent is read and visited
+    {
+        Remover r("empty", false);
+        EXPECT_THROWS_AS(TreeWalker(1).walk(root, r), FailedSystemCall);
+        size_t skipped = r.skipped_.size();
+        EXPECT_EQUAL(skipped, 1);
+    }
+
+    (root + "/empty").mkdir();
+    {
+        Remover r("empty", true);
+        TreeWalker(1).walk(root, r);
+        size_t skipped = r.skipped_.size();
+        EXPECT_EQUAL(skipped, 1);
+        std::string path = r.skipped_[0].first;
+        int error        = r.skipped_[0].second;
+        EXPECT_EQUAL(path, root.path() + "/empty");
+        EXPECT_EQUAL(error, ENOENT);
+        EXPECT(r.entries_.count(root.path() + "/dir.1/file.0"));
+    }
+}
+
+CASE("childrenRecursive is unchanged") {
+    TmpDir tmp;
+    LocalPathName root(tmp.localPath());
+
+    makeTree(root, 3, 3, 3);
+
+    std::vector<PathName> files;
+    std::vector<PathName> dirs;
+    tmp.childrenRecursive(files, dirs);
+
+    // Serial recursion, as before
+    std::vector<LocalPathName> expectFiles;
+    std::vector<LocalPathName> expectDirs;
+    std::vector<LocalPathName> todo{root};
+    while (!todo.empty()) {
+        LocalPathName dir = todo.back();
+        todo.pop_back();
+        std::vector<LocalPathName> d;
+        dir.children(expectFiles, d);
+        expectDirs.insert(expectDirs.end(), d.begin(), d.end());
+        todo.insert(todo.end(), d.begin(), d.end());
+    }
+
+    std::sort(expectFiles.begin(), expectFiles.end());
+    std::sort(expectDirs.begin(), expectDirs.end());
+
+    EXPECT_EQUAL(files.size(), expectFiles.size());
+    EXPECT_EQUAL(dirs.size(), expectDirs.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        EXPECT_EQUAL(files[i].asString(), expectFiles[i].path());
+    }
+    for (size_t i = 0; i < dirs.size(); ++i) {
+        EXPECT_EQUAL(dirs[i].asString(), expectDirs[i].path());
+    }
+
+    // Parents come before their children
+    EXPECT(std::is_sorted(dirs.begin(), dirs.end()));
+
+    // The same with several threads, when asked for
+    std::vector<PathName> parallelFiles;
+    std::vector<PathName> parallelDirs;
+    tmp.childrenRecursive(parallelFiles, parallelDirs, 4);
+    EXPECT(parallelFiles == files);
+    EXPECT(parallelDirs == dirs);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
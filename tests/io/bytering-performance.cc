@@ -0,0 +1,210 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Hands data over from a thread reading it to a thread writing it, in chunks of several sizes, through the existing
+// handoffs (DblBuffer, AsyncHandle) and through a ByteRing, in place and with ByteRingHandle. The reading and the
+// writing both touch the data, without I/O. The size can be set with ECKIT_BYTE_RING_PERFORMANCE_SIZE.
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "eckit/config/Resource.h"
+#include "eckit/io/AsyncHandle.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/ByteRing.h"
+#include "eckit/io/ByteRingHandle.h"
+#include "eckit/io/DblBuffer.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Timer.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Produces size bytes
+class SourceHandle : public DataHandle {
+public:
+    explicit SourceHandle(size_t size) :
+        pattern_(1024 * 1024), size_(size), position_(0) {
+        for (size_t i = 0; i < pattern_.size(); ++i) {
+            pattern_[i] = char(i);
+        }
+    }
+
+    void print(std::ostream& s) const override { s << "SourceHandle[]"; }
+    Length openForRead() override {
+        position_ = 0;
+        return size_;
+    }
+    long read(void* buffer, long length) override {
+        size_t n = std::min({size_t(length), size_ - position_, pattern_.size()});
+        ::memcpy(buffer, pattern_, n);
+        position_ += n;
+        return long(n);
+    }
+    void close() override {}
+    Length estimate() override { return size_; }
+
+private:
+    Buffer pattern_;
+    size_t size_;
+    size_t position_;
+};
+
+/// Reads every byte written
+class SinkHandle : public DataHandle {
+public:
+    void print(std::ostream& s) const override { s << "SinkHandle[]"; }
+    void openForWrite(const Length&) override {}
+    long write(const void* buffer, long length) override {
+        const unsigned char* p = static_cast<const unsigned char*>(buffer);
+        for (long i = 0; i < length; ++i) {
+            sum_ += p[i];
+        }
+        bytes_ += size_t(length);
+        return length;
+    }
+    void close() override {}
+    void flush() override {}
+
+    size_t bytes() const { return bytes_; }
+
+private:
+    size_t bytes_      = 0;
+    unsigned long sum_ = 0;
+};
+
+static void report(const std::string& name, size_t bytes, Timer& timer) {
+    std::cout << "    " << std::setw(40) << std::left << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(3) << timer.elapsed() << " s  " << Bytes(bytes, timer) << std::endl;
+}
+
+CASE("Handing data over between threads") {
+    size_t size = Resource<size_t>("$ECKIT_BYTE_RING_PERFORMANCE_SIZE", 1024 * 1024 * 1024);
+
+    for (size_t chunk : {size_t(4 * 1024), size_t(64 * 1024), size_t(1024 * 1024)}) {
+        std::cout << Bytes(size) << " in chunks of " << Bytes(chunk) << std::endl;
+
+        {
+            SourceHandle source(size);
+            SinkHandle sink;
+            Timer timer("DblBuffer", std::cout);
+            DblBuffer buffer(8, long(chunk));
+            buffer.copy(source, sink);
+            timer.stop();
+            ASSERT(sink.bytes() == size);
+            report("DblBuffer", size, timer);
+        }
+
+        {
+            SourceHandle source(size);
+            SinkHandle sink;
+            Timer timer("AsyncHandle", std::cout);
+            {
+                AsyncHandle async(sink, 8 * chunk, chunk);
+                Buffer buffer(chunk);
+                source.openForRead();
+                async.openForWrite(size);
+                long n;
+                while ((n = source.read(buffer, long(chunk))) > 0) {
+                    async.write(buffer, n);
+                }
+                async.close();
+            }
+            timer.stop();
+            ASSERT(sink.bytes() == size);
+            report("AsyncHandle", size, timer);
+        }
+
+        {
+            SourceHandle source(size);
+            SinkHandle sink;
+            Timer timer("ByteRing", std::cout);
+            ByteRing ring(8 * chunk);
+
+            std::thread producer([&] {
+                source.openForRead();
+                for (;;) {
+                    char* data;
+                    size_t n = std::min(ring.reserve(data), chunk);
+                    long r   = source.read(data, long(n));
+                    if (r <= 0) {
+                        break;
+                    }
+                    ring.commit(size_t(r));
+                }
+                ring.closeWrite();
+            });
+
+            const char* data;
+            size_t n;
+            while ((n = ring.peek(data)) > 0) {
+                n = std::min(n, chunk);
+                sink.write(data, long(n));
+                ring.consume(n);
+            }
+            producer.join();
+            timer.stop();
+            ASSERT(sink.bytes() == size);
+            report("ByteRing in place", size, timer);
+        }
+
+        {
+            SourceHandle source(size);
+            SinkHandle sink;
+            Timer timer("ByteRingHandle", std::cout);
+            ByteRing ring(8 * chunk);
+
+            std::thread producer([&] {
+                ByteRingHandle out(ring);
+                Buffer buffer(chunk);
+                source.openForRead();
+                out.openForWrite(size);
+                long n;
+                while ((n = source.read(buffer, long(chunk))) > 0) {
+                    out.write(buffer, n);
+                }
+                out.close();
+            });
+
+            ByteRingHandle in(ring);
+            Buffer buffer(chunk);
+            in.openForRead();
+            long n;
+            while ((n = in.read(buffer, long(chunk))) > 0) {
+                sink.write(buffer, n);
+            }
+            in.close();
+            producer.join();
+            timer.stop();
+            ASSERT(sink.bytes() == size);
+            report("ByteRingHandle", size, timer);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,144 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Reads small parts of many files in the page cache from several threads: opening the file for each read, lending
+// a descriptor to one thread at a time as FilePool does, and sharing descriptors with FileDescriptorPool. The number
+// of files and of reads per thread can be set with ECKIT_FD_POOL_PERFORMANCE_FILES and ECKIT_FD_POOL_PERFORMANCE_READS.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/FileDescriptorPool.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Timer.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static const size_t fileSize = 1024 * 1024;
+static const size_t partSize = 4096;
+
+static void report(const std::string& name, size_t bytes, Timer& timer) {
+    std::cout << "    " << std::setw(40) << std::left << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(3) << timer.elapsed() << " s  " << Bytes(bytes, timer) << std::endl;
+}
+
+/// Each thread reads parts of random files, with read(file, buffer, offset)
+static void run(const std::string& name, size_t threads, size_t reads, size_t files,
+                const std::function<void(size_t, char*, off_t)>& read) {
+    Timer timer(name, std::cout);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 random(t);
+            char buffer[partSize];
+            for (size_t i = 0; i < reads; ++i) {
+                read(random() % files, buffer, off_t(random() % (fileSize / partSize) * partSize));
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    timer.stop();
+
+    std::ostringstream s;
+    s << name << " threads=" << threads;
+    report(s.str(), threads * reads * partSize, timer);
+}
+
+CASE("Reads of many files from many threads") {
+    size_t files = Resource<size_t>("$ECKIT_FD_POOL_PERFORMANCE_FILES", 256);
+    size_t reads = Resource<size_t>("$ECKIT_FD_POOL_PERFORMANCE_READS", 20000);
+
+    std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+
+    std::vector<PathName> paths;
+    Buffer data(fileSize);
+    for (size_t i = 0; i < files; ++i) {
+        paths.push_back(PathName::unique(base + "/filedescriptorpool-performance"));
+        FileHandle f(paths.back());
+        f.openForWrite(0);
+        f.write(data, long(data.size()));
+        f.close();
+    }
+
+    std::cout << files << " files of " << Bytes(fileSize) << ", reads of " << Bytes(partSize) << std::endl;
+
+    for (size_t threads : {1, 4, 16}) {
+        run("open per read", threads, reads, files, [&](size_t f, char* buffer, off_t offset) {
+            int fd = ::open(paths[f].localPath(), O_RDONLY);
+            ASSERT(fd >= 0);
+            ASSERT(::pread(fd, buffer, partSize, offset) == ssize_t(partSize));
+            ::close(fd);
+        });
+
+        {
+            // One descriptor per file, lent to one thread at a time
+            std::vector<int> fds;
+            for (auto& p : paths) {
+                fds.push_back(::open(p.localPath(), O_RDONLY));
+            }
+            std::vector<std::mutex> mutexes(files);
+            run("exclusive checkout", threads, reads, files, [&](size_t f, char* buffer, off_t offset) {
+                std::lock_guard<std::mutex> lock(mutexes[f]);
+                ASSERT(::lseek(fds[f], offset, SEEK_SET) == offset);
+                ASSERT(::read(fds[f], buffer, partSize) == ssize_t(partSize));
+            });
+            for (int fd : fds) {
+                ::close(fd);
+            }
+        }
+
+        for (size_t capacity : {files, files / 4}) {
+            FileDescriptorPool pool(capacity);
+            std::ostringstream name;
+            name << "FileDescriptorPool capacity=" << capacity;
+            run(name.str(), threads, reads, files, [&](size_t f, char* buffer, off_t offset) {
+                ASSERT(pool.read(paths[f], buffer, partSize, offset) == long(partSize));
+            });
+            std::cout << "      " << pool << std::endl;
+        }
+    }
+
+    for (auto& p : paths) {
+        p.unlink(false);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,209 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Reads a large file sequentially and at random offsets with FileHandle, PooledHandle and MMappedFileHandle, from
+// the disk and from the page cache. The size of the file and the number of random reads can be set with
+// ECKIT_MMAP_HANDLE_PERFORMANCE_SIZE and ECKIT_MMAP_HANDLE_PERFORMANCE_READS.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/io/MMappedFileHandle.h"
+#include "eckit/io/PooledHandle.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Timer.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void dropCache(const PathName& path) {
+#if defined(POSIX_FADV_DONTNEED)
+    int fd = ::open(path.localPath(), O_RDONLY);
+    ASSERT(fd >= 0);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+#endif
+}
+
+static void report(const std::string& name, size_t bytes, Timer& timer) {
+    std::cout << "    " << std::setw(40) << std::left << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(3) << timer.elapsed() << " s  " << Bytes(bytes, timer) << std::endl;
+}
+
+static size_t readAt(DataHandle& h, const std::vector<size_t>& offsets, Buffer& buffer) {
+    size_t total = 0;
+    for (size_t offset : offsets) {
+        h.seek(offset);
+        total += h.read(buffer, long(buffer.size()));
+    }
+    return total;
+}
+
+/// Keeps the pages touched by viewAt() from being optimised away
+static volatile unsigned char sink = 0;
+
+static size_t viewAt(MMappedFileHandle& h, const std::vector<size_t>& offsets, size_t length) {
+    size_t total     = 0;
+    unsigned char xs = 0;
+    for (size_t offset : offsets) {
+        h.seek(offset);
+        const void* data;
+        long n = h.view(data, long(length));
+        // Touch the pages, as a reader would
+        for (long i = 0; i < n; i += 4096) {
+            xs ^= static_cast<const unsigned char*>(data)[i];
+        }
+        total += n;
+    }
+    sink = static_cast<unsigned char>(sink ^ xs);
+    return total;
+}
+
+CASE("Sequential and random reads") {
+    size_t size  = Resource<size_t>("$ECKIT_MMAP_HANDLE_PERFORMANCE_SIZE", 512 * 1024 * 1024);
+    size_t reads = Resource<size_t>("$ECKIT_MMAP_HANDLE_PERFORMANCE_READS", 20000);
+
+    std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+    PathName path    = PathName::unique(base + "/mmappedfilehandle-performance");
+
+    Buffer buffer(1024 * 1024);
+    {
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            buffer[i] = char(i * 7);
+        }
+        FileHandle f(path);
+        f.openForWrite(0);
+        for (size_t done = 0; done < size; done += buffer.size()) {
+            f.write(buffer, long(buffer.size()));
+        }
+        f.close();
+    }
+
+    std::cout << Bytes(size) << ", " << reads << " random reads of 64 Kbytes" << std::endl;
+
+    using Access = MMappedFileHandle::Access;
+
+    std::vector<std::pair<std::string, std::function<DataHandle*()>>> handles{
+        {"FileHandle", [&] { return new FileHandle(path); }},
+        {"PooledHandle", [&] { return new PooledHandle(path); }},
+        {"MMappedFileHandle", [&] { return new MMappedFileHandle(path); }},
+        {"MMappedFileHandle window=64M",
+         [&] {
+             auto* h = new MMappedFileHandle(path);
+             h->window(64 * 1024 * 1024);
+             return h;
+         }},
+    };
+
+    for (bool cold : {true, false}) {
+        std::cout << (cold ? "  From the disk" : "  From the page cache") << std::endl;
+
+        for (auto& h : handles) {
+            if (cold) {
+                dropCache(path);
+            }
+            std::unique_ptr<DataHandle> handle(h.second());
+            Timer timer("sequential", std::cout);
+            handle->openForRead();
+            size_t total = 0;
+            long n;
+            while ((n = handle->read(buffer, long(buffer.size()))) > 0) {
+                total += n;
+            }
+            handle->close();
+            timer.stop();
+            EXPECT(total == size);
+            report("sequential " + h.first, size, timer);
+        }
+
+        {
+            if (cold) {
+                dropCache(path);
+            }
+            MMappedFileHandle handle(path);
+            Timer timer("sequential", std::cout);
+            handle.openForRead();
+            std::vector<size_t> offsets;
+            for (size_t offset = 0; offset < size; offset += buffer.size()) {
+                offsets.push_back(offset);
+            }
+            EXPECT(viewAt(handle, offsets, buffer.size()) == size);
+            handle.close();
+            timer.stop();
+            report("sequential MMappedFileHandle view", size, timer);
+        }
+
+        std::mt19937_64 random(42);
+        std::vector<size_t> offsets(reads);
+        for (auto& offset : offsets) {
+            offset = random() % (size - 64 * 1024);
+        }
+        Buffer part(64 * 1024);
+
+        for (auto& h : handles) {
+            if (cold) {
+                dropCache(path);
+            }
+            std::unique_ptr<DataHandle> handle(h.second());
+            if (auto* m = dynamic_cast<MMappedFileHandle*>(handle.get())) {
+                m->access(Access::Random);
+            }
+            Timer timer("random", std::cout);
+            handle->openForRead();
+            EXPECT(readAt(*handle, offsets, part) == reads * part.size());
+            handle->close();
+            timer.stop();
+            report("random " + h.first, reads * part.size(), timer);
+        }
+
+        {
+            if (cold) {
+                dropCache(path);
+            }
+            MMappedFileHandle handle(path);
+            handle.access(Access::Random);
+            Timer timer("random", std::cout);
+            handle.openForRead();
+            EXPECT(viewAt(handle, offsets, part.size()) == reads * part.size());
+            handle.close();
+            timer.stop();
+            report("random MMappedFileHandle view", reads * part.size(), timer);
+        }
+    }
+
+    path.unlink(false);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
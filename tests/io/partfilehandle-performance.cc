@@ -0,0 +1,144 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Reads random parts of a large file, with PartFileHandle and with RangeReader, after dropping the file from the
+// page cache. The size of the file and the number of parts can be set with ECKIT_PART_FILE_HANDLE_PERFORMANCE_SIZE
+// and ECKIT_PART_FILE_HANDLE_PERFORMANCE_PARTS.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/io/PartFileHandle.h"
+#include "eckit/io/RangeReader.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Timer.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void dropCache(const PathName& path) {
+#if defined(POSIX_FADV_DONTNEED)
+    int fd = ::open(path.localPath(), O_RDONLY);
+    ASSERT(fd >= 0);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+#endif
+}
+
+static void report(const std::string& name, size_t bytes, Timer& timer, size_t requests = 0) {
+    std::cout << "    " << std::setw(40) << std::left << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(3) << timer.elapsed() << " s  " << Bytes(bytes, timer);
+    if (requests) {
+        std::cout << "  (" << requests << " requests)";
+    }
+    std::cout << std::endl;
+}
+
+CASE("Random parts of a large file") {
+    size_t size  = Resource<size_t>("$ECKIT_PART_FILE_HANDLE_PERFORMANCE_SIZE", size_t(2) * 1024 * 1024 * 1024);
+    size_t parts = Resource<size_t>("$ECKIT_PART_FILE_HANDLE_PERFORMANCE_PARTS", 5000);
+
+    std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+    PathName path    = PathName::unique(base + "/partfilehandle-performance");
+    path += ".dat";
+
+    {
+        Buffer buffer(8 * 1024 * 1024);
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            buffer[i] = char(i);
+        }
+        FileHandle f(path);
+        f.openForWrite(0);
+        for (size_t done = 0; done < size; done += buffer.size()) {
+            f.write(buffer, long(std::min(buffer.size(), size - done)));
+        }
+        f.close();
+    }
+
+    // Fields of 4 KiB to 64 KiB, in no particular order
+    std::mt19937_64 random(42);
+    OffsetList offsets;
+    LengthList lengths;
+    size_t total = 0;
+    for (size_t i = 0; i < parts; ++i) {
+        size_t length = 4096 + random() % (60 * 1024);
+        offsets.push_back(random() % (size - length));
+        lengths.push_back(length);
+        total += length;
+    }
+
+    std::cout << parts << " parts, " << Bytes(total) << " of a file of " << Bytes(size) << std::endl;
+
+    Buffer buffer(total);
+
+    {
+        dropCache(path);
+        Timer timer("PartFileHandle", std::cout);
+        PartFileHandle h(path, offsets, lengths);
+        h.openForRead();
+        EXPECT(h.read(buffer, long(total)) == long(total));
+        h.close();
+        timer.stop();
+        report(h.rangeReads() ? "PartFileHandle (RangeReader)" : "PartFileHandle", total, timer);
+    }
+
+    int fd = ::open(path.localPath(), O_RDONLY);
+    ASSERT(fd >= 0);
+
+    std::vector<RangeReader::Range> ranges;
+    char* p = buffer;
+    for (size_t i = 0; i < parts; ++i) {
+        ranges.push_back(RangeReader::Range{fd, off_t((long long)offsets[i]), size_t(lengths[i]), p, &path});
+        p += size_t(lengths[i]);
+    }
+
+    for (size_t threads : {1, 8, 32}) {
+        for (size_t gap : {size_t(0), size_t(64 * 1024), size_t(1024 * 1024)}) {
+            dropCache(path);
+            Timer timer("RangeReader", std::cout);
+            RangeReader reader(threads, gap, 8 * 1024 * 1024);
+            reader.read(ranges);
+            timer.stop();
+
+            std::ostringstream name;
+            name << "RangeReader threads=" << threads << " gap=" << Bytes(gap);
+            report(name.str(), total, timer, reader.nbRequests());
+        }
+    }
+
+    ::close(fd);
+    path.unlink(false);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,234 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Runs four stages, as decode, filter, checksum and encode, between a source and a sink handle: one after the other
+// on a single thread, as nested handles do, and with a StagedPipeline, with a thread per stage and with shared threads.
+// The size can be set with ECKIT_STAGED_PIPELINE_PERFORMANCE_SIZE, and the shared threads with
+// ECKIT_STAGED_PIPELINE_PERFORMANCE_THREADS.
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/DataHandle.h"
+#include "eckit/io/StagedPipeline.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Timer.h"
+#include "eckit/utils/MD5.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Produces size bytes
+class SourceHandle : public DataHandle {
+public:
+    explicit SourceHandle(size_t size) :
+        pattern_(1024 * 1024), size_(size), position_(0) {
+        for (size_t i = 0; i < pattern_.size(); ++i) {
+            pattern_[i] = char(i % 7);
+        }
+    }
+
+    void print(std::ostream& s) const override { s << "SourceHandle[]"; }
+    Length openForRead() override {
+        position_ = 0;
+        return size_;
+    }
+    long read(void* buffer, long length) override {
+        size_t n = std::min({size_t(length), size_ - position_, pattern_.size()});
+        ::memcpy(buffer, pattern_, n);
+        position_ += n;
+        return long(n);
+    }
+    void close() override {}
+    Length estimate() override { return size_; }
+
+private:
+    Buffer pattern_;
+    size_t size_;
+    size_t position_;
+};
+
+class SinkHandle : public DataHandle {
+public:
+    void print(std::ostream& s) const override { s << "SinkHandle[]"; }
+    void openForWrite(const Length&) override {}
+    long write(const void*, long length) override { return length; }
+    void close() override {}
+    void flush() override {}
+};
+
+/// Running sums of the bytes, in place
+class DecodeStage : public PipelineStage {
+public:
+    DecodeStage() :
+        PipelineStage("decode") {}
+    void process(Buffer&& buffer, size_t size, Output& out) override {
+        unsigned char* p = reinterpret_cast<unsigned char*>(buffer.data());
+        for (size_t i = 0; i < size; ++i) {
+            last_ = p[i] = static_cast<unsigned char>(last_ + p[i]);
+        }
+        out.emit(std::move(buffer), size);
+    }
+
+private:
+    unsigned char last_ = 0;
+};
+
+/// Scales the bytes, in place
+class FilterStage : public PipelineStage {
+public:
+    FilterStage() :
+        PipelineStage("filter") {}
+    void process(Buffer&& buffer, size_t size, Output& out) override {
+        unsigned char* p = reinterpret_cast<unsigned char*>(buffer.data());
+        for (size_t i = 0; i < size; ++i) {
+            p[i] = static_cast<unsigned char>((p[i] * 3 + 1) >> 1);
+        }
+        out.emit(std::move(buffer), size);
+    }
+};
+
+class ChecksumStage : public PipelineStage {
+public:
+    ChecksumStage() :
+        PipelineStage("checksum") {}
+    void process(Buffer&& buffer, size_t size, Output& out) override {
+        md5_.update(buffer.data(), long(size));
+        out.emit(std::move(buffer), size);
+    }
+
+private:
+    MD5 md5_;
+};
+
+/// Differences of the bytes, into a new buffer
+class EncodeStage : public PipelineStage {
+public:
+    EncodeStage() :
+        PipelineStage("encode") {}
+    void process(Buffer&& buffer, size_t size, Output& out) override {
+        Buffer encoded(size);
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(buffer.data());
+        unsigned char* q       = reinterpret_cast<unsigned char*>(encoded.data());
+        for (size_t i = 0; i < size; ++i) {
+            q[i]  = static_cast<unsigned char>(p[i] - last_);
+            last_ = p[i];
+        }
+        out.emit(std::move(encoded), size);
+    }
+
+private:
+    unsigned char last_ = 0;
+};
+
+static std::vector<std::unique_ptr<PipelineStage>> stages() {
+    std::vector<std::unique_ptr<PipelineStage>> s;
+    s.emplace_back(new DecodeStage());
+    s.emplace_back(new FilterStage());
+    s.emplace_back(new ChecksumStage());
+    s.emplace_back(new EncodeStage());
+    return s;
+}
+
+/// Calls the next stage directly, as nested handles do
+class Chain : public PipelineStage::Output {
+public:
+    Chain(std::vector<std::unique_ptr<PipelineStage>>& stages, size_t index, DataHandle& out) :
+        stages_(stages), index_(index), out_(out) {}
+
+    void emit(Buffer&& buffer, size_t size) override {
+        if (index_ == stages_.size()) {
+            out_.write(buffer, long(size));
+            return;
+        }
+        Chain next(stages_, index_ + 1, out_);
+        stages_[index_]->process(std::move(buffer), size, next);
+    }
+
+private:
+    std::vector<std::unique_ptr<PipelineStage>>& stages_;
+    size_t index_;
+    DataHandle& out_;
+};
+
+static void report(const std::string& name, size_t bytes, Timer& timer) {
+    std::cout << "    " << std::setw(40) << std::left << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(3) << timer.elapsed() << " s  " << Bytes(bytes, timer) << std::endl;
+}
+
+CASE("Four stages") {
+    size_t size    = Resource<size_t>("$ECKIT_STAGED_PIPELINE_PERFORMANCE_SIZE", 1024 * 1024 * 1024);
+    size_t threads = Resource<size_t>("$ECKIT_STAGED_PIPELINE_PERFORMANCE_THREADS", 2);
+
+    std::cout << Bytes(size) << " through four stages" << std::endl;
+
+    {
+        SourceHandle source(size);
+        SinkHandle sink;
+        auto s = stages();
+        Chain chain(s, 0, sink);
+
+        Timer timer("one thread", std::cout);
+        source.openForRead();
+        for (;;) {
+            Buffer buffer(1024 * 1024);
+            long len = source.read(buffer, long(buffer.size()));
+            if (len <= 0) {
+                break;
+            }
+            chain.emit(std::move(buffer), size_t(len));
+        }
+        timer.stop();
+        report("one thread", size, timer);
+    }
+
+    for (size_t n : {size_t(0), threads}) {
+        SourceHandle source(size);
+        SinkHandle sink;
+
+        StagedPipeline pipeline;
+        pipeline.threads(n);
+        for (auto& stage : stages()) {
+            pipeline.add(stage.release());
+        }
+
+        Timer timer("pipeline", std::cout);
+        pipeline.copy(source, sink);
+        timer.stop();
+
+        std::ostringstream name;
+        name << "StagedPipeline, " << (n ? std::to_string(n) + " shared threads" : "a thread per stage");
+        report(name.str(), size, timer);
+        std::cout << pipeline << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
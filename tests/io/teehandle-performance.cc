@@ -0,0 +1,125 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Writes into a file and into a handle limited in bandwidth, as a remote one, through a TeeHandle writing into them
+// in turn and concurrently. The size written and the bandwidth of the slow handle can be set with
+// ECKIT_TEE_HANDLE_PERFORMANCE_SIZE and ECKIT_TEE_HANDLE_PERFORMANCE_RATE.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/io/TeeHandle.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Timer.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class SlowHandle : public DataHandle {
+public:
+    explicit SlowHandle(size_t rate) :
+        rate_(rate) {}
+
+    void print(std::ostream& s) const override { s << "SlowHandle[]"; }
+    void openForWrite(const Length&) override {}
+    long write(const void*, long length) override {
+        // Each write takes its time, whatever the caller did in between
+        std::this_thread::sleep_for(std::chrono::microseconds(length * 1000000 / rate_));
+        return length;
+    }
+    void close() override {}
+    void flush() override {}
+
+private:
+    size_t rate_;
+};
+
+static void report(const std::string& name, size_t bytes, Timer& timer) {
+    std::cout << "    " << std::setw(40) << std::left << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(3) << timer.elapsed() << " s  " << Bytes(bytes, timer) << std::endl;
+}
+
+CASE("A file and a slow handle") {
+    size_t size = Resource<size_t>("$ECKIT_TEE_HANDLE_PERFORMANCE_SIZE", 512 * 1024 * 1024);
+    size_t rate = Resource<size_t>("$ECKIT_TEE_HANDLE_PERFORMANCE_RATE", 400 * 1024 * 1024);
+
+    std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+    PathName path    = PathName::unique(base + "/teehandle-performance");
+
+    Buffer buffer(1024 * 1024);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = char(i);
+    }
+
+    std::cout << Bytes(size) << ", slow handle at " << Bytes(rate) << " per second" << std::endl;
+
+    {
+        Timer timer("file", std::cout);
+        FileHandle f(path);
+        f.openForWrite(0);
+        for (size_t done = 0; done < size; done += buffer.size()) {
+            f.write(buffer, long(buffer.size()));
+        }
+        f.close();
+        timer.stop();
+        report("file only", size, timer);
+    }
+
+    for (bool concurrent : {false, true}) {
+        for (size_t window : {size_t(4 * 1024 * 1024), size_t(64 * 1024 * 1024)}) {
+            if (!concurrent && window > 4 * 1024 * 1024) {
+                continue;
+            }
+
+            Timer timer("tee", std::cout);
+            TeeHandle tee(new FileHandle(path), new SlowHandle(rate));
+            tee.concurrent(concurrent);
+            tee.window(window);
+            tee.openForWrite(0);
+            for (size_t done = 0; done < size; done += buffer.size()) {
+                tee.write(buffer, long(buffer.size()));
+            }
+            tee.close();
+            timer.stop();
+
+            std::ostringstream name;
+            name << "tee " << (concurrent ? "concurrent" : "in turn");
+            if (concurrent) {
+                name << " window=" << Bytes(window);
+            }
+            report(name.str(), size, timer);
+        }
+    }
+
+    path.unlink(false);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
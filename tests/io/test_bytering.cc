@@ -0,0 +1,199 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <unistd.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "eckit/io/Buffer.h"
+#include "eckit/io/ByteRing.h"
+#include "eckit/io/ByteRingHandle.h"
+#include "eckit/io/MemoryHandle.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static unsigned char value(size_t i) {
+    return static_cast<unsigned char>((i * 7) ^ (i >> 11));
+}
+
+CASE("Without a second thread") {
+    const size_t page = size_t(::sysconf(_SC_PAGESIZE));
+
+    for (bool mirror : {true, false}) {
+        ByteRing ring(1000, mirror);
+        EXPECT(ring.capacity() == page);
+
+        std::vector<char> in(ring.capacity() + 100, 'x');
+        std::vector<char> out(in.size());
+
+        // Fills up
+        EXPECT(ring.tryWrite(in.data(), in.size()) == ring.capacity());
+        EXPECT(ring.length() == ring.capacity());
+        EXPECT(ring.tryWrite(in.data(), 1) == 0);
+
+        // Wraps around
+        EXPECT(ring.tryRead(out.data(), 100) == 100);
+        for (size_t i = 0; i < in.size(); ++i) {
+            in[i] = char(value(i));
+        }
+        EXPECT(ring.tryRead(out.data(), ring.capacity() - 200) == ring.capacity() - 200);
+        EXPECT(ring.tryWrite(in.data(), 500) == 500);
+        EXPECT(ring.length() == 600);
+
+        const char* data;
+        size_t n = ring.peek(data);
+        EXPECT(n == (mirror ? 600 : 100));
+        ring.consume(100);
+
+        n = ring.peek(data);
+        EXPECT(n == 500);
+        EXPECT(::memcmp(data, in.data(), n) == 0);
+
+        EXPECT(ring.tryRead(out.data(), out.size()) == 500);
+        EXPECT(::memcmp(out.data(), in.data(), 500) == 0);
+        EXPECT(ring.tryRead(out.data(), out.size()) == 0);
+
+        // In place, over the end of the memory
+        char* space;
+        n = ring.reserve(space);
+        EXPECT(n == (mirror ? ring.capacity() : ring.capacity() - 500));
+        ::memcpy(space, in.data(), 10);
+        ring.commit(10);
+        EXPECT(ring.length() == 10);
+
+        ring.closeWrite();
+        EXPECT(ring.read(out.data(), out.size()) == 10);
+        EXPECT(ring.read(out.data(), out.size()) == 0);
+    }
+}
+
+CASE("Between two threads") {
+    const size_t total = 64 * 1024 * 1024 + 123;
+
+    for (bool mirror : {true, false}) {
+        ByteRing ring(64 * 1024, mirror);
+
+        std::thread producer([&] {
+            std::vector<unsigned char> chunk(10000);
+            size_t done = 0;
+            size_t step = 1;
+            while (done < total) {
+                size_t n = std::min({step, chunk.size(), total - done});
+                for (size_t i = 0; i < n; ++i) {
+                    chunk[i] = value(done + i);
+                }
+                if (step % 3 == 0) {
+                    // In place
+                    size_t k = 0;
+                    while (k < n) {
+                        char* data;
+                        size_t m = std::min(ring.reserve(data), n - k);
+                        ::memcpy(data, chunk.data() + k, m);
+                        ring.commit(m);
+                        k += m;
+                    }
+                }
+                else {
+                    ring.write(chunk.data(), n);
+                }
+                done += n;
+                step = step * 7 % 9973;
+            }
+            ring.closeWrite();
+        });
+
+        std::vector<unsigned char> chunk(7777);
+        size_t done = 0;
+        bool ok     = true;
+        for (;;) {
+            size_t n;
+            if (done % 2) {
+                const char* data;
+                n = std::min(ring.peek(data), chunk.size());
+                ::memcpy(chunk.data(), data, n);
+                ring.consume(n);
+            }
+            else {
+                n = ring.read(chunk.data(), chunk.size());
+            }
+            if (n == 0) {
+                break;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                ok = ok && chunk[i] == value(done + i);
+            }
+            done += n;
+        }
+
+        producer.join();
+
+        EXPECT(ok);
+        EXPECT(done == total);
+    }
+}
+
+CASE("The reader gives up") {
+    ByteRing ring(4096);
+
+    std::thread consumer([&] {
+        char c;
+        ring.read(&c, 1);
+        ring.closeRead();
+    });
+
+    std::vector<char> data(1024 * 1024);
+    EXPECT_THROWS_AS(ring.write(data.data(), data.size()), WriteError);
+
+    consumer.join();
+}
+
+CASE("Handles at both ends") {
+    const size_t size = 10 * 1024 * 1024 + 3;
+
+    Buffer in(size);
+    for (size_t i = 0; i < size; ++i) {
+        in[i] = char(value(i));
+    }
+    Buffer out(size + 10);
+
+    ByteRing ring(256 * 1024);
+
+    std::thread producer([&] {
+        MemoryHandle source(in);
+        ByteRingHandle sink(ring);
+        source.saveInto(sink);
+    });
+
+    ByteRingHandle source(ring);
+    MemoryHandle sink(out);
+    EXPECT(source.saveInto(sink) == Length(size));
+
+    producer.join();
+
+    EXPECT(::memcmp(in, out, size) == 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
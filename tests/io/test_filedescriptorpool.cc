@@ -0,0 +1,210 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/FileDescriptorPool.h"
+#include "eckit/io/FileHandle.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class TestFiles {
+public:
+    TestFiles(size_t count, size_t size) {
+        for (size_t i = 0; i < count; ++i) {
+            PathName path = PathName::unique(PathName("test_filedescriptorpool").fullName());
+            std::string data(size, 0);
+            for (size_t j = 0; j < size; ++j) {
+                data[j] = char(i * 101 + j * 7 + j / 4093);
+            }
+            FileHandle f(path);
+            f.openForWrite(0);
+            f.write(data.data(), long(data.size()));
+            f.close();
+            paths_.push_back(path);
+            data_.push_back(data);
+        }
+    }
+
+    ~TestFiles() {
+        for (auto& p : paths_) {
+            p.unlink(false);
+        }
+    }
+
+    const PathName& path(size_t i) const { return paths_[i]; }
+    const std::string& data(size_t i) const { return data_[i]; }
+
+private:
+    std::vector<PathName> paths_;
+    std::vector<std::string> data_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Leases of the same file share a descriptor") {
+    TestFiles files(2, 100 * 1000);
+    FileDescriptorPool pool(4);
+
+    {
+        FileDescriptorPool::Lease a = pool.checkout(files.path(0));
+        FileDescriptorPool::Lease b = pool.checkout(files.path(0));
+        EXPECT(a.fd() == b.fd());
+        EXPECT(pool.usage() == 1);
+
+        char buffer[1000];
+        EXPECT(a.read(buffer, sizeof(buffer), 5000) == long(sizeof(buffer)));
+        EXPECT(::memcmp(buffer, files.data(0).data() + 5000, sizeof(buffer)) == 0);
+
+        // Fewer bytes at the end of the file
+        EXPECT(b.read(buffer, sizeof(buffer), 100 * 1000 - 10) == 10);
+        EXPECT(b.read(buffer, sizeof(buffer), 100 * 1000) == 0);
+    }
+
+    EXPECT(pool.usage() == 0);
+    EXPECT(pool.size() == 1);
+
+    char buffer[10];
+    EXPECT(pool.read(files.path(0), buffer, sizeof(buffer), 0) == 10);
+    EXPECT(pool.read(files.path(1), buffer, sizeof(buffer), 0) == 10);
+
+    FileDescriptorPool::Statistics s = pool.statistics();
+    EXPECT(s.opens == 2);
+    EXPECT(s.hits == 2);
+    EXPECT(s.evictions == 0);
+}
+
+CASE("The least recently used files are closed first") {
+    TestFiles files(4, 1000);
+    FileDescriptorPool pool(2);
+
+    char c;
+    pool.read(files.path(0), &c, 1, 0);
+    pool.read(files.path(1), &c, 1, 0);
+    pool.read(files.path(0), &c, 1, 0);
+    pool.read(files.path(2), &c, 1, 0);  // Closes 1
+    EXPECT(pool.size() == 2);
+
+    pool.read(files.path(0), &c, 1, 0);
+    EXPECT(pool.statistics().opens == 3);
+    EXPECT(pool.statistics().evictions == 1);
+
+    pool.read(files.path(1), &c, 1, 0);  // Closes 2
+    pool.read(files.path(0), &c, 1, 0);
+    EXPECT(pool.statistics().opens == 4);
+
+    pool.capacity(1);
+    EXPECT(pool.size() == 1);
+}
+
+CASE("Leased files stay open, and a full pool waits for a release") {
+    TestFiles files(2, 1000);
+    FileDescriptorPool pool(1);
+
+    FileDescriptorPool::Lease a = pool.checkout(files.path(0));
+
+    std::atomic<bool> done(false);
+    std::thread t([&] {
+        char c;
+        pool.read(files.path(1), &c, 1, 0);
+        done = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT(!done);
+
+    a.release();
+    t.join();
+    EXPECT(done);
+    EXPECT(pool.statistics().waits == 1);
+    EXPECT(pool.statistics().evictions == 1);
+}
+
+CASE("Removed files are opened again") {
+    TestFiles files(1, 1000);
+    FileDescriptorPool pool(4);
+
+    FileDescriptorPool::Lease a = pool.checkout(files.path(0));
+    EXPECT(pool.remove(files.path(0)));
+    EXPECT(!pool.remove(files.path(0)));
+
+    // Still readable by its lease
+    char c;
+    EXPECT(a.read(&c, 1, 0) == 1);
+
+    FileDescriptorPool::Lease b = pool.checkout(files.path(0));
+    EXPECT(pool.statistics().opens == 2);
+    EXPECT(pool.size() == 2);
+
+    a.release();
+    EXPECT(pool.size() == 1);
+}
+
+CASE("Files that cannot be opened") {
+    FileDescriptorPool pool(4);
+    PathName missing("/this/file/does/not/exist");
+    EXPECT_THROWS_AS(pool.checkout(missing), CantOpenFile);
+    EXPECT(pool.size() == 0);
+    EXPECT(pool.usage() == 0);
+}
+
+CASE("Many threads read the same files") {
+    TestFiles files(8, 64 * 1024);
+    FileDescriptorPool pool(3);
+
+    std::atomic<size_t> errors(0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 16; ++t) {
+        threads.emplace_back([&, t] {
+            char buffer[4096];
+            for (size_t i = 0; i < 500; ++i) {
+                size_t f      = (t * 7 + i * 3) % 8;
+                size_t offset = (t * 1013 + i * 4099) % (64 * 1024 - sizeof(buffer));
+                long n        = pool.read(files.path(f), buffer, sizeof(buffer), off_t(offset));
+                if (n != long(sizeof(buffer)) || ::memcmp(buffer, files.data(f).data() + offset, n) != 0) {
+                    errors++;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT(errors == 0);
+    EXPECT(pool.size() <= 3);
+    EXPECT(pool.usage() == 0);
+
+    FileDescriptorPool::Statistics s = pool.statistics();
+    EXPECT(s.opens + s.hits == 16 * 500);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,182 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_test_http_server_h
+#define eckit_test_http_server_h
+
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/net/TCPServer.h"
+#include "eckit/utils/StringTools.h"
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Serves one resource, /data, over HTTP/1.1 on a port of localhost, with keep-alive and, optionally, byte ranges.
+/// The bandwidth of each connection can be limited, as by a remote server.
+class HTTPServer {
+public:
+    explicit HTTPServer(std::string data, bool ranges = true, size_t rate = 0) :
+        data_(std::move(data)),
+        ranges_(ranges),
+        rate_(rate),
+        server_(net::SocketOptions::server().listenBacklog(64)),
+        stop_(false),
+        connections_(0),
+        requests_(0) {
+        port_   = server_.localPort();
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~HTTPServer() {
+        stop_ = true;
+        thread_.join();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& s : sockets_) {
+                ::shutdown(s->socket(), SHUT_RDWR);
+            }
+        }
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    std::string url(const std::string& path = "/data") const {
+        return "http://127.0.0.1:" + std::to_string(port_) + path;
+    }
+
+    size_t connections() const { return connections_; }
+    size_t requests() const { return requests_; }
+
+private:
+    void serve() {
+        while (!stop_) {
+            bool connected = false;
+            net::TCPSocket& s = server_.accept("HTTPServer", 1, &connected);
+            if (!connected) {
+                continue;
+            }
+            connections_++;
+            std::lock_guard<std::mutex> lock(mutex_);
+            sockets_.emplace_back(new net::TCPSocket(s));
+            net::TCPSocket* socket = sockets_.back().get();
+            threads_.emplace_back([this, socket] { connection(socket->socket()); });
+        }
+    }
+
+    void connection(int fd) {
+        std::string buffer;
+        for (;;) {
+            size_t end;
+            while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                char tmp[4096];
+                ssize_t n = ::recv(fd, tmp, sizeof(tmp), 0);
+                if (n <= 0) {
+                    return;
+                }
+                buffer.append(tmp, n);
+            }
+
+            std::vector<std::string> lines = StringTools::split("\r\n", buffer.substr(0, end));
+            buffer.erase(0, end + 4);
+
+            std::vector<std::string> request = StringTools::split(" ", lines[0]);
+            bool head                        = request[0] == "HEAD";
+
+            size_t from = 0;
+            size_t to   = data_.size() - 1;
+            bool range  = false;
+            for (const std::string& line : lines) {
+                std::string l = StringTools::lower(line);
+                if (ranges_ && StringTools::startsWith(l, "range: bytes=")) {
+                    std::vector<std::string> v = StringTools::split("-", l.substr(13));
+                    from                       = std::stoul(v[0]);
+                    to                         = std::min(std::stoul(v[1]), data_.size() - 1);
+                    range                      = true;
+                }
+            }
+
+            requests_++;
+
+            std::ostringstream reply;
+            if (request[1] != "/data") {
+                reply << "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+                send(fd, reply.str(), 0, 0);
+                continue;
+            }
+
+            reply << (range ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n");
+            reply << "Content-Length: " << (to + 1 - from) << "\r\n";
+            if (ranges_) {
+                reply << "Accept-Ranges: bytes\r\n";
+            }
+            if (range) {
+                reply << "Content-Range: bytes " << from << "-" << to << "/" << data_.size() << "\r\n";
+            }
+            reply << "\r\n";
+
+            if (!send(fd, reply.str(), from, head ? 0 : to + 1 - from)) {
+                return;
+            }
+        }
+    }
+
+    bool send(int fd, const std::string& header, size_t from, size_t length) {
+        if (::send(fd, header.data(), header.size(), MSG_NOSIGNAL) != ssize_t(header.size())) {
+            return false;
+        }
+        const size_t chunk = 64 * 1024;
+        auto start         = std::chrono::steady_clock::now();
+        for (size_t sent = 0; sent < length;) {
+            ssize_t n = ::send(fd, data_.data() + from + sent, std::min(chunk, length - sent), MSG_NOSIGNAL);
+            if (n <= 0) {
+                return false;
+            }
+            sent += n;
+            if (rate_) {
+                std::this_thread::sleep_until(start + std::chrono::microseconds(sent * 1000000 / rate_));
+            }
+        }
+        return true;
+    }
+
+    std::string data_;
+    bool ranges_;
+    size_t rate_;
+
+    net::EphemeralTCPServer server_;
+    int port_;
+    std::atomic<bool> stop_;
+    std::atomic<size_t> connections_;
+    std::atomic<size_t> requests_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<net::TCPSocket>> sockets_;
+    std::vector<std::thread> threads_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/io/MMappedFileHandle.h"
+#include "eckit/io/MemoryHandle.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class TestFile {
+public:
+    explicit TestFile(size_t size) :
+        path_(PathName::unique(PathName("test_mmappedfilehandle").fullName())), data_(size, 0) {
+        for (size_t i = 0; i < size; ++i) {
+            data_[i] = char(i * 13 + i / 4093);
+        }
+        FileHandle f(path_);
+        f.openForWrite(0);
+        f.write(data_.data(), long(data_.size()));
+        f.close();
+    }
+
+    ~TestFile() { path_.unlink(); }
+
+    const PathName& path() const { return path_; }
+    const std::string& data() const { return data_; }
+
+private:
+    PathName path_;
+    std::string data_;
+};
+
+static std::string readAll(MMappedFileHandle& h, size_t step) {
+    std::string result;
+    std::string buffer(step, 0);
+    long n;
+    while ((n = h.read(&buffer[0], long(step))) > 0) {
+        result.append(buffer.data(), n);
+    }
+    return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("MMappedFileHandle reads the whole file") {
+    TestFile file(3 * 1024 * 1024 + 123);
+
+    using A = MMappedFileHandle::Access;
+    for (A access : {A::Normal, A::Sequential, A::Random}) {
+        for (bool populate : {false, true}) {
+            MMappedFileHandle h(file.path());
+            h.access(access);
+            h.populate(populate);
+            h.readAhead(64 * 1024);
+
+            EXPECT(h.openForRead() == Length(file.data().size()));
+            EXPECT(readAll(h, 100 * 1000) == file.data());
+            EXPECT(h.position() == Offset(file.data().size()));
+            h.close();
+        }
+    }
+}
+
+CASE("MMappedFileHandle slides a window along the file") {
+    TestFile file(1024 * 1024 + 77);
+
+    // Smaller than a page, a page is mapped
+    for (size_t window : {size_t(1), size_t(64 * 1024), size_t(100 * 1000)}) {
+        for (size_t step : {size_t(1000), size_t(65536), size_t(300 * 1000)}) {
+            MMappedFileHandle h(file.path());
+            h.window(window);
+            h.openForRead();
+            EXPECT(readAll(h, step) == file.data());
+            h.close();
+        }
+    }
+
+    SECTION("Seek") {
+        MMappedFileHandle h(file.path());
+        h.window(64 * 1024);
+        h.access(MMappedFileHandle::Access::Random);
+        h.openForRead();
+
+        std::mt19937 random(42);
+        char buffer[5000];
+        for (size_t i = 0; i < 200; ++i) {
+            size_t offset = random() % file.data().size();
+            EXPECT(h.seek(offset) == Offset(offset));
+
+            long expected = long(std::min(sizeof(buffer), file.data().size() - offset));
+            EXPECT(h.read(buffer, sizeof(buffer)) == expected);
+            EXPECT(::memcmp(buffer, file.data().data() + offset, expected) == 0);
+        }
+        h.close();
+    }
+}
+
+CASE("MMappedFileHandle points into the mapping") {
+    TestFile file(500 * 1000);
+
+    for (size_t window : {size_t(0), size_t(64 * 1024)}) {
+        MMappedFileHandle h(file.path());
+        h.window(window);
+        h.openForRead();
+
+        std::string result;
+        const void* data;
+        long n;
+        while ((n = h.view(data, 40000)) > 0) {
+            EXPECT(n <= 40000);
+            result.append(static_cast<const char*>(data), n);
+        }
+        EXPECT(result == file.data());
+
+        // Without copying, the same memory is seen twice
+        if (!window) {
+            const void* first;
+            const void* second;
+            h.seek(1000);
+            h.view(first, 10);
+            h.seek(1000);
+            h.view(second, 10);
+            EXPECT(first == second);
+        }
+        h.close();
+    }
+}
+
+CASE("MMappedFileHandle with an empty file, and as a source") {
+    SECTION("Empty") {
+        TestFile file(0);
+        MMappedFileHandle h(file.path());
+        EXPECT(h.openForRead() == Length(0));
+        EXPECT(h.isEmpty());
+        char c;
+        EXPECT(h.read(&c, 1) == 0);
+        h.close();
+    }
+
+    SECTION("saveInto") {
+        TestFile file(2 * 1024 * 1024 + 1);
+        MMappedFileHandle h(file.path());
+        h.window(256 * 1024);
+        MemoryHandle result(file.data().size());
+        h.saveInto(result);
+        EXPECT(result.size() == Length(file.data().size()));
+        EXPECT(::memcmp(result.data(), file.data().data(), file.data().size()) == 0);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,211 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/io/MultiHandle.h"
+#include "eckit/io/PartFileHandle.h"
+#include "eckit/io/RangeReader.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Tester {
+public:
+    explicit Tester(size_t size = 1024 * 1024) :
+        data_(size) {
+        for (size_t i = 0; i < size; ++i) {
+            data_[i] = char(i * 7 + i / 251);
+        }
+
+        std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+        path_            = PathName::unique(base + "/rangereader");
+        path_ += ".dat";
+
+        FileHandle f(path_);
+        f.openForWrite(0);
+        f.write(data_.data(), long(data_.size()));
+        f.close();
+
+        fd_ = ::open(path_.localPath(), O_RDONLY);
+        ASSERT(fd_ >= 0);
+    }
+
+    ~Tester() {
+        ::close(fd_);
+        path_.unlink(false);
+    }
+
+    PathName path_;
+    std::vector<char> data_;
+    int fd_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("RangeReader coalesces ranges") {
+    Tester test;
+
+    std::vector<char> out(30);
+    auto range = [&](off_t offset, size_t length, size_t into) {
+        return RangeReader::Range{test.fd_, offset, length, out.data() + into};
+    };
+
+    SECTION("Close ranges, out of order and overlapping, are read by one request") {
+        RangeReader reader(4, 100, 1024 * 1024);
+        reader.read({range(1000, 10, 0), range(10, 10, 10), range(15, 10, 20)});
+
+        EXPECT(reader.nbRequests() == 2);
+        EXPECT(::memcmp(out.data(), &test.data_[1000], 10) == 0);
+        EXPECT(::memcmp(out.data() + 10, &test.data_[10], 10) == 0);
+        EXPECT(::memcmp(out.data() + 20, &test.data_[15], 10) == 0);
+    }
+
+    SECTION("Ranges further apart than the gap are not") {
+        RangeReader reader(4, 0, 1024 * 1024);
+        reader.read({range(0, 10, 0), range(11, 10, 10), range(22, 10, 20)});
+        EXPECT(reader.nbRequests() == 3);
+        EXPECT(reader.nbBytes() == 30);
+    }
+
+    SECTION("Requests are limited in size") {
+        RangeReader reader(4, 1024, 8);
+        reader.read({range(100, 30, 0)});
+        EXPECT(reader.nbRequests() == 4);
+        EXPECT(::memcmp(out.data(), &test.data_[100], 30) == 0);
+    }
+
+    SECTION("Reading past the end of the file") {
+        RangeReader reader(4, 0, 1024 * 1024);
+        EXPECT_THROWS_AS(reader.read({range(off_t(test.data_.size()) - 5, 10, 0), range(0, 10, 10)}), ShortFile);
+    }
+}
+
+CASE("RangeReader with many random ranges") {
+    Tester test;
+
+    std::mt19937_64 random(42);
+
+    for (size_t threads : {1, 2, 8}) {
+        for (size_t gap : {0, 4096}) {
+            std::vector<RangeReader::Range> ranges;
+            std::vector<char> out(4000 * 300);
+            std::vector<std::pair<size_t, size_t>> expect;
+
+            size_t into = 0;
+            for (size_t i = 0; i < 4000; ++i) {
+                size_t length = random() % 300;
+                size_t offset = random() % (test.data_.size() - length);
+                ranges.push_back({test.fd_, off_t(offset), length, out.data() + into, &test.path_});
+                expect.emplace_back(offset, length);
+                into += length;
+            }
+
+            RangeReader reader(threads, gap, 64 * 1024);
+            reader.read(ranges);
+
+            into = 0;
+            for (const auto& e : expect) {
+                EXPECT(::memcmp(out.data() + into, &test.data_[e.first], e.second) == 0);
+                into += e.second;
+            }
+        }
+    }
+}
+
+CASE("PartFileHandle and MultiHandle read with a RangeReader") {
+    // Set in main()
+    std::unique_ptr<RangeReader> reader(PartFileHandle::rangeReader());
+    EXPECT(reader);
+    EXPECT(reader->threads() == 4);
+
+    Tester test;
+
+    std::mt19937_64 random(43);
+
+    OffsetList offsets;
+    LengthList lengths;
+    std::string expect;
+    for (size_t i = 0; i < 2000; ++i) {
+        size_t length = random() % 1000;
+        size_t offset = random() % (test.data_.size() - length);
+        offsets.push_back(offset);
+        lengths.push_back(length);
+        expect.append(&test.data_[offset], length);
+    }
+
+    SECTION("PartFileHandle") {
+        PartFileHandle h(test.path_, offsets, lengths);
+        MemoryHandle result(expect.size());
+        h.saveInto(result);
+        EXPECT(result.size() == Length(expect.size()));
+        EXPECT(::memcmp(result.data(), expect.data(), expect.size()) == 0);
+
+        // Partial reads
+        Buffer buffer(1000);
+        h.openForRead();
+        EXPECT(h.rangeReads());
+        h.seek(12345);
+        EXPECT(h.read(buffer, 1000) == 1000);
+        EXPECT(h.position() == Offset(13345));
+        EXPECT(::memcmp(buffer, expect.data() + 12345, 1000) == 0);
+        h.close();
+        EXPECT(!h.rangeReads());
+    }
+
+    SECTION("MultiHandle of PartFileHandles and others") {
+        // Of the same data, in different files
+        Tester other;
+
+        MultiHandle mh;
+        for (size_t i = 0; i < offsets.size(); ++i) {
+            if (i % 100 == 99) {
+                mh += new MemoryHandle(&test.data_[offsets[i]], lengths[i]);
+            }
+            else {
+                mh += new PartFileHandle(i % 3 ? test.path_ : other.path_, offsets[i], lengths[i]);
+            }
+        }
+
+        MemoryHandle result(expect.size());
+        mh.saveInto(result);
+        EXPECT(result.size() == Length(expect.size()));
+        EXPECT(::memcmp(result.data(), expect.data(), expect.size()) == 0);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    ::setenv("ECKIT_PART_FILE_HANDLE_THREADS", "4", 1);
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,207 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/io/StagedPipeline.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Changes the data in place
+class XorStage : public PipelineStage {
+public:
+    explicit XorStage(std::set<const void*>* seen = nullptr) :
+        PipelineStage("xor"), seen_(seen) {}
+
+    void process(Buffer&& buffer, size_t size, Output& out) override {
+        if (seen_) {
+            seen_->insert(buffer.data());
+        }
+        for (size_t i = 0; i < size; ++i) {
+            buffer[i] ^= 0x5a;
+        }
+        out.emit(std::move(buffer), size);
+    }
+
+private:
+    std::set<const void*>* seen_;
+};
+
+/// Passes on every byte twice, in new buffers, and a trailer
+class DoubleStage : public PipelineStage {
+public:
+    DoubleStage() :
+        PipelineStage("double") {}
+
+    void process(Buffer&& buffer, size_t size, Output& out) override {
+        for (size_t start : {size_t(0), size / 2}) {
+            size_t half = start == 0 ? size / 2 : size - size / 2;
+            Buffer doubled(2 * half + 1);
+            for (size_t i = 0; i < half; ++i) {
+                doubled[2 * i] = doubled[2 * i + 1] = buffer[start + i];
+            }
+            out.emit(std::move(doubled), 2 * half);
+        }
+    }
+
+    void finish(Output& out) override { out.emit(Buffer(std::string("END")), 3); }
+};
+
+class FailingStage : public PipelineStage {
+public:
+    explicit FailingStage(size_t after) :
+        PipelineStage("failing"), after_(after) {}
+
+    void process(Buffer&& buffer, size_t size, Output& out) override {
+        if (after_-- == 0) {
+            throw UserError("failing stage");
+        }
+        out.emit(std::move(buffer), size);
+    }
+
+private:
+    size_t after_;
+};
+
+class SlowStage : public PipelineStage {
+public:
+    SlowStage() :
+        PipelineStage("slow") {}
+
+    void process(Buffer&& buffer, size_t size, Output& out) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        out.emit(std::move(buffer), size);
+    }
+};
+
+static std::string input(size_t size) {
+    std::string s(size, ' ');
+    for (size_t i = 0; i < size; ++i) {
+        s[i] = char(i * 31 + (i >> 8));
+    }
+    return s;
+}
+
+CASE("Stages transform the data in order") {
+    const std::string in = input(1000 * 1000 + 17);
+
+    std::string expected;
+    for (char c : in) {
+        c ^= 0x5a;
+        expected += c;
+        expected += c;
+    }
+    expected += "END";
+
+    for (size_t threads : {0, 1, 3}) {
+        for (size_t queue : {1, 4}) {
+            StagedPipeline pipeline;
+            pipeline.threads(threads);
+            pipeline.queueLength(queue);
+            pipeline.bufferSize(4096);
+            pipeline.add(new XorStage()).add(new DoubleStage());
+
+            MemoryHandle source(in.data(), in.size());
+            MemoryHandle sink(4 * in.size());
+
+            EXPECT(pipeline.copy(source, sink) == Length(expected.size()));
+            EXPECT(sink.size() == Length(expected.size()));
+            EXPECT(::memcmp(sink.data(), expected.data(), expected.size()) == 0);
+
+            const auto& stats = pipeline.statistics();
+            EXPECT(stats.size() == 4);
+            EXPECT(stats[0].name == "read");
+            EXPECT(stats[1].name == "xor");
+            EXPECT(stats[3].name == "write");
+            EXPECT(stats[0].bytesOut == in.size());
+            EXPECT(stats[1].bytesIn == in.size());
+            EXPECT(stats[1].bytesOut == in.size());
+            EXPECT(stats[2].buffersOut == 2 * stats[2].buffersIn + 1);
+            EXPECT(stats[3].bytesIn == expected.size());
+        }
+    }
+}
+
+CASE("Buffers are passed on, not copied") {
+    const std::string in = input(64 * 1024);
+
+    std::set<const void*> first;
+    std::set<const void*> second;
+
+    StagedPipeline pipeline;
+    pipeline.queueLength(64);
+    pipeline.bufferSize(1024);
+    pipeline.add(new XorStage(&first)).add(new XorStage(&second));
+
+    MemoryHandle source(in.data(), in.size());
+    MemoryHandle sink(in.size());
+    pipeline.copy(source, sink);
+
+    EXPECT(first == second);
+    EXPECT(::memcmp(sink.data(), in.data(), in.size()) == 0);
+}
+
+CASE("A slow stage holds back the others") {
+    const std::string in = input(200 * 1024);
+
+    StagedPipeline pipeline;
+    pipeline.threads(0);
+    pipeline.queueLength(2);
+    pipeline.bufferSize(4096);
+    pipeline.add(new XorStage()).add(new SlowStage());
+
+    MemoryHandle source(in.data(), in.size());
+    MemoryHandle sink(in.size());
+    pipeline.copy(source, sink);
+
+    const auto& stats = pipeline.statistics();
+    EXPECT(stats[2].busy > 0.05);
+    EXPECT(stats[1].outputWait > 0.05);
+    EXPECT(stats[3].inputWait > 0.05);
+}
+
+CASE("An error stops the pipeline") {
+    const std::string in = input(1000 * 1000);
+
+    for (size_t threads : {0, 2}) {
+        StagedPipeline pipeline;
+        pipeline.threads(threads);
+        pipeline.queueLength(1);
+        pipeline.bufferSize(1024);
+        pipeline.add(new XorStage()).add(new FailingStage(10)).add(new SlowStage());
+
+        MemoryHandle source(in.data(), in.size());
+        MemoryHandle sink(in.size());
+        EXPECT_THROWS_AS(pipeline.copy(source, sink), UserError);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,158 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/io/TeeHandle.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Writes into a string, slowly, and fails after a number of bytes if asked to
+class TestHandle : public DataHandle {
+public:
+    explicit TestHandle(std::string& out, size_t failAfter = 0, int delay = 0) :
+        out_(out), failAfter_(failAfter), delay_(delay), closed_(false) {}
+
+    void print(std::ostream& s) const override { s << "TestHandle[]"; }
+    void openForWrite(const Length&) override { out_.clear(); }
+    long write(const void* buffer, long length) override {
+        if (failAfter_ && out_.size() + length > failAfter_) {
+            throw WriteError("TestHandle full");
+        }
+        if (delay_) {
+            std::this_thread::sleep_for(std::chrono::microseconds(delay_));
+        }
+        out_.append(static_cast<const char*>(buffer), length);
+        return length;
+    }
+    void close() override { closed_ = true; }
+    void flush() override {}
+
+    bool closed() const { return closed_; }
+
+private:
+    std::string& out_;
+    size_t failAfter_;
+    int delay_;
+    bool closed_;
+};
+
+static std::string makeData(size_t size) {
+    std::string data(size, 0);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = char(i * 17 + i / 1021);
+    }
+    return data;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("TeeHandle writes the same data, in order, into each handle") {
+    std::string data = makeData(1024 * 1024 + 7);
+
+    for (bool concurrent : {false, true}) {
+        for (size_t window : {size_t(1), size_t(4096), size_t(64 * 1024 * 1024)}) {
+            std::string a;
+            std::string b;
+            std::string c;
+
+            TeeHandle tee;
+            tee += new TestHandle(a);
+            tee += new TestHandle(b, 0, 10);
+            tee += new TestHandle(c);
+            tee.concurrent(concurrent);
+            tee.window(window);
+
+            tee.openForWrite(0);
+            size_t done = 0;
+            for (size_t n = 1; done < data.size(); n = n * 3 % 5000 + 1) {
+                n = std::min(n, data.size() - done);
+                EXPECT(tee.write(data.data() + done, long(n)) == long(n));
+                done += n;
+
+                // Everything is written after a flush
+                if (done > data.size() / 2 && done - n <= data.size() / 2) {
+                    tee.flush();
+                    EXPECT(a.size() == done);
+                    EXPECT(b.size() == done);
+                }
+            }
+            tee.close();
+
+            EXPECT(a == data);
+            EXPECT(b == data);
+            EXPECT(c == data);
+        }
+    }
+}
+
+CASE("TeeHandle reports the errors of any handle") {
+    std::string data = makeData(100 * 1000);
+
+    std::string a;
+    std::string b;
+    TestHandle* good = new TestHandle(a);
+    TestHandle* bad  = new TestHandle(b, 50 * 1000);
+
+    TeeHandle tee(good, bad);
+    tee.concurrent(true);
+    tee.openForWrite(0);
+
+    // By a write, and by close() at the latest
+    try {
+        for (size_t done = 0; done < data.size(); done += 1000) {
+            tee.write(data.data() + done, 1000);
+        }
+    }
+    catch (WriteError&) {
+    }
+    EXPECT_THROWS_AS(tee.close(), WriteError);
+
+    EXPECT(good->closed());
+    EXPECT(bad->closed());
+    EXPECT(b.size() == 50 * 1000);
+}
+
+CASE("TeeHandle with concurrent writes, closed by its destructor") {
+    std::string data = makeData(10000);
+    std::string a;
+    std::string b;
+    {
+        TeeHandle tee(new TestHandle(a, 0, 100), new TestHandle(b));
+        tee.concurrent(true);
+        tee.openForWrite(0);
+        for (size_t i = 0; i < 10; ++i) {
+            tee.write(data.data() + i * 1000, 1000);
+        }
+    }
+    EXPECT(a.size() <= data.size());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,339 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/io/RawFileHandle.h"
+#include "eckit/io/TransferEngine.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static std::vector<char> makeData(size_t size) {
+    std::vector<char> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = char(i * 13 + i / 509);
+    }
+    return data;
+}
+
+class Tester {
+public:
+    explicit Tester(size_t size) :
+        data_(makeData(size)) {
+        std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+        in_              = PathName::unique(base + "/transferengine");
+        out_             = PathName::unique(base + "/transferengine");
+
+        FileHandle f(in_);
+        f.openForWrite(0);
+        f.write(data_.data(), long(data_.size()));
+        f.close();
+    }
+
+    ~Tester() {
+        in_.unlink(false);
+        if (out_.exists()) {
+            out_.unlink(false);
+        }
+    }
+
+    bool same(size_t from = 0, size_t length = size_t(-1)) const {
+        length = std::min(length, data_.size() - from);
+        if (out_.size() != Length(length)) {
+            return false;
+        }
+        std::vector<char> result(length);
+        FileHandle f(out_);
+        f.openForRead();
+        long n = length ? f.read(result.data(), long(length)) : 0;
+        f.close();
+        return n == long(length) && ::memcmp(result.data(), data_.data() + from, length) == 0;
+    }
+
+    std::vector<char> data_;
+    PathName in_;
+    PathName out_;
+};
+
+/// Sums the bytes it sees
+class SumWatcher : public TransferWatcher {
+public:
+    void watch(const void* buffer, long length) override {
+        EXPECT(buffer != nullptr || length == 0);
+        const unsigned char* p = static_cast<const unsigned char*>(buffer);
+        for (long i = 0; i < length; ++i) {
+            sum_ += p[i];
+        }
+        bytes_ += length;
+    }
+
+    unsigned long long sum_   = 0;
+    unsigned long long bytes_ = 0;
+};
+
+/// Counts the bytes without looking at them
+class CountWatcher : public TransferWatcher {
+public:
+    void watch(const void*, long length) override { bytes_ += length; }
+    bool needsData() const override { return false; }
+
+    unsigned long long bytes_ = 0;
+};
+
+/// Reads from memory, asking once for the transfer to restart from an earlier offset
+class FlakyHandle : public DataHandle {
+public:
+    FlakyHandle(const std::vector<char>& data, size_t failAt, size_t restartAt) :
+        data_(data), pos_(0), failAt_(failAt), restartAt_(restartAt) {}
+
+    void print(std::ostream& s) const override { s << "FlakyHandle[]"; }
+    Length openForRead() override {
+        pos_ = 0;
+        return data_.size();
+    }
+    long read(void* buffer, long length) override {
+        if (failAt_ && pos_ >= failAt_) {
+            failAt_ = 0;
+            throw RestartTransfer(restartAt_);
+        }
+        long n = long(std::min<size_t>(length, data_.size() - pos_));
+        ::memcpy(buffer, data_.data() + pos_, n);
+        pos_ += n;
+        return n;
+    }
+    void close() override {}
+    void restartReadFrom(const Offset& from) override { pos_ = size_t((long long)from); }
+
+private:
+    const std::vector<char>& data_;
+    size_t pos_;
+    size_t failAt_;
+    size_t restartAt_;
+};
+
+/// Writes into a string, and can restart
+class StringHandle : public DataHandle {
+public:
+    void print(std::ostream& s) const override { s << "StringHandle[]"; }
+    void openForWrite(const Length&) override { data_.clear(); }
+    long write(const void* buffer, long length) override {
+        data_.append(static_cast<const char*>(buffer), length);
+        return length;
+    }
+    void close() override {}
+    void restartWriteFrom(const Offset& from) override { data_.resize(size_t((long long)from)); }
+
+    std::string data_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Copies between files") {
+    Tester test(3 * 1024 * 1024 + 123);
+
+    struct Setting {
+        long buffers;
+        bool zeroCopy;
+        long threads;
+        TransferEngine::Method method;
+    };
+
+    std::vector<Setting> settings{
+        {1, false, 1, TransferEngine::BUFFER},
+        {4, false, 1, TransferEngine::RING},
+        {7, false, 1, TransferEngine::RING},
+#if defined(__linux__)
+        {4, true, 1, TransferEngine::COPY_FILE_RANGE},
+        {4, true, 4, TransferEngine::COPY_FILE_RANGE},
+#endif
+    };
+
+    for (const Setting& s : settings) {
+        for (Length length : {Length(0), Length(1000), Length(2 * 1024 * 1024 + 1)}) {
+            CountWatcher watcher;
+            TransferEngine engine(256 * 1024, watcher);
+            engine.buffers(s.buffers);
+            engine.zeroCopy(s.zeroCopy);
+            engine.threads(s.threads);
+
+            FileHandle in(test.in_);
+            FileHandle out(test.out_);
+            in.openForRead();
+            out.openForWrite(0);
+
+            // From where the handles are
+            char header[10];
+            EXPECT(in.read(header, 10) == 10);
+            EXPECT(out.write(header, 10) == 10);
+
+            Length copied = engine.copy(in, out, length);
+            EXPECT(in.position() == Offset(10) + copied);
+            EXPECT(out.position() == Offset(10) + copied);
+            in.close();
+            out.close();
+
+            Length expect = length == Length(0) ? Length(test.data_.size() - 10) : length;
+            EXPECT(copied == expect);
+            EXPECT(watcher.bytes_ == (unsigned long long)expect);
+            // Not worth another thread for less than a buffer of the ring
+            if (s.method == TransferEngine::RING && length == Length(1000)) {
+                EXPECT(engine.method() == TransferEngine::BUFFER);
+            }
+            else {
+                EXPECT(engine.method() == s.method);
+            }
+            EXPECT(test.same(0, size_t(10 + (long long)expect)));
+        }
+    }
+}
+
+CASE("A watcher that needs the data sees all of it") {
+    Tester test(1024 * 1024 + 17);
+
+    unsigned long long sum = 0;
+    for (char c : test.data_) {
+        sum += (unsigned char)c;
+    }
+
+    for (long buffers : {1, 4}) {
+        SumWatcher watcher;
+        TransferEngine engine(64 * 1024, watcher);
+        engine.buffers(buffers);
+
+        FileHandle in(test.in_);
+        FileHandle out(test.out_);
+        in.openForRead();
+        out.openForWrite(0);
+        EXPECT(engine.copy(in, out) == Length(test.data_.size()));
+        in.close();
+        out.close();
+
+        EXPECT(engine.method() != TransferEngine::COPY_FILE_RANGE);
+        EXPECT(watcher.bytes_ == test.data_.size());
+        EXPECT(watcher.sum_ == sum);
+        EXPECT(test.same());
+    }
+}
+
+CASE("Copies from and into memory") {
+    std::vector<char> data = makeData(500 * 1000);
+
+    for (long buffers : {1, 3}) {
+        TransferEngine engine(64 * 1024);
+        engine.buffers(buffers);
+
+        MemoryHandle in(data.data(), data.size());
+        MemoryHandle out(data.size());
+        in.openForRead();
+        out.openForWrite(0);
+        EXPECT(engine.copy(in, out, 100 * 1000) == Length(100 * 1000));
+        EXPECT(engine.copy(in, out) == Length(400 * 1000));
+        EXPECT(engine.copy(in, out) == Length(0));
+        in.close();
+        out.close();
+
+        EXPECT(out.size() == Length(data.size()));
+        EXPECT(::memcmp(out.data(), data.data(), data.size()) == 0);
+    }
+}
+
+#if defined(__linux__)
+CASE("sendfile into a pipe") {
+    Tester test(2 * 1024 * 1024 + 5);
+    SYSCALL(::mkfifo(test.out_.localPath(), 0600));
+
+    std::string result;
+    std::thread reader([&] {
+        RawFileHandle f(test.out_);
+        f.openForRead();
+        char buffer[65536];
+        long n;
+        while ((n = f.read(buffer, sizeof(buffer))) > 0) {
+            result.append(buffer, n);
+        }
+        f.close();
+    });
+
+    CountWatcher watcher;
+    TransferEngine engine(128 * 1024, watcher);
+
+    FileHandle in(test.in_);
+    RawFileHandle out(test.out_);
+    in.openForRead();
+    out.openForWrite(0);
+    Length copied = engine.copy(in, out);
+    in.close();
+    out.close();
+
+    reader.join();
+
+    EXPECT(copied == Length(test.data_.size()));
+    EXPECT(engine.method() == TransferEngine::SENDFILE);
+    EXPECT(result.size() == test.data_.size());
+    EXPECT(::memcmp(result.data(), test.data_.data(), result.size()) == 0);
+}
+#endif
+
+CASE("saveInto and copyTo") {
+    Tester test(5 * 1024 * 1024 + 3);
+
+    SECTION("saveInto") {
+        FileHandle in(test.in_);
+        FileHandle out(test.out_);
+        EXPECT(in.saveInto(out) == Length(test.data_.size()));
+        EXPECT(test.same());
+    }
+
+    SECTION("copyTo, limited") {
+        FileHandle in(test.in_);
+        FileHandle out(test.out_);
+        EXPECT(in.copyTo(out, 100 * 1024, 1024 * 1024 + 1) == Length(1024 * 1024 + 1));
+        EXPECT(test.same(0, 1024 * 1024 + 1));
+    }
+
+    SECTION("saveInto restarts") {
+        for (long buffers : {1, 4}) {
+            ::setenv("ECKIT_TRANSFER_BUFFERS", buffers == 1 ? "1" : "4", 1);
+            FlakyHandle in(test.data_, 3 * 1024 * 1024, 1024 * 1024);
+            StringHandle out;
+            EXPECT(in.saveInto(out) == Length(test.data_.size()));
+            EXPECT(out.data_.size() == test.data_.size());
+            EXPECT(::memcmp(out.data_.data(), test.data_.data(), test.data_.size()) == 0);
+        }
+        ::unsetenv("ECKIT_TRANSFER_BUFFERS");
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,139 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "eckit/io/EasyCURL.h"
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/io/URLHandle.h"
+
+#include "eckit/testing/Test.h"
+
+#include "test_http_server.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static std::string makeData(size_t size) {
+    std::string data(size, 0);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = char(i * 31 + i / 4093);
+    }
+    return data;
+}
+
+static std::string download(DataHandle&& h, size_t size) {
+    MemoryHandle result(size);
+    h.saveInto(result);
+    return std::string(static_cast<const char*>(result.data()), size_t(result.size()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Set in main()
+const size_t rangeSize = 64 * 1024;
+
+CASE("URLHandle fetches ranges over several connections") {
+    std::string data = makeData(1024 * 1024 + 77);
+    HTTPServer server(data);
+
+    EXPECT(download(URLHandle(server.url()), data.size()) == data);
+
+    // A HEAD, then one request per range
+    EXPECT(server.requests() == 1 + (data.size() + rangeSize - 1) / rangeSize);
+    EXPECT(server.connections() <= 1 + 4);
+
+    // Connections are kept for the next download
+    size_t connections = server.connections();
+    EXPECT(download(URLHandle(server.url()), data.size()) == data);
+    EXPECT(server.connections() <= connections + 1);
+}
+
+CASE("URLHandle streams resources without ranges, or smaller than a range") {
+    SECTION("No ranges") {
+        std::string data = makeData(300 * 1000);
+        HTTPServer server(data, false);
+        EXPECT(download(URLHandle(server.url()), data.size()) == data);
+        EXPECT(server.requests() == 2);
+    }
+
+    SECTION("Small") {
+        std::string data = makeData(rangeSize);
+        HTTPServer server(data);
+        EXPECT(download(URLHandle(server.url()), data.size()) == data);
+        EXPECT(server.requests() == 2);
+    }
+}
+
+CASE("Ranged GET") {
+    std::string data = makeData(500 * 1000 + 1);
+    HTTPServer server(data);
+
+    SECTION("Reads of any size, across ranges") {
+        for (size_t connections : {1, 3, 8}) {
+            EasyCURL curl;
+            std::unique_ptr<DataHandle> h(curl.rangedGET(server.url(), data.size(), connections, 10000));
+            EXPECT(h->openForRead() == Length(data.size()));
+
+            std::string result;
+            char buffer[7777];
+            long n;
+            while ((n = h->read(buffer, sizeof(buffer))) > 0) {
+                result.append(buffer, n);
+            }
+            EXPECT(h->position() == Offset(data.size()));
+            h->close();
+
+            EXPECT(result == data);
+        }
+    }
+
+    SECTION("Closed before the end") {
+        EasyCURL curl;
+        std::unique_ptr<DataHandle> h(curl.rangedGET(server.url(), data.size(), 4, 10000));
+        h->openForRead();
+        char buffer[100];
+        EXPECT(h->read(buffer, sizeof(buffer)) == long(sizeof(buffer)));
+        EXPECT(::memcmp(buffer, data.data(), sizeof(buffer)) == 0);
+        h->close();
+    }
+
+    SECTION("Errors") {
+        EasyCURL curl;
+        std::unique_ptr<DataHandle> h(curl.rangedGET(server.url("/missing"), data.size(), 4, 10000));
+        h->openForRead();
+        char buffer[100];
+        try {
+            h->read(buffer, sizeof(buffer));
+            EXPECT(false);
+        }
+        catch (URLException& e) {
+            EXPECT(e.code() == 404);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    ::setenv("ECKIT_URL_HANDLE_CONNECTIONS", "4", 1);
+    ::setenv("ECKIT_URL_HANDLE_RANGE_SIZE", std::to_string(eckit::test::rangeSize).c_str(), 1);
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,190 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Copies a large file with each method of TransferEngine: into another file, into a pipe, and from memory. The size
+// of the file can be set with ECKIT_TRANSFER_PERFORMANCE_SIZE.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/io/RawFileHandle.h"
+#include "eckit/io/TransferEngine.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Timer.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void dropCache(const PathName& path) {
+#if defined(POSIX_FADV_DONTNEED)
+    int fd = ::open(path.localPath(), O_RDONLY);
+    ASSERT(fd >= 0);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+#endif
+}
+
+static void report(const std::string& name, size_t bytes, Timer& timer) {
+    std::cout << "    " << std::setw(40) << std::left << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(3) << timer.elapsed() << " s  " << Bytes(bytes, timer) << std::endl;
+}
+
+struct Setting {
+    const char* name;
+    long buffers;
+    bool zeroCopy;
+    long threads;
+};
+
+static const Setting settings[] = {
+    {"buffer", 1, false, 1},
+    {"ring", 4, false, 1},
+    {"zero copy", 4, true, 1},
+    {"zero copy, 4 threads", 4, true, 4},
+};
+
+static void configure(TransferEngine& engine, const Setting& s) {
+    engine.buffers(s.buffers);
+    engine.zeroCopy(s.zeroCopy);
+    engine.threads(s.threads);
+}
+
+static const char* method(TransferEngine::Method m) {
+    switch (m) {
+        case TransferEngine::COPY_FILE_RANGE:
+            return "copy_file_range";
+        case TransferEngine::SENDFILE:
+            return "sendfile";
+        case TransferEngine::RING:
+            return "ring";
+        case TransferEngine::BUFFER:
+            return "buffer";
+        default:
+            return "none";
+    }
+}
+
+CASE("Transfers of a large file") {
+    size_t size = Resource<size_t>("$ECKIT_TRANSFER_PERFORMANCE_SIZE", size_t(1024) * 1024 * 1024);
+    long buffer = 8 * 1024 * 1024;
+
+    std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+    PathName in      = PathName::unique(base + "/transfer-performance");
+    PathName out     = PathName::unique(base + "/transfer-performance");
+    PathName fifo    = PathName::unique(base + "/transfer-performance");
+
+    Buffer data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = char(i);
+    }
+
+    {
+        FileHandle f(in);
+        f.openForWrite(0);
+        f.write(data, long(size));
+        f.close();
+    }
+
+    std::cout << "File of " << Bytes(size) << std::endl;
+
+    std::cout << "  File to file" << std::endl;
+    for (const Setting& s : settings) {
+        dropCache(in);
+        Timer timer(s.name, std::cout);
+        TransferEngine engine(buffer);
+        configure(engine, s);
+        FileHandle from(in);
+        FileHandle to(out);
+        from.openForRead();
+        to.openForWrite(0);
+        EXPECT(engine.copy(from, to) == Length(size));
+        from.close();
+        to.close();
+        timer.stop();
+        report(std::string(s.name) + " (" + method(engine.method()) + ")", size, timer);
+        out.unlink(false);
+    }
+
+    std::cout << "  File to pipe" << std::endl;
+    SYSCALL(::mkfifo(fifo.localPath(), 0600));
+    for (const Setting& s : settings) {
+        dropCache(in);
+
+        std::thread reader([&] {
+            RawFileHandle f(fifo);
+            f.openForRead();
+            Buffer b(1024 * 1024);
+            while (f.read(b, long(b.size())) > 0) {
+            }
+            f.close();
+        });
+
+        Timer timer(s.name, std::cout);
+        TransferEngine engine(buffer);
+        configure(engine, s);
+        FileHandle from(in);
+        RawFileHandle to(fifo);
+        from.openForRead();
+        to.openForWrite(0);
+        EXPECT(engine.copy(from, to) == Length(size));
+        from.close();
+        to.close();
+        reader.join();
+        timer.stop();
+        report(std::string(s.name) + " (" + method(engine.method()) + ")", size, timer);
+    }
+    fifo.unlink(false);
+
+    std::cout << "  Memory to file" << std::endl;
+    for (const Setting& s : settings) {
+        Timer timer(s.name, std::cout);
+        TransferEngine engine(buffer);
+        configure(engine, s);
+        MemoryHandle from(data, size);
+        FileHandle to(out);
+        from.openForRead();
+        to.openForWrite(0);
+        EXPECT(engine.copy(from, to) == Length(size));
+        from.close();
+        to.close();
+        timer.stop();
+        report(std::string(s.name) + " (" + method(engine.method()) + ")", size, timer);
+        out.unlink(false);
+    }
+
+    in.unlink(false);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
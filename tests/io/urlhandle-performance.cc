@@ -0,0 +1,92 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Downloads a resource from a local HTTP server limiting the bandwidth of each connection, as one stream and as
+// ranges over several connections. The size of the resource and the bandwidth of a connection can be set with
+// ECKIT_URL_HANDLE_PERFORMANCE_SIZE and ECKIT_URL_HANDLE_PERFORMANCE_RATE.
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "eckit/config/Resource.h"
+#include "eckit/io/EasyCURL.h"
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Timer.h"
+
+#include "eckit/testing/Test.h"
+
+#include "test_http_server.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void report(const std::string& name, size_t bytes, Timer& timer) {
+    std::cout << "    " << std::setw(40) << std::left << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(3) << timer.elapsed() << " s  " << Bytes(bytes, timer) << std::endl;
+}
+
+CASE("Single stream and ranged downloads") {
+    size_t size = Resource<size_t>("$ECKIT_URL_HANDLE_PERFORMANCE_SIZE", 256 * 1024 * 1024);
+    size_t rate = Resource<size_t>("$ECKIT_URL_HANDLE_PERFORMANCE_RATE", 50 * 1024 * 1024);
+
+    std::string data(size, 0);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = char(i);
+    }
+
+    HTTPServer server(data, true, rate);
+
+    std::cout << Bytes(size) << ", " << Bytes(rate) << " per second and connection" << std::endl;
+
+    {
+        Timer timer("stream", std::cout);
+        EasyCURL curl;
+        std::unique_ptr<DataHandle> h(curl.GET(server.url(), true).dataHandle());
+        MemoryHandle result(size);
+        h->saveInto(result);
+        timer.stop();
+        EXPECT(result.size() == Length(size));
+        report("stream", size, timer);
+    }
+
+    for (size_t connections : {2, 4, 8, 16}) {
+        for (size_t rangeSize : {size_t(1024 * 1024), size_t(8 * 1024 * 1024)}) {
+            Timer timer("ranges", std::cout);
+            EasyCURL curl;
+            std::unique_ptr<DataHandle> h(curl.rangedGET(server.url(), size, connections, rangeSize));
+            MemoryHandle result(size);
+            h->saveInto(result);
+            timer.stop();
+            EXPECT(result.size() == Length(size));
+            EXPECT(::memcmp(result.data(), data.data(), size) == 0);
+
+            std::ostringstream name;
+            name << "ranges connections=" << connections << " size=" << Bytes(rangeSize);
+            report(name.str(), size, timer);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
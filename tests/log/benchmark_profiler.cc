@@ -0,0 +1,97 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Overhead of an ECKIT_PROFILE_REGION around an empty body: disabled, enabled, and enabled with tracing, against
+// a Timer (gettimeofday and clock) that does not report. The number of iterations can be increased with
+// ECKIT_PROFILER_BENCHMARK_ITERATIONS.
+
+#include <chrono>
+#include <string>
+
+#include "eckit/config/Resource.h"
+#include "eckit/log/Log.h"
+#include "eckit/log/Profiler.h"
+#include "eckit/log/Timer.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static volatile size_t sink = 0;
+
+__attribute__((noinline)) static void region() {
+    ECKIT_PROFILE_REGION("region");
+    sink = sink + 1;
+}
+
+__attribute__((noinline)) static void bare() {
+    sink = sink + 1;
+}
+
+__attribute__((noinline)) static void timer() {
+    Timer t;
+    sink = sink + 1;
+    t.stop();
+}
+
+template <class F>
+static double measure(const std::string& name, F f, size_t n) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        f();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+    Log::info() << "    " << name << ": " << ns << " ns per call" << std::endl;
+    return ns;
+}
+
+CASE("Overhead per region") {
+    size_t n = Resource<size_t>("$ECKIT_PROFILER_BENCHMARK_ITERATIONS", 10000000);
+
+    Profiler& p = Profiler::instance();
+
+    double base = measure("empty function", bare, n);
+
+    p.enable(false);
+    double disabled = measure("region, disabled", region, n);
+
+    p.enable(true);
+    p.reset();
+    double enabled = measure("region, enabled", region, n);
+
+    p.tracing(true);
+    p.reset();
+    double tracing = measure("region, enabled and tracing", region, n);
+    p.tracing(false);
+    p.enable(false);
+
+    measure("Timer", timer, n / 10);
+
+    Log::info() << "    overhead: disabled " << disabled - base << " ns, enabled " << enabled - base
+                << " ns, tracing " << tracing - base << " ns, " << p.dropped() << " events dropped" << std::endl;
+
+    Profiler::Region root = p.tree();
+    EXPECT_EQUAL(root.children.size(), 1);
+    size_t calls = root.children[0].calls;
+    EXPECT_EQUAL(calls, n);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,228 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "eckit/io/Buffer.h"
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/io/StatsHandle.h"
+#include "eckit/io/TransferWatcher.h"
+#include "eckit/log/Histogram.h"
+#include "eckit/log/JSON.h"
+#include "eckit/parser/JSONParser.h"
+#include "eckit/runtime/Metrics.h"
+#include "eckit/serialisation/MemoryStream.h"
+#include "eckit/serialisation/ResizableMemoryStream.h"
+#include "eckit/value/Value.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Buckets cover all values") {
+    EXPECT_EQUAL(Histogram::bucket(0), 0);
+    EXPECT_EQUAL(Histogram::bucket(31), 31);
+    EXPECT_EQUAL(Histogram::bucket(~uint64_t(0)), Histogram::BUCKETS - 1);
+
+    for (size_t b = 0; b + 1 < Histogram::BUCKETS; ++b) {
+        uint64_t lo = Histogram::lowerBound(b);
+        uint64_t hi = Histogram::upperBound(b);
+        EXPECT_EQUAL(Histogram::bucket(lo), b);
+        EXPECT_EQUAL(Histogram::bucket(hi), b);
+        EXPECT_EQUAL(Histogram::lowerBound(b + 1), hi + 1);
+        // Relative width of a bucket
+        EXPECT(double(hi - lo) <= double(lo) / Histogram::SUB_BUCKETS);
+    }
+}
+
+CASE("Percentiles are within the precision") {
+    std::mt19937_64 rng(42);
+    std::lognormal_distribution<double> dist(10, 2);
+
+    std::vector<uint64_t> values;
+    Histogram h;
+    for (size_t i = 0; i < 100000; ++i) {
+        uint64_t v = uint64_t(dist(rng));
+        values.push_back(v);
+        h.record(v);
+    }
+
+    std::sort(values.begin(), values.end());
+
+    EXPECT_EQUAL(h.count(), values.size());
+    EXPECT_EQUAL(h.min(), values.front());
+    EXPECT_EQUAL(h.max(), values.back());
+    EXPECT_EQUAL(h.percentile(100), values.back());
+
+    for (double p : {1., 50., 90., 99., 99.9}) {
+        uint64_t exact = values[size_t(std::ceil(p / 100 * values.size())) - 1];
+        uint64_t approx = h.percentile(p);
+        EXPECT(approx >= exact);
+        EXPECT(double(approx - exact) <= double(exact) / Histogram::SUB_BUCKETS + 1);
+    }
+}
+
+CASE("Merge and serialise") {
+    Histogram a;
+    Histogram b;
+    Histogram all;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        (i % 2 ? a : b).record(i * 1000);
+        all.record(i * 1000);
+    }
+
+    a.merge(b);
+    EXPECT(a.buckets() == all.buckets());
+    EXPECT_EQUAL(a.count(), all.count());
+    EXPECT_EQUAL(a.sum(), all.sum());
+    EXPECT_EQUAL(a.min(), 0);
+    EXPECT_EQUAL(a.max(), 999000);
+
+    Buffer buffer(1024);
+    ResizableMemoryStream out(buffer);
+    out << a;
+
+    MemoryStream in(buffer);
+    Histogram c(in);
+    EXPECT(c.buckets() == all.buckets());
+    EXPECT_EQUAL(c.percentile(50), all.percentile(50));
+    EXPECT_EQUAL(c.min(), all.min());
+}
+
+CASE("Atomic histograms and counters from several threads") {
+    AtomicHistogram h;
+    Counter c;
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&h, &c, t] {
+            for (uint64_t i = 0; i < 10000; ++i) {
+                h.record(t * 10000 + i);
+                c.add();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    Histogram s = h.snapshot();
+    EXPECT_EQUAL(s.count(), 40000);
+    EXPECT_EQUAL(s.min(), 0);
+    EXPECT_EQUAL(s.max(), 39999);
+    EXPECT_EQUAL(s.sum(), 39999ull * 40000 / 2);
+    uint64_t value = c.value();
+    EXPECT_EQUAL(value, 40000);
+    EXPECT(c.rate() > 0);
+
+    h.reset();
+    EXPECT(h.snapshot().count() == 0);
+}
+
+CASE("Instruments are exported") {
+    Instruments::reset();
+    AtomicHistogram& h = Instruments::histogram("test.latency");
+    EXPECT(&h == &Instruments::histogram("test.latency"));
+
+    h.record(1000000);
+    h.record(3000000);
+    Instruments::counter("test.requests").add(2);
+
+    std::ostringstream out;
+    {
+        JSON json(out);
+        Instruments::json(json);
+    }
+
+    std::istringstream in(out.str());
+    Value v = JSONParser(in).parse();
+    EXPECT_EQUAL(int(v["histograms"]["test.latency"]["count"]), 2);
+    EXPECT(std::abs(double(v["histograms"]["test.latency"]["max"]) - 0.003) < 1e-12);
+    EXPECT_EQUAL(int(v["counters"]["test.requests"]["value"]), 2);
+
+    // Exporting again reports the same counters
+    std::ostringstream again;
+    {
+        JSON json(again);
+        Instruments::json(json);
+    }
+    std::istringstream in2(again.str());
+    Value w = JSONParser(in2).parse();
+    EXPECT_EQUAL(int(w["counters"]["test.requests"]["value"]), 2);
+    EXPECT(double(w["counters"]["test.requests"]["rate"]) > 0);
+
+    std::ostringstream metrics;
+    {
+        CollectMetrics collect;
+        Instruments::collect();
+        metrics << collect;
+    }
+    EXPECT(metrics.str().find("\"p99\"") != std::string::npos);
+}
+
+CASE("StatsHandle records latencies") {
+    Buffer data(1024 * 1024);
+    MemoryHandle source(data);
+    StatsHandle stats(source);
+
+    Buffer buffer(64 * 1024);
+    stats.openForRead();
+    while (stats.read(buffer, buffer.size()) > 0) {
+    }
+    stats.close();
+
+    std::ostringstream metrics;
+    {
+        CollectMetrics collect;
+        stats.collectMetrics("source");
+        metrics << collect;
+    }
+    EXPECT(metrics.str().find("\"source_read_latency\":{\"count\":17") != std::string::npos);
+}
+
+CASE("HistogramWatcher records transfers") {
+    const size_t size = 10 * 1024 * 1024;
+    Buffer data(size);
+
+    MemoryHandle source(data);
+    MemoryHandle target(size, true);
+
+    HistogramWatcher watcher;
+    source.saveInto(target, watcher);
+
+    EXPECT(watcher.latency().count() > 0);
+    EXPECT_EQUAL(watcher.sizes().sum(), size);
+
+    std::ostringstream metrics;
+    {
+        CollectMetrics collect;
+        watcher.collectMetrics("transfer");
+        metrics << collect;
+    }
+    EXPECT(metrics.str().find("transfer_block_latency") != std::string::npos);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
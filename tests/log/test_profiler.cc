@@ -0,0 +1,147 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "eckit/log/Profiler.h"
+#include "eckit/parser/JSONParser.h"
+#include "eckit/value/Value.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void inner() {
+    ECKIT_PROFILE_REGION("inner");
+}
+
+static void outer(size_t n) {
+    ECKIT_PROFILE_REGION("outer");
+    for (size_t i = 0; i < n; ++i) {
+        inner();
+    }
+}
+
+static const Profiler::Region& child(const Profiler::Region& r, const std::string& name) {
+    for (const auto& c : r.children) {
+        if (c.name == name) {
+            return c;
+        }
+    }
+    throw UserError("No region " + name);
+}
+
+CASE("Disabled regions are not recorded") {
+    Profiler& p = Profiler::instance();
+    p.enable(false);
+    p.reset();
+
+    outer(10);
+
+    EXPECT(p.tree().children.empty());
+}
+
+CASE("Call tree") {
+    Profiler& p = Profiler::instance();
+    p.enable(true);
+    p.reset();
+
+    outer(10);
+    outer(5);
+    inner();
+
+    p.enable(false);
+
+    Profiler::Region root = p.tree();
+    EXPECT_EQUAL(root.children.size(), 2);
+
+    const Profiler::Region& o = child(root, "outer");
+    EXPECT_EQUAL(o.calls, 2);
+    EXPECT_EQUAL(o.children.size(), 1);
+    EXPECT_EQUAL(child(o, "inner").calls, 15);
+
+    EXPECT_EQUAL(child(root, "inner").calls, 1);
+
+    EXPECT(o.total >= child(o, "inner").total);
+    EXPECT(o.min <= o.max);
+    EXPECT(o.self <= o.total);
+
+    std::ostringstream out;
+    p.report(out);
+    Log::info() << out.str();
+    EXPECT(out.str().find("    inner") != std::string::npos);
+}
+
+CASE("Threads are merged") {
+    Profiler& p = Profiler::instance();
+    p.enable(true);
+    p.reset();
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([] { outer(100); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    p.enable(false);
+
+    Profiler::Region root = p.tree();
+    const Profiler::Region& o = child(root, "outer");
+    EXPECT_EQUAL(o.calls, 4);
+    EXPECT_EQUAL(child(o, "inner").calls, 400);
+}
+
+CASE("Chrome trace") {
+    Profiler& p = Profiler::instance();
+    p.tracing(true);
+    p.enable(true);
+    p.reset();
+
+    outer(3);
+
+    p.enable(false);
+    p.tracing(false);
+
+    std::ostringstream out;
+    p.trace(out);
+
+    std::istringstream in(out.str());
+    JSONParser parser(in);
+    Value trace = parser.parse();
+
+    Value events = trace["traceEvents"];
+    size_t complete = 0;
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (std::string(events[i]["ph"]) == "X") {
+            complete++;
+            EXPECT(double(events[i]["dur"]) >= 0);
+        }
+    }
+    EXPECT_EQUAL(complete, 4);
+    size_t dropped = p.dropped();
+    EXPECT_EQUAL(dropped, 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
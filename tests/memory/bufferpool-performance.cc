@@ -0,0 +1,118 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Creates a buffer for each read, as much I/O code does, with new[] and with Buffer from the BufferPool, and counts
+// the time and the page faults. The bytes read per size can be set with ECKIT_BUFFER_POOL_PERFORMANCE_SIZE. Run with
+// ECKIT_BUFFER_POOL=0 to have Buffer use new[] as well.
+
+#include <sys/resource.h>
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Timer.h"
+#include "eckit/memory/BufferPool.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static long minorFaults() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+static void run(const std::string& name, size_t count, const std::function<void()>& f) {
+    long faults = minorFaults();
+    Timer timer(name, std::cout);
+    for (size_t i = 0; i < count; ++i) {
+        f();
+    }
+    timer.stop();
+    faults = minorFaults() - faults;
+
+    std::cout << "    " << std::setw(40) << std::left << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(3) << timer.elapsed() << " s  " << std::setw(10)
+              << std::setprecision(2) << timer.elapsed() * 1e6 / count << " us/buffer  " << std::setw(8)
+              << double(faults) / count << " faults/buffer" << std::endl;
+}
+
+CASE("A buffer for each read") {
+    size_t total = Resource<size_t>("$ECKIT_BUFFER_POOL_PERFORMANCE_SIZE", 2048UL * 1024 * 1024);
+
+    std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+    PathName path    = PathName::unique(base + "/bufferpool-performance");
+
+    const size_t fileSize = 64 * 1024 * 1024;
+    {
+        Buffer data(fileSize);
+        data.zero();
+        FileHandle f(path);
+        f.openForWrite(0);
+        f.write(data, long(data.size()));
+        f.close();
+    }
+
+    FileHandle file(path);
+    file.openForRead();
+
+    auto readInto = [&](void* buffer, size_t size) {
+        if (file.position() + Offset(size) > Offset(fileSize)) {
+            file.seek(0);
+        }
+        ASSERT(file.read(buffer, long(size)) == long(size));
+    };
+
+    for (size_t size : {size_t(64 * 1024), size_t(1024 * 1024), size_t(8 * 1024 * 1024), size_t(64 * 1024 * 1024)}) {
+        size_t count = std::max(total / size, size_t(1));
+        std::cout << count << " reads of " << Bytes(size) << std::endl;
+
+        run("new[]", count, [&] {
+            std::unique_ptr<char[]> buffer(new char[size]);
+            readInto(buffer.get(), size);
+        });
+
+        run("Buffer", count, [&] {
+            Buffer buffer(size);
+            readInto(buffer, size);
+        });
+    }
+
+    file.close();
+    path.unlink(false);
+
+    std::cout << BufferPool::statistics().allocations << " allocations, ";
+    BufferPool::print(std::cout);
+    std::cout << std::endl;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
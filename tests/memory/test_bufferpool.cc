@@ -0,0 +1,194 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <unistd.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "eckit/io/Buffer.h"
+#include "eckit/memory/BufferPool.h"
+#include "eckit/memory/MemoryBuffer.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static bool aligned(const void* p, size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+// The tests assume the defaults: pool enabled from 64 KiB
+CASE("Blocks are rounded up and aligned") {
+    const size_t page = size_t(::sysconf(_SC_PAGESIZE));
+
+    EXPECT(!BufferPool::pooled(1000));
+    EXPECT(BufferPool::capacity(1000) == 1000);
+
+    for (size_t size : {size_t(64 * 1024), size_t(100 * 1000), size_t(1024 * 1024 + 1), size_t(5 * 1024 * 1024)}) {
+        size_t capacity = BufferPool::capacity(size);
+        EXPECT(capacity >= size);
+        EXPECT(capacity <= size + size / 2 + page);
+        EXPECT(capacity % page == 0);
+
+        char* p = BufferPool::allocate(size);
+        EXPECT(aligned(p, size >= 2 * 1024 * 1024 ? 2 * 1024 * 1024 : page));
+        ::memset(p, 1, capacity);
+        BufferPool::deallocate(p, size);
+    }
+}
+
+CASE("Blocks are reused, first by the same thread") {
+    BufferPool::purge();
+
+    BufferPool::Statistics before = BufferPool::statistics();
+
+    char* p = BufferPool::allocate(200 * 1000);
+    BufferPool::deallocate(p, 200 * 1000);
+
+    // Same size class
+    char* q = BufferPool::allocate(BufferPool::capacity(200 * 1000));
+    EXPECT(q == p);
+    BufferPool::deallocate(q, BufferPool::capacity(200 * 1000));
+
+    BufferPool::Statistics after = BufferPool::statistics();
+    EXPECT(after.allocations == before.allocations + 2);
+    EXPECT(after.threadHits == before.threadHits + 1);
+    EXPECT(after.systemAllocations == before.systemAllocations + 1);
+
+    // Given to the shared pool when the thread ends
+    char* r = nullptr;
+    std::thread t([&] {
+        r = BufferPool::allocate(300 * 1000);
+        BufferPool::deallocate(r, 300 * 1000);
+    });
+    t.join();
+
+    EXPECT(BufferPool::statistics().cached >= BufferPool::capacity(300 * 1000));
+    char* s = BufferPool::allocate(300 * 1000);
+    EXPECT(s == r);
+    EXPECT(BufferPool::statistics().poolHits == after.poolHits + 1);
+    BufferPool::deallocate(s, 300 * 1000);
+
+    BufferPool::purge();
+    EXPECT(BufferPool::statistics().cached == 0);
+}
+
+CASE("Blocks kept by threads count against the capacity") {
+    BufferPool::purge();
+
+    // Each thread keeps up to 14 MiB (blocks of 8 and 6 MiB), more than the 256 MiB of the pool in total
+    const size_t threads = 24;
+    const size_t sizes[] = {8 * 1024 * 1024, 6 * 1024 * 1024};
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    size_t released = 0;
+    bool done       = false;
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([&] {
+            for (size_t size : sizes) {
+                BufferPool::deallocate(BufferPool::allocate(size), size);
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            released++;
+            cond.notify_all();
+            cond.wait(lock, [&] { return done; });
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&] { return released == threads; });
+
+        BufferPool::Statistics st = BufferPool::statistics();
+        EXPECT(st.threadCached > 0);
+        EXPECT(st.cached + st.threadCached <= 256 * 1024 * 1024);
+        EXPECT(st.systemReleases > 0);
+
+        done = true;
+        cond.notify_all();
+    }
+
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    BufferPool::Statistics st = BufferPool::statistics();
+    EXPECT(st.threadCached == 0);
+    EXPECT(st.cached <= 256 * 1024 * 1024);
+
+    BufferPool::purge();
+    EXPECT(BufferPool::statistics().cached == 0);
+}
+
+CASE("Buffer and MemoryBuffer use the pool") {
+    BufferPool::purge();
+
+    SECTION("Buffer") {
+        const void* data;
+        {
+            Buffer b(1024 * 1024);
+            ::memset(b, 7, b.size());
+            data = b.data();
+        }
+        Buffer b(1024 * 1024);
+        EXPECT(b.data() == data);
+
+        // Resized within its block, the data stays in place
+        b.resize(1000 * 1000, true);
+        EXPECT(b.data() == data);
+        EXPECT(b.size() == 1000 * 1000);
+        EXPECT(static_cast<const char*>(b.data())[1000 * 1000 - 1] == 7);
+
+        b.resize(10 * 1024 * 1024, true);
+        EXPECT(b.size() == 10 * 1024 * 1024);
+        EXPECT(static_cast<const char*>(b.data())[1000 * 1000 - 1] == 7);
+
+        b.resize(10);
+        EXPECT(b.size() == 10);
+
+        Buffer c(2 * 1024 * 1024);
+        c = std::move(b);
+        EXPECT(c.size() == 10);
+    }
+
+    SECTION("MemoryBuffer") {
+        const void* data;
+        {
+            MemoryBuffer b(512 * 1024);
+            data = b.data();
+        }
+        MemoryBuffer b(512 * 1024);
+        EXPECT(b.data() == data);
+        b.resize(100);
+        EXPECT(b.size() == 100);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
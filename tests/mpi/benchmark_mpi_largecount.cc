@@ -0,0 +1,148 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Times collectives, point-to-point and broadcastFile on large buffers.
+// The buffer size defaults to a size suitable for a unit test; to run over multi-GB buffers (more than 2^31 elements)
+// with a local MPI, e.g.:
+//
+//   ECKIT_MPI_BENCHMARK_BYTES=6000000000 mpirun -np 2 ./eckit_test_mpi_benchmark_largecount
+
+#include <fstream>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+#include "eckit/log/Timer.h"
+#include "eckit/mpi/Comm.h"
+#include "eckit/runtime/Main.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static size_t benchmarkBytes() {
+    static size_t bytes = Resource<size_t>("$ECKIT_MPI_BENCHMARK_BYTES", 64 * 1024 * 1024);
+    return bytes;
+}
+
+static void report(Timer& timer, size_t bytes) {
+    double s = timer.elapsed();
+    Log::info() << "    " << Bytes(bytes) << " in " << s << "s, " << Bytes(double(bytes), s) << std::endl;
+}
+
+CASE("benchmark broadcast") {
+    auto& comm   = mpi::comm("world");
+    size_t bytes = benchmarkBytes();
+
+    std::vector<char> v(bytes, comm.rank() == 0 ? 'x' : 0);
+
+    comm.barrier();
+    Timer timer("broadcast", Log::debug());
+    comm.broadcast(v, 0);
+    comm.barrier();
+    timer.stop();
+
+    if (comm.rank() == 0) {
+        report(timer, bytes);
+    }
+    EXPECT(v.back() == 'x');
+}
+
+CASE("benchmark allReduceInPlace") {
+    auto& comm   = mpi::comm("world");
+    size_t count = benchmarkBytes() / sizeof(float);
+
+    std::vector<float> v(count, 1.f);
+
+    comm.barrier();
+    Timer timer("allReduceInPlace", Log::debug());
+    comm.allReduceInPlace(v.data(), v.size(), mpi::sum());
+    timer.stop();
+
+    if (comm.rank() == 0) {
+        report(timer, count * sizeof(float));
+    }
+    EXPECT(v.back() == float(comm.size()));
+}
+
+CASE("benchmark send and receive") {
+    auto& comm   = mpi::comm("world");
+    size_t bytes = benchmarkBytes();
+    size_t last  = comm.size() - 1;
+    int tag      = 7;
+
+    if (comm.size() < 2) {
+        return;
+    }
+
+    std::vector<char> v;
+    if (comm.rank() == 0 || comm.rank() == last) {
+        v.resize(bytes, comm.rank() == 0 ? 'y' : 0);
+    }
+
+    comm.barrier();
+    Timer timer("send/receive", Log::debug());
+    if (comm.rank() == 0) {
+        comm.send(v.data(), v.size(), last, tag);
+    }
+    if (comm.rank() == last) {
+        mpi::Status st = comm.receive(v.data(), v.size(), 0, tag);
+        EXPECT(comm.getCount<char>(st) == bytes);
+        EXPECT(v.back() == 'y');
+    }
+    comm.barrier();
+    timer.stop();
+
+    if (comm.rank() == 0) {
+        report(timer, bytes);
+    }
+}
+
+CASE("benchmark broadcastFile") {
+    auto& comm   = mpi::comm("world");
+    size_t bytes = benchmarkBytes();
+
+    LocalPathName path(eckit::Main::instance().name() + "_benchmark.dat");
+    if (comm.rank() == 0) {
+        std::vector<char> v(bytes, 'z');
+        std::ofstream file(path.c_str(), std::ios_base::out | std::ios_base::binary);
+        file.write(v.data(), v.size());
+        file.close();
+    }
+
+    comm.barrier();
+    Timer timer("broadcastFile", Log::debug());
+    SharedBuffer buffer = comm.broadcastFile(path, 0);
+    comm.barrier();
+    timer.stop();
+
+    if (comm.rank() == 0) {
+        report(timer, bytes);
+        path.unlink();
+    }
+    EXPECT(buffer.size() == bytes);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    int failures = run_tests(argc, argv);
+    eckit::mpi::finaliseAllComms();
+    return failures;
+}
@@ -0,0 +1,96 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Compares loading a file on every task (broadcastFile) with loading it once per node into shared memory
+// (broadcastFileShared): time, and memory held on each node. To run on a many-rank node, e.g.:
+//
+//   ECKIT_MPI_BENCHMARK_BYTES=1000000000 mpirun -np 64 ./eckit_test_mpi_benchmark_shared
+
+#include <fstream>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+#include "eckit/log/Timer.h"
+#include "eckit/mpi/Comm.h"
+#include "eckit/runtime/Main.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("benchmark broadcastFile and broadcastFileShared") {
+    auto& comm = mpi::comm("world");
+    auto& node = comm.splitShared("node");
+
+    size_t bytes = Resource<size_t>("$ECKIT_MPI_BENCHMARK_BYTES", 64 * 1024 * 1024);
+
+    LocalPathName path(eckit::Main::instance().name() + "_benchmark.dat");
+    if (comm.rank() == 0) {
+        std::vector<char> v(bytes, 'z');
+        std::ofstream file(path.c_str(), std::ios_base::out | std::ios_base::binary);
+        file.write(v.data(), v.size());
+        file.close();
+    }
+    comm.barrier();
+
+    {
+        comm.barrier();
+        Timer timer("broadcastFile", Log::debug());
+        SharedBuffer buffer = comm.broadcastFile(path, 0);
+        comm.barrier();
+        timer.stop();
+
+        EXPECT(buffer.size() == bytes);
+        if (comm.rank() == 0) {
+            Log::info() << "    broadcastFile:       " << timer.elapsed() << "s, "
+                        << Bytes(double(bytes * node.size())) << " per node" << std::endl;
+        }
+    }
+
+    {
+        comm.barrier();
+        Timer timer("broadcastFileShared", Log::debug());
+        mpi::SharedArray<char> data(comm.broadcastFileShared(path, 0));
+        comm.barrier();
+        timer.stop();
+
+        EXPECT(data.size() == bytes);
+        EXPECT(data[bytes - 1] == 'z');
+        if (comm.rank() == 0) {
+            Log::info() << "    broadcastFileShared: " << timer.elapsed() << "s, " << Bytes(double(bytes))
+                        << " per node" << std::endl;
+        }
+    }
+
+    comm.barrier();
+    if (comm.rank() == 0) {
+        path.unlink();
+    }
+
+    mpi::deleteComm("node");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    int failures = run_tests(argc, argv);
+    eckit::mpi::finaliseAllComms();
+    return failures;
+}
@@ -0,0 +1,73 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/log/Histogram.h"
+#include "eckit/mpi/Comm.h"
+#include "eckit/mpi/Histogram.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("allReduce") {
+    auto& comm  = mpi::comm("world");
+    size_t rank = comm.rank();
+    size_t size = comm.size();
+
+    // Rank r records 1000 * r .. 1000 * r + 999
+    Histogram local;
+    Histogram expected;
+    for (size_t r = 0; r < size; ++r) {
+        for (uint64_t i = 0; i < 1000; ++i) {
+            expected.record(1000 * r + i);
+            if (r == rank) {
+                local.record(1000 * r + i);
+            }
+        }
+    }
+
+    Histogram h = mpi::allReduce(local, comm);
+
+    EXPECT(h.buckets() == expected.buckets());
+    EXPECT_EQUAL(h.count(), expected.count());
+    EXPECT_EQUAL(h.sum(), expected.sum());
+    EXPECT_EQUAL(h.min(), 0);
+    EXPECT_EQUAL(h.max(), 1000 * size - 1);
+    EXPECT_EQUAL(h.percentile(99), expected.percentile(99));
+}
+
+CASE("allReduce with empty ranks") {
+    auto& comm = mpi::comm("world");
+
+    Histogram local;
+    if (comm.rank() == comm.size() - 1) {
+        local.record(42);
+    }
+
+    Histogram h = mpi::allReduce(local, comm);
+    EXPECT_EQUAL(h.count(), 1);
+    EXPECT_EQUAL(h.min(), 42);
+    EXPECT_EQUAL(h.max(), 42);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    int failures = run_tests(argc, argv);
+    eckit::mpi::finaliseAllComms();
+    return failures;
+}
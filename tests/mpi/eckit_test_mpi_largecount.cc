@@ -0,0 +1,183 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Exercises the large count code paths (derived datatypes, chunking) with small buffers, by running with
+// ECKIT_MPI_MAX_COUNT lowered well below the buffer sizes used here.
+
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/mpi/Comm.h"
+#include "eckit/runtime/Main.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static const size_t N = 1000 + 7;  // not a multiple of the chunk size
+
+CASE("broadcast") {
+    auto& comm = mpi::comm("world");
+
+    std::vector<double> v(N, 0.);
+    if (comm.rank() == 0) {
+        std::iota(v.begin(), v.end(), 1.);
+    }
+
+    comm.broadcast(v, 0);
+
+    EXPECT(v.front() == 1.);
+    EXPECT(v.back() == double(N));
+}
+
+CASE("broadcast, more chunks than the maximum count") {
+    auto& comm = mpi::comm("world");
+
+    // Above the square of ECKIT_MPI_MAX_COUNT, the blocks themselves are nested
+    const size_t n = 3 * 100 * 100 + 7;
+
+    std::vector<int> v(n, 0);
+    if (comm.rank() == 0) {
+        std::iota(v.begin(), v.end(), 1);
+    }
+
+    comm.broadcast(v, 0);
+
+    EXPECT(v.front() == 1);
+    EXPECT(v[n / 2] == int(n / 2 + 1));
+    EXPECT(v.back() == int(n));
+}
+
+CASE("allReduce") {
+    auto& comm = mpi::comm("world");
+
+    std::vector<long> send(N);
+    std::iota(send.begin(), send.end(), 0);
+    std::vector<long> recv(N, -1);
+
+    comm.allReduce(send, recv, mpi::sum());
+
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT(recv[i] == long(i * comm.size()));
+    }
+
+    comm.allReduceInPlace(send.begin(), send.end(), mpi::max());
+    EXPECT(send.back() == long(N - 1));
+}
+
+CASE("reduce") {
+    auto& comm = mpi::comm("world");
+
+    std::vector<int> v(N, 1);
+    comm.reduceInPlace(v.begin(), v.end(), mpi::sum(), 0);
+
+    if (comm.rank() == 0) {
+        EXPECT(v[0] == int(comm.size()));
+        EXPECT(v[N - 1] == int(comm.size()));
+    }
+}
+
+CASE("gather, scatter and allToAll") {
+    auto& comm = mpi::comm("world");
+
+    std::vector<float> send(N * comm.size(), float(comm.rank()));
+    std::vector<float> recv(N * comm.size(), -1.f);
+
+    comm.allToAll(send, recv);
+
+    for (size_t r = 0; r < comm.size(); ++r) {
+        EXPECT(recv[r * N] == float(r));
+        EXPECT(recv[r * N + N - 1] == float(r));
+    }
+
+    std::vector<float> gathered(N * comm.size() * comm.size(), -1.f);
+    comm.gather(send, gathered, 0);
+    if (comm.rank() == 0) {
+        for (size_t r = 0; r < comm.size(); ++r) {
+            EXPECT(gathered[r * N * comm.size()] == float(r));
+        }
+    }
+
+    std::vector<float> scattered(N * comm.size(), -1.f);
+    comm.scatter(gathered, scattered, 0);
+    EXPECT(scattered == send);
+}
+
+CASE("send and receive") {
+    auto& comm = mpi::comm("world");
+    int tag    = 42;
+
+    std::vector<double> v(N);
+    std::iota(v.begin(), v.end(), 0.);
+
+    size_t last = comm.size() - 1;
+
+    if (comm.rank() == 0) {
+        comm.send(v.data(), v.size(), last, tag);
+        mpi::Request r = comm.iSend(v.data(), v.size(), last, tag + 1);
+        comm.wait(r);
+    }
+
+    if (comm.rank() == last) {
+        std::vector<double> recv(N + 10, -1.);  // larger than the message
+
+        mpi::Status st = comm.receive(recv.data(), recv.size(), 0, tag);
+        EXPECT(comm.getCount<double>(st) == N);
+        EXPECT(recv[N - 1] == double(N - 1));
+        EXPECT(recv[N] == -1.);
+
+        std::vector<double> irecv(N, -1.);
+        mpi::Request r = comm.iReceive(irecv.data(), irecv.size(), 0, tag + 1);
+        comm.wait(r);
+        EXPECT(irecv == v);
+    }
+}
+
+CASE("broadcastFile") {
+    auto& comm  = mpi::comm("world");
+    size_t root = 0;
+
+    std::string str(3 * N + 1, 'x');
+    for (size_t i = 0; i < str.size(); ++i) {
+        str[i] = char('a' + i % 26);
+    }
+
+    LocalPathName path(eckit::Main::instance().name() + "_largecount_broadcastFile.txt");
+    if (comm.rank() == root) {
+        std::ofstream file(path.c_str(), std::ios_base::out);
+        file << str;
+        file.close();
+    }
+    comm.barrier();
+
+    EXPECT(comm.broadcastFile(path, root).str() == str);
+
+    comm.barrier();
+    if (comm.rank() == root) {
+        path.unlink();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    int failures = run_tests(argc, argv);
+    eckit::mpi::finaliseAllComms();
+    return failures;
+}
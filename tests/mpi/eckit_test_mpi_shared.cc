@@ -0,0 +1,137 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/mpi/Comm.h"
+#include "eckit/runtime/Main.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("splitShared") {
+    auto& comm = mpi::comm("world");
+    auto& node = comm.splitShared("node");
+
+    EXPECT(mpi::hasComm("node"));
+    EXPECT(node.size() >= 1);
+    EXPECT(node.size() <= comm.size());
+
+    // all tasks of the node run on the same host
+    std::string host = node.processorName();
+    std::vector<char> hosts(host.begin(), host.end());
+    node.broadcast(hosts, 0);
+    EXPECT(std::string(hosts.begin(), hosts.end()) == host);
+
+    mpi::deleteComm("node");
+}
+
+CASE("allocateShared") {
+    auto& node = mpi::comm("world").splitShared("node");
+
+    SECTION("written by the root") {
+        size_t root = node.size() - 1;
+
+        mpi::SharedArray<double> a = node.allocateShared<double>(1000, root);
+        EXPECT(a.size() == 1000);
+        EXPECT(a.window().size() == 1000 * sizeof(double));
+
+        if (node.rank() == root) {
+            for (size_t i = 0; i < a.size(); ++i) {
+                a[i] = double(i);
+            }
+        }
+        a.sync();
+
+        for (size_t i = 0; i < a.size(); ++i) {
+            EXPECT(a[i] == double(i));
+        }
+        a.sync();
+    }
+
+    SECTION("written by all tasks") {
+        auto a = node.allocateShared<int>(node.size());
+        EXPECT(a.size() == node.size());
+
+        a[node.rank()] = int(node.rank()) + 1;
+        a.sync();
+
+        for (size_t i = 0; i < a.size(); ++i) {
+            EXPECT(a[i] == int(i) + 1);
+        }
+        a.sync();
+    }
+
+    SECTION("copies share the memory") {
+        mpi::SharedWindow w = node.allocateSharedWindow(16);
+        mpi::SharedWindow copy(w);
+        EXPECT(copy.data() == w.data());
+        EXPECT(copy.size() == 16);
+        w.sync();
+    }
+
+    SECTION("empty") {
+        auto a = node.allocateShared<char>(0);
+        EXPECT(a.empty());
+    }
+
+    mpi::deleteComm("node");
+}
+
+CASE("broadcastFileShared") {
+    auto& comm = mpi::comm("world");
+
+    std::string str(10007, 'x');
+    for (size_t i = 0; i < str.size(); ++i) {
+        str[i] = char('a' + i % 26);
+    }
+
+    for (size_t root : {size_t(0), comm.size() - 1}) {
+        LocalPathName path(eckit::Main::instance().name() + "_broadcastFileShared.txt");
+        if (comm.rank() == root) {
+            std::ofstream file(path.c_str(), std::ios_base::out);
+            file << str;
+            file.close();
+        }
+        comm.barrier();
+
+        mpi::SharedArray<char> data(comm.broadcastFileShared(path, root));
+        EXPECT(std::string(data.begin(), data.end()) == str);
+
+        comm.barrier();
+        if (comm.rank() == root) {
+            path.unlink();
+        }
+    }
+
+    SECTION("missing file") {
+        EXPECT_THROWS_AS(comm.broadcastFileShared("/this/file/does/not/exist", 0), CantOpenFile);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    int failures = run_tests(argc, argv);
+    eckit::mpi::finaliseAllComms();
+    return failures;
+}
@@ -0,0 +1,128 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Contention on the task slots: each thread updates the status of its own slot while a reader takes snapshots of
+// all of them, as PsCmd does. The seqlock slots are compared against the same updates serialised by one
+// cross-process semaphore. Threads and iterations can be set with ECKIT_MONITOR_BENCHMARK_THREADS and
+// ECKIT_MONITOR_BENCHMARK_ITERATIONS.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/TmpFile.h"
+#include "eckit/log/Log.h"
+#include "eckit/os/Semaphore.h"
+#include "eckit/runtime/TaskInfo.h"
+#include "eckit/thread/AutoLock.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Result {
+    double ns;
+    size_t snapshots;
+};
+
+static Result run(size_t threads, size_t n, Semaphore* sem) {
+    // Zeroed slots, as in the Monitor's mapped array
+    std::unique_ptr<TaskSnapshot[]> slots(new TaskSnapshot[threads]);
+
+    std::atomic<size_t> ready(0);
+    std::atomic<bool> done(false);
+
+    size_t snapshots = 0;
+    std::thread reader([&] {
+        TaskSnapshot copy;
+        while (!done) {
+            for (size_t t = 0; t < ready; ++t) {
+                if (sem) {
+                    AutoLock<Semaphore> lock(sem);
+                    copy.take(slots[t].info());
+                }
+                else {
+                    copy.take(slots[t].info());
+                }
+                snapshots++;
+            }
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < threads; ++t) {
+        writers.emplace_back([&, t] {
+            TaskInfo& info = *new (&slots[t].info()) TaskInfo();
+            ready++;
+            std::string status("Processing request");
+            for (size_t i = 0; i < n; ++i) {
+                if (sem) {
+                    AutoLock<Semaphore> lock(sem);
+                    info.status(status);
+                }
+                else {
+                    info.status(status);
+                }
+            }
+        });
+    }
+
+    for (auto& w : writers) {
+        w.join();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+
+    done = true;
+    reader.join();
+
+    TaskSnapshot copy;
+    for (size_t t = 0; t < threads; ++t) {
+        EXPECT(copy.take(slots[t].info()));
+        EXPECT(std::string(copy->status()) == "Processing request");
+    }
+
+    return {ns, snapshots};
+}
+
+CASE("Status updates under contention") {
+    size_t threads = Resource<size_t>("$ECKIT_MONITOR_BENCHMARK_THREADS", 8);
+    size_t n       = Resource<size_t>("$ECKIT_MONITOR_BENCHMARK_ITERATIONS", 100000);
+
+    TmpFile path;
+    Semaphore sem(path);
+
+    for (size_t t = 1; t <= threads; t *= 2) {
+        Result seqlock   = run(t, n, nullptr);
+        Result semaphore = run(t, n, &sem);
+        Log::info() << "    " << t << " threads: seqlock " << seqlock.ns << " ns per update, " << seqlock.snapshots
+                    << " snapshots; semaphore " << semaphore.ns << " ns per update, " << semaphore.snapshots
+                    << " snapshots" << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
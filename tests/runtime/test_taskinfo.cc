@@ -0,0 +1,149 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <atomic>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/log/JSON.h"
+#include "eckit/parser/JSONParser.h"
+#include "eckit/runtime/Monitor.h"
+#include "eckit/runtime/TaskInfo.h"
+#include "eckit/value/Value.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Slots live in zeroed memory, as in the Monitor's mapped array
+alignas(TaskInfo) static char slot[sizeof(TaskInfo)];
+
+CASE("Snapshot of a slot") {
+    TaskInfo& info = *new (slot) TaskInfo();
+
+    info.status("Reading");
+    info.message("file.grib");
+    info.progress(10);
+    info.bytesRead(1024);
+    info.bytesWritten(16);
+
+    TaskSnapshot copy;
+    EXPECT(copy.take(info));
+
+    std::string status(copy->status());
+    std::string message(copy->message());
+    unsigned long long val          = copy->val();
+    unsigned long long bytesRead    = copy->bytesRead();
+    unsigned long long bytesWritten = copy->bytesWritten();
+    EXPECT_EQUAL(status, "Reading");
+    EXPECT_EQUAL(message, "file.grib");
+    EXPECT_EQUAL(val, 10);
+    EXPECT_EQUAL(bytesRead, 1024);
+    EXPECT_EQUAL(bytesWritten, 16);
+    EXPECT(copy->cpuUser() >= 0);
+
+    // The copy is private
+    info.status("Writing");
+    EXPECT(std::string(copy->status()) == "Reading");
+
+    std::ostringstream out;
+    {
+        JSON json(out);
+        copy->json(json, 42);
+    }
+    std::istringstream in(out.str());
+    Value v = JSONParser(in).parse();
+    EXPECT_EQUAL(long(v["id"]), 42);
+    EXPECT_EQUAL(long(v["bytesRead"]), 1024);
+
+    info.TaskInfo::~TaskInfo();
+}
+
+CASE("Snapshots are consistent while the slot is updated") {
+    std::atomic<bool> ready(false);
+    std::atomic<bool> done(false);
+
+    // The slot belongs to the writer thread, whose statuses are strings of one repeated letter
+    std::thread writer([&] {
+        TaskInfo& info = *new (slot) TaskInfo();
+        ready          = true;
+        for (size_t i = 0; i < 200000; ++i) {
+            info.status(std::string(1 + (i * 7) % 250, char('a' + i % 26)));
+        }
+        done = true;
+    });
+
+    while (!ready) {
+        std::this_thread::yield();
+    }
+
+    const TaskInfo& info = *reinterpret_cast<TaskInfo*>(slot);
+    TaskSnapshot copy;
+    size_t taken = 0;
+    size_t torn  = 0;
+    while (!done) {
+        if (copy.take(info)) {
+            taken++;
+            std::string status(copy->status());
+            if (status.find_first_not_of(status[0]) != std::string::npos) {
+                torn++;
+            }
+        }
+    }
+    writer.join();
+
+    Log::info() << taken << " snapshots taken" << std::endl;
+    EXPECT_EQUAL(torn, 0);
+    EXPECT(copy.take(info));
+}
+
+CASE("File I/O counts bytes only on threads that have a monitor") {
+    PathName path("test_taskinfo.data");
+    bool monitored = true;
+
+    // A worker thread must not take a monitor slot just by reading or writing a file
+    std::thread worker([&] {
+        {
+            FileHandle out(path);
+            out.openForWrite(0);
+            out.write("0123456789", 10);
+            out.close();
+        }
+        {
+            char buffer[10];
+            FileHandle in(path);
+            in.openForRead();
+            in.read(buffer, sizeof(buffer));
+            in.close();
+        }
+        monitored = Monitor::current() != nullptr;
+    });
+    worker.join();
+    path.unlink();
+
+    EXPECT(!monitored);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
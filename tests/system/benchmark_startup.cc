@@ -0,0 +1,142 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Startup time of a short-lived tool, with and without the startup cache: this executable runs itself as a child
+// that only initialises Main, with a directory of plugin manifests to scan. The number of manifests and of runs can
+// be set with ECKIT_STARTUP_BENCHMARK_MANIFESTS and ECKIT_STARTUP_BENCHMARK_RUNS.
+
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/filesystem/TmpDir.h"
+#include "eckit/log/Log.h"
+#include "eckit/runtime/Main.h"
+#include "eckit/system/LibraryManager.h"
+#include "eckit/system/Plugin.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class BenchmarkPlugin : system::Plugin {
+public:
+    BenchmarkPlugin() :
+        Plugin("startup-benchmark") {}
+    static const BenchmarkPlugin& instance() {
+        static BenchmarkPlugin instance;
+        return instance;
+    }
+    std::string version() const override { return "0.0.0"; }
+    std::string gitsha1(unsigned int count) const override { return "undefined"; }
+};
+
+REGISTER_LIBRARY(BenchmarkPlugin);
+
+static char* self = nullptr;
+
+// Not modified in the second the cache is written, see StartupCache
+static void age(const PathName& path) {
+    ::timeval times[2];
+    ::gettimeofday(&times[0], nullptr);
+    times[0].tv_sec -= 10;
+    times[1] = times[0];
+    ::utimes(path.localPath(), times);
+}
+
+static void manifests(const PathName& dir, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        std::string name = i == 0 ? std::string("startup-benchmark") : "plugin-" + std::to_string(i);
+        PathName path = dir / (name + ".yml");
+        std::ofstream out(path.localPath());
+        out << "plugin:\n"
+            << "  name: " << name << "\n"
+            << "  namespace: bench\n"
+            << "  library: " << name << "\n"
+            << "  description: a plugin manifest, parsed at startup unless cached\n";
+        out.close();
+        age(path);
+    }
+    age(dir);
+}
+
+static double run(size_t runs) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < runs; ++i) {
+        pid_t pid = ::fork();
+        ASSERT(pid >= 0);
+        if (pid == 0) {
+            char* argv[] = {self, nullptr};
+            ::setenv("ECKIT_STARTUP_BENCHMARK_CHILD", "1", 1);
+            ::execv(self, argv);
+            ::_exit(127);
+        }
+        int status = 0;
+        ASSERT(::waitpid(pid, &status, 0) == pid);
+        ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+}
+
+CASE("Startup time") {
+    size_t n    = Resource<size_t>("$ECKIT_STARTUP_BENCHMARK_MANIFESTS", 200);
+    size_t runs = Resource<size_t>("$ECKIT_STARTUP_BENCHMARK_RUNS", 20);
+
+    TmpDir dir;
+    manifests(dir, n);
+    PathName cache = dir.dirName() / (dir.baseName() + ".cache");
+
+    ::setenv("PLUGINS_MANIFEST_PATH", dir.localPath(), 1);
+    ::setenv("LOAD_PLUGINS", "bench.startup-benchmark", 1);
+
+    ::unsetenv("ECKIT_STARTUP_CACHE");
+    double plain = run(runs);
+
+    ::setenv("ECKIT_STARTUP_CACHE", cache.localPath(), 1);
+    run(1);  // fills the cache
+    EXPECT(cache.exists());
+    double cached = run(runs);
+
+    ::setenv("ECKIT_LAZY_PLUGINS", "1", 1);
+    double lazy = run(runs);
+
+    Log::info() << "    " << n << " manifests: " << plain << " ms per startup, " << cached << " ms with the cache, "
+                << lazy << " ms with the cache and lazy plugins" << std::endl;
+
+    cache.unlink();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    if (::getenv("ECKIT_STARTUP_BENCHMARK_CHILD")) {
+        // The tool being started
+        Main::initialise(argc, argv);
+        system::LibraryManager::lookupPlugin("startup-benchmark");
+        return 0;
+    }
+
+    eckit::test::self = argv[0];
+    return run_tests(argc, argv);
+}
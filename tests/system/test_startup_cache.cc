@@ -0,0 +1,254 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <sys/time.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/filesystem/TmpDir.h"
+#include "eckit/log/Log.h"
+#include "eckit/memory/Builder.h"
+#include "eckit/memory/Factory.h"
+#include "eckit/system/LibraryManager.h"
+#include "eckit/system/Plugin.h"
+#include "eckit/system/StartupCache.h"
+#include "eckit/utils/Compressor.h"
+#include "eckit/utils/Hash.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+using eckit::system::LibraryManager;
+using eckit::system::Plugin;
+using eckit::system::StartupCache;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static bool initialised = false;
+
+class LazyPlugin : Plugin {
+public:
+    LazyPlugin() :
+        Plugin("startup-cache-test") {}
+    static const LazyPlugin& instance() {
+        static LazyPlugin instance;
+        return instance;
+    }
+    void init() override { initialised = true; }
+    std::string version() const override { return "0.0.0"; }
+    std::string gitsha1(unsigned int count) const override { return "undefined"; }
+};
+
+REGISTER_LIBRARY(LazyPlugin);
+
+static std::atomic<bool> slowInitialised{false};
+
+/// Takes a while to load
+class SlowPlugin : Plugin {
+public:
+    SlowPlugin() :
+        Plugin("startup-cache-slow") {}
+    static const SlowPlugin& instance() {
+        static SlowPlugin instance;
+        return instance;
+    }
+    void init() override {
+        ::usleep(100000);
+        slowInitialised = true;
+    }
+    std::string version() const override { return "0.0.0"; }
+    std::string gitsha1(unsigned int count) const override { return "undefined"; }
+};
+
+class LazyProduct {
+public:
+    typedef BuilderT0<LazyProduct> builder_t;
+    static std::string className() { return "eckit_test.LazyProduct"; }
+    virtual ~LazyProduct() = default;
+};
+
+// Dates back a path, so that it is not modified in the second the cache is written
+static void age(const PathName& path) {
+    ::timeval times[2];
+    ::gettimeofday(&times[0], nullptr);
+    times[0].tv_sec -= 10;
+    times[1] = times[0];
+    ::utimes(path.localPath(), times);
+}
+
+static PathName manifest(const PathName& dir, const std::string& name) {
+    PathName path = dir / (name + ".yml");
+    std::ofstream out(path.localPath());
+    out << "plugin:\n  name: " << name << "\n  namespace: test\n  library: " << name << "\n";
+    out.close();
+    age(path);
+    age(dir);
+    return path;
+}
+
+// The manifest search path is read once, the cases loading the plugin share it
+static void lazyPluginManifest() {
+    static TmpDir dir;
+    static PathName path = manifest(dir, "startup-cache-test");
+    static PathName slow = manifest(dir, "startup-cache-slow");
+    ::setenv("PLUGINS_MANIFEST_PATH", dir.localPath(), 1);
+    ::setenv("ECKIT_LAZY_PLUGINS", "1", 1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Manifests are cached until their directory changes") {
+    TmpDir dir;
+    PathName file = manifest(dir, "one");
+    PathName cache = dir.dirName() / (dir.baseName() + ".cache");
+
+    std::vector<std::string> scan{dir.asString(), "/does/not/exist"};
+    std::vector<StartupCache::Manifest> found;
+
+    {
+        StartupCache c(cache);
+        EXPECT(!c.manifests(scan, found));
+        c.manifests(scan, {file.asString()}, {{"one", "test", "one"}});
+        c.save();
+    }
+
+    {
+        StartupCache c(cache);
+        EXPECT(c.manifests(scan, found));
+        EXPECT_EQUAL(found.size(), 1);
+        EXPECT_EQUAL(found[0].library, "one");
+
+        // Other scan paths
+        EXPECT(!c.manifests({dir.asString()}, found));
+    }
+
+    // A new manifest changes the directory
+    manifest(dir, "two");
+    ::timeval now[2];
+    ::gettimeofday(&now[0], nullptr);
+    now[1] = now[0];
+    ::utimes(dir.localPath(), now);
+
+    {
+        StartupCache c(cache);
+        EXPECT(!c.manifests(scan, found));
+    }
+
+    cache.unlink();
+}
+
+CASE("Library paths are cached") {
+    TmpDir dir;
+    age(dir);
+    PathName cache = dir.dirName() / (dir.baseName() + ".cache");
+
+    std::vector<std::string> paths{dir.asString()};
+    std::string found;
+
+    {
+        StartupCache c(cache);
+        EXPECT(!c.library("libfoo.so", paths, found));
+        c.library("libfoo.so", paths, "/some/where/libfoo.so");
+        c.library("libbar.so", paths, "");
+        c.save();
+    }
+
+    {
+        StartupCache c(cache);
+        EXPECT(c.library("libfoo.so", paths, found));
+        EXPECT_EQUAL(found, "/some/where/libfoo.so");
+        EXPECT(c.library("libbar.so", paths, found));
+        EXPECT_EQUAL(found, "");
+        EXPECT(!c.library("libbaz.so", paths, found));
+    }
+
+    cache.unlink();
+}
+
+CASE("Disabled cache") {
+    StartupCache c("");
+    std::vector<StartupCache::Manifest> found;
+    EXPECT(!c.enabled());
+    EXPECT(!c.manifests({"/tmp"}, found));
+}
+
+CASE("Deferred plugins are loaded on first lookup") {
+    LazyPlugin::instance();
+
+    lazyPluginManifest();
+
+    LibraryManager::autoLoadPlugins({"test.startup-cache-test"});
+    EXPECT(!initialised);
+
+    // Any factory missing a builder loads them
+    EXPECT_THROWS(HashFactory::instance().build("no-such-hash"));
+    EXPECT(initialised);
+    EXPECT(!LibraryManager::loadDeferredPlugins());
+
+    // The other lookups of DeferredPlugins.h in this library, each with plugins deferred again
+    std::vector<std::pair<std::string, std::function<void()>>> lookups{
+        {"Factory<T>::get", [] { Factory<LazyProduct>::instance().get("no-such-builder"); }},
+        {"CompressorFactory", [] { std::unique_ptr<Compressor>(CompressorFactory::instance().build("no-such")); }},
+        {"PathNameFactory", [] { PathName("nosuch://path"); }},
+        {"LibraryManager::lookupPlugin", [] { LibraryManager::lookupPlugin("no-such-plugin"); }},
+    };
+
+    for (const auto& lookup : lookups) {
+        Log::info() << "Lookup: " << lookup.first << std::endl;
+        LibraryManager::autoLoadPlugins({"test.startup-cache-test"});
+        EXPECT_THROWS(lookup.second());
+        EXPECT(!LibraryManager::loadDeferredPlugins());
+    }
+}
+
+CASE("Threads missing a builder while deferred plugins load wait for them") {
+    SlowPlugin::instance();
+
+    lazyPluginManifest();
+    LibraryManager::autoLoadPlugins({"test.startup-cache-slow"});
+
+    std::atomic<size_t> loaded{0};
+    std::atomic<size_t> waited{0};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            loaded += LibraryManager::loadDeferredPlugins();
+            waited += slowInitialised;
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    size_t l = loaded;
+    size_t w = waited;
+    EXPECT(l >= 1);
+    EXPECT_EQUAL(w, 4);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
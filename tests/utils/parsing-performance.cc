@@ -0,0 +1,127 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <iostream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "eckit/log/Timer.h"
+#include "eckit/types/Date.h"
+#include "eckit/utils/Tokenizer.h"
+#include "eckit/utils/Translator.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit {
+namespace test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// A request as our parsers see them
+static const std::string request(
+    "class=od,expver=0001,stream=oper,type=fc,levtype=pl,levelist=1000/850/700/500/400/300,"
+    "param=130.128/131.128/132.128,date=2024-01-15,time=1200,step=0/6/12/18/24/30/36/42/48,grid=0.25/0.25");
+
+static const std::string numbers("0.25,1.5,273.15,-12.75,1e-3,101325,0.0065,9.80665,287.05,1013.25");
+
+template <typename F>
+void time(const char* name, size_t n, F f) {
+    Timer timer;
+    size_t count = 0;
+
+    timer.start();
+    for (size_t i = 0; i < n; ++i) {
+        count += f();
+    }
+    timer.stop();
+
+    EXPECT(count > 0);
+    std::cout << " - " << name << ": " << timer.elapsed() * 1e9 / n << " ns" << std::endl;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Tokenizer") {
+    const size_t n = 200000;
+    Tokenizer parse(",=/");
+
+    time("vector<string>", n, [&] {
+        std::vector<std::string> v;
+        parse(request, v);
+        return v.size();
+    });
+
+    time("set<string>", n, [&] {
+        std::set<std::string> v;
+        parse(request, v);
+        return v.size();
+    });
+
+    time("vector<string_view>", n, [&] {
+        std::vector<std::string_view> v;
+        parse(std::string_view(request), v);
+        return v.size();
+    });
+
+    time("tokens()", n, [&] {
+        size_t count = 0;
+        for (std::string_view token : parse.tokens(request)) {
+            count += !token.empty();
+        }
+        return count;
+    });
+}
+
+CASE("Numbers") {
+    const size_t n = 200000;
+    Tokenizer parse(",");
+
+    time("tokenize, Translator<string, double>", n, [&] {
+        double sum = 0;
+        for (const auto& token : parse.tokenize(numbers)) {
+            sum += Translator<std::string, double>()(token);
+        }
+        return sum != 0;
+    });
+
+    time("tokens(), Translator<string_view, double>", n, [&] {
+        double sum = 0;
+        for (std::string_view token : parse.tokens(numbers)) {
+            sum += Translator<std::string_view, double>()(token);
+        }
+        return sum != 0;
+    });
+
+    time("Translator<string, long>", n, [&] {
+        return Translator<std::string, long>()("101325") + Translator<std::string, long>()("64MiB");
+    });
+}
+
+CASE("Dates") {
+    const size_t n = 200000;
+
+    time("Date::parse(yyyy-mm-dd)", n, [&] { return Date::parse("2024-01-15"); });
+    time("Date::parse(yyyymmdd)", n, [&] { return Date::parse("20240115"); });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace eckit
+
+int main(int argc, char* argv[]) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,147 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+// Synchronises a synthetic tree of large and small files into a copy of it where every file has a few changes, with
+// one thread and with several, and with each strong sum. The tree can be set with ECKIT_RSYNC_PERFORMANCE_LARGE (count
+// of large files), ECKIT_RSYNC_PERFORMANCE_LARGE_SIZE, ECKIT_RSYNC_PERFORMANCE_SMALL and
+// ECKIT_RSYNC_PERFORMANCE_SMALL_SIZE, and the threads with ECKIT_RSYNC_PERFORMANCE_THREADS.
+
+#include <utime.h>
+
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Timer.h"
+#include "eckit/utils/Rsync.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void report(const std::string& name, size_t bytes, Timer& timer) {
+    std::cout << "    " << std::setw(40) << std::left << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(3) << timer.elapsed() << " s  " << Bytes(bytes, timer) << std::endl;
+}
+
+/// Pseudo-random data, with a change every 8 MiB and at the end when changed, older when not
+static void write(const PathName& path, size_t size, unsigned seed, bool changed) {
+    Buffer buffer(size);
+    unsigned x = seed;
+    for (size_t i = 0; i < size; ++i) {
+        x         = x * 1103515245 + 12345;
+        buffer[i] = char(x >> 16);
+    }
+    if (changed) {
+        for (size_t i = 0; i < size; i += 8 * 1024 * 1024) {
+            buffer[i]++;
+        }
+        buffer[size - 1]++;
+    }
+
+    FileHandle f(path);
+    f.openForWrite(0);
+    f.write(buffer, long(size));
+    f.close();
+
+    // The unchanged copy older, to be synchronised
+    if (!changed) {
+        struct utimbuf times = {::time(nullptr) - 1000, ::time(nullptr) - 1000};
+        ::utime(path.localPath(), &times);
+    }
+}
+
+static void removeTree(const PathName& dir) {
+    std::vector<PathName> files;
+    std::vector<PathName> dirs;
+    dir.childrenRecursive(files, dirs);
+    for (const auto& f : files) {
+        f.unlink();
+    }
+    for (auto d = dirs.rbegin(); d != dirs.rend(); ++d) {
+        d->rmdir();
+    }
+    dir.rmdir();
+}
+
+CASE("Synchronise a tree of large and small files") {
+    size_t large     = Resource<size_t>("$ECKIT_RSYNC_PERFORMANCE_LARGE", 2);
+    size_t largeSize = Resource<size_t>("$ECKIT_RSYNC_PERFORMANCE_LARGE_SIZE", 256 * 1024 * 1024);
+    size_t small     = Resource<size_t>("$ECKIT_RSYNC_PERFORMANCE_SMALL", 200);
+    size_t smallSize = Resource<size_t>("$ECKIT_RSYNC_PERFORMANCE_SMALL_SIZE", 1024 * 1024);
+    size_t threads   = Resource<size_t>("$ECKIT_RSYNC_PERFORMANCE_THREADS", 4);
+
+    std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+    PathName source  = PathName::unique(base + "/rsync-performance-source");
+    PathName target  = PathName::unique(base + "/rsync-performance-target");
+
+    auto tree = [&](const PathName& root, bool changed) {
+        root.mkdir();
+        for (size_t i = 0; i < large; ++i) {
+            write(root / ("large" + std::to_string(i)), largeSize, unsigned(i), changed);
+        }
+        for (size_t i = 0; i < small; ++i) {
+            PathName dir = root / ("dir" + std::to_string(i % 10));
+            dir.mkdir();
+            write(dir / ("small" + std::to_string(i)), smallSize, unsigned(large + i), changed);
+        }
+    };
+
+    size_t total = large * largeSize + small * smallSize;
+    std::cout << large << " files of " << Bytes(largeSize) << " and " << small << " files of " << Bytes(smallSize)
+              << std::endl;
+
+    tree(source, true);
+
+    for (const char* sum : {"blake2", "md4"}) {
+        for (size_t n : {size_t(1), threads}) {
+            tree(target, false);
+
+            Rsync rsync;
+            rsync.threads(n);
+            rsync.strongSum(sum);
+
+            Timer timer("rsync", std::cout);
+            rsync.syncRecursive(source, target);
+            timer.stop();
+
+            std::ostringstream name;
+            name << sum << ", " << n << " thread" << (n > 1 ? "s" : "");
+            report(name.str(), total, timer);
+
+            removeTree(target);
+        }
+    }
+
+    removeTree(source);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -8,6 +8,9 @@
  * does it submit to any jurisdiction.
  */
 
+#include <utime.h>
+
+#include <algorithm>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -253,6 +256,135 @@ CASE("Directory sync") {
     remove_dir_recursive(source);
 }
 
+static void fill(const PathName& path, const std::string& data, size_t size) {
+    std::ofstream ofs(path.localPath(), std::ios::binary);
+    ofs.write(data.data(), std::streamsize(std::min(size, data.size())));
+}
+
+static std::string random_data(size_t size, unsigned seed) {
+    std::string data(size, ' ');
+    for (auto& c : data) {
+        seed = seed * 1103515245 + 12345;
+        c    = char(seed >> 16);
+    }
+    return data;
+}
+
+CASE("Large files by chunks") {
+
+    Rsync rsync;
+    rsync.chunkSize(64 * 1024);
+    rsync.threads(4);
+
+    PathName source    = PathName::unique(PathName(LocalPathName::cwd()) / "test");
+    PathName target    = PathName::unique(PathName(LocalPathName::cwd()) / "test");
+    PathName signature = PathName::unique(PathName(LocalPathName::cwd()) / "test");
+
+    std::string data = random_data(1024 * 1024 + 123, 42);
+
+    // Inserted, removed and changed bytes, some across chunks
+    std::string changed = data;
+    changed.insert(1000, "inserted");
+    changed.erase(300 * 1000, 5000);
+    changed.replace(64 * 1024 - 10, 20, std::string(20, 'x'));
+    changed.replace(700 * 1000, 3, "abc");
+
+    SECTION("Signature by chunks") {
+        fill(target, data, data.size());
+
+        {
+            AutoStdFile tgt(target);
+            AutoStdFile sig(signature, "w");
+            ASSERT(rs_sig_file(tgt, sig, RS_DEFAULT_BLOCK_LEN, 0, RS_RK_BLAKE2_SIG_MAGIC, nullptr) == RS_DONE);
+        }
+
+        MemoryHandle out;
+        out.openForWrite(0);
+        EXPECT_NO_THROW(rsync.computeSignature(target, out));
+
+        std::unique_ptr<DataHandle> ref(signature.fileHandle());
+        EXPECT(ref->compare(out));
+    }
+
+    SECTION("Sync by chunks") {
+        fill(source, changed, changed.size());
+        fill(target, data, data.size());
+
+        EXPECT_NO_THROW(rsync.syncData(source, target));
+        EXPECT(same_contents(source, target));
+    }
+
+    SECTION("Sync by chunks with MD4") {
+        rsync.strongSum("md4");
+
+        fill(source, data, data.size());
+        fill(target, changed, changed.size());
+
+        EXPECT_NO_THROW(rsync.syncData(source, target));
+        EXPECT(same_contents(source, target));
+    }
+
+    SECTION("Unknown strong sum") {
+        EXPECT_THROWS_AS(rsync.strongSum("sha256"), eckit::UserError);
+    }
+
+    SECTION("Files of the same size told apart by their hash") {
+        fill(target, data, data.size());
+        fill(source, data, data.size());
+
+        // The target older than the source
+        struct utimbuf times = {::time(nullptr) - 1000, ::time(nullptr) - 1000};
+        ::utime(target.localPath(), &times);
+
+        EXPECT(rsync.shouldUpdate(source, target));
+
+        rsync.compareHash("MD5");
+        EXPECT(!rsync.shouldUpdate(source, target));
+
+        std::string other = data;
+        other[1000]++;
+        fill(source, other, other.size());
+        EXPECT(rsync.shouldUpdate(source, target));
+    }
+
+    for (const auto& path : {source, target, signature}) {
+        if (path.exists())
+            path.unlink();
+    }
+}
+
+CASE("Directory sync of large and small files") {
+
+    Rsync rsync;
+    rsync.chunkSize(64 * 1024);
+    rsync.threads(4);
+
+    PathName source = PathName::unique(PathName(LocalPathName::cwd()) / "rsync" / "source");
+    PathName target = PathName::unique(PathName(LocalPathName::cwd()) / "rsync" / "target");
+    source.mkdir();
+
+    for (unsigned i = 0; i < 20; ++i) {
+        PathName dir = source / ("dir" + std::to_string(i % 3));
+        dir.mkdir();
+        fill(dir / ("f" + std::to_string(i)), random_data(i % 5 == 0 ? 300 * 1000 : 1000 * i, i), 1000 * 1000);
+    }
+
+    EXPECT_NO_THROW(rsync.syncRecursive(source, target));
+    EXPECT(same_dir(source, target));
+
+    // Changed in place, and synchronised again
+    for (unsigned i = 0; i < 20; i += 2) {
+        PathName file = source / ("dir" + std::to_string(i % 3)) / ("f" + std::to_string(i));
+        fill(file, random_data(i % 5 == 0 ? 300 * 1000 + 7 : 1000 * i + 7, i + 1), 1000 * 1000);
+    }
+
+    EXPECT_NO_THROW(rsync.syncRecursive(source, target));
+    EXPECT(same_dir(source, target));
+
+    remove_dir_recursive(target);
+    remove_dir_recursive(source);
+}
+
 CASE("DataHandle operations") {
 
     Rsync rsync;
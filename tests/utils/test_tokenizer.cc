@@ -8,6 +8,10 @@
  * does it submit to any jurisdiction.
  */
 
+#include <iterator>
+#include <string_view>
+#include <vector>
+
 #include "eckit/log/Log.h"
 #include "eckit/runtime/Tool.h"
 #include "eckit/types/Types.h"
@@ -110,6 +114,51 @@ void test_keep_empty_set() {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void test_views(const std::string& separators, bool keepEmpty, const std::string& source) {
+    Tokenizer parse(separators, keepEmpty);
+
+    StringList expected;
+    parse(source, expected);
+
+    std::vector<std::string_view> views;
+    parse(std::string_view(source), views);
+    EXPECT(views.size() == expected.size());
+
+    size_t n = 0;
+    for (std::string_view token : parse.tokens(source)) {
+        EXPECT(n < expected.size());
+        EXPECT(token == expected[n]);
+        EXPECT(views[n] == expected[n]);
+        // Views of the source
+        EXPECT(token.data() >= source.data() && token.data() + token.size() <= source.data() + source.size());
+        n++;
+    }
+    EXPECT(n == expected.size());
+}
+
+CASE("Test Tokenizer string views") {
+    for (bool keepEmpty : {false, true}) {
+        test_views(":", keepEmpty, ":lolo1:lolo2::lolo3");
+        test_views("-:;", keepEmpty, "-lolo0-lolo1-lolo2;lolo3:-lolo4-");
+        test_views(":", keepEmpty, ":4i:2100:::01:::::.");
+        test_views(":", keepEmpty, "");
+        test_views(":", keepEmpty, ":");
+        test_views(":", keepEmpty, "lolo");
+        test_views("\xff,", keepEmpty, "a\xff,b");
+    }
+
+    Tokenizer parse(":", true);
+    std::vector<std::string_view> views;
+    parse(std::string_view(""), views);
+    EXPECT(views.size() == 1);
+    EXPECT(views[0].empty());
+
+    auto tokens = parse.tokens("a::b");
+    EXPECT(std::distance(tokens.begin(), tokens.end()) == 4 - 1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 CASE("Test Tokenizer StringList") {
 
     test_single<StringList>();
@@ -9,6 +9,7 @@
  */
 
 #include <string>
+#include <string_view>
 
 #include "eckit/eckit.h"
 
@@ -134,6 +135,55 @@ CASE("Translate strings to double") {
 }
 
 
+template <typename T>
+void test_view(const std::string& str) {
+    T fromString = Translator<std::string, T>()(str);
+    T fromView   = Translator<std::string_view, T>()(std::string_view(str));
+    EXPECT(fromView == fromString);
+}
+
+CASE("Translate string views as strings") {
+    // The same rules, whether the fast path applies or the C library is used
+    for (const char* s : {"0", "42", "-42", "+42", " 42", "42 ", "1KB", "2 MiB", "3x", "", "abc", "-", "yes", "off",
+                          "99999999999999999999", "-99999999999999999999", "18446744073709551615"}) {
+        test_view<int>(s);
+        test_view<unsigned int>(s);
+        test_view<long>(s);
+        test_view<unsigned long>(s);
+        test_view<long long>(s);
+        test_view<unsigned long long>(s);
+    }
+
+    Translator<std::string, long> toLong;
+    Translator<std::string, unsigned long> toULong;
+    Translator<std::string, double> toDouble;
+    Translator<std::string, float> toFloat;
+
+    EXPECT(toLong(" 42") == 42);
+    EXPECT(toLong("+42") == 42);
+    EXPECT(toULong("-1") == static_cast<unsigned long>(-1));
+
+    EXPECT(toDouble("+0.5") == 0.5);
+    EXPECT(toDouble("\t0.5") == 0.5);
+    EXPECT_THROWS_AS(toDouble("1e-310"), BadParameter);  // subnormal, as strtod
+    EXPECT_THROWS_AS(toFloat("1e39"), BadParameter);
+    EXPECT(toFloat("0.5") == 0.5f);
+
+    // Views are not null-terminated
+    Translator<std::string_view, long> viewToLong;
+    Translator<std::string_view, double> viewToDouble;
+
+    std::string str("12,1KB,0.25");
+    std::string_view view(str);
+    EXPECT(viewToLong(view.substr(0, 2)) == 12);
+    EXPECT(viewToLong(view.substr(3, 2)) == 1);
+    EXPECT(viewToLong(view.substr(3, 3)) == 1024);
+    EXPECT(viewToDouble(view.substr(7)) == 0.25);
+    EXPECT(viewToDouble(view.substr(7, 3)) == 0.2);
+    EXPECT_THROWS_AS(viewToDouble(view.substr(0, 3)), BadParameter);
+}
+
+
 CASE("Translate signed char as a number") {
     Translator<signed char, std::string> t;
 